@@ -0,0 +1,94 @@
+/**
+ * @file bench.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+
+#include "bench.h"
+
+/**
+ * @brief Rende accessibile il device su cui effettuare il benchmark.
+ *
+ * @param [out] dev          struttura che mantiene le informazioni sul mapping;
+ * @param [in]  gpio_address indirizzo fisico del device; se pari a zero il device viene simulato in RAM;
+ *
+ * @return istanza myGPIO da usare nel benchmark, NULL in caso di errore.
+ */
+myGPIO_t bench_device_open(bench_device_t *dev, uint32_t gpio_address) {
+	memset(dev, 0, sizeof(bench_device_t));
+	dev->descriptor = -1;
+	if (gpio_address == 0)
+		return dev->ram;
+
+	if ((dev->descriptor = open("/dev/mem", O_RDWR)) < 1) {
+		perror("/dev/mem");
+		return NULL;
+	}
+	dev->page_size = sysconf(_SC_PAGESIZE);
+	uint32_t page_addr = gpio_address & ~(dev->page_size-1);
+	dev->page = mmap(NULL, dev->page_size, PROT_READ | PROT_WRITE, MAP_SHARED, dev->descriptor, page_addr);
+	if (dev->page == MAP_FAILED) {
+		printf("Mapping indirizzo fisico - indirizzo virtuale FALLITO!\n");
+		close(dev->descriptor);
+		return NULL;
+	}
+	return (myGPIO_t)((uint8_t*)dev->page + (gpio_address - page_addr));
+}
+
+/**
+ * @brief Rilascia il mapping effettuato da bench_device_open()
+ */
+void bench_device_close(bench_device_t *dev) {
+	if (dev->descriptor == -1)
+		return;
+	munmap(dev->page, dev->page_size);
+	close(dev->descriptor);
+}
+
+/**
+ * @brief Restituisce il valore del clock monotono di sistema, in nanosecondi.
+ */
+uint64_t bench_now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Stampa il risultato di una misura: tempo medio per operazione, operazioni al secondo e, se
+ * disponibile, numero medio di letture e scritture sui registri per operazione.
+ */
+void bench_report(const char *name, uint32_t iterations, uint64_t elapsed_ns, unsigned long reads, unsigned long writes) {
+	if (reads == BENCH_UNCOUNTED || writes == BENCH_UNCOUNTED) {
+		printf("%-40s %10.2f ns/op %10.3f Mop/s\n", name, (double)elapsed_ns / iterations, iterations * 1000.0 / elapsed_ns);
+		return;
+	}
+	printf("%-40s %10.2f ns/op %10.3f Mop/s %8.2f read/op %8.2f write/op\n",
+			name,
+			(double)elapsed_ns / iterations,
+			iterations * 1000.0 / elapsed_ns,
+			(double)reads / iterations,
+			(double)writes / iterations);
+}
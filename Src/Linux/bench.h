@@ -0,0 +1,76 @@
+/**
+ * @file bench.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_BENCH_HEADER_H
+#define MYGPIO_BENCH_HEADER_H
+
+#include <inttypes.h>
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+
+/**
+ * @brief Funzioni di supporto comuni ai programmi di benchmark.
+ *
+ * @details
+ * Un benchmark può operare su un device reale, mappato attraverso /dev/mem come avviene in noDriver.c,
+ * oppure, se non viene specificato alcun indirizzo fisico, su un banco di registri allocato in RAM. Nel
+ * secondo caso i tempi misurati non comprendono il costo delle transazioni sul bus, ma il conteggio degli
+ * accessi ai registri resta significativo.
+ */
+typedef struct {
+	int       descriptor;  //!< descrittore di /dev/mem, -1 se il device è simulato in RAM
+	void     *page;        //!< indirizzo virtuale della pagina a cui è mappato il device
+	uint32_t  page_size;   //!< dimensione della pagina mappata
+	uint32_t  ram[8];      //!< registri del device, se simulato in RAM
+} bench_device_t;
+
+myGPIO_t bench_device_open (bench_device_t *dev, uint32_t gpio_address);
+void     bench_device_close(bench_device_t *dev);
+uint64_t bench_now_ns      (void);
+void     bench_report      (const char *name, uint32_t iterations, uint64_t elapsed_ns, unsigned long reads, unsigned long writes);
+
+#define BENCH_UNCOUNTED (~0UL)  //!< numero di accessi non disponibile
+
+/**
+ * @brief Esegue iterations volte l'istruzione stmt, e riporta tempo medio ed accessi ai registri per
+ * operazione; il numero di accessi è disponibile solo se MYGPIO_COUNT_ACCESS è definito.
+ */
+#ifdef MYGPIO_COUNT_ACCESS
+#define BENCH_RUN(name, iterations, stmt) do {                                                \
+	unsigned long __reads = myGPIO_BusReads, __writes = myGPIO_BusWrites;                    \
+	uint32_t __i;                                                                             \
+	uint64_t __start = bench_now_ns();                                                        \
+	for (__i = 0; __i < (iterations); __i++) { stmt; }                                        \
+	bench_report((name), (iterations), bench_now_ns() - __start,                              \
+			myGPIO_BusReads - __reads, myGPIO_BusWrites - __writes);                          \
+} while (0)
+#else
+#define BENCH_RUN(name, iterations, stmt) do {                                                \
+	uint32_t __i;                                                                             \
+	uint64_t __start = bench_now_ns();                                                        \
+	for (__i = 0; __i < (iterations); __i++) { stmt; }                                        \
+	bench_report((name), (iterations), bench_now_ns() - __start, BENCH_UNCOUNTED, BENCH_UNCOUNTED); \
+} while (0)
+#endif
+
+#endif
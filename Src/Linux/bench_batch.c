@@ -0,0 +1,151 @@
+/**
+ * @file bench_batch.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_batch.c
+ * Il file bench_batch.c contiene un programma che confronta sequenze di configurazione effettuate
+ * chiamando direttamente le funzioni di myGPIO.h con le stesse sequenze registrate in un myGPIO_Batch_t:
+ * - la configurazione di led, button e switch effettuata in main() da interrupt_bare.c;
+ * - la configurazione, pin per pin, di 16 uscite di un singolo device.
+ * Per ciascuna sequenza vengono riportati il tempo medio ed il numero di accessi ai registri, e viene
+ * verificato che lo stato finale dei registri sia lo stesso nei due casi. I device sono simulati in RAM.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_batch.h"
+#include "bench.h"
+
+#define LOW4 (MYGPIO_PIN0 | MYGPIO_PIN1 | MYGPIO_PIN2 | MYGPIO_PIN3)
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_batch [-n iterazioni]\n");
+	printf("\t-n <num>: numero di iterazioni per ciascuna misura (default 1000000)\n");
+}
+
+/**
+ * @brief Configurazione dei device di interrupt_bare.c, con chiamate dirette
+ */
+static void setup_plain(myGPIO_t *gpio) {
+	myGPIO_SetMode(gpio[0], LOW4, MYGPIO_MODE_WRITE);
+	myGPIO_SetMode(gpio[1], LOW4, MYGPIO_MODE_READ);
+	myGPIO_SetMode(gpio[2], LOW4, MYGPIO_MODE_READ);
+	myGPIO_SetValue(gpio[0], LOW4, MYGPIO_PIN_RESET);
+	myGPIO_SetValue(gpio[1], LOW4, MYGPIO_PIN_RESET);
+	myGPIO_SetValue(gpio[2], LOW4, MYGPIO_PIN_RESET);
+	myGPIO_GlobalInterruptEnable(gpio[1]);
+	myGPIO_GlobalInterruptEnable(gpio[2]);
+	myGPIO_PinInterruptEnable(gpio[1], LOW4);
+	myGPIO_PinInterruptEnable(gpio[2], LOW4);
+}
+
+/**
+ * @brief Configurazione dei device di interrupt_bare.c, attraverso un batch
+ */
+static void setup_batch(myGPIO_t *gpio, uint32_t flags) {
+	myGPIO_Batch_t batch;
+	myGPIO_Batch_Init(&batch, flags);
+	myGPIO_Batch_SetMode(&batch, gpio[0], LOW4, MYGPIO_MODE_WRITE);
+	myGPIO_Batch_SetMode(&batch, gpio[1], LOW4, MYGPIO_MODE_READ);
+	myGPIO_Batch_SetMode(&batch, gpio[2], LOW4, MYGPIO_MODE_READ);
+	myGPIO_Batch_SetValue(&batch, gpio[0], LOW4, MYGPIO_PIN_RESET);
+	myGPIO_Batch_SetValue(&batch, gpio[1], LOW4, MYGPIO_PIN_RESET);
+	myGPIO_Batch_SetValue(&batch, gpio[2], LOW4, MYGPIO_PIN_RESET);
+	myGPIO_Batch_GlobalInterruptEnable(&batch, gpio[1]);
+	myGPIO_Batch_GlobalInterruptEnable(&batch, gpio[2]);
+	myGPIO_Batch_PinInterruptEnable(&batch, gpio[1], LOW4);
+	myGPIO_Batch_PinInterruptEnable(&batch, gpio[2], LOW4);
+	myGPIO_Batch_Flush(&batch);
+}
+
+/**
+ * @brief Configurazione, pin per pin, di 16 uscite, con chiamate dirette
+ */
+static void pins_plain(myGPIO_t gpio) {
+	uint32_t i;
+	for (i = 0; i < 16; i++) {
+		myGPIO_SetMode(gpio, MYGPIO_PIN(i), MYGPIO_MODE_WRITE);
+		myGPIO_SetValue(gpio, MYGPIO_PIN(i), i & 1);
+	}
+}
+
+/**
+ * @brief Configurazione, pin per pin, di 16 uscite, attraverso un batch
+ */
+static void pins_batch(myGPIO_t gpio) {
+	uint32_t i;
+	myGPIO_Batch_t batch;
+	myGPIO_Batch_Init(&batch, 0);
+	for (i = 0; i < 16; i++) {
+		myGPIO_Batch_SetMode(&batch, gpio, MYGPIO_PIN(i), MYGPIO_MODE_WRITE);
+		myGPIO_Batch_SetValue(&batch, gpio, MYGPIO_PIN(i), i & 1);
+	}
+	myGPIO_Batch_Flush(&batch);
+}
+
+int main(int argc, char **argv) {
+	uint32_t iterations = 1000000;
+	uint32_t plain[3][8], batch[3][8];
+	myGPIO_t gpio_plain[3] = {plain[0], plain[1], plain[2]};
+	myGPIO_t gpio_batch[3] = {batch[0], batch[1], batch[2]};
+	int par;
+
+	while((par = getopt(argc, argv, "n:")) != -1) {
+		switch (par) {
+		case 'n' :
+			iterations = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (iterations == 0) {
+		printf("il numero di iterazioni deve essere maggiore di zero.\n");
+		return -1;
+	}
+
+	memset(plain, 0, sizeof(plain));
+	memset(batch, 0, sizeof(batch));
+	setup_plain(gpio_plain);
+	setup_batch(gpio_batch, MYGPIO_BATCH_ASSUME_RESET);
+	pins_plain(gpio_plain[0]);
+	pins_batch(gpio_batch[0]);
+	printf("stato finale dei registri: %s\n", (memcmp(plain, batch, sizeof(plain)) == 0 ? "identico" : "DIVERSO"));
+
+	printf("configurazione di interrupt_bare.c, iterazioni: %u\n", iterations);
+	BENCH_RUN("myGPIO.h",                           iterations, setup_plain(gpio_plain));
+	BENCH_RUN("myGPIO_Batch_t",                     iterations, setup_batch(gpio_batch, 0));
+	BENCH_RUN("myGPIO_Batch_t, ASSUME_RESET",       iterations, setup_batch(gpio_batch, MYGPIO_BATCH_ASSUME_RESET));
+	printf("configurazione di 16 uscite, pin per pin, iterazioni: %u\n", iterations);
+	BENCH_RUN("myGPIO.h",                           iterations, pins_plain(gpio_plain[0]));
+	BENCH_RUN("myGPIO_Batch_t",                     iterations, pins_batch(gpio_batch[0]));
+	return 0;
+}
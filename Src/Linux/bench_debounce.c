@@ -0,0 +1,156 @@
+/**
+ * @file bench_debounce.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_debounce.c
+ * Il file bench_debounce.c contiene un programma che misura il numero di campioni al secondo elaborati dal
+ * debouncer a contatori verticali definito in myGPIO_debounce.h, confrontandolo con un debouncer che
+ * mantiene un contatore per ciascun pin. I campioni vengono generati sinteticamente: ciascuno dei 32 pin
+ * cambia livello ad intervalli casuali, ed ogni transizione è seguita da un transitorio di rimbalzi.
+ * Viene inoltre verificato che i due debouncer producano, campione per campione, gli stessi risultati.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_debounce.h"
+#include "bench.h"
+
+/**
+ * @brief Debouncer di riferimento: un contatore per pin.
+ */
+typedef struct {
+	uint32_t state;
+	uint32_t count[32];
+	uint32_t samples;
+} reference_t;
+
+static uint32_t reference_update(reference_t *r, uint32_t sample) {
+	uint32_t pin, changed = 0;
+	for (pin = 0; pin < 32; pin++) {
+		if (((sample ^ r->state) & MYGPIO_PIN(pin)) == 0)
+			r->count[pin] = 0;
+		else if (++r->count[pin] == r->samples) {
+			r->count[pin] = 0;
+			changed |= MYGPIO_PIN(pin);
+		}
+	}
+	r->state ^= changed;
+	return changed;
+}
+
+/**
+ * @brief Generatore pseudo-casuale xorshift32
+ */
+static uint32_t xorshift32(uint32_t *x) {
+	*x ^= *x << 13;
+	*x ^= *x >> 17;
+	*x ^= *x << 5;
+	return *x;
+}
+
+/**
+ * @brief Genera una traccia di campioni con transizioni e rimbalzi.
+ */
+static void generate(uint32_t *trace, uint32_t length, uint32_t bounce) {
+	uint32_t seed = 0x2545F491U, level = 0, pin, i;
+	uint32_t next_edge[32], bounce_end[32];
+	for (pin = 0; pin < 32; pin++) {
+		next_edge[pin] = xorshift32(&seed) % 1000;
+		bounce_end[pin] = 0;
+	}
+	for (i = 0; i < length; i++) {
+		uint32_t noise = 0;
+		for (pin = 0; pin < 32; pin++) {
+			if (i == next_edge[pin]) {
+				level ^= MYGPIO_PIN(pin);
+				bounce_end[pin] = i + 1 + xorshift32(&seed) % bounce;
+				next_edge[pin] = i + bounce + 1 + xorshift32(&seed) % 1000;
+			}
+			if (i < bounce_end[pin] && (xorshift32(&seed) & 1))
+				noise |= MYGPIO_PIN(pin);
+		}
+		trace[i] = level ^ noise;
+	}
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_debounce [-n campioni] [-s campioni-consecutivi]\n");
+	printf("\t-n <num>: lunghezza della traccia (default 1000000)\n");
+	printf("\t-s <num>: campioni consecutivi necessari per il cambiamento di stato (default 4, max %u)\n", MYGPIO_DEBOUNCE_MAX_SAMPLES);
+}
+
+int main(int argc, char **argv) {
+	uint32_t length = 1000000, samples = 4, i, changes = 0, mismatch = 0;
+	uint32_t *trace, *out_vertical, *out_reference;
+	myGPIO_Debounce_t debounce;
+	reference_t reference = {0};
+	int par;
+
+	while((par = getopt(argc, argv, "n:s:")) != -1) {
+		switch (par) {
+		case 'n' :
+			length = strtoul(optarg, NULL, 0);
+			break;
+		case 's' :
+			samples = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (length == 0 || samples == 0 || samples > MYGPIO_DEBOUNCE_MAX_SAMPLES) {
+		howto();
+		return -1;
+	}
+	trace = malloc(length * sizeof(uint32_t));
+	out_vertical = malloc(length * sizeof(uint32_t));
+	out_reference = malloc(length * sizeof(uint32_t));
+	if (trace == NULL || out_vertical == NULL || out_reference == NULL) {
+		perror(argv[0]);
+		return -1;
+	}
+	generate(trace, length, samples);
+
+	myGPIO_Debounce_Init(&debounce, 0, samples);
+	reference.samples = samples;
+	printf("traccia: %u campioni, %u campioni consecutivi per il cambiamento di stato\n", length, samples);
+	BENCH_RUN("myGPIO_Debounce_Update",         length, out_vertical[__i] = myGPIO_Debounce_Update(&debounce, trace[__i]));
+	BENCH_RUN("contatore per pin (riferimento)", length, out_reference[__i] = reference_update(&reference, trace[__i]));
+
+	for (i = 0; i < length; i++) {
+		mismatch += (out_vertical[i] != out_reference[i]);
+		changes += __builtin_popcount(out_vertical[i]);
+	}
+	printf("cambiamenti di stato rilevati: %u\n", changes);
+	printf("verifica: %s\n", (mismatch == 0 ? "ok" : "FALLITA"));
+	free(trace);
+	free(out_vertical);
+	free(out_reference);
+	return (mismatch == 0 ? 0 : -1);
+}
@@ -0,0 +1,141 @@
+/**
+ * @file bench_group.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_group.c
+ * Il file bench_group.c contiene un programma che confronta l'aggiornamento di un bus a 96 bit, realizzato
+ * affiancando tre device myGPIO, effettuato con chiamate a myGPIO_SetValue() sui singoli device, con lo
+ * stesso aggiornamento effettuato attraverso un oggetto myGPIO_Group_t.
+ * Gli indirizzi fisici dei tre device possono essere specificati ripetendo l'opzione -a; i device non
+ * specificati vengono simulati in RAM.
+ *
+ * @warning Il benchmark pone in uscita e modifica tutti i pin dei tre device; i registri MODE e WRITE
+ * vengono ripristinati al termine.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_group.h"
+#include "bench.h"
+
+#define BUS_DEVICES 3  //!< numero di device che compongono il bus a 96 bit
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_group [-a gpio_phisycal_address]... [-n iterazioni]\n");
+	printf("\t-a <address>: indirizzo fisico di un device, fino a tre volte; i device mancanti sono simulati in RAM\n");
+	printf("\t-n <num>: numero di iterazioni per ciascuna misura (default 1000000)\n");
+}
+
+/**
+ * @brief Effettua il parsing dei parametri passati al programma
+ *
+ * @retval 0 se il parsing ha successo
+ * @retval -1 se si verifica un errore
+ */
+int parse_args(int argc, char **argv, uint32_t *gpio_address, uint32_t *iterations) {
+	int par, devices = 0;
+	while((par = getopt(argc, argv, "a:n:")) != -1) {
+		switch (par) {
+		case 'a' :
+			if (devices == BUS_DEVICES) {
+				printf("al più %d device.\n", BUS_DEVICES);
+				return -1;
+			}
+			gpio_address[devices++] = strtoul(optarg, NULL, 0);
+			break;
+		case 'n' :
+			*iterations = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (*iterations == 0) {
+		printf("il numero di iterazioni deve essere maggiore di zero.\n");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Aggiornamento del bus scritto "a mano", device per device, come farebbe un'applicazione che
+ * usa direttamente myGPIO.h
+ */
+static void bus_write_per_device(myGPIO_t *gpio, const uint32_t *mask, const uint32_t *value) {
+	uint32_t i;
+	for (i = 0; i < BUS_DEVICES; i++) {
+		myGPIO_SetValue(gpio[i], mask[i] & value[i], MYGPIO_PIN_SET);
+		myGPIO_SetValue(gpio[i], mask[i] & ~value[i], MYGPIO_PIN_RESET);
+	}
+}
+
+int main(int argc, char **argv) {
+	uint32_t gpio_addr[BUS_DEVICES] = {0, 0, 0};
+	uint32_t iterations = 1000000;
+	bench_device_t dev[BUS_DEVICES];
+	myGPIO_t gpio[BUS_DEVICES];
+	uint32_t saved_mode[BUS_DEVICES], saved_write[BUS_DEVICES];
+	myGPIO_Group_t bus;
+	uint32_t i;
+
+	if (parse_args(argc, argv, gpio_addr, &iterations) == -1)
+		return -1;
+	for (i = 0; i < BUS_DEVICES; i++) {
+		if ((gpio[i] = bench_device_open(&dev[i], gpio_addr[i])) == NULL)
+			return -1;
+		saved_mode[i]  = myGPIO_RegRead(gpio[i], MODE_REG);
+		saved_write[i] = myGPIO_RegRead(gpio[i], WRITE_REG);
+		printf("device %u: %s\n", i, (gpio_addr[i] == 0 ? "RAM" : "/dev/mem"));
+	}
+
+	uint32_t all[BUS_DEVICES]    = {0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU};
+	uint32_t mask[BUS_DEVICES]   = {0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU};
+	uint32_t sparse[BUS_DEVICES] = {0x000000FFU, 0x00000000U, 0xFF000000U};
+	uint32_t value[2][BUS_DEVICES] = {
+		{0xA5A5A5A5U, 0x5A5A5A5AU, 0xA5A5A5A5U},
+		{0x5A5A5A5AU, 0xA5A5A5A5U, 0x5A5A5A5AU}
+	};
+
+	myGPIO_Group_Init(&bus, gpio, BUS_DEVICES);
+	myGPIO_Group_SetMode(&bus, all, MYGPIO_MODE_WRITE);
+
+	printf("aggiornamento del bus a 96 bit, iterazioni: %u\n", iterations);
+	BENCH_RUN("per-device myGPIO_SetValue",        iterations, bus_write_per_device(gpio, mask, value[__i & 1]));
+	BENCH_RUN("myGPIO_Group_Write",                iterations, myGPIO_Group_Write(&bus, mask, value[__i & 1]));
+	BENCH_RUN("per-device myGPIO_SetValue, sparse", iterations, bus_write_per_device(gpio, sparse, value[__i & 1]));
+	BENCH_RUN("myGPIO_Group_Write, sparse",        iterations, myGPIO_Group_Write(&bus, sparse, value[__i & 1]));
+
+	for (i = 0; i < BUS_DEVICES; i++) {
+		myGPIO_RegWrite(gpio[i], MODE_REG, saved_mode[i]);
+		myGPIO_RegWrite(gpio[i], WRITE_REG, saved_write[i]);
+		bench_device_close(&dev[i]);
+	}
+	return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file bench_inline.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_inline.c
+ * Il file bench_inline.c contiene un programma che misura il tempo medio delle operazioni definite in
+ * bench_inline_ops.c. Il Makefile produce due eseguibili: bench_inline, che fa uso delle funzioni
+ * out-of-line di myGPIO.c, e bench_inline_fast, che fa uso della variante "static inline" definita in
+ * myGPIO_inline.h, senza assert. Il target "make inline-size" riporta, per entrambe le varianti, la
+ * dimensione del codice generato per ciascuna operazione.
+ * Se viene specificato l'indirizzo fisico di un device, il benchmark opera su di esso attraverso /dev/mem,
+ * altrimenti su un banco di registri allocato in RAM.
+ *
+ * @warning Il benchmark modifica il valore ed il verso dei pin 0 ed 1.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "bench.h"
+
+void     op_SetValue_Set   (myGPIO_t gpio);
+void     op_SetValue_Reset (myGPIO_t gpio);
+void     op_SetMode_Write  (myGPIO_t gpio);
+void     op_Toggle         (myGPIO_t gpio);
+uint32_t op_GetRead        (myGPIO_t gpio);
+void     op_PinInterruptAck(myGPIO_t gpio);
+void     op_SetPins        (myGPIO_t gpio);
+void     op_ClearPins      (myGPIO_t gpio);
+void     op_WritePins      (myGPIO_t gpio);
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_inline [-a gpio_phisycal_address] [-n iterazioni]\n");
+	printf("\t-a <address>: indirizzo fisico del device; se omesso, il device viene simulato in RAM\n");
+	printf("\t-n <num>: numero di iterazioni per ciascuna misura (default 1000000)\n");
+}
+
+/**
+ * @brief Effettua il parsing dei parametri passati al programma
+ *
+ * @retval 0 se il parsing ha successo
+ * @retval -1 se si verifica un errore
+ */
+int parse_args(int argc, char **argv, uint32_t *gpio_address, uint32_t *iterations) {
+	int par;
+	while((par = getopt(argc, argv, "a:n:")) != -1) {
+		switch (par) {
+		case 'a' :
+			*gpio_address = strtoul(optarg, NULL, 0);
+			break;
+		case 'n' :
+			*iterations = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (*iterations == 0) {
+		printf("il numero di iterazioni deve essere maggiore di zero.\n");
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	uint32_t gpio_addr  = 0;        // indirizzo fisico del device, 0 se simulato in RAM
+	uint32_t iterations = 1000000;  // numero di iterazioni per ciascuna misura
+	bench_device_t dev;
+	myGPIO_t gpio;
+
+	if (parse_args(argc, argv, &gpio_addr, &iterations) == -1)
+		return -1;
+	if ((gpio = bench_device_open(&dev, gpio_addr)) == NULL)
+		return -1;
+
+	printf("%s - device: %s, iterazioni: %u\n", argv[0], (gpio_addr == 0 ? "RAM" : "/dev/mem"), iterations);
+	BENCH_RUN("myGPIO_SetValue(SET)",     iterations, op_SetValue_Set(gpio));
+	BENCH_RUN("myGPIO_SetValue(RESET)",   iterations, op_SetValue_Reset(gpio));
+	BENCH_RUN("myGPIO_SetMode(WRITE)",    iterations, op_SetMode_Write(gpio));
+	BENCH_RUN("myGPIO_Toggle",            iterations, op_Toggle(gpio));
+	BENCH_RUN("myGPIO_GetRead",           iterations, op_GetRead(gpio));
+	BENCH_RUN("myGPIO_PinInterruptAck",   iterations, op_PinInterruptAck(gpio));
+	BENCH_RUN("myGPIO_SetPins",           iterations, op_SetPins(gpio));
+	BENCH_RUN("myGPIO_ClearPins",         iterations, op_ClearPins(gpio));
+	BENCH_RUN("myGPIO_WritePins",         iterations, op_WritePins(gpio));
+
+	bench_device_close(&dev);
+	return 0;
+}
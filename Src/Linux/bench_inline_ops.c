@@ -0,0 +1,42 @@
+/**
+ * @file bench_inline_ops.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @details
+ * Operazioni misurate da bench_inline.c. Il file viene compilato due volte: una volta facendo uso delle
+ * funzioni out-of-line di myGPIO.c, ed una volta con MYGPIO_INLINE e MYGPIO_NO_ASSERT definiti. Ciascuna
+ * operazione è racchiusa in una funzione non inline rispetto al chiamante, in modo che il costo della
+ * chiamata sia lo stesso nei due casi e che la dimensione del codice generato possa essere confrontata
+ * simbolo per simbolo (make inline-size).
+ */
+#include "myGPIO.h"
+#include "myGPIO_inline.h"
+
+#define OPS_MASK (MYGPIO_PIN0 | MYGPIO_PIN1)
+
+void op_SetValue_Set(myGPIO_t gpio)        { myGPIO_SetValue(gpio, OPS_MASK, MYGPIO_PIN_SET); }
+void op_SetValue_Reset(myGPIO_t gpio)      { myGPIO_SetValue(gpio, OPS_MASK, MYGPIO_PIN_RESET); }
+void op_SetMode_Write(myGPIO_t gpio)       { myGPIO_SetMode(gpio, OPS_MASK, MYGPIO_MODE_WRITE); }
+void op_Toggle(myGPIO_t gpio)              { myGPIO_Toggle(gpio, OPS_MASK); }
+uint32_t op_GetRead(myGPIO_t gpio)         { return myGPIO_GetRead(gpio); }
+void op_PinInterruptAck(myGPIO_t gpio)     { myGPIO_PinInterruptAck(gpio, OPS_MASK); }
+void op_SetPins(myGPIO_t gpio)             { myGPIO_SetPins(gpio, OPS_MASK); }
+void op_ClearPins(myGPIO_t gpio)           { myGPIO_ClearPins(gpio, OPS_MASK); }
+void op_WritePins(myGPIO_t gpio)           { myGPIO_WritePins(gpio, OPS_MASK); }
@@ -0,0 +1,664 @@
+/**
+ * @file bench_paths.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example bench_paths.c
+ * Il file bench_paths.c contiene un programma che confronta, su ciascuna operazione, i modi di accesso al
+ * device mostrati dagli esempi:
+ *  - devmem: le funzioni di myGPIO.h su un device mappato attraverso /dev/mem, come in noDriver.c;
+ *  - uio: le stesse funzioni su un device mappato attraverso /dev/uioX, come in uio.c;
+ *  - mygpiok: lettura e scrittura dei registri attraverso il modulo myGPIOK, con lseek() seguita da
+ *    read()/write() oppure con pread()/pwrite(), come in mygpiok.c con e senza __USE_PWRITE__;
+ *  - le attese di un'interruzione: read() bloccante, poll() seguita da read() e polling del registro IRQ.
+ *
+ * I modi devmem, uio e mygpiok vengono misurati sul device reale indicato con -a, -u e -k. Le stesse
+ * operazioni vengono sempre misurate anche sul modello di myGPIO_model.h (modo "mmio", backend "model"), col
+ * tempo modellato: la somma dei costi degli accessi ai registri, indicati con -r e -w, che non dipende
+ * dalla macchina su cui il programma viene eseguito. Il costo delle system call di myGPIOK non è modellato,
+ * per cui il modo mygpiok viene misurato solo sul device reale. Le attese vengono sempre misurate anche
+ * sull'host (backend "host"), con una pipe, o un flag in memoria condivisa per il polling, scritta da un
+ * secondo thread: il risultato comprende il costo delle system call e dei risvegli dell'host, ma non quello
+ * del driver e del device.
+ *
+ * Le attese delle interruzioni reali richiedono che un pin configurato come uscita sia collegato
+ * fisicamente ad un pin configurato come ingresso (-L out:in): un secondo thread genera un impulso sul pin
+ * di uscita, e viene misurato il tempo trascorso fino al ritorno dell'attesa. Le altre operazioni agiscono
+ * sui pin indicati da -m, di default nessuno, per cui sul device reale scrivono sui registri i valori che
+ * vi leggono. Su un sistema con un solo core le attese attive cedono il processore ad ogni iterazione,
+ * altrimenti il thread che genera l'evento non verrebbe eseguito fino al termine del quanto di tempo.
+ *
+ * Le operazioni vengono misurate a blocchi: per ciascun blocco si calcola il tempo medio per operazione,
+ * e sulla distribuzione dei blocchi i percentili 50, 90 e 99 ed il massimo; le attese vengono misurate una
+ * per una. I risultati vengono stampati e, con -j, salvati in formato JSON, un risultato per riga, assieme
+ * al nome ed all'architettura della macchina; con -b vengono confrontati, sulla mediana, con quelli di una
+ * precedente esecuzione, e con -t le operazioni peggiorate oltre la soglia indicata fanno terminare il
+ * programma con errore. I risultati del modello vengono sempre confrontati, gli altri solo se il file è
+ * stato prodotto sulla stessa macchina.
+ *
+ * Compilato con MYGPIO_BACKEND e collegato a myGPIO_bridge_wrap.c (bench_paths-ghdl), il programma misura
+ * gli stessi modi di accesso, con lo stesso codice, sul device simulato da bridge_model o dal testbench
+ * VHDL (backend "bridge"): /dev/mem, /dev/uioX e /dev/myGPIOKx vengono serviti dalla mailbox, con la
+ * semantica di uio_pdrv_genirq e di myGPIOK, e le attese ricevono l'impulso attraverso il loopback indicato
+ * con MYGPIO_BRIDGE_LOOPBACK. I tempi comprendono quindi il costo della mailbox, e non quello del bus AXI,
+ * ma il confronto tra i modi di accesso, compreso quello tra lseek()+write() e pwrite(), esercita il codice
+ * reale. Le misure sul modello non vengono effettuate, perché il backend è quello della mailbox.
+ *
+ * @code
+ * $ ./bench_paths -j bench_paths.json -b bench_paths_baseline.json          # modello ed attese sull'host
+ * $ ./bench_paths -a 0x43c00000 -u /dev/uio0 -k /dev/myGPIOK0 -L 4:0 -j zynq.json -b zynq_baseline.json
+ * $ MYGPIO_BRIDGE=/bench_paths MYGPIO_BRIDGE_LOOPBACK=4:0 ./bridge_model -p 0 &
+ * $ MYGPIO_BRIDGE=/bench_paths ./bench_paths-ghdl -a 0x43c00000 -u /dev/uio0 -k /dev/myGPIOK0 -L 4:0
+ * @endcode
+ */
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/utsname.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "bench.h"
+#include "bench_paths.h"
+
+#define MODE_OFFSET   0U
+#define WRITE_OFFSET  4U
+#define READ_OFFSET   8U
+
+#define BLOCK_MMAP     256U  //!< operazioni per blocco sui device mappati
+#define BLOCK_SYSCALL  16U   //!< operazioni per blocco attraverso myGPIOK
+#define MAX_RESULTS    64U
+
+#ifdef MYGPIO_BACKEND
+#define DEVICE_BACKEND "bridge"  //!< device simulato, servito dalla mailbox di myGPIO_bridge.h
+#else
+#define DEVICE_BACKEND "hw"      //!< device reale
+#endif
+
+/**
+ * @brief Risultato di una misura.
+ */
+typedef struct {
+	char     path[16];     //!< modo di accesso
+	char     backend[8];   //!< "hw" se il device è reale, "bridge" se simulato, "model" se modellato, "host" se misurato sull'host
+	char     op[40];       //!< operazione misurata
+	uint32_t iterations;   //!< operazioni effettuate
+	double   ns_per_op;    //!< tempo medio per operazione
+	double   p50;          //!< percentili del tempo per operazione, in ns
+	double   p90;
+	double   p99;
+	double   max;
+} result_t;
+
+static result_t results[MAX_RESULTS];
+static uint32_t result_count = 0;
+static int      single_cpu = 0;  //!< vero se il sistema ha un solo core: le attese attive cedono il processore
+
+/**
+ * @brief Parametri di esecuzione.
+ */
+typedef struct {
+	uint32_t    address;     //!< indirizzo fisico del device, 0 se non misurato
+	const char *uio;         //!< file /dev/uioX, NULL se non misurato
+	const char *mygpiok;     //!< file /dev/myGPIOKx, NULL se non misurato
+	uint32_t    mask;        //!< pin su cui agire
+	uint32_t    out;         //!< pin di uscita collegato al pin di ingresso in, se loopback
+	uint32_t    in;
+	int         loopback;    //!< vero se -L è stato indicato
+	uint32_t    iterations;  //!< operazioni per misura sui device mappati
+	uint32_t    events;      //!< interruzioni per misura
+	uint32_t    read_ns;     //!< costo di una lettura sul modello
+	uint32_t    write_ns;    //!< costo di una scrittura sul modello
+} param_t;
+
+static int compare_double(const void *a, const void *b) {
+	double x = *(const double*)a, y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * @brief Registra e stampa il risultato di una misura, a partire dai tempi per operazione dei blocchi.
+ */
+void bench_paths_record(const char *path, const char *backend, const char *op, double *sample, uint32_t samples, uint32_t per_sample) {
+	result_t *r;
+	double sum = 0;
+	uint32_t i;
+	if (result_count == MAX_RESULTS || samples == 0)
+		return;
+	r = &results[result_count++];
+	snprintf(r->path, sizeof(r->path), "%s", path);
+	snprintf(r->backend, sizeof(r->backend), "%s", backend);
+	snprintf(r->op, sizeof(r->op), "%s", op);
+	for (i = 0; i < samples; i++)
+		sum += sample[i];
+	qsort(sample, samples, sizeof(double), compare_double);
+	r->iterations = samples * per_sample;
+	r->ns_per_op = sum / samples;
+	r->p50 = sample[samples / 2];
+	r->p90 = sample[(uint64_t)samples * 90 / 100];
+	r->p99 = sample[(uint64_t)samples * 99 / 100];
+	r->max = sample[samples - 1];
+	printf("%-8s %-4s %-34s %10.2f ns/op %12.0f op/s  p50 %9.2f  p90 %9.2f  p99 %9.2f  max %10.2f\n", r->path,
+			r->backend, r->op, r->ns_per_op, 1e9 / r->ns_per_op, r->p50, r->p90, r->p99, r->max);
+}
+
+/**
+ * @brief Esegue stmt a blocchi di block operazioni, fino a totalizzare iterations operazioni, e registra
+ * il tempo per operazione di ciascun blocco.
+ */
+#define MEASURE(path, backend, op, iterations, block, stmt) do {                    \
+	uint32_t __samples = (iterations) / (block), __s, __i;                          \
+	double *__sample = malloc((__samples != 0 ? __samples : 1) * sizeof(double));    \
+	for (__s = 0; __s < __samples; __s++) {                                          \
+		uint64_t __start = bench_now_ns();                                           \
+		for (__i = 0; __i < (block); __i++) { stmt; }                                \
+		__sample[__s] = (double)(bench_now_ns() - __start) / (block);                \
+	}                                                                                \
+	bench_paths_record((path), (backend), (op), __sample, __samples, (block));       \
+	free(__sample);                                                                  \
+} while (0)
+
+/**
+ * @brief Misura ciascuna funzione di myGPIO.h su un device mappato in memoria.
+ */
+static void bench_api(const char *path, const char *backend, myGPIO_t gpio, const param_t *p) {
+	volatile uint32_t sink = 0;
+	uint32_t n = p->iterations, mask = p->mask;
+#define MAPPED(op, stmt) MEASURE(path, backend, (op), n, BLOCK_MMAP, stmt);
+	BENCH_PATHS_API(MAPPED)
+#undef MAPPED
+	(void)sink;
+}
+
+/**
+ * @brief Misura lettura e scrittura dei registri attraverso un file, come avviene con myGPIOK.
+ *
+ * @details
+ * myGPIOK_read() attende che il registro letto torni a zero, per cui MODE e WRITE non vengono mai letti
+ * attraverso il modulo: i valori scritti sono quelli letti dal device mappato, se presente, altrimenti
+ * quelli di reset.
+ */
+static void bench_file(const char *backend, int fd, myGPIO_t mapped, const param_t *p) {
+	uint32_t n = p->iterations / 16, value = 0, mode = 0, write_value = 0;
+	ssize_t sink = 0;
+	// i valori scritti sono quelli già presenti nei registri, così da non modificare lo stato dei pin
+	if (mapped != NULL) {
+		mode = myGPIO_RegRead(mapped, MODE_REG);
+		write_value = myGPIO_RegRead(mapped, WRITE_REG);
+	}
+	MEASURE("mygpiok", backend, "MODE lseek+write", n, BLOCK_SYSCALL,
+			lseek(fd, MODE_OFFSET, SEEK_SET); sink += write(fd, &mode, sizeof(mode)));
+	MEASURE("mygpiok", backend, "MODE pwrite", n, BLOCK_SYSCALL, sink += pwrite(fd, &mode, sizeof(mode), MODE_OFFSET));
+	MEASURE("mygpiok", backend, "WRITE lseek+write", n, BLOCK_SYSCALL,
+			lseek(fd, WRITE_OFFSET, SEEK_SET); sink += write(fd, &write_value, sizeof(write_value)));
+	MEASURE("mygpiok", backend, "WRITE pwrite", n, BLOCK_SYSCALL,
+			sink += pwrite(fd, &write_value, sizeof(write_value), WRITE_OFFSET));
+	MEASURE("mygpiok", backend, "READ lseek+read", n, BLOCK_SYSCALL,
+			lseek(fd, READ_OFFSET, SEEK_SET); sink += read(fd, &value, sizeof(value)));
+	MEASURE("mygpiok", backend, "READ pread", n, BLOCK_SYSCALL, sink += pread(fd, &value, sizeof(value), READ_OFFSET));
+	(void)sink;
+}
+
+/**
+ * @brief Attesa di un'interruzione: un thread la genera con signal(), il chiamante la attende con wait()
+ * e la serve con rearm() prima di dichiararsi pronto per la successiva.
+ */
+typedef struct wait_path wait_path_t;
+struct wait_path {
+	void (*signal)(wait_path_t *w);  //!< genera l'evento
+	int  (*wait)(wait_path_t *w);    //!< attende l'evento, restituisce zero se si è manifestato
+	void (*rearm)(wait_path_t *w);   //!< serve l'evento e riarma l'attesa
+	int               fd[2];         //!< pipe, o descrittore del device in fd[0]
+	myGPIO_t          gpio;          //!< device mappato, se reale
+	uint32_t          out;           //!< maschera del pin di uscita del loopback
+	uint32_t          in;            //!< maschera del pin di ingresso del loopback
+	uint32_t          base;          //!< valore del registro WRITE a riposo, per myGPIOK
+	volatile uint32_t flag;          //!< evento sull'host per il polling
+	volatile uint32_t ready;         //!< il chiamante è in attesa del prossimo evento
+	volatile uint32_t stop;          //!< il thread deve terminare
+	volatile uint64_t t0;            //!< istante in cui è stato generato l'ultimo evento
+};
+
+static void *wait_signaller(void *arg) {
+	wait_path_t *w = arg;
+	struct timespec pause = { 0, 100000 };
+	while (!w->stop) {
+		if (!__atomic_load_n(&w->ready, __ATOMIC_ACQUIRE)) {
+			sched_yield();
+			continue;
+		}
+		__atomic_store_n(&w->ready, 0, __ATOMIC_RELAXED);
+		// il chiamante ha il tempo di addormentarsi prima che l'evento venga generato
+		nanosleep(&pause, NULL);
+		w->t0 = bench_now_ns();
+		w->signal(w);
+	}
+	return NULL;
+}
+
+static void bench_wait(const char *path, const char *backend, const char *op, wait_path_t *w, uint32_t events) {
+	double *sample = malloc((events != 0 ? events : 1) * sizeof(double));
+	pthread_t thread;
+	uint32_t i, samples = 0;
+	w->ready = w->stop = 0;
+	if (pthread_create(&thread, NULL, wait_signaller, w) != 0) {
+		perror("pthread_create");
+		free(sample);
+		return;
+	}
+	for (i = 0; i < events; i++) {
+		w->rearm(w);
+		__atomic_store_n(&w->ready, 1, __ATOMIC_RELEASE);
+		if (w->wait(w) != 0) {
+			printf("%s %s: evento non ricevuto\n", path, op);
+			break;
+		}
+		sample[samples++] = (double)(bench_now_ns() - w->t0);
+	}
+	w->stop = 1;
+	pthread_join(thread, NULL);
+	w->rearm(w);
+	bench_paths_record(path, backend, op, sample, samples, 1);
+	free(sample);
+}
+
+/* Attese sull'host: pipe e flag in memoria condivisa */
+
+static void host_signal(wait_path_t *w) {
+	uint32_t one = 1;
+	__atomic_store_n(&w->flag, 1, __ATOMIC_RELEASE);
+	if (write(w->fd[1], &one, sizeof(one)) != sizeof(one))
+		perror("write");
+}
+
+static void host_rearm(wait_path_t *w) {
+	struct pollfd pfd = { w->fd[0], POLLIN, 0 };
+	uint32_t value;
+	w->flag = 0;
+	while (poll(&pfd, 1, 0) == 1 && read(w->fd[0], &value, sizeof(value)) > 0);
+}
+
+static int host_wait_read(wait_path_t *w) {
+	uint32_t value;
+	return read(w->fd[0], &value, sizeof(value)) == sizeof(value) ? 0 : -1;
+}
+
+static int host_wait_poll(wait_path_t *w) {
+	struct pollfd pfd = { w->fd[0], POLLIN, 0 };
+	uint32_t value;
+	if (poll(&pfd, 1, 1000) != 1)
+		return -1;
+	return read(w->fd[0], &value, sizeof(value)) == sizeof(value) ? 0 : -1;
+}
+
+static int host_wait_spin(wait_path_t *w) {
+	while (!__atomic_load_n(&w->flag, __ATOMIC_ACQUIRE))
+		if (single_cpu)
+			sched_yield();
+	return 0;
+}
+
+/* Attese reali: impulso sul pin di uscita del loopback */
+
+static void hw_signal_mapped(wait_path_t *w) {
+	myGPIO_SetValue(w->gpio, w->out, MYGPIO_PIN_SET);
+	myGPIO_SetValue(w->gpio, w->out, MYGPIO_PIN_RESET);
+}
+
+static void uio_rearm(wait_path_t *w) {
+	uint32_t reenable = 1;
+	myGPIO_PinInterruptAck(w->gpio, w->in);
+	if (write(w->fd[0], &reenable, sizeof(reenable)) != sizeof(reenable))
+		perror("write");
+}
+
+static int uio_wait_read(wait_path_t *w) {
+	uint32_t count;
+	return read(w->fd[0], &count, sizeof(count)) == sizeof(count) ? 0 : -1;
+}
+
+static int uio_wait_poll(wait_path_t *w) {
+	struct pollfd pfd = { w->fd[0], POLLIN, 0 };
+	if (poll(&pfd, 1, 1000) != 1)
+		return -1;
+	return uio_wait_read(w);
+}
+
+static void polling_rearm(wait_path_t *w) {
+	myGPIO_PinInterruptAck(w->gpio, w->in);
+}
+
+static int polling_wait(wait_path_t *w) {
+	uint64_t deadline = bench_now_ns() + 1000000000ULL;
+	while ((myGPIO_PendingPinInterrupt(w->gpio) & w->in) == 0) {
+		if (bench_now_ns() > deadline)
+			return -1;
+		if (single_cpu)
+			sched_yield();
+	}
+	return 0;
+}
+
+static void mygpiok_signal(wait_path_t *w) {
+	uint32_t value = w->base | w->out;
+	if (pwrite(w->fd[1], &value, sizeof(value), WRITE_OFFSET) != sizeof(value))
+		perror("pwrite");
+	value = w->base;
+	if (pwrite(w->fd[1], &value, sizeof(value), WRITE_OFFSET) != sizeof(value))
+		perror("pwrite");
+}
+
+static void mygpiok_rearm(wait_path_t *w) {
+	(void)w;  // ack e riabilitazione sono effettuati dal driver, al termine della read()
+}
+
+static int mygpiok_wait_read(wait_path_t *w) {
+	uint32_t value;
+	return pread(w->fd[0], &value, sizeof(value), READ_OFFSET) == sizeof(value) ? 0 : -1;
+}
+
+static int mygpiok_wait_poll(wait_path_t *w) {
+	struct pollfd pfd = { w->fd[0], POLLIN, 0 };
+	if (poll(&pfd, 1, 1000) != 1)
+		return -1;
+	return mygpiok_wait_read(w);
+}
+
+/**
+ * @brief Configura il loopback su un device mappato: out in uscita a zero, in in ingresso con interrupt.
+ */
+static void loopback_setup(myGPIO_t gpio, uint32_t out, uint32_t in) {
+	myGPIO_SetValue(gpio, out, MYGPIO_PIN_RESET);
+	myGPIO_SetMode(gpio, out, MYGPIO_MODE_WRITE);
+	myGPIO_SetMode(gpio, in, MYGPIO_MODE_READ);
+	myGPIO_PinInterruptAck(gpio, in);
+	myGPIO_PinInterruptEnable(gpio, in);
+	myGPIO_GlobalInterruptEnable(gpio);
+}
+
+/**
+ * @brief Salva i risultati in formato JSON, un risultato per riga.
+ */
+static int save_json(const char *file) {
+	struct utsname host;
+	FILE *f = (strcmp(file, "-") == 0 ? stdout : fopen(file, "w"));
+	uint32_t i;
+	if (f == NULL) {
+		perror(file);
+		return -1;
+	}
+	if (uname(&host) != 0) {
+		strcpy(host.nodename, "unknown");
+		strcpy(host.machine, "unknown");
+	}
+	fprintf(f, "{\n\"program\": \"bench_paths\",\n\"host\": \"%s\",\n\"machine\": \"%s\",\n\"results\": [\n",
+			host.nodename, host.machine);
+	for (i = 0; i < result_count; i++) {
+		const result_t *r = &results[i];
+		fprintf(f, "{\"path\": \"%s\", \"backend\": \"%s\", \"op\": \"%s\", \"iterations\": %u, \"ns_per_op\": %.3f, "
+				"\"ops_per_s\": %.0f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}%s\n",
+				r->path, r->backend, r->op, r->iterations, r->ns_per_op, 1e9 / r->ns_per_op, r->p50, r->p90, r->p99,
+				r->max, (i + 1 < result_count ? "," : ""));
+	}
+	fprintf(f, "]\n}\n");
+	if (f != stdout)
+		fclose(f);
+	return 0;
+}
+
+/**
+ * @brief Confronta la mediana di ciascun risultato con quella dello stesso risultato in un file salvato
+ * con -j, e restituisce il numero di risultati peggiorati oltre threshold punti percentuali.
+ *
+ * @details
+ * I risultati del modello non dipendono dalla macchina e vengono sempre confrontati; gli altri solo se il
+ * file è stato salvato su una macchina con lo stesso nome e la stessa architettura.
+ */
+static int compare_baseline(const char *file, double threshold) {
+	char line[512], path[16], backend[8], op[40], name[65] = "", machine[65] = "";
+	double ns_per_op, p50, delta;
+	uint32_t i, iterations, found = 0, skipped = 0;
+	int regressions = 0, same_host;
+	struct utsname host;
+	FILE *f = fopen(file, "r");
+	if (f == NULL) {
+		perror(file);
+		return -1;
+	}
+	if (uname(&host) != 0) {
+		strcpy(host.nodename, "unknown");
+		strcpy(host.machine, "unknown");
+	}
+	printf("\nconfronto con %s (mediana):\n", file);
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (sscanf(line, "\"host\": \"%64[^\"]\"", name) == 1 || sscanf(line, "\"machine\": \"%64[^\"]\"", machine) == 1)
+			continue;
+		if (sscanf(line, "{\"path\": \"%15[^\"]\", \"backend\": \"%7[^\"]\", \"op\": \"%39[^\"]\", \"iterations\": %u, "
+				"\"ns_per_op\": %lf, \"ops_per_s\": %*f, \"p50\": %lf", path, backend, op, &iterations, &ns_per_op, &p50) != 6)
+			continue;
+		same_host = (strcmp(name, host.nodename) == 0 && strcmp(machine, host.machine) == 0);
+		if (strcmp(backend, "model") != 0 && !same_host) {
+			skipped++;
+			continue;
+		}
+		for (i = 0; i < result_count; i++) {
+			const result_t *r = &results[i];
+			if (strcmp(r->path, path) != 0 || strcmp(r->backend, backend) != 0 || strcmp(r->op, op) != 0)
+				continue;
+			delta = (p50 > 0 ? (r->p50 - p50) * 100.0 / p50 : 0.0);
+			found++;
+			printf("%-8s %-4s %-34s %10.2f -> %10.2f ns %+8.1f%%%s\n", path, backend, op, p50, r->p50, delta,
+					(threshold > 0 && delta > threshold ? "  PEGGIORATO" : ""));
+			if (threshold > 0 && delta > threshold)
+				regressions++;
+		}
+	}
+	fclose(f);
+	if (skipped != 0)
+		printf("%u risultati non confrontati, perché misurati su %s (%s)\n", skipped, name, machine);
+	printf("%u risultati confrontati, %d peggiorati oltre la soglia\n", found, regressions);
+	return regressions;
+}
+
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_paths [opzioni]\n");
+	printf("\t-a <address>: indirizzo fisico del device, per l'accesso attraverso /dev/mem\n");
+	printf("\t-u /dev/uioX: device UIO\n");
+	printf("\t-k /dev/myGPIOKx: device myGPIOK\n");
+	printf("\t-m <hex-mask>: maschera dei pin su cui agire (default 0, nessun pin)\n");
+	printf("\t-L <out>:<in>: pin di uscita collegato al pin di ingresso, per le attese delle interruzioni reali\n");
+	printf("\t-n <num>: operazioni per misura sui device mappati (default 262144)\n");
+	printf("\t-e <num>: interruzioni per misura (default 1000)\n");
+	printf("\t-r <ns>: costo di una lettura di registro sul modello (default 150)\n");
+	printf("\t-w <ns>: costo di una scrittura di registro sul modello (default 60)\n");
+	printf("\t-j <file>: salva i risultati in formato JSON (- per lo standard output)\n");
+	printf("\t-b <file>: confronta i risultati con quelli salvati in precedenza con -j\n");
+	printf("\t-t <percent>: con -b, termina con errore se una mediana peggiora oltre la soglia\n");
+	printf("Senza -a, -u e -k, i corrispondenti modi di accesso non vengono misurati: le operazioni vengono\n");
+	printf("sempre misurate sul modello, le attese sull'host.\n");
+}
+
+int main(int argc, char **argv) {
+	param_t p = { 0, NULL, NULL, 0, 0, 0, 0, 262144, 1000, 150, 60 };
+	const char *json = NULL, *baseline = NULL;
+	double threshold = 0;
+	bench_device_t dev;
+	wait_path_t w;
+	myGPIO_t gpio = NULL, uio_gpio = NULL;
+	void *uio_page = MAP_FAILED;
+	long page_size = sysconf(_SC_PAGESIZE);
+	int uio_fd = -1, kfd = -1, par, regressions = 0;
+	char *colon;
+
+	while ((par = getopt(argc, argv, "a:u:k:m:L:n:e:r:w:j:b:t:")) != -1) {
+		switch (par) {
+			case 'a' : p.address = strtoul(optarg, NULL, 0); break;
+			case 'u' : p.uio = optarg; break;
+			case 'k' : p.mygpiok = optarg; break;
+			case 'm' : p.mask = strtoul(optarg, NULL, 16); break;
+			case 'L' :
+				p.out = strtoul(optarg, &colon, 0);
+				if (*colon != ':' || p.out > 31 || (p.in = strtoul(colon + 1, NULL, 0)) > 31 || p.in == p.out) {
+					howto();
+					return -1;
+				}
+				p.loopback = 1;
+				break;
+			case 'n' : p.iterations = strtoul(optarg, NULL, 0); break;
+			case 'e' : p.events = strtoul(optarg, NULL, 0); break;
+			case 'r' : p.read_ns = strtoul(optarg, NULL, 0); break;
+			case 'w' : p.write_ns = strtoul(optarg, NULL, 0); break;
+			case 'j' : json = optarg; break;
+			case 'b' : baseline = optarg; break;
+			case 't' : threshold = strtod(optarg, NULL); break;
+			default : howto(); return -1;
+		}
+	}
+	if (p.iterations < BLOCK_MMAP * 16 || p.events == 0) {
+		howto();
+		return -1;
+	}
+	single_cpu = (sysconf(_SC_NPROCESSORS_ONLN) < 2);
+
+#ifndef MYGPIO_BACKEND
+	// mmio: le funzioni di myGPIO.h sul modello, col tempo modellato
+	bench_paths_model(p.iterations, BLOCK_MMAP, p.mask, p.read_ns, p.write_ns);
+#endif
+
+	// devmem: /dev/mem, come in noDriver.c
+	if (p.address != 0) {
+		if ((gpio = bench_device_open(&dev, p.address)) == NULL)
+			return -1;
+		bench_api("devmem", DEVICE_BACKEND, gpio, &p);
+	}
+
+	// uio: /dev/uioX, come in uio.c
+	if (p.uio != NULL) {
+		if ((uio_fd = open(p.uio, O_RDWR)) < 0 ||
+				(uio_page = mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_SHARED, uio_fd, 0)) == MAP_FAILED) {
+			perror(p.uio);
+			return -1;
+		}
+		uio_gpio = (myGPIO_t)uio_page;
+		bench_api("uio", DEVICE_BACKEND, uio_gpio, &p);
+	}
+
+	// mygpiok: le letture del registro READ non devono attendere un'interruzione
+	if (p.mygpiok != NULL) {
+		if ((kfd = open(p.mygpiok, O_RDWR | O_NONBLOCK)) < 0) {
+			perror(p.mygpiok);
+			return -1;
+		}
+		bench_file(DEVICE_BACKEND, kfd, (gpio != NULL ? gpio : uio_gpio), &p);
+	}
+
+	// attese delle interruzioni
+	memset(&w, 0, sizeof(w));
+	if (pipe(w.fd) != 0) {
+		perror("pipe");
+		return -1;
+	}
+	w.signal = host_signal;
+	w.rearm = host_rearm;
+	w.wait = host_wait_read;
+	bench_wait("wait", "host", "read", &w, p.events);
+	w.wait = host_wait_poll;
+	bench_wait("wait", "host", "poll+read", &w, p.events);
+	w.wait = host_wait_spin;
+	bench_wait("wait", "host", "polling", &w, p.events);
+	close(w.fd[0]);
+	close(w.fd[1]);
+
+	if (p.loopback) {
+		w.out = MYGPIO_PIN(p.out);
+		w.in = MYGPIO_PIN(p.in);
+		if (p.address != 0) {
+			loopback_setup(gpio, w.out, w.in);
+			w.gpio = gpio;
+			w.signal = hw_signal_mapped;
+			w.rearm = polling_rearm;
+			w.wait = polling_wait;
+			bench_wait("devmem", DEVICE_BACKEND, "wait polling IRQ", &w, p.events);
+			myGPIO_GlobalInterruptDisable(gpio);
+		}
+		if (p.uio != NULL) {
+			loopback_setup(uio_gpio, w.out, w.in);
+			w.gpio = uio_gpio;
+			w.fd[0] = uio_fd;
+			w.signal = hw_signal_mapped;
+			w.rearm = uio_rearm;
+			w.wait = uio_wait_read;
+			bench_wait("uio", DEVICE_BACKEND, "wait read", &w, p.events);
+			w.wait = uio_wait_poll;
+			bench_wait("uio", DEVICE_BACKEND, "wait poll+read", &w, p.events);
+		}
+		if (p.mygpiok != NULL) {
+			myGPIO_t mapped = (gpio != NULL ? gpio : uio_gpio);
+			uint32_t mode = 0;
+			// le attese usano un descrittore bloccante, le scritture sul pin di uscita quello non bloccante
+			if ((w.fd[0] = open(p.mygpiok, O_RDWR)) < 0) {
+				perror(p.mygpiok);
+				return -1;
+			}
+			w.fd[1] = kfd;
+			// MODE e WRITE non possono essere letti attraverso myGPIOK, si veda bench_file()
+			w.base = 0;
+			if (mapped != NULL) {
+				mode = myGPIO_RegRead(mapped, MODE_REG);
+				w.base = myGPIO_RegRead(mapped, WRITE_REG) & ~w.out;
+			}
+			mode = (mode | w.out) & ~w.in;
+			if (pwrite(kfd, &mode, sizeof(mode), MODE_OFFSET) != sizeof(mode))
+				perror("pwrite");
+			w.signal = mygpiok_signal;
+			w.rearm = mygpiok_rearm;
+			w.wait = mygpiok_wait_read;
+			bench_wait("mygpiok", DEVICE_BACKEND, "wait read", &w, p.events);
+			w.wait = mygpiok_wait_poll;
+			bench_wait("mygpiok", DEVICE_BACKEND, "wait poll+read", &w, p.events);
+			close(w.fd[0]);
+		}
+	}
+
+	if (uio_page != MAP_FAILED)
+		munmap(uio_page, page_size);
+	if (uio_fd >= 0)
+		close(uio_fd);
+	if (kfd >= 0)
+		close(kfd);
+	if (gpio != NULL)
+		bench_device_close(&dev);
+
+	if (json != NULL && save_json(json) != 0)
+		return -1;
+	if (baseline != NULL && (regressions = compare_baseline(baseline, threshold)) != 0)
+		return -1;
+	return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file bench_paths.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_BENCH_PATHS_HEADER_H
+#define MYGPIO_BENCH_PATHS_HEADER_H
+
+#include <inttypes.h>
+
+/**
+ * @brief Operazioni di myGPIO.h misurate da bench_paths, comuni ai device mappati ed al modello.
+ *
+ * @details
+ * OP(op, stmt) viene espansa per ciascuna operazione, col nome op e l'istruzione stmt, che agisce sul device
+ * gpio e sui pin mask, ed accumula in sink i valori letti.
+ */
+#define BENCH_PATHS_API(OP)                                                                              \
+	OP("myGPIO_SetMode", myGPIO_SetMode(gpio, mask, MYGPIO_MODE_WRITE))                                  \
+	OP("myGPIO_SetValue", myGPIO_SetValue(gpio, mask, MYGPIO_PIN_SET))                                   \
+	OP("myGPIO_Toggle", myGPIO_Toggle(gpio, mask))                                                       \
+	OP("myGPIO_GetValue", sink += myGPIO_GetValue(gpio, mask))                                           \
+	OP("myGPIO_GetRead", sink += myGPIO_GetRead(gpio))                                                   \
+	OP("myGPIO_IsGlobalInterruptEnabled", sink += myGPIO_IsGlobalInterruptEnabled(gpio))                 \
+	OP("myGPIO_PendingInterrupt", sink += myGPIO_PendingInterrupt(gpio))                                 \
+	OP("myGPIO_PinInterruptEnable", myGPIO_PinInterruptEnable(gpio, mask))                               \
+	OP("myGPIO_PinInterruptDisable", myGPIO_PinInterruptDisable(gpio, mask))                             \
+	OP("myGPIO_EnabledPinInterrupt", sink += myGPIO_EnabledPinInterrupt(gpio))                           \
+	OP("myGPIO_PendingPinInterrupt", sink += myGPIO_PendingPinInterrupt(gpio))                           \
+	OP("myGPIO_PinInterruptAck", myGPIO_PinInterruptAck(gpio, mask))
+
+void bench_paths_record(const char *path, const char *backend, const char *op, double *sample, uint32_t samples, uint32_t per_sample);
+void bench_paths_model (uint32_t iterations, uint32_t block, uint32_t mask, uint32_t read_ns, uint32_t write_ns);
+
+#endif
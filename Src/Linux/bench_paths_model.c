@@ -0,0 +1,64 @@
+/**
+ * @file bench_paths_model.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @details
+ * Misure di bench_paths sul modello del device: questo file viene compilato con MYGPIO_INLINE e
+ * MYGPIO_BACKEND definiti, per cui le funzioni di myGPIO.h, qui static inline, servono gli accessi col
+ * modello di myGPIO_model.h, mentre il resto del programma usa myGPIO.o per i device reali.
+ */
+#include <stdlib.h>
+
+#include "myGPIO.h"
+#include "myGPIO_model.h"
+#include "bench_paths.h"
+
+/**
+ * @brief Misura le operazioni di myGPIO.h sul modello, a blocchi di block operazioni, col tempo modellato.
+ *
+ * @details
+ * Il tempo di ciascun blocco è la somma dei costi degli accessi effettuati, read_ns per ogni lettura e
+ * write_ns per ogni scrittura, per cui i risultati non dipendono dalla macchina su cui il programma viene
+ * eseguito. Gli accessi di devmem ed uio hanno lo stesso costo sul bus, per cui vengono riportati una sola
+ * volta, come modo di accesso "mmio".
+ */
+void bench_paths_model(uint32_t iterations, uint32_t block, uint32_t mask, uint32_t read_ns, uint32_t write_ns) {
+	uint32_t samples = iterations / block, s, i;
+	double *sample = malloc((samples != 0 ? samples : 1) * sizeof(double));
+	volatile uint32_t sink = 0;
+	myGPIO_Model_t model;
+	myGPIO_t gpio;
+	uint64_t start;
+
+	myGPIO_Model_Init(&model, 32);
+	myGPIO_Model_SetLatency(&model, read_ns, write_ns, 0);
+	gpio = myGPIO_Model_Gpio(&model);
+#define MODELLED(op, stmt)                                                         \
+	for (s = 0; s < samples; s++) {                                                \
+		start = model.time_ns;                                                     \
+		for (i = 0; i < block; i++) { stmt; }                                      \
+		sample[s] = (double)(model.time_ns - start) / block;                       \
+	}                                                                              \
+	bench_paths_record("mmio", "model", (op), sample, samples, block);
+	BENCH_PATHS_API(MODELLED)
+#undef MODELLED
+	(void)sink;
+	free(sample);
+}
@@ -0,0 +1,195 @@
+/**
+ * @file bench_playback.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_playback.c
+ * Il file bench_playback.c contiene un programma che misura il motore di playback definito in
+ * myGPIO_playback.h. Viene dapprima misurato il tempo necessario a generare una forma d'onda con chiamate
+ * a myGPIO_SetValue(), poi viene riprodotta, con il periodo richiesto, una sequenza di parole crescenti,
+ * nella modalità selezionata. Vengono riportati la frequenza di aggiornamento ottenuta, il ritardo minimo,
+ * medio e massimo rispetto alle scadenze, il jitter (differenza tra ritardo massimo e minimo), il numero di
+ * underrun ed il numero di accessi ai registri per aggiornamento. Come contatore viene usato il clock
+ * monotono di sistema, per cui i periodi sono espressi in nanosecondi.
+ * Se viene specificato l'indirizzo fisico di un device, il benchmark opera su di esso attraverso /dev/mem,
+ * altrimenti su un banco di registri allocato in RAM.
+ *
+ * @warning Il benchmark modifica il valore del registro WRITE del device.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_playback.h"
+#include "bench.h"
+
+/**
+ * @brief Contatore libero a 32 bit usato dal motore di playback: il clock monotono, in nanosecondi.
+ */
+static uint32_t timestamp_ns(void) {
+	return (uint32_t)bench_now_ns();
+}
+
+/**
+ * @brief Riempie un buffer con parole crescenti, a partire da first.
+ */
+static void fill(uint32_t *buffer, uint32_t length, uint32_t first) {
+	uint32_t i;
+	for (i = 0; i < length; i++)
+		buffer[i] = first + i;
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_playback [-a gpio_phisycal_address] [-n aggiornamenti] [-p periodo] [-m modalità] [-l lunghezza]\n");
+	printf("\t-a <address>: indirizzo fisico del device; se omesso, il device viene simulato in RAM\n");
+	printf("\t-n <num>: numero di aggiornamenti (default 100000)\n");
+	printf("\t-p <ns>: periodo di aggiornamento, in nanosecondi; 0 per la massima frequenza (default 1000)\n");
+	printf("\t-m <oneshot|loop|double>: modalità di riproduzione (default double)\n");
+	printf("\t-l <num>: lunghezza dei buffer nelle modalità loop e double (default 256)\n");
+}
+
+/**
+ * @brief Effettua il parsing dei parametri passati al programma
+ *
+ * @retval 0 se il parsing ha successo
+ * @retval -1 se si verifica un errore
+ */
+int parse_args(int argc, char **argv, uint32_t *gpio_address, uint32_t *updates, uint32_t *period, uint32_t *mode, uint32_t *length) {
+	int par;
+	while((par = getopt(argc, argv, "a:n:p:m:l:")) != -1) {
+		switch (par) {
+		case 'a' :
+			*gpio_address = strtoul(optarg, NULL, 0);
+			break;
+		case 'n' :
+			*updates = strtoul(optarg, NULL, 0);
+			break;
+		case 'p' :
+			*period = strtoul(optarg, NULL, 0);
+			break;
+		case 'm' :
+			if (strcmp(optarg, "oneshot") == 0)
+				*mode = MYGPIO_PLAYBACK_ONESHOT;
+			else if (strcmp(optarg, "loop") == 0)
+				*mode = MYGPIO_PLAYBACK_LOOP;
+			else if (strcmp(optarg, "double") == 0)
+				*mode = MYGPIO_PLAYBACK_DOUBLE;
+			else {
+				printf("%s: modalità sconosciuta.\n", optarg);
+				howto();
+				return -1;
+			}
+			break;
+		case 'l' :
+			*length = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (*updates == 0 || *length == 0 || *period >= 0x80000000U) {
+		howto();
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	uint32_t gpio_address = 0, updates = 100000, period = 1000, mode = MYGPIO_PLAYBACK_DOUBLE, length = 256;
+	uint32_t *buffer, generated, write_value, ok;
+	unsigned long writes;
+	uint64_t start, elapsed;
+	bench_device_t dev;
+	myGPIO_t gpio;
+	myGPIO_Playback_t pb;
+	static const char *mode_name[] = {"oneshot", "loop", "double"};
+
+	if (parse_args(argc, argv, &gpio_address, &updates, &period, &mode, &length) == -1)
+		return -1;
+	if ((gpio = bench_device_open(&dev, gpio_address)) == NULL)
+		return -1;
+	if (mode == MYGPIO_PLAYBACK_ONESHOT)
+		length = updates;
+	if ((buffer = malloc(2 * length * sizeof(uint32_t))) == NULL) {
+		perror(argv[0]);
+		bench_device_close(&dev);
+		return -1;
+	}
+	write_value = myGPIO_RegRead(gpio, WRITE_REG);
+
+	BENCH_RUN("myGPIO_SetValue (forma d'onda)", updates, myGPIO_SetValue(gpio, MYGPIO_PIN(0), __i & 1));
+
+	myGPIO_Playback_Init(&pb, gpio, timestamp_ns, period, mode);
+	printf("calibrazione: polling %u ns, ciclo di ritardo %.2f iterazioni/ns\n", pb.spin, pb.loops_q8 / 256.0);
+	generated = (mode == MYGPIO_PLAYBACK_DOUBLE ? 2 * length : length);
+	fill(buffer, generated, 0);
+	myGPIO_Playback_Submit(&pb, buffer, length);
+	if (mode == MYGPIO_PLAYBACK_DOUBLE)
+		myGPIO_Playback_Submit(&pb, buffer + length, length);
+
+	writes = myGPIO_BusWrites;
+	start = bench_now_ns();
+	myGPIO_Playback_Start(&pb);
+	if (mode == MYGPIO_PLAYBACK_DOUBLE) {
+		uint32_t refill = 0;
+		while (pb.stats.ticks < updates) {
+			if (myGPIO_Playback_Step(&pb) == MYGPIO_PLAYBACK_REFILL && generated < updates) {
+				uint32_t *free_buffer = buffer + (refill++ & 1) * length;
+				fill(free_buffer, length, generated);
+				generated += length;
+				myGPIO_Playback_Submit(&pb, free_buffer, length);
+			}
+		}
+	}
+	else
+		myGPIO_Playback_Run(&pb, updates);
+	elapsed = bench_now_ns() - start;
+	writes = myGPIO_BusWrites - writes;
+
+	printf("modalità %s, periodo %u ns, %u aggiornamenti in %" PRIu64 " ns\n", mode_name[mode], period, pb.stats.ticks, elapsed);
+	printf("frequenza di aggiornamento: %.3f MHz", pb.stats.ticks * 1000.0 / elapsed);
+	if (period != 0)
+		printf(" (richiesta: %.3f MHz)\n", 1000.0 / period);
+	else
+		printf(" (richiesta: massima)\n");
+	printf("ritardo rispetto alla scadenza: min %d ns, medio %.1f ns, max %d ns, jitter %d ns\n",
+			pb.stats.late_min, (double)pb.stats.late_sum / pb.stats.ticks, pb.stats.late_max,
+			pb.stats.late_max - pb.stats.late_min);
+	printf("underrun: %u, scritture per aggiornamento: %.2f\n", pb.stats.underrun, (double)writes / pb.stats.ticks);
+
+	ok = (pb.stats.ticks == updates && writes == updates);
+	if (gpio_address == 0)
+		ok = ok && (myGPIO_RegRead(gpio, WRITE_REG) == (mode == MYGPIO_PLAYBACK_LOOP ? (updates - 1) % length : updates - 1));
+	printf("verifica: %s\n", (ok ? "ok" : "FALLITA"));
+
+	myGPIO_RegWrite(gpio, WRITE_REG, write_value);
+	free(buffer);
+	bench_device_close(&dev);
+	return (ok ? 0 : -1);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file bench_pwm.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_pwm.c
+ * Il file bench_pwm.c contiene un programma che misura il costo, per periodo, del generatore PWM/BAM
+ * definito in myGPIO_pwm.h al variare del numero di canali, confrontandolo con la generazione della stessa
+ * forma d'onda PWM attraverso una chiamata a myGPIO_SetValue() per canale e per slot. Viene misurato anche
+ * il costo di myGPIO_Pwm_Commit(), ossia della ricostruzione della tabella. Per ciascuna configurazione
+ * viene verificato che, in un periodo, ciascun canale resti acceso per un numero di unità di tempo pari al
+ * proprio duty-cycle. Il device è simulato in RAM.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_pwm.h"
+#include "bench.h"
+
+/**
+ * @brief Un periodo PWM generato con una chiamata a myGPIO_SetValue() per canale e per slot.
+ */
+static void setvalue_period(myGPIO_t gpio, const uint8_t *duty, uint32_t channels, uint32_t slots) {
+	uint32_t t, channel;
+	for (t = 0; t < slots; t++)
+		for (channel = 0; channel < channels; channel++)
+			myGPIO_SetValue(gpio, MYGPIO_PIN(channel), (duty[channel] > t ? MYGPIO_PIN_SET : MYGPIO_PIN_RESET));
+}
+
+/**
+ * @brief Un periodo generato da myGPIO_Pwm_Tick().
+ */
+static void pwm_period(myGPIO_Pwm_t *pwm) {
+	uint32_t t;
+	for (t = 0; t < pwm->slots; t++)
+		myGPIO_Pwm_Tick(pwm);
+}
+
+/**
+ * @brief Verifica che, in un periodo, ciascun canale resti acceso per duty unità di tempo.
+ *
+ * @return numero di canali errati
+ */
+static uint32_t verify(myGPIO_t gpio, myGPIO_Pwm_t *pwm, const uint8_t *duty, uint32_t channels) {
+	uint32_t on[32] = {0}, t, channel, errors = 0;
+	pwm_period(pwm);  // il periodo in cui avviene lo scambio delle tabelle
+	for (t = 0; t < pwm->slots; t++) {
+		uint32_t length = myGPIO_Pwm_Tick(pwm), value = myGPIO_RegRead(gpio, WRITE_REG);
+		for (channel = 0; channel < channels; channel++)
+			if (value & MYGPIO_PIN(channel))
+				on[channel] += length;
+	}
+	for (channel = 0; channel < channels; channel++)
+		errors += (on[channel] != duty[channel]);
+	return errors;
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_pwm [-n periodi] [-b bit]\n");
+	printf("\t-n <num>: numero di periodi per ciascuna misura (default 10000)\n");
+	printf("\t-b <num>: risoluzione, in bit (default 8, max %u)\n", MYGPIO_PWM_MAX_BITS);
+}
+
+int main(int argc, char **argv) {
+	static const uint32_t channel_count[] = {1, 2, 4, 8, 16, 32};
+	uint32_t periods = 10000, bits = 8, seed = 0x9E3779B9U, n, channel, errors = 0;
+	uint8_t duty[32];
+	bench_device_t dev;
+	myGPIO_t gpio;
+	myGPIO_Pwm_t pwm, bam;
+	char name[64];
+	int par;
+
+	while((par = getopt(argc, argv, "n:b:")) != -1) {
+		switch (par) {
+		case 'n' :
+			periods = strtoul(optarg, NULL, 0);
+			break;
+		case 'b' :
+			bits = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (periods == 0 || bits == 0 || bits > MYGPIO_PWM_MAX_BITS) {
+		howto();
+		return -1;
+	}
+	if ((gpio = bench_device_open(&dev, 0)) == NULL)
+		return -1;
+	for (channel = 0; channel < 32; channel++) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		duty[channel] = (uint8_t)(seed & ((1U << bits) - 1));
+	}
+
+	printf("risoluzione %u bit: %u slot per periodo PWM, %u slot per periodo BAM; tempi per periodo\n", bits, (1U << bits) - 1, bits);
+	for (n = 0; n < sizeof(channel_count) / sizeof(channel_count[0]); n++) {
+		uint32_t channels = channel_count[n];
+		uint32_t mask = (channels == 32 ? 0xFFFFFFFFU : MYGPIO_PIN(channels) - 1);
+
+		myGPIO_Pwm_Init(&pwm, gpio, mask, MYGPIO_PWM_MODE_PWM, bits);
+		myGPIO_Pwm_Init(&bam, gpio, mask, MYGPIO_PWM_MODE_BAM, bits);
+		for (channel = 0; channel < channels; channel++) {
+			myGPIO_Pwm_SetDuty(&pwm, channel, duty[channel]);
+			myGPIO_Pwm_SetDuty(&bam, channel, duty[channel]);
+		}
+		myGPIO_Pwm_Commit(&pwm);
+		myGPIO_Pwm_Commit(&bam);
+		errors += verify(gpio, &pwm, duty, channels);
+		errors += verify(gpio, &bam, duty, channels);
+
+		snprintf(name, sizeof(name), "myGPIO_SetValue, %u canali", channels);
+		BENCH_RUN(name, periods, setvalue_period(gpio, duty, channels, pwm.slots));
+		snprintf(name, sizeof(name), "myGPIO_Pwm_Tick PWM, %u canali", channels);
+		BENCH_RUN(name, periods, pwm_period(&pwm));
+		snprintf(name, sizeof(name), "myGPIO_Pwm_Tick BAM, %u canali", channels);
+		BENCH_RUN(name, periods, pwm_period(&bam));
+		// pending viene azzerato direttamente, simulando lo scambio effettuato da myGPIO_Pwm_Tick()
+		snprintf(name, sizeof(name), "myGPIO_Pwm_Commit PWM, %u canali", channels);
+		BENCH_RUN(name, periods, { myGPIO_Pwm_Commit(&pwm); pwm.pending = 0; });
+		snprintf(name, sizeof(name), "myGPIO_Pwm_Commit BAM, %u canali", channels);
+		BENCH_RUN(name, periods, { myGPIO_Pwm_Commit(&bam); bam.pending = 0; });
+	}
+	bench_device_close(&dev);
+
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	return (errors == 0 ? 0 : -1);
+}
@@ -0,0 +1,178 @@
+/**
+ * @file bench_quad.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_quad.c
+ * Il file bench_quad.c contiene un programma che misura il numero di campioni al secondo elaborati dal
+ * decoder in quadratura definito in myGPIO_quad.h, confrontandolo con un decoder che, per ciascuna coppia,
+ * consulta una tabella di 16 elementi indicizzata da stato precedente e stato corrente. I campioni vengono
+ * generati sinteticamente: 16 encoder si muovono con velocità variabili, in avanti ed all'indietro, ed
+ * occasionalmente saltano uno stato, producendo una transizione illegale. Viene verificato che posizioni e
+ * numero di errori calcolati da entrambi i decoder coincidano con quelli del generatore.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_quad.h"
+#include "bench.h"
+
+#define PAIRS MYGPIO_QUAD_MAX_PAIRS
+
+static const uint32_t gray[4] = {0x0, 0x1, 0x3, 0x2};  //!< stati (B << 1 | A) nel verso di avanzamento
+
+/**
+ * @brief Decoder di riferimento, a tabella: l'indice è (stato precedente << 2) | stato corrente; il valore
+ * 2 denota una transizione illegale.
+ */
+static const int8_t transition[16] = {
+	 0, +1, -1,  2,
+	-1,  0,  2, +1,
+	+1,  2,  0, -1,
+	 2, -1, +1,  0
+};
+
+typedef struct {
+	uint32_t previous;
+	int32_t  count[PAIRS];
+	uint32_t error[PAIRS];
+} reference_t;
+
+static void reference_update(reference_t *r, uint32_t sample) {
+	uint32_t pair;
+	for (pair = 0; pair < PAIRS; pair++) {
+		int8_t delta = transition[(((r->previous >> (2 * pair)) & 3) << 2) | ((sample >> (2 * pair)) & 3)];
+		if (delta == 2)
+			r->error[pair]++;
+		else
+			r->count[pair] += delta;
+	}
+	r->previous = sample;
+}
+
+/**
+ * @brief Generatore pseudo-casuale xorshift32
+ */
+static uint32_t xorshift32(uint32_t *x) {
+	*x ^= *x << 13;
+	*x ^= *x >> 17;
+	*x ^= *x << 5;
+	return *x;
+}
+
+/**
+ * @brief Genera la traccia di 16 encoder, restituendo le posizioni che un decoder deve calcolare ed il
+ * numero di transizioni illegali; una transizione illegale non modifica la posizione decodificata.
+ */
+static void generate(uint32_t *trace, uint32_t length, int32_t *decoded, uint32_t *errors) {
+	uint32_t seed = 0xC0FFEE11U, pair, i;
+	uint32_t period[PAIRS], phase[PAIRS];
+	int32_t direction[PAIRS], position[PAIRS];
+	for (pair = 0; pair < PAIRS; pair++) {
+		period[pair] = 1 + xorshift32(&seed) % 8;
+		phase[pair] = 0;
+		direction[pair] = (xorshift32(&seed) & 1 ? 1 : -1);
+		position[pair] = 0;
+		decoded[pair] = 0;
+		errors[pair] = 0;
+	}
+	for (i = 0; i < length; i++) {
+		uint32_t sample = 0;
+		for (pair = 0; pair < PAIRS; pair++) {
+			uint32_t r = xorshift32(&seed);
+			if (r % 1000 == 0) {
+				period[pair] = 1 + (r >> 10) % 8;
+				direction[pair] = -direction[pair];
+			}
+			if (++phase[pair] >= period[pair]) {
+				phase[pair] = 0;
+				if ((r >> 16) % 5000 == 0) {
+					position[pair] += 2 * direction[pair];  // salto di uno stato: transizione illegale
+					errors[pair]++;
+				}
+				else {
+					position[pair] += direction[pair];
+					decoded[pair] += direction[pair];
+				}
+			}
+			sample |= gray[position[pair] & 3] << (2 * pair);
+		}
+		trace[i] = sample;
+	}
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_quad [-n campioni]\n");
+	printf("\t-n <num>: lunghezza della traccia (default 1000000)\n");
+}
+
+int main(int argc, char **argv) {
+	uint32_t length = 1000000, pair, mismatch = 0, error_total = 0;
+	uint32_t *trace, errors[PAIRS];
+	int32_t decoded[PAIRS];
+	myGPIO_Quad_t quad;
+	reference_t reference;
+	int par;
+
+	while((par = getopt(argc, argv, "n:")) != -1) {
+		switch (par) {
+		case 'n' :
+			length = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (length == 0) {
+		howto();
+		return -1;
+	}
+	if ((trace = malloc(length * sizeof(uint32_t))) == NULL) {
+		perror(argv[0]);
+		return -1;
+	}
+	generate(trace, length, decoded, errors);
+
+	myGPIO_Quad_Init(&quad, PAIRS, 0);
+	memset(&reference, 0, sizeof(reference));
+	printf("traccia: %u campioni, %u coppie A/B\n", length, PAIRS);
+	BENCH_RUN("myGPIO_Quad_Update", length, myGPIO_Quad_Update(&quad, trace[__i]));
+	BENCH_RUN("tabella per coppia (riferimento)", length, reference_update(&reference, trace[__i]));
+	myGPIO_Quad_Flush(&quad);
+
+	for (pair = 0; pair < PAIRS; pair++) {
+		mismatch += (quad.error[pair] != errors[pair] || reference.error[pair] != errors[pair]);
+		mismatch += (quad.count[pair] != decoded[pair] || reference.count[pair] != decoded[pair]);
+		error_total += errors[pair];
+	}
+	printf("transizioni illegali generate: %u\n", error_total);
+	printf("verifica: %s\n", (mismatch == 0 ? "ok" : "FALLITA"));
+	free(trace);
+	return (mismatch == 0 ? 0 : -1);
+}
@@ -0,0 +1,244 @@
+/**
+ * @file bench_queue.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_queue.c
+ * Il file bench_queue.c contiene un programma che misura il throughput della coda ISR-main-loop definita
+ * in myGPIO_queue.h. Le interruzioni di un device, il cui banco di registri è allocato in RAM, vengono
+ * simulate aggiornando i registri IRQ e READ e chiamando myGPIO_Queue_Isr(); il main-loop preleva gli
+ * eventi a blocchi.
+ * Di default ISR e main-loop si alternano nello stesso thread, come su un sistema bare-metal single-core:
+ * la ISR viene eseguita "burst" volte consecutive, dopodiché il main-loop svuota la coda. Con l'opzione -t
+ * produttore e consumatore vengono invece eseguiti in due thread distinti, il che verifica la correttezza
+ * della coda in presenza di accessi concorrenti da core diversi.
+ * Al termine vengono riportati il tempo medio per ISR e per evento prelevato, il numero di eventi
+ * consegnati e persi, e viene verificato che gli eventi consegnati siano integri ed in ordine.
+ * Prima della misura viene verificato che un impulso giunto dopo il ritorno della ISR, senza altre
+ * scritture sul device, generi un nuovo evento, con la regola con cui il VHDL aggiorna IRQ mentre IACK non
+ * è nullo.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_queue.h"
+#include "bench.h"
+
+/**
+ * @brief Parametri condivisi tra produttore e consumatore
+ */
+typedef struct {
+	myGPIO_QueueSource_t source;      //!< device simulato e coda
+	uint32_t             events;      //!< numero di interruzioni da simulare
+	uint64_t             elapsed_ns;  //!< tempo impiegato dal produttore
+	volatile uint32_t    done;        //!< impostato ad 1 dal produttore al termine
+} bench_queue_t;
+
+static uint32_t sequence = 0;  //!< contatore usato come sorgente di timestamp
+
+/**
+ * @brief Sorgente di timestamp: un contatore incrementato ad ogni interruzione, che consente al consumatore
+ * di verificare l'ordine degli eventi.
+ */
+static uint32_t sequence_timestamp(void) {
+	return sequence;
+}
+
+/**
+ * @brief Simula una interruzione del device.
+ */
+static inline void fire(myGPIO_QueueSource_t *source) {
+	source->gpio[IRQ_REG] = MYGPIO_PIN(sequence & 31);
+	source->gpio[READ_REG] = sequence;
+	myGPIO_Queue_Isr(source);
+}
+
+/**
+ * @brief Verifica gli eventi prelevati: timestamp crescenti, contenuto coerente con l'interruzione che li
+ * ha generati.
+ */
+static uint32_t check(const myGPIO_Event_t *event, uint32_t n, uint32_t *last, myGPIO_t gpio) {
+	uint32_t i, errors = 0;
+	for (i = 0; i < n; i++) {
+		if (event[i].timestamp <= *last || event[i].read != event[i].timestamp ||
+				event[i].pending != MYGPIO_PIN(event[i].timestamp & 31) || event[i].gpio != gpio)
+			errors++;
+		*last = event[i].timestamp;
+	}
+	return errors;
+}
+
+/**
+ * @brief Verifica che un impulso giunto dopo il ritorno della ISR, senza altre scritture sul device, generi
+ * un nuovo evento.
+ *
+ * @details
+ * Il banco di registri in RAM conserva in IACK l'ultimo valore scritto, come fa il VHDL fino alla
+ * successiva scrittura su un qualsiasi registro; l'impulso viene applicato ad IRQ con la regola del VHDL:
+ * finché IACK non è nullo i suoi bit vengono azzerati in IRQ e nessuna interruzione viene registrata.
+ *
+ * @return 0 se l'impulso genera un nuovo evento, 1 altrimenti
+ */
+static uint32_t check_late_pulse(myGPIO_QueueSource_t *source) {
+	myGPIO_Event_t event[2];
+	uint32_t n;
+	source->gpio[IRQ_REG] = MYGPIO_PIN0;
+	myGPIO_Queue_Isr(source);
+	// il device ha azzerato il bit notificato; segue un impulso sul pin 1
+	source->gpio[IRQ_REG] = 0;
+	if (source->gpio[IACK_REG] != 0)
+		source->gpio[IRQ_REG] &= ~source->gpio[IACK_REG];
+	else
+		source->gpio[IRQ_REG] |= MYGPIO_PIN1;
+	if (source->gpio[IRQ_REG] != 0)
+		myGPIO_Queue_Isr(source);
+	n = myGPIO_Queue_Drain(source->queue, event, 2);
+	memset((void*)source->gpio, 0, 8 * sizeof(uint32_t));
+	printf("impulso successivo alla ISR: %s\n", (n == 2 && event[1].pending == MYGPIO_PIN1 ? "consegnato" : "perso"));
+	return (n == 2 && event[1].pending == MYGPIO_PIN1 ? 0 : 1);
+}
+
+/**
+ * @brief Produttore, in esecuzione su un thread dedicato con l'opzione -t.
+ */
+static void* producer(void *arg) {
+	bench_queue_t *b = (bench_queue_t*) arg;
+	uint64_t start = bench_now_ns();
+	for (sequence = 1; sequence <= b->events; sequence++)
+		fire(&b->source);
+	b->elapsed_ns = bench_now_ns() - start;
+	__atomic_store_n(&b->done, 1, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_queue [-n eventi] [-b blocco] [-r burst] [-t]\n");
+	printf("\t-n <num>: numero di interruzioni simulate (default 10000000)\n");
+	printf("\t-b <num>: numero massimo di eventi prelevati per volta dal main-loop (default 16)\n");
+	printf("\t-r <num>: interruzioni consecutive tra due esecuzioni del main-loop (default 32)\n");
+	printf("\t-t: produttore e consumatore su thread distinti\n");
+}
+
+int main(int argc, char **argv) {
+	uint32_t regs[8];
+	myGPIO_Queue_t queue;
+	bench_queue_t b;
+	myGPIO_Event_t *event;
+	uint32_t block = 16, burst = 32, threaded = 0;
+	uint32_t delivered = 0, drains = 0, errors = 0, last = 0, n;
+	uint64_t drain_ns = 0, start;
+	pthread_t thread;
+	int par;
+
+	memset(regs, 0, sizeof(regs));
+	b.events = 10000000;
+	while((par = getopt(argc, argv, "n:b:r:t")) != -1) {
+		switch (par) {
+		case 'n' :
+			b.events = strtoul(optarg, NULL, 0);
+			break;
+		case 'b' :
+			block = strtoul(optarg, NULL, 0);
+			break;
+		case 'r' :
+			burst = strtoul(optarg, NULL, 0);
+			break;
+		case 't' :
+			threaded = 1;
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (b.events == 0 || block == 0 || burst == 0) {
+		howto();
+		return -1;
+	}
+	if ((event = malloc(block * sizeof(myGPIO_Event_t))) == NULL) {
+		perror(argv[0]);
+		return -1;
+	}
+
+	myGPIO_Queue_Init(&queue, sequence_timestamp);
+	b.source.gpio = regs;
+	b.source.queue = &queue;
+	b.done = 0;
+	b.elapsed_ns = 0;
+	errors += check_late_pulse(&b.source);
+
+	if (threaded) {
+		if (pthread_create(&thread, NULL, producer, &b) != 0) {
+			perror(argv[0]);
+			return -1;
+		}
+		start = bench_now_ns();
+		for (;;) {
+			uint32_t done = __atomic_load_n(&b.done, __ATOMIC_ACQUIRE);
+			n = myGPIO_Queue_Drain(&queue, event, block);
+			errors += check(event, n, &last, regs);
+			delivered += n;
+			drains += (n != 0);
+			if (n == 0 && done)
+				break;
+		}
+		drain_ns = bench_now_ns() - start;
+		pthread_join(thread, NULL);
+	}
+	else {
+		sequence = 1;
+		while (sequence <= b.events) {
+			start = bench_now_ns();
+			for (n = 0; n < burst && sequence <= b.events; n++, sequence++)
+				fire(&b.source);
+			b.elapsed_ns += bench_now_ns() - start;
+			start = bench_now_ns();
+			while ((n = myGPIO_Queue_Drain(&queue, event, block)) != 0) {
+				errors += check(event, n, &last, regs);
+				delivered += n;
+				drains++;
+			}
+			drain_ns += bench_now_ns() - start;
+		}
+	}
+
+	printf("dimensione coda: %u, blocco: %u, %s\n", MYGPIO_QUEUE_SIZE, block, (threaded ? "due thread" : "ISR e main-loop alternati"));
+	if (!threaded)
+		printf("interruzioni per esecuzione del main-loop: %u\n", burst);
+	printf("interruzioni simulate: %u, %.2f ns/ISR\n", b.events, (double)b.elapsed_ns / b.events);
+	printf("eventi consegnati: %u, %.2f ns/evento prelevato, %.2f eventi per prelievo\n",
+			delivered, (delivered != 0 ? (double)drain_ns / delivered : 0.0), (drains != 0 ? (double)delivered / drains : 0.0));
+	printf("eventi persi: %u, maschera: %08x\n", queue.overflow, queue.overflow_pins);
+	if (delivered + queue.overflow != b.events)
+		errors++;
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	free(event);
+	return (errors == 0 ? 0 : -1);
+}
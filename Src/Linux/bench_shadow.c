@@ -0,0 +1,121 @@
+/**
+ * @file bench_shadow.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_shadow.c
+ * Il file bench_shadow.c contiene un programma che confronta il costo delle funzioni di aggiornamento dei
+ * registri del driver myGPIO, che effettuano una sequenza read-modify-write, con quello delle equivalenti
+ * funzioni dell'handle myGPIO_Shadow_t, che effettuano una sola scrittura.
+ * Per ciascuna operazione vengono riportati il tempo medio ed il numero di letture e scritture sui registri.
+ * Se viene specificato l'indirizzo fisico di un device, il benchmark opera su di esso attraverso /dev/mem,
+ * altrimenti su un banco di registri allocato in RAM.
+ *
+ * @warning Il benchmark modifica il valore dei pin selezionati dalla maschera; i registri MODE, WRITE e PIE
+ * vengono ripristinati al termine.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_shadow.h"
+#include "bench.h"
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_shadow [-a gpio_phisycal_address] [-n iterazioni] [-m <hex-mask>]\n");
+	printf("\t-a <address>: indirizzo fisico del device; se omesso, il device viene simulato in RAM\n");
+	printf("\t-n <num>: numero di iterazioni per ciascuna misura (default 1000000)\n");
+	printf("\t-m <hex-mask>: maschera dei pin su cui agire (default 0x1)\n");
+}
+
+/**
+ * @brief Effettua il parsing dei parametri passati al programma
+ *
+ * @retval 0 se il parsing ha successo
+ * @retval -1 se si verifica un errore
+ */
+int parse_args(int argc, char **argv, uint32_t *gpio_address, uint32_t *iterations, uint32_t *mask) {
+	int par;
+	while((par = getopt(argc, argv, "a:n:m:")) != -1) {
+		switch (par) {
+		case 'a' :
+			*gpio_address = strtoul(optarg, NULL, 0);
+			break;
+		case 'n' :
+			*iterations = strtoul(optarg, NULL, 0);
+			break;
+		case 'm' :
+			*mask = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (*iterations == 0) {
+		printf("il numero di iterazioni deve essere maggiore di zero.\n");
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	uint32_t gpio_addr  = 0;        // indirizzo fisico del device, 0 se simulato in RAM
+	uint32_t iterations = 1000000;  // numero di iterazioni per ciascuna misura
+	uint32_t mask       = MYGPIO_PIN0;
+	bench_device_t dev;
+	myGPIO_t gpio;
+	myGPIO_Shadow_t shadow;
+
+	if (parse_args(argc, argv, &gpio_addr, &iterations, &mask) == -1)
+		return -1;
+	if ((gpio = bench_device_open(&dev, gpio_addr)) == NULL)
+		return -1;
+
+	uint32_t saved_mode  = myGPIO_RegRead(gpio, MODE_REG);
+	uint32_t saved_write = myGPIO_RegRead(gpio, WRITE_REG);
+	uint32_t saved_pie   = myGPIO_RegRead(gpio, PIE_REG);
+	myGPIO_Shadow_Init(&shadow, gpio);
+
+	printf("device: %s, iterazioni: %u, maschera: %08x\n", (gpio_addr == 0 ? "RAM" : "/dev/mem"), iterations, mask);
+	BENCH_RUN("myGPIO_SetValue",                   iterations, myGPIO_SetValue(gpio, mask, __i & 1));
+	BENCH_RUN("myGPIO_Shadow_SetValue",            iterations, myGPIO_Shadow_SetValue(&shadow, mask, __i & 1));
+	BENCH_RUN("myGPIO_Toggle",                     iterations, myGPIO_Toggle(gpio, mask));
+	BENCH_RUN("myGPIO_Shadow_Toggle",              iterations, myGPIO_Shadow_Toggle(&shadow, mask));
+	BENCH_RUN("myGPIO_SetMode",                    iterations, myGPIO_SetMode(gpio, mask, MYGPIO_MODE_WRITE));
+	BENCH_RUN("myGPIO_Shadow_SetMode",             iterations, myGPIO_Shadow_SetMode(&shadow, mask, MYGPIO_MODE_WRITE));
+	BENCH_RUN("myGPIO_PinInterruptEnable",         iterations, myGPIO_PinInterruptEnable(gpio, 0));
+	BENCH_RUN("myGPIO_Shadow_PinInterruptEnable",  iterations, myGPIO_Shadow_PinInterruptEnable(&shadow, 0));
+	BENCH_RUN("myGPIO_PinInterruptDisable",        iterations, myGPIO_PinInterruptDisable(gpio, 0));
+	BENCH_RUN("myGPIO_Shadow_PinInterruptDisable", iterations, myGPIO_Shadow_PinInterruptDisable(&shadow, 0));
+
+	myGPIO_RegWrite(gpio, MODE_REG, saved_mode);
+	myGPIO_RegWrite(gpio, WRITE_REG, saved_write);
+	myGPIO_RegWrite(gpio, PIE_REG, saved_pie);
+	bench_device_close(&dev);
+	return 0;
+}
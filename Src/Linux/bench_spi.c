@@ -0,0 +1,191 @@
+/**
+ * @file bench_spi.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example bench_spi.c
+ * Il file bench_spi.c contiene un programma che misura le funzioni di trasposizione del master SPI
+ * multi-lane definito in myGPIO_spi.h, confrontandole con una trasposizione bit a bit, per 1, 2, 4, 8 e
+ * 16 lane; viene verificato che le due trasposizioni producano le stesse slice e che myGPIO_Spi_Unslice()
+ * ricostruisca i dati di partenza. Per la trasposizione viene riportato il tempo per byte trasposto.
+ * Viene poi misurato un trasferimento completo, su un device simulato in RAM, confrontando il master
+ * multi-lane con il bit-bang degli slave uno alla volta attraverso myGPIO_SetValue(): per ciascuno sono
+ * riportati tempo ed accessi ai registri per byte trasferito, che nel primo caso diminuiscono al crescere
+ * del numero di lane. I trasferimenti full-duplex usano fino a 15 lane; con 16 lane vengono misurati
+ * trasferimenti di sola trasmissione.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_spi.h"
+#include "bench.h"
+
+#define MOSI_PIN 0   //!< pin della linea MOSI della lane 0
+#define MISO_PIN 15  //!< pin della linea MISO della lane 0
+
+/**
+ * @brief Trasposizione di riferimento, bit a bit.
+ */
+static void reference_slice(const uint8_t *data, uint32_t lanes, uint32_t length, uint16_t *slice) {
+	uint32_t k, lane, bit;
+	memset(slice, 0, 8 * length * sizeof(uint16_t));
+	for (k = 0; k < length; k++)
+		for (lane = 0; lane < lanes; lane++)
+			for (bit = 0; bit < 8; bit++)
+				if (data[k * lanes + lane] & (0x80 >> bit))
+					slice[8 * k + bit] |= (uint16_t)(1U << lane);
+}
+
+/**
+ * @brief Bit-bang di un byte verso un solo slave, con le funzioni di myGPIO.h, come avviene senza il
+ * master multi-lane.
+ */
+static uint8_t single_lane_byte(myGPIO_t gpio, uint32_t lane, uint8_t tx) {
+	uint32_t bit;
+	uint8_t rx = 0;
+	for (bit = 0; bit < 8; bit++) {
+		myGPIO_SetValue(gpio, MYGPIO_PIN(MOSI_PIN + lane), (tx & (0x80 >> bit)) ? MYGPIO_PIN_SET : MYGPIO_PIN_RESET);
+		myGPIO_SetValue(gpio, MYGPIO_PIN(31), MYGPIO_PIN_SET);
+		rx = (uint8_t)((rx << 1) | ((myGPIO_GetRead(gpio) >> (MISO_PIN + lane)) & 1));
+		myGPIO_SetValue(gpio, MYGPIO_PIN(31), MYGPIO_PIN_RESET);
+	}
+	return rx;
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("bench_spi [-n byte] [-r ripetizioni]\n");
+	printf("\t-n <num>: byte per lane (default 4096)\n");
+	printf("\t-r <num>: ripetizioni di ciascuna misura (default 100)\n");
+}
+
+int main(int argc, char **argv) {
+	static const uint32_t lane_count[] = {1, 2, 4, 8, 16};
+	static const uint32_t transfer_lanes[] = {1, 2, 4, 8, 15, 16};
+	uint32_t length = 4096, repeat = 100, seed = 0x12345678U, i, n, lane, mismatch = 0;
+	uint8_t *tx, *rx;
+	uint16_t *slice, *expected;
+	bench_device_t dev;
+	myGPIO_t gpio;
+	myGPIO_Spi_t spi;
+	char name[64];
+	int par;
+
+	while((par = getopt(argc, argv, "n:r:")) != -1) {
+		switch (par) {
+		case 'n' :
+			length = strtoul(optarg, NULL, 0);
+			break;
+		case 'r' :
+			repeat = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (length == 0 || repeat == 0) {
+		howto();
+		return -1;
+	}
+	tx = malloc(MYGPIO_SPI_MAX_LANES * length);
+	rx = malloc(MYGPIO_SPI_MAX_LANES * length);
+	slice = malloc(8 * length * sizeof(uint16_t));
+	expected = malloc(8 * length * sizeof(uint16_t));
+	if (tx == NULL || rx == NULL || slice == NULL || expected == NULL) {
+		perror(argv[0]);
+		return -1;
+	}
+	for (i = 0; i < MYGPIO_SPI_MAX_LANES * length; i++) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		tx[i] = (uint8_t)seed;
+	}
+
+	printf("trasposizione, tempo per byte trasposto:\n");
+	for (n = 0; n < sizeof(lane_count) / sizeof(lane_count[0]); n++) {
+		uint32_t lanes = lane_count[n], bytes = lanes * length * repeat;
+		uint64_t start;
+
+		start = bench_now_ns();
+		for (i = 0; i < repeat; i++)
+			reference_slice(tx, lanes, length, expected);
+		snprintf(name, sizeof(name), "bit a bit, %u lane", lanes);
+		bench_report(name, bytes, bench_now_ns() - start, BENCH_UNCOUNTED, BENCH_UNCOUNTED);
+
+		start = bench_now_ns();
+		for (i = 0; i < repeat; i++)
+			myGPIO_Spi_Slice(tx, lanes, length, slice);
+		snprintf(name, sizeof(name), "myGPIO_Spi_Slice, %u lane", lanes);
+		bench_report(name, bytes, bench_now_ns() - start, BENCH_UNCOUNTED, BENCH_UNCOUNTED);
+
+		start = bench_now_ns();
+		for (i = 0; i < repeat; i++)
+			myGPIO_Spi_Unslice(slice, lanes, length, rx);
+		snprintf(name, sizeof(name), "myGPIO_Spi_Unslice, %u lane", lanes);
+		bench_report(name, bytes, bench_now_ns() - start, BENCH_UNCOUNTED, BENCH_UNCOUNTED);
+
+		mismatch += (memcmp(slice, expected, 8 * length * sizeof(uint16_t)) != 0);
+		mismatch += (memcmp(tx, rx, lanes * length) != 0);
+	}
+
+	printf("trasferimento su device simulato in RAM, tempo ed accessi per byte trasferito:\n");
+	if ((gpio = bench_device_open(&dev, 0)) == NULL)
+		return -1;
+	for (n = 0; n < sizeof(transfer_lanes) / sizeof(transfer_lanes[0]); n++) {
+		uint32_t lanes = transfer_lanes[n], bytes = lanes * length, full_duplex = (lanes < MYGPIO_SPI_MAX_LANES);
+		unsigned long reads, writes;
+		uint64_t start;
+
+		reads = myGPIO_BusReads;
+		writes = myGPIO_BusWrites;
+		start = bench_now_ns();
+		for (i = 0; i < length; i++)
+			for (lane = 0; lane < lanes; lane++)
+				rx[i * lanes + lane] = single_lane_byte(gpio, lane, tx[i * lanes + lane]);
+		snprintf(name, sizeof(name), "myGPIO_SetValue, %u slave in sequenza", lanes);
+		bench_report(name, bytes, bench_now_ns() - start, myGPIO_BusReads - reads, myGPIO_BusWrites - writes);
+
+		myGPIO_Spi_Init(&spi, gpio, lanes, MOSI_PIN, (full_duplex ? MISO_PIN : MYGPIO_SPI_NO_MISO), 31, MYGPIO_PIN(30));
+		reads = myGPIO_BusReads;
+		writes = myGPIO_BusWrites;
+		start = bench_now_ns();
+		myGPIO_Spi_Transfer(&spi, tx, (full_duplex ? rx : NULL), length);
+		snprintf(name, sizeof(name), "myGPIO_Spi_Transfer, %u lane%s", lanes, (full_duplex ? "" : " (solo MOSI)"));
+		bench_report(name, bytes, bench_now_ns() - start, myGPIO_BusReads - reads, myGPIO_BusWrites - writes);
+	}
+	bench_device_close(&dev);
+
+	printf("verifica: %s\n", (mismatch == 0 ? "ok" : "FALLITA"));
+	free(tx);
+	free(rx);
+	free(slice);
+	free(expected);
+	return (mismatch == 0 ? 0 : -1);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file bridge_ctl.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example bridge_ctl.c
+ * Il file bridge_ctl.c contiene un programma di controllo della co-simulazione di myGPIO.vhd descritta in
+ * myGPIO_bridge.h: consente di imporre lo stimolo esterno sui pin, di leggere il livello dei pin, il numero
+ * di interrupt ed il numero di cicli simulati, di attendere un interrupt e di terminare la simulazione.
+ * Può essere eseguito in parallelo ad uno dei programmi collegati al ponte, ad esempio uio-int-ghdl, per
+ * generare le interruzioni che questo attende.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO_bridge.h"
+
+void howto(void) {
+	printf("Uso:\n");
+	printf("bridge_ctl [-s mask] [-c mask] [-p] [-w] [-q]\n");
+	printf("\t-s mask: porta a livello alto lo stimolo esterno sui pin indicati da mask\n");
+	printf("\t-c mask: porta a livello basso lo stimolo esterno sui pin indicati da mask\n");
+	printf("\t-p: stampa il livello dei pin, il numero di interrupt ed il numero di cicli simulati\n");
+	printf("\t-w: attende un interrupt\n");
+	printf("\t-q: termina la simulazione\n");
+	printf("Le opzioni vengono eseguite nell'ordine in cui sono indicate.\n");
+	printf("La variabile d'ambiente MYGPIO_BRIDGE indica il nome della memoria condivisa (default %s)\n", MYGPIO_BRIDGE_NAME);
+}
+
+int main(int argc, char **argv) {
+	uint32_t mask, seen;
+	int par;
+
+	if (argc == 1) {
+		howto();
+		return 0;
+	}
+	if (myGPIO_Bridge_Open() != 0) {
+		printf("Simulazione non in esecuzione\n");
+		return -1;
+	}
+	while((par = getopt(argc, argv, "s:c:pwq")) != -1) {
+		switch (par) {
+		case 's' :
+			mask = strtoul(optarg, NULL, 0);
+			myGPIO_Bridge_SetPins(mask, mask);
+			break;
+		case 'c' :
+			mask = strtoul(optarg, NULL, 0);
+			myGPIO_Bridge_SetPins(mask, 0);
+			break;
+		case 'p' :
+			printf("pin: %08x interrupt: %u cicli: %" PRIu64 "\n",
+					myGPIO_Bridge_GetPads(), myGPIO_Bridge_Interrupts(), myGPIO_Bridge_Cycles());
+			break;
+		case 'w' :
+			seen = myGPIO_Bridge_WaitInterrupt(myGPIO_Bridge_Interrupts());
+			printf("interrupt: %u\n", seen);
+			break;
+		case 'q' :
+			myGPIO_Bridge_Quit();
+			break;
+		default :
+			howto();
+			return -1;
+		}
+	}
+	return 0;
+}
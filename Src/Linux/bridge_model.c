@@ -0,0 +1,119 @@
+/**
+ * @file bridge_model.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example bridge_model.c
+ * Il file bridge_model.c contiene un sostituto di myGPIO_bridge_tb.vhd, per l'esecuzione dei programmi
+ * collegati al ponte descritto in myGPIO_bridge.h in assenza di GHDL. Le funzioni di myGPIO_bridge_vhpi.c
+ * vengono chiamate nello stesso ordine in cui le chiama il testbench, ma le richieste vengono servite dal
+ * modello del banco di registri di myGPIO_model.h, anziché dall'RTL: ogni iterazione corrisponde ad un ciclo
+ * di clock, in cui viene servita al più una richiesta. Il livello della linea di interrupt e dei pin viene
+ * pubblicato prima del completamento della richiesta, così che, al ritorno di un accesso, la mailbox
+ * rifletta già il suo effetto; in assenza di richieste, tra un ciclo ed il successivo si attende il periodo
+ * indicato, oppure, con periodo nullo, si cede soltanto il processore, così che il costo di un accesso sia
+ * quello del ponte e non quello del risveglio della simulazione.
+ * @code
+ * $ ./bridge_model -w 8 &
+ * $ ./uio-int-ghdl -d /dev/uio0 -r &
+ * $ ./bridge_ctl -s 1 -c 1 -q
+ * @endcode
+ */
+#include <inttypes.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_bridge.h"
+#include "myGPIO_model.h"
+
+static volatile sig_atomic_t stopped = 0;
+
+static void stop(int signal) {
+	(void)signal;
+	stopped = 1;
+}
+
+void howto(void) {
+	printf("Uso:\n");
+	printf("bridge_model [-w width] [-p period]\n");
+	printf("\t-w width: numero di pin del device simulato (default 8)\n");
+	printf("\t-p period: attesa, in microsecondi, tra due cicli senza richieste (default 10; 0: cede solo il processore)\n");
+	printf("La variabile d'ambiente MYGPIO_BRIDGE indica il nome della memoria condivisa (default %s)\n", MYGPIO_BRIDGE_NAME);
+}
+
+int main(int argc, char **argv) {
+	myGPIO_Model_t model;
+	myGPIO_t gpio;
+	uint32_t width = 8, period = 10, value;
+	int32_t op;
+	int par;
+
+	while((par = getopt(argc, argv, "w:p:h")) != -1) {
+		switch (par) {
+		case 'w' :
+			width = strtoul(optarg, NULL, 0);
+			break;
+		case 'p' :
+			period = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			howto();
+			return -1;
+		}
+	}
+	if (width == 0 || width > 32) {
+		howto();
+		return -1;
+	}
+
+	myGPIO_Model_Init(&model, width);
+	gpio = myGPIO_Model_Gpio(&model);
+	if (myGPIO_Bridge_VhpiOpen(width) != 0)
+		return -1;
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+
+	while (!stopped) {
+		op = myGPIO_Bridge_VhpiPoll();
+		value = 0;
+		switch (op) {
+		case MYGPIO_BRIDGE_READ :
+			value = myGPIO_BackendRead(gpio, myGPIO_Bridge_VhpiReg());
+			break;
+		case MYGPIO_BRIDGE_WRITE :
+			myGPIO_BackendWrite(gpio, myGPIO_Bridge_VhpiReg(), myGPIO_Bridge_VhpiValue());
+			break;
+		case MYGPIO_BRIDGE_QUIT :
+			return 0;
+		}
+		myGPIO_Model_SetPins(&model, model.mask, myGPIO_Bridge_VhpiExchange(model.line, myGPIO_Model_GetPins(&model)));
+		if (op != MYGPIO_BRIDGE_NONE)
+			myGPIO_Bridge_VhpiComplete(value);
+		else if (period != 0)
+			usleep(period);
+		else
+			sched_yield();
+	}
+	return 0;
+}
@@ -23,12 +23,13 @@ fi
 buildroot=$(realpath $buildroot)
 
 export CC=arm-buildroot-linux-uclibcgnueabihf-gcc
-export CFLAGS="-I. -I.. -Wall -Wextra"
+export CFLAGS="-I. -I.. -O2 -Wall -Wextra"
 export CXX=arm-buildroot-linux-uclibcgnueabihf-g++
 export LD=arm-buildroot-linux-uclibcgnueabihf-ld
 export AR=arm-buildroot-linux-uclibcgnueabihf-ar
 export OBJCOPY=arm-buildroot-linux-uclibcgnueabihf-objcopy
 export SIZE=arm-buildroot-linux-uclibcgnueabihf-size
+export NM=arm-buildroot-linux-uclibcgnueabihf-nm
 export PATH=$buildroot/output/host/bin:$PATH
 
 make -j `nproc`
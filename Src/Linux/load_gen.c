@@ -0,0 +1,337 @@
+/**
+ * @file load_gen.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example load_gen.c
+ * Il file load_gen.c contiene un generatore di carico, in tempo reale, per i device simulati esterni al
+ * programma: la co-simulazione GHDL descritta in myGPIO_bridge.h ed il device QEMU di Src/QEMU/mygpio.c.
+ * Gli stimoli vengono generati con myGPIO_stimulus.h, con le stesse opzioni di sim_load, ed applicati ai pin
+ * all'istante previsto, mentre il consumatore, ad esempio uio-int-ghdl o mygpiok_stress sul sistema
+ * emulato, serve le interruzioni. Al termine vengono riportati gli impulsi generati, le salite della linea
+ * di interrupt e, per QEMU, le latenze misurate dal device, oltre al ritardo con cui gli stimoli sono stati
+ * applicati.
+ * Gli eventi osservati dal consumatore sono gli ack con cui riconosce i bit pendenti di IRQ, registrati da
+ * myGPIO_bridge.c nella mailbox, o dal device QEMU e prelevati con la richiesta "acks". Ciascuno di essi
+ * viene passato a myGPIO_Stimulus_Observe() per ogni pin riconosciuto, come fa sim_load, per cui gli impulsi
+ * consegnati, persi e le osservazioni spurie, ed i percentili della latenza tra il fronte di salita e l'ack,
+ * sono quelli visti dal consumatore. Per il ponte, gli istanti degli ack sono letti dallo stesso orologio
+ * usato per gli stimoli; per QEMU sono in tempo virtuale, e vengono riportati sull'asse degli stimoli
+ * rispetto all'ultimo fronte applicato prima dell'ack, di cui sono noti sia l'istante di applicazione sia
+ * il tempo virtuale, restituito dalla risposta a "set". In entrambi i casi la latenza comprende l'eventuale
+ * ritardo con cui il fronte di salita è stato applicato.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "myGPIO_bridge.h"
+#include "myGPIO_stimulus.h"
+
+#define NS_PER_MS 1000000ULL
+#define NS_PER_S  1000000000ULL
+
+#define TARGET_BRIDGE 0
+#define TARGET_QEMU   1
+
+static FILE *qemu = NULL;
+static uint32_t observed = 0;     //!< ack prelevati
+static uint32_t overwritten = 0;  //!< ack sovrascritti prima di essere prelevati
+
+static uint64_t now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * NS_PER_S + ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t ns) {
+	struct timespec ts;
+	ts.tv_sec = ns / NS_PER_S;
+	ts.tv_nsec = ns % NS_PER_S;
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0);
+}
+
+static int qemu_request(const char *line, char *reply, size_t size) {
+	fprintf(qemu, "%s\n", line);
+	fflush(qemu);
+	if (fgets(reply, size, qemu) == NULL)
+		return -1;
+	return strncmp(reply, "error", 5) == 0 ? -1 : 0;
+}
+
+static int qemu_open(const char *path) {
+	struct sockaddr_un address;
+	int descriptor;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+	if ((descriptor = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+			connect(descriptor, (struct sockaddr *)&address, sizeof(address)) != 0) {
+		perror(path);
+		return -1;
+	}
+	qemu = fdopen(descriptor, "r+");
+	return 0;
+}
+
+/**
+ * @brief Impone lo stimolo; per QEMU restituisce in device_ns il tempo virtuale in cui è stato applicato.
+ */
+static int set_pins(int target, uint32_t mask, uint32_t value, int64_t *device_ns) {
+	char line[64], reply[256];
+	if (target == TARGET_BRIDGE) {
+		myGPIO_Bridge_SetPins(mask, value);
+		return 0;
+	}
+	snprintf(line, sizeof(line), "set 0x%08x 0x%08x", mask, value);
+	if (qemu_request(line, reply, sizeof(reply)) != 0 || sscanf(reply, "ok %" SCNd64, device_ns) != 1)
+		return -1;
+	return 0;
+}
+
+/**
+ * @brief Passa a myGPIO_Stimulus_Observe() un ack, per ciascun pin riconosciuto.
+ */
+static void observe(myGPIO_Stimulus_t *st, uint32_t mask, uint64_t time) {
+	uint32_t pin;
+	for (pin = 0; pin < MYGPIO_STIMULUS_PINS; pin++)
+		if (mask & (1U << pin))
+			myGPIO_Stimulus_Observe(st, pin, time);
+	observed++;
+}
+
+/**
+ * @brief Preleva gli ack registrati dal ponte; start è l'istante, in ns da CLOCK_MONOTONIC, dell'origine
+ * degli stimoli.
+ */
+static void collect_bridge(myGPIO_Stimulus_t *st, uint32_t *next, uint64_t start) {
+	uint32_t acks = myGPIO_Bridge_Acks();
+	myGPIO_BridgeAck_t ack;
+	if (acks - *next > MYGPIO_BRIDGE_ACKS) {
+		overwritten += acks - *next - MYGPIO_BRIDGE_ACKS;
+		*next = acks - MYGPIO_BRIDGE_ACKS;
+	}
+	for (; *next != acks; (*next)++) {
+		ack = myGPIO_Bridge_Ack(*next);
+		observe(st, ack.mask, ack.time > start ? ack.time - start : 0);
+	}
+}
+
+/**
+ * @brief Preleva gli ack registrati dal device QEMU. device_ns ed applied_at contengono, per i primi applied
+ * fronti, il tempo virtuale e l'istante sull'asse degli stimoli in cui sono stati applicati. Gli istanti
+ * ricavati non decrescono, anche se il tempo virtuale avanza più rapidamente di quello reale.
+ */
+static int collect_qemu(myGPIO_Stimulus_t *st, const int64_t *device_ns, const uint64_t *applied_at, uint64_t applied) {
+	static uint64_t anchor = 0, last = 0;
+	char reply[256];
+	unsigned int lost;
+	int64_t time;
+	uint32_t mask;
+	fprintf(qemu, "acks\n");
+	fflush(qemu);
+	while (fgets(reply, sizeof(reply), qemu) != NULL) {
+		if (sscanf(reply, "end %u", &lost) == 1) {
+			overwritten += lost;
+			return 0;
+		}
+		if (sscanf(reply, "ack %" SCNd64 " %" SCNx32, &time, &mask) != 2)
+			return -1;
+		while (anchor + 1 < applied && device_ns[anchor + 1] <= time)
+			anchor++;
+		if (applied != 0 && time >= device_ns[anchor] && applied_at[anchor] + (time - device_ns[anchor]) > last)
+			last = applied_at[anchor] + (time - device_ns[anchor]);
+		observe(st, mask, last);
+	}
+	return -1;
+}
+
+void howto(void) {
+	printf("Uso:\n");
+	printf("load_gen -t bridge|qemu [opzioni]\n");
+	printf("\t-t bridge|qemu: device simulato da stimolare\n");
+	printf("\t-S socket: socket del chardev del device QEMU (default /tmp/mygpio.sock)\n");
+	printf("\t-k periodic|poisson|burst: processo di arrivo (default poisson)\n");
+	printf("\t-r <num>: impulsi al secondo per pin (default 100)\n");
+	printf("\t-n <num>: numero di pin stimolati, a partire dal pin 0 (default 1)\n");
+	printf("\t-w <num>: durata degli impulsi in ns (default 1000000)\n");
+	printf("\t-B <num>: impulsi per raffica (default 8)\n");
+	printf("\t-R <num>: raffiche al secondo (default 10)\n");
+	printf("\t-b <num>: massimo numero di coppie di rimbalzi per fronte (default 0)\n");
+	printf("\t-j <num>: massima distanza tra due rimbalzi in ns (default 50000)\n");
+	printf("\t-d <num>: durata in ms (default 10000)\n");
+	printf("\t-s <num>: seme degli stimoli\n");
+}
+
+static int lookup(const char *name, const char *const *names, uint32_t count) {
+	uint32_t i;
+	for (i = 0; i < count; i++)
+		if (strcmp(name, names[i]) == 0)
+			return i;
+	return -1;
+}
+
+int main(int argc, char **argv) {
+	static const char *target_name[] = { "bridge", "qemu" };
+	static const char *kind_name[] = { "periodic", "poisson", "burst" };
+	const char *path = "/tmp/mygpio.sock";
+	myGPIO_StimulusPin_t config;
+	myGPIO_Stimulus_t st;
+	uint32_t pins = 1, seed = 0x9E3779B9U, i, j, mask, value;
+	uint64_t duration = 10000 * NS_PER_MS, start, late, late_max = 0, late_sum = 0, applied = 0;
+	uint32_t interrupts = 0, next = 0;
+	uint64_t *applied_at;
+	int64_t *device_ns;
+	char reply[256];
+	int target = -1, par, index;
+
+	memset(&config, 0, sizeof(config));
+	config.kind = MYGPIO_STIMULUS_POISSON;
+	config.rate = 100;
+	config.width_ns = 1000000;
+	config.burst = 8;
+	config.burst_rate = 10;
+	config.bounce_ns = 50000;
+	while ((par = getopt(argc, argv, "t:S:k:r:n:w:B:R:b:j:d:s:")) != -1) {
+		switch (par) {
+			case 't' :
+				if ((target = lookup(optarg, target_name, 2)) < 0) { howto(); return -1; }
+				break;
+			case 'S' : path = optarg; break;
+			case 'k' :
+				if ((index = lookup(optarg, kind_name, 3)) < 0) { howto(); return -1; }
+				config.kind = index;
+				break;
+			case 'r' : config.rate = strtod(optarg, NULL); break;
+			case 'n' : pins = strtoul(optarg, NULL, 0); break;
+			case 'w' : config.width_ns = strtoul(optarg, NULL, 0); break;
+			case 'B' : config.burst = strtoul(optarg, NULL, 0); break;
+			case 'R' : config.burst_rate = strtod(optarg, NULL); break;
+			case 'b' : config.bounces = strtoul(optarg, NULL, 0); break;
+			case 'j' : config.bounce_ns = strtoul(optarg, NULL, 0); break;
+			case 'd' : duration = strtoull(optarg, NULL, 0) * NS_PER_MS; break;
+			case 's' : seed = strtoul(optarg, NULL, 0); break;
+			default : howto(); return -1;
+		}
+	}
+	if (target < 0 || pins == 0 || pins > 32 || config.rate <= 0 || config.width_ns == 0 || seed == 0 ||
+			config.burst == 0 || config.burst_rate <= 0 || config.bounce_ns == 0) {
+		howto();
+		return -1;
+	}
+
+	myGPIO_Stimulus_Init(&st, seed);
+	for (i = 0; i < pins; i++)
+		myGPIO_Stimulus_SetPin(&st, i, &config);
+	if (myGPIO_Stimulus_Generate(&st, duration) != 0) {
+		printf("memoria insufficiente\n");
+		return -1;
+	}
+
+	if (target == TARGET_BRIDGE) {
+		if (myGPIO_Bridge_Open() != 0) {
+			printf("Simulazione non in esecuzione\n");
+			return -1;
+		}
+		interrupts = myGPIO_Bridge_Interrupts();
+		next = myGPIO_Bridge_Acks();
+	} else if (qemu_open(path) != 0 || qemu_request("clear", reply, sizeof(reply)) != 0) {
+		return -1;
+	}
+
+	device_ns = malloc((st.edges != 0 ? st.edges : 1) * sizeof(int64_t));
+	applied_at = malloc((st.edges != 0 ? st.edges : 1) * sizeof(uint64_t));
+	if (device_ns == NULL || applied_at == NULL) {
+		printf("memoria insufficiente\n");
+		return -1;
+	}
+
+	// i fronti simultanei vengono applicati con una sola richiesta; gli ack vengono prelevati ad ogni
+	// fronte dal ponte, e da QEMU solo se il fronte successivo è ad almeno 1 ms, per non ritardarlo
+	start = now_ns() + 10 * NS_PER_MS;
+	for (i = 0; i < st.edges; i = j) {
+		mask = value = 0;
+		for (j = i; j < st.edges && st.edge[j].time == st.edge[i].time; j++) {
+			mask |= 1U << st.edge[j].pin;
+			value = st.edge[j].level ? value | (1U << st.edge[j].pin) : value & ~(1U << st.edge[j].pin);
+		}
+		sleep_until(start + st.edge[i].time);
+		if (set_pins(target, mask, value, &device_ns[applied]) != 0) {
+			printf("il device non risponde\n");
+			return -1;
+		}
+		late = now_ns() - (start + st.edge[i].time);
+		late_sum += late;
+		if (late > late_max)
+			late_max = late;
+		applied_at[applied++] = st.edge[i].time + late;
+		if (target == TARGET_BRIDGE)
+			collect_bridge(&st, &next, start);
+		else if ((j == st.edges || st.edge[j].time - st.edge[i].time >= NS_PER_MS) &&
+				collect_qemu(&st, device_ns, applied_at, applied) != 0) {
+			printf("risposta non valida dal device\n");
+			return -1;
+		}
+	}
+	sleep_until(now_ns() + 100 * NS_PER_MS);
+	if (target == TARGET_BRIDGE)
+		collect_bridge(&st, &next, start);
+	else if (collect_qemu(&st, device_ns, applied_at, applied) != 0) {
+		printf("risposta non valida dal device\n");
+		return -1;
+	}
+	myGPIO_Stimulus_Finish(&st);
+
+	printf("impulsi generati: %u, fronti applicati: %" PRIu64 ", ritardo medio %.1f us, massimo %.1f us\n", st.generated,
+			applied, applied != 0 ? late_sum / 1e3 / applied : 0.0, late_max / 1e3);
+	if (target == TARGET_BRIDGE) {
+		interrupts = myGPIO_Bridge_Interrupts() - interrupts;
+		printf("salite della linea di interrupt: %u (%.2f%% degli impulsi)\n", interrupts,
+				st.generated != 0 ? 100.0 * interrupts / st.generated : 0.0);
+	} else {
+		unsigned long long rises, acked;
+		long long isr_mean, isr_max, wakeup_mean, wakeup_max, ack_mean, ack_max;
+		if (qemu_request("stats", reply, sizeof(reply)) != 0 ||
+				sscanf(reply, "interrupts %llu acked %llu isr %lld %lld wakeup %lld %lld ack %lld %lld", &rises, &acked,
+					&isr_mean, &isr_max, &wakeup_mean, &wakeup_max, &ack_mean, &ack_max) != 8) {
+			printf("risposta non valida dal device\n");
+			return -1;
+		}
+		printf("salite della linea di interrupt: %llu, riconosciute: %llu\n", rises, acked);
+		printf("latenze (media/max, us): isr %.1f/%.1f, wakeup %.1f/%.1f, ack %.1f/%.1f\n", isr_mean / 1e3, isr_max / 1e3,
+				wakeup_mean / 1e3, wakeup_max / 1e3, ack_mean / 1e3, ack_max / 1e3);
+		fclose(qemu);
+	}
+	printf("ack del consumatore: %u, sovrascritti prima del prelievo: %u\n", observed, overwritten);
+	printf("impulsi consegnati: %u, persi: %u (%.2f%%), osservazioni spurie: %u\n", st.delivered, st.lost,
+			st.generated != 0 ? 100.0 * st.lost / st.generated : 0.0, st.spurious);
+	printf("latenza di consegna (us): p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+			myGPIO_Stimulus_Percentile(&st, 50) / 1e3, myGPIO_Stimulus_Percentile(&st, 90) / 1e3,
+			myGPIO_Stimulus_Percentile(&st, 99) / 1e3, myGPIO_Stimulus_Percentile(&st, 100) / 1e3);
+	free(device_ns);
+	free(applied_at);
+	myGPIO_Stimulus_Destroy(&st);
+	return 0;
+}
@@ -1 +0,0 @@
-../myGPIO.c
\ No newline at end of file
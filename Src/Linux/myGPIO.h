@@ -1 +0,0 @@
-../myGPIO.h
\ No newline at end of file
@@ -0,0 +1,255 @@
+/**
+ * @file myGPIO_bridge.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "myGPIO_bridge.h"
+
+#define MYGPIO_BRIDGE_SPIN 1000U  //!< tentativi prima di sospendersi sul futex
+
+static myGPIO_BridgeMailbox_t *myGPIO_Bridge_Mailbox = NULL;
+static uint32_t myGPIO_Bridge_Pending = 0;  //!< ultimo valore di IRQ letto da questo processo
+
+static void myGPIO_Bridge_FutexWait(uint32_t *address, uint32_t value, const struct timespec *timeout) {
+	syscall(SYS_futex, address, FUTEX_WAIT, value, timeout, NULL, 0);
+}
+
+/**
+ * @brief Attende che *address sia diverso da value, prima attivamente, poi sospendendosi sul futex.
+ */
+static uint32_t myGPIO_Bridge_WaitChange(uint32_t *address, uint32_t value) {
+	uint32_t i, current;
+	for (i = 0; i < MYGPIO_BRIDGE_SPIN; i++)
+		if ((current = __atomic_load_n(address, __ATOMIC_ACQUIRE)) != value)
+			return current;
+	while ((current = __atomic_load_n(address, __ATOMIC_ACQUIRE)) == value)
+		myGPIO_Bridge_FutexWait(address, value, NULL);
+	return current;
+}
+
+/**
+ * @brief Mappa la mailbox creata dalla simulazione.
+ *
+ * @retval 0 se la mailbox è disponibile
+ * @retval -1 se la simulazione non è in esecuzione
+ *
+ * @details
+ * Viene chiamata automaticamente al primo accesso ai registri; un programma può chiamarla esplicitamente
+ * per verificare in anticipo che la simulazione sia in esecuzione.
+ */
+int myGPIO_Bridge_Open(void) {
+	const char *name = getenv("MYGPIO_BRIDGE");
+	void *mapped;
+	int descriptor;
+	if (myGPIO_Bridge_Mailbox != NULL)
+		return 0;
+	descriptor = shm_open(name != NULL ? name : MYGPIO_BRIDGE_NAME, O_RDWR, 0);
+	if (descriptor < 0)
+		return -1;
+	mapped = mmap(NULL, sizeof(myGPIO_BridgeMailbox_t), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (mapped == MAP_FAILED)
+		return -1;
+	if (__atomic_load_n(&((myGPIO_BridgeMailbox_t*)mapped)->magic, __ATOMIC_ACQUIRE) != MYGPIO_BRIDGE_MAGIC) {
+		munmap(mapped, sizeof(myGPIO_BridgeMailbox_t));
+		return -1;
+	}
+	myGPIO_Bridge_Mailbox = (myGPIO_BridgeMailbox_t*)mapped;
+	return 0;
+}
+
+static myGPIO_BridgeMailbox_t *myGPIO_Bridge_Get(void) {
+	if (myGPIO_Bridge_Open() != 0) {
+		fprintf(stderr, "myGPIO_bridge: simulazione non in esecuzione\n");
+		exit(EXIT_FAILURE);
+	}
+	return myGPIO_Bridge_Mailbox;
+}
+
+static void myGPIO_Bridge_Lock(myGPIO_BridgeMailbox_t *mb) {
+	uint32_t expected = 0;
+	while (!__atomic_compare_exchange_n(&mb->lock, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		expected = 0;
+		sched_yield();
+	}
+}
+
+/**
+ * @brief Deposita una richiesta e ne attende il completamento.
+ */
+static uint32_t myGPIO_Bridge_Request(uint32_t op, uint32_t reg, uint32_t value) {
+	myGPIO_BridgeMailbox_t *mb = myGPIO_Bridge_Get();
+	uint32_t request;
+	myGPIO_Bridge_Lock(mb);
+	mb->op = op;
+	mb->reg = reg;
+	mb->value = value;
+	request = mb->request + 1;
+	__atomic_store_n(&mb->request, request, __ATOMIC_RELEASE);
+	if (op != MYGPIO_BRIDGE_QUIT)
+		while (myGPIO_Bridge_WaitChange(&mb->response, request - 1) != request)
+			;
+	value = mb->value;
+	__atomic_store_n(&mb->lock, 0, __ATOMIC_RELEASE);
+	return value;
+}
+
+/**
+ * @brief Registra nella mailbox il riconoscimento dei bit pendenti indicati.
+ */
+static void myGPIO_Bridge_LogAck(uint32_t mask) {
+	myGPIO_BridgeMailbox_t *mb = myGPIO_Bridge_Get();
+	struct timespec ts;
+	uint32_t acks;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	myGPIO_Bridge_Lock(mb);
+	acks = mb->acks;
+	mb->ack[acks % MYGPIO_BRIDGE_ACKS].time = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	mb->ack[acks % MYGPIO_BRIDGE_ACKS].mask = mask;
+	__atomic_store_n(&mb->acks, acks + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&mb->lock, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Restituisce il numero di salite della linea di interrupt dall'avvio della simulazione.
+ */
+uint32_t myGPIO_Bridge_Interrupts(void) {
+	return __atomic_load_n(&myGPIO_Bridge_Get()->interrupts, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Restituisce il livello della linea di interrupt.
+ */
+uint32_t myGPIO_Bridge_Line(void) {
+	return __atomic_load_n(&myGPIO_Bridge_Get()->interrupt, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Attende una salita della linea di interrupt.
+ *
+ * @param[in] seen  numero di salite già osservate, restituito da myGPIO_Bridge_Interrupts() o da una
+ *                  precedente chiamata;
+ *
+ * @return numero di salite dall'avvio della simulazione, diverso da seen
+ */
+uint32_t myGPIO_Bridge_WaitInterrupt(uint32_t seen) {
+	return myGPIO_Bridge_WaitChange(&myGPIO_Bridge_Get()->interrupts, seen);
+}
+
+/**
+ * @brief Attende una salita della linea di interrupt, per al più timeout_ms millisecondi.
+ *
+ * @param[in] seen        numero di salite già osservate;
+ * @param[in] timeout_ms  tempo massimo di attesa, in millisecondi;
+ *
+ * @return numero di salite dall'avvio della simulazione, pari a seen se il tempo è scaduto
+ */
+uint32_t myGPIO_Bridge_WaitInterruptTimeout(uint32_t seen, uint32_t timeout_ms) {
+	uint32_t *interrupts = &myGPIO_Bridge_Get()->interrupts;
+	struct timespec timeout = { timeout_ms / 1000, (timeout_ms % 1000) * 1000000L };
+	uint32_t current;
+	if ((current = __atomic_load_n(interrupts, __ATOMIC_ACQUIRE)) == seen) {
+		myGPIO_Bridge_FutexWait(interrupts, seen, &timeout);
+		current = __atomic_load_n(interrupts, __ATOMIC_ACQUIRE);
+	}
+	return current;
+}
+
+/**
+ * @brief Impone lo stimolo esterno sui pin indicati.
+ */
+void myGPIO_Bridge_SetPins(uint32_t mask, uint32_t value) {
+	myGPIO_BridgeMailbox_t *mb = myGPIO_Bridge_Get();
+	uint32_t pins = __atomic_load_n(&mb->pins, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(&mb->pins, &pins, (pins & ~mask) | (value & mask), 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		;
+}
+
+/**
+ * @brief Restituisce il livello dei pin del device simulato.
+ */
+uint32_t myGPIO_Bridge_GetPads(void) {
+	return __atomic_load_n(&myGPIO_Bridge_Get()->pads, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Restituisce il numero di ack registrati dall'avvio della simulazione.
+ */
+uint32_t myGPIO_Bridge_Acks(void) {
+	return __atomic_load_n(&myGPIO_Bridge_Get()->acks, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Restituisce la voce index del registro degli ack.
+ *
+ * @details
+ * Solo le ultime MYGPIO_BRIDGE_ACKS voci, tra quelle contate da myGPIO_Bridge_Acks(), sono disponibili: le
+ * precedenti sono state sovrascritte, e vanno considerate perse da chi le preleva.
+ */
+myGPIO_BridgeAck_t myGPIO_Bridge_Ack(uint32_t index) {
+	return myGPIO_Bridge_Get()->ack[index % MYGPIO_BRIDGE_ACKS];
+}
+
+/**
+ * @brief Restituisce il numero di cicli di clock simulati.
+ */
+uint64_t myGPIO_Bridge_Cycles(void) {
+	return __atomic_load_n(&myGPIO_Bridge_Get()->cycles, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Termina la simulazione.
+ */
+void myGPIO_Bridge_Quit(void) {
+	myGPIO_Bridge_Request(MYGPIO_BRIDGE_QUIT, 0, 0);
+}
+
+uint32_t myGPIO_BackendRead(myGPIO_t gpio, uint32_t reg) {
+	uint32_t value;
+	(void)gpio;
+	value = myGPIO_Bridge_Request(MYGPIO_BRIDGE_READ, reg, 0);
+	if (reg == IRQ_REG)
+		myGPIO_Bridge_Pending = value;
+	return value;
+}
+
+void myGPIO_BackendWrite(myGPIO_t gpio, uint32_t reg, uint32_t value) {
+	(void)gpio;
+	myGPIO_Bridge_Request(MYGPIO_BRIDGE_WRITE, reg, value);
+	if (reg == IACK_REG && (value & myGPIO_Bridge_Pending) != 0) {
+		myGPIO_Bridge_LogAck(value & myGPIO_Bridge_Pending);
+		myGPIO_Bridge_Pending &= ~value;
+	}
+}
+
+void myGPIO_BackendSpin(uint32_t loops) {
+	volatile uint32_t n = loops;
+	while (n != 0)
+		n--;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file myGPIO_bridge.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_BRIDGE_HEADER_H
+#define MYGPIO_BRIDGE_HEADER_H
+
+#include <inttypes.h>
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+
+/**
+ * @brief Ponte di co-simulazione tra i programmi C e l'RTL di myGPIO.vhd, simulato con GHDL.
+ *
+ * @details
+ * Il testbench myGPIO_bridge_tb.vhd istanzia myGPIO.vhd e contiene un master AXI4-Lite che serve le
+ * richieste di lettura e scrittura dei registri depositate in una mailbox in memoria condivisa, creata dalla
+ * simulazione con shm_open() e di nome MYGPIO_BRIDGE_NAME, o quello indicato dalla variabile d'ambiente
+ * MYGPIO_BRIDGE. Ad ogni ciclo di clock il testbench pubblica nella mailbox il livello della linea di
+ * interrupt ed il livello dei pin, e preleva lo stimolo esterno da imporre ai pin configurati come ingresso.
+ *
+ * Sul lato C, un programma compilato con MYGPIO_BACKEND definito ed collegato a myGPIO_bridge.o inoltra
+ * ogni accesso ai registri alla simulazione, attendendone il completamento; il puntatore myGPIO_t non viene
+ * usato, per cui può essere qualunque. Le salite della linea di interrupt vengono contate, e
+ * myGPIO_Bridge_WaitInterrupt() consente di attenderle. Per eseguire senza modifiche i programmi noDriver,
+ * uio, uio-int e bench_paths, myGPIO_bridge_wrap.c sostituisce, in fase di collegamento, le chiamate di
+ * sistema sui file /dev/mem, /dev/uioX e /dev/myGPIOKx, con la semantica di UIO e di myGPIOK.
+ *
+ * Se la variabile d'ambiente MYGPIO_BRIDGE_LOOPBACK, nella forma out:in, è definita per la simulazione, il
+ * livello del pin out viene riportato, ad ogni ciclo, sul pin in, come da un collegamento fisico tra i due.
+ *
+ * Il campo cycles della mailbox conta i cicli di clock simulati, per cui la differenza di cycles attorno ad
+ * una sequenza di chiamate ne misura la durata sull'hardware descritto, indipendentemente dalla velocità del
+ * simulatore.
+ *
+ * Ogni scrittura di IACK effettuata da un programma collegato al ponte che riconosce interruzioni pendenti,
+ * cioè i bit di IRQ letti per ultimi dallo stesso processo, viene registrata nella mailbox, con l'istante in
+ * cui è stata completata, letto da CLOCK_MONOTONIC. Il registro è circolare, di MYGPIO_BRIDGE_ACKS voci, e
+ * consente ad un altro processo, ad esempio load_gen, di ricavare gli eventi effettivamente osservati dal
+ * consumatore con myGPIO_Bridge_Acks() e myGPIO_Bridge_Ack().
+ *
+ * @code
+ * $ cd Src/VHDL && make && ./myGPIO_bridge_tb -gGPIO_width=8 &
+ * $ cd Src/Linux && ./noDriver-ghdl -a 0x43c00000 -m f -w 5 -r
+ * $ ./bridge_ctl -s 1      # pin 0 alto
+ * @endcode
+ *
+ * In assenza di GHDL, bridge_model serve la stessa mailbox con il modello di myGPIO_model.h al posto
+ * dell'RTL, così che i programmi collegati al ponte possano essere eseguiti comunque: le prove condotte in
+ * questo modo verificano il lato C del ponte, non il comportamento dell'RTL.
+ */
+
+#define MYGPIO_BRIDGE_NAME  "/myGPIO_bridge"  //!< nome di default della memoria condivisa
+#define MYGPIO_BRIDGE_MAGIC 0x6D475042U       //!< scritto per ultimo dalla simulazione, a mailbox pronta
+
+#define MYGPIO_BRIDGE_NONE  0U  //!< nessuna richiesta
+#define MYGPIO_BRIDGE_READ  1U  //!< lettura di un registro
+#define MYGPIO_BRIDGE_WRITE 2U  //!< scrittura di un registro
+#define MYGPIO_BRIDGE_QUIT  3U  //!< termine della simulazione
+
+#define MYGPIO_BRIDGE_ACKS  1024U  //!< voci del registro degli ack
+
+/**
+ * @brief Voce del registro degli ack.
+ */
+typedef struct {
+	uint64_t time;      //!< istante di completamento della scrittura di IACK, in ns da CLOCK_MONOTONIC
+	uint32_t mask;      //!< bit pendenti riconosciuti
+	uint32_t reserved;
+} myGPIO_BridgeAck_t;
+
+/**
+ * @brief Mailbox condivisa tra la simulazione ed i programmi C.
+ *
+ * @details
+ * Una richiesta viene depositata in op, reg e value, e pubblicata incrementando request; la simulazione la
+ * serve e pubblica il completamento copiando request in response. I campi request, response ed interrupts
+ * vengono usati anche come futex, per l'attesa senza polling. Il campo lock serializza le richieste di più
+ * processi.
+ */
+typedef struct {
+	uint32_t magic;       //!< MYGPIO_BRIDGE_MAGIC, a mailbox pronta
+	uint32_t lock;        //!< zero se nessun processo sta effettuando una richiesta
+	uint32_t request;     //!< numero d'ordine dell'ultima richiesta pubblicata
+	uint32_t response;    //!< numero d'ordine dell'ultima richiesta servita
+	uint32_t op;          //!< tipo di richiesta
+	uint32_t reg;         //!< indice del registro
+	uint32_t value;       //!< dato da scrivere, o dato letto
+	uint32_t interrupt;   //!< livello della linea di interrupt
+	uint32_t interrupts;  //!< salite della linea di interrupt
+	uint32_t pins;        //!< stimolo esterno sui pin
+	uint32_t pads;        //!< livello dei pin
+	uint32_t width;       //!< numero di pin del device simulato
+	uint64_t cycles;      //!< cicli di clock simulati
+	uint32_t acks;        //!< ack registrati dall'avvio della simulazione
+	uint32_t reserved;
+	myGPIO_BridgeAck_t ack[MYGPIO_BRIDGE_ACKS];  //!< registro circolare degli ack
+} myGPIO_BridgeMailbox_t;
+
+int      myGPIO_Bridge_Open         (void);
+uint32_t myGPIO_Bridge_Interrupts   (void);
+uint32_t myGPIO_Bridge_Line         (void);
+uint32_t myGPIO_Bridge_WaitInterrupt(uint32_t seen);
+uint32_t myGPIO_Bridge_WaitInterruptTimeout(uint32_t seen, uint32_t timeout_ms);
+void     myGPIO_Bridge_SetPins      (uint32_t mask, uint32_t value);
+uint32_t myGPIO_Bridge_GetPads      (void);
+uint64_t myGPIO_Bridge_Cycles       (void);
+uint32_t myGPIO_Bridge_Acks         (void);
+myGPIO_BridgeAck_t myGPIO_Bridge_Ack(uint32_t index);
+void     myGPIO_Bridge_Quit         (void);
+
+/* lato simulazione, ../VHDL/myGPIO_bridge_vhpi.c: chiamate dal testbench, o da bridge_model.c */
+int32_t  myGPIO_Bridge_VhpiOpen     (int32_t width);
+int32_t  myGPIO_Bridge_VhpiPoll     (void);
+int32_t  myGPIO_Bridge_VhpiReg      (void);
+int32_t  myGPIO_Bridge_VhpiValue    (void);
+void     myGPIO_Bridge_VhpiComplete (int32_t value);
+int32_t  myGPIO_Bridge_VhpiExchange (int32_t interrupt, int32_t pads);
+
+#endif
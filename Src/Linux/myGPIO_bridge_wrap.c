@@ -0,0 +1,341 @@
+/**
+ * @file myGPIO_bridge_wrap.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example myGPIO_bridge_wrap.c
+ *
+ * Sostituzione, in fase di collegamento, delle chiamate di sistema con cui noDriver, uio ed uio-int accedono
+ * al device, in modo che possano essere eseguiti senza modifiche contro la simulazione di myGPIO.vhd.
+ *
+ * Il programma va collegato con le opzioni
+ * @code
+ * -Wl,--wrap=open,--wrap=mmap,--wrap=read,--wrap=write,--wrap=close,--wrap=lseek,--wrap=pread,--wrap=pwrite,--wrap=poll
+ * @endcode
+ * e compilato senza _FORTIFY_SOURCE, così che read() non venga sostituita da __read_chk().
+ * L'apertura di /dev/mem, di /dev/uioX o di /dev/myGPIOKx restituisce un descrittore segnaposto, su
+ * /dev/null; mmap() su di esso restituisce una pagina anonima, il cui indirizzo viene passato a myGPIO_Init()
+ * ma mai dereferenziato, dal momento che gli accessi ai registri vengono inoltrati alla simulazione da
+ * myGPIO_bridge.c.
+ * Sui descrittori di /dev/uioX, read() e write() riproducono il comportamento di uio_pdrv_genirq: ogni
+ * descrittore parte con la linea abilitata; read() attende che la linea sia abilitata ed alta, o che sia
+ * salita dall'ultima abilitazione, la maschera e restituisce il numero di interrupt serviti; write() di 1
+ * riabilita la linea, write() di 0 la maschera. Una read() su una linea mascherata resta quindi bloccata
+ * fino alla write() di 1, eventualmente da parte di un altro thread; poll() segnala POLLIN quando read()
+ * non resterebbe bloccata.
+ * Sui descrittori di /dev/myGPIOKx, read(), write(), pread() e pwrite() accedono al registro che si trova
+ * all'offset indicato, o alla posizione fissata con lseek(), ed effettuano gli stessi accessi di
+ * myGPIOK_read() e myGPIOK_write(): read() bloccante attende il flag can_read, e qualunque read() attende che
+ * il registro letto torni a zero, invia l'ack di tutti i pin e riabilita le interruzioni. Il gestore delle
+ * interruzioni del modulo, myGPIOK_irq_handler(), viene eseguito, per ciascuna salita della linea successiva
+ * all'apertura, alla prima chiamata che la osserva, compresa poll(), che segnala POLLIN se can_read è
+ * impostato. Ogni chiamata su un descrittore di myGPIOK effettua comunque la chiamata di sistema originale
+ * sul segnaposto, così che il costo della system call resti nel percorso misurato.
+ * Le chiamate su tutti gli altri file vengono servite dalle funzioni originali.
+ */
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "myGPIO_bridge.h"
+
+#define MYGPIO_BRIDGE_FILES 16  //!< numero massimo di descrittori segnaposto aperti
+#define MYGPIOK_IRQ_MASK    0xFFFFFFFFU  //!< pin di cui myGPIOK gestisce le interruzioni, come myGPIOK_USED_INT
+#define MYGPIOK_WAIT_MS     10U  //!< intervallo tra due verifiche durante le attese
+
+int     __real_open (const char *pathname, int flags, ...);
+void   *__real_mmap (void *addr, size_t length, int prot, int flags, int fd, off_t offset);
+ssize_t __real_read (int fd, void *buf, size_t count);
+ssize_t __real_write(int fd, const void *buf, size_t count);
+int     __real_close(int fd);
+off_t   __real_lseek(int fd, off_t offset, int whence);
+ssize_t __real_pread(int fd, void *buf, size_t count, off_t offset);
+ssize_t __real_pwrite(int fd, const void *buf, size_t count, off_t offset);
+int     __real_poll(struct pollfd *fds, nfds_t nfds, int timeout);
+
+typedef struct {
+	int      fd;       //!< descrittore segnaposto, -1 se la voce è libera
+	int      uio;      //!< non nullo se il file aperto è /dev/uioX
+	int      mygpiok;  //!< non nullo se il file aperto è /dev/myGPIOKx
+	int      nonblock; //!< non nullo se il file è stato aperto con O_NONBLOCK
+	off_t    pos;      //!< posizione fissata con lseek(), per /dev/myGPIOKx
+	int      masked;   //!< non nullo se la linea di interrupt è mascherata
+	uint32_t armed;    //!< salite della linea al momento dell'ultima abilitazione
+	uint32_t count;    //!< interrupt serviti, restituiti da read()
+} myGPIO_BridgeFile_t;
+
+static myGPIO_BridgeFile_t myGPIO_Bridge_Files[MYGPIO_BRIDGE_FILES] = {
+	[0 ... MYGPIO_BRIDGE_FILES - 1] = { .fd = -1 }
+};
+
+static uint32_t myGPIO_Bridge_Handled = 0;  //!< salite della linea servite dal gestore di myGPIOK
+static uint32_t myGPIO_Bridge_CanRead = 0;  //!< flag can_read di myGPIOK
+
+/**
+ * @brief Restituisce la voce del descrittore segnaposto fd, o una voce libera se fd vale -1.
+ */
+static myGPIO_BridgeFile_t *myGPIO_Bridge_File(int fd) {
+	int i;
+	for (i = 0; i < MYGPIO_BRIDGE_FILES; i++)
+		if (myGPIO_Bridge_Files[i].fd == fd)
+			return &myGPIO_Bridge_Files[i];
+	return NULL;
+}
+
+int __wrap_open(const char *pathname, int flags, ...) {
+	myGPIO_BridgeFile_t *file;
+	mode_t mode = 0;
+	va_list ap;
+	int fd;
+	if (flags & O_CREAT) {
+		va_start(ap, flags);
+		mode = va_arg(ap, mode_t);
+		va_end(ap);
+	}
+	if (strcmp(pathname, "/dev/mem") != 0 && strncmp(pathname, "/dev/uio", 8) != 0 && strncmp(pathname, "/dev/myGPIOK", 12) != 0)
+		return __real_open(pathname, flags, mode);
+	if (myGPIO_Bridge_Open() != 0 || (file = myGPIO_Bridge_File(-1)) == NULL) {
+		errno = ENODEV;
+		return -1;
+	}
+	if ((fd = __real_open("/dev/null", O_RDWR)) < 0)
+		return -1;
+	file->fd = fd;
+	file->uio = (pathname[5] == 'u');
+	file->mygpiok = (pathname[5] == 'm' && pathname[6] == 'y');
+	file->nonblock = ((flags & O_NONBLOCK) != 0);
+	file->pos = 0;
+	file->masked = 0;
+	file->armed = myGPIO_Bridge_Interrupts();
+	file->count = 0;
+	if (file->mygpiok)
+		__atomic_store_n(&myGPIO_Bridge_Handled, file->armed, __ATOMIC_RELEASE);
+	return fd;
+}
+
+void *__wrap_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset) {
+	int anonymous = MAP_PRIVATE | MAP_ANONYMOUS;
+	if (fd < 0 || myGPIO_Bridge_File(fd) == NULL)
+		return __real_mmap(addr, length, prot, flags, fd, offset);
+#ifdef MAP_32BIT
+	/* i programmi convertono il puntatore in uint32_t prima di passarlo a myGPIO_Init() */
+	anonymous |= MAP_32BIT;
+#endif
+	return __real_mmap(NULL, length, PROT_READ | PROT_WRITE, anonymous, -1, 0);
+}
+
+/**
+ * @brief Esegue myGPIOK_irq_handler(), se la linea è salita dall'ultima esecuzione: disabilita le
+ * interruzioni del device ed imposta can_read.
+ */
+static void myGPIO_Bridge_KernelIrq(void) {
+	uint32_t handled = __atomic_load_n(&myGPIO_Bridge_Handled, __ATOMIC_ACQUIRE);
+	uint32_t rises = myGPIO_Bridge_Interrupts();
+	if (rises == handled ||
+			!__atomic_compare_exchange_n(&myGPIO_Bridge_Handled, &handled, rises, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		return;
+	myGPIO_BackendWrite(NULL, GIES_REG, 0);
+	myGPIO_BackendWrite(NULL, PIE_REG, myGPIO_BackendRead(NULL, PIE_REG) & ~MYGPIOK_IRQ_MASK);
+	__atomic_store_n(&myGPIO_Bridge_CanRead, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Accessi di myGPIOK_read() al registro che si trova all'offset indicato.
+ */
+static ssize_t myGPIO_Bridge_KernelRead(myGPIO_BridgeFile_t *file, void *buf, size_t count, off_t offset) {
+	uint32_t reg = (uint32_t)(offset / 4), value, seen;
+	if (count != sizeof(uint32_t) || offset < 0 || reg > IACK_REG + 1) {
+		errno = EFAULT;
+		return -1;
+	}
+	if (!file->nonblock)
+		for (;;) {
+			seen = myGPIO_Bridge_Interrupts();
+			myGPIO_Bridge_KernelIrq();
+			if (__atomic_exchange_n(&myGPIO_Bridge_CanRead, 0, __ATOMIC_ACQ_REL))
+				break;
+			myGPIO_Bridge_WaitInterruptTimeout(seen, MYGPIOK_WAIT_MS);
+		}
+	value = myGPIO_BackendRead(NULL, reg);
+	memcpy(buf, &value, sizeof(uint32_t));
+	while (myGPIO_BackendRead(NULL, reg) != 0)
+		;
+	myGPIO_BackendWrite(NULL, IACK_REG, MYGPIOK_IRQ_MASK);
+	myGPIO_BackendWrite(NULL, GIES_REG, 1);
+	myGPIO_BackendWrite(NULL, PIE_REG, myGPIO_BackendRead(NULL, PIE_REG) | MYGPIOK_IRQ_MASK);
+	return sizeof(uint32_t);
+}
+
+/**
+ * @brief Accesso di myGPIOK_write() al registro che si trova all'offset indicato.
+ */
+static ssize_t myGPIO_Bridge_KernelWrite(const void *buf, size_t count, off_t offset) {
+	uint32_t reg = (uint32_t)(offset / 4), value;
+	if (count != sizeof(uint32_t) || offset < 0 || reg > IACK_REG + 1) {
+		errno = EFAULT;
+		return -1;
+	}
+	memcpy(&value, buf, sizeof(uint32_t));
+	myGPIO_BackendWrite(NULL, reg, value);
+	return sizeof(uint32_t);
+}
+
+ssize_t __wrap_read(int fd, void *buf, size_t count) {
+	myGPIO_BridgeFile_t *file = (fd < 0 ? NULL : myGPIO_Bridge_File(fd));
+	struct timespec pause = {0, 100000};
+	uint32_t seen;
+	if (file != NULL && file->mygpiok) {
+		(void)__real_read(fd, buf, 0);
+		return myGPIO_Bridge_KernelRead(file, buf, count, file->pos);
+	}
+	if (file == NULL || !file->uio)
+		return __real_read(fd, buf, count);
+	if (count != sizeof(uint32_t)) {
+		errno = EINVAL;
+		return -1;
+	}
+	while (__atomic_load_n(&file->masked, __ATOMIC_ACQUIRE))
+		nanosleep(&pause, NULL);
+	/* seen viene letto prima del livello, così che una salita successiva al controllo non vada persa */
+	seen = myGPIO_Bridge_Interrupts();
+	while (!myGPIO_Bridge_Line() && seen == file->armed)
+		seen = myGPIO_Bridge_WaitInterrupt(seen);
+	__atomic_store_n(&file->masked, 1, __ATOMIC_RELEASE);
+	file->count++;
+	memcpy(buf, &file->count, sizeof(uint32_t));
+	return sizeof(uint32_t);
+}
+
+ssize_t __wrap_write(int fd, const void *buf, size_t count) {
+	myGPIO_BridgeFile_t *file = (fd < 0 ? NULL : myGPIO_Bridge_File(fd));
+	uint32_t enable;
+	if (file != NULL && file->mygpiok) {
+		(void)__real_write(fd, buf, count);
+		return myGPIO_Bridge_KernelWrite(buf, count, file->pos);
+	}
+	if (file == NULL || !file->uio)
+		return __real_write(fd, buf, count);
+	if (count != sizeof(uint32_t)) {
+		errno = EINVAL;
+		return -1;
+	}
+	memcpy(&enable, buf, sizeof(uint32_t));
+	if (enable && __atomic_load_n(&file->masked, __ATOMIC_ACQUIRE)) {
+		file->armed = myGPIO_Bridge_Interrupts();
+		__atomic_store_n(&file->masked, 0, __ATOMIC_RELEASE);
+	}
+	else if (!enable)
+		__atomic_store_n(&file->masked, 1, __ATOMIC_RELEASE);
+	return sizeof(uint32_t);
+}
+
+off_t __wrap_lseek(int fd, off_t offset, int whence) {
+	myGPIO_BridgeFile_t *file = (fd < 0 ? NULL : myGPIO_Bridge_File(fd));
+	off_t pos;
+	if (file == NULL || !file->mygpiok)
+		return __real_lseek(fd, offset, whence);
+	(void)__real_lseek(fd, 0, SEEK_SET);
+	switch (whence) {
+		case SEEK_SET : pos = offset; break;
+		case SEEK_CUR : pos = file->pos + offset; break;
+		default : errno = EINVAL; return -1;
+	}
+	if (pos < 0) {
+		errno = EINVAL;
+		return -1;
+	}
+	return (file->pos = pos);
+}
+
+ssize_t __wrap_pread(int fd, void *buf, size_t count, off_t offset) {
+	myGPIO_BridgeFile_t *file = (fd < 0 ? NULL : myGPIO_Bridge_File(fd));
+	if (file == NULL || !file->mygpiok)
+		return __real_pread(fd, buf, count, offset);
+	(void)__real_pread(fd, buf, 0, offset);
+	return myGPIO_Bridge_KernelRead(file, buf, count, offset);
+}
+
+ssize_t __wrap_pwrite(int fd, const void *buf, size_t count, off_t offset) {
+	myGPIO_BridgeFile_t *file = (fd < 0 ? NULL : myGPIO_Bridge_File(fd));
+	if (file == NULL || !file->mygpiok)
+		return __real_pwrite(fd, buf, count, offset);
+	(void)__real_pwrite(fd, buf, count, offset);
+	return myGPIO_Bridge_KernelWrite(buf, count, offset);
+}
+
+/**
+ * @brief Eventi pronti sul descrittore segnaposto file, secondo la semantica di UIO o di myGPIOK.
+ */
+static short myGPIO_Bridge_Ready(myGPIO_BridgeFile_t *file, uint32_t seen) {
+	if (file->uio)
+		return (!__atomic_load_n(&file->masked, __ATOMIC_ACQUIRE) && (myGPIO_Bridge_Line() || seen != file->armed) ? POLLIN | POLLRDNORM : 0);
+	if (file->mygpiok) {
+		myGPIO_Bridge_KernelIrq();
+		return (__atomic_load_n(&myGPIO_Bridge_CanRead, __ATOMIC_ACQUIRE) ? POLLIN | POLLRDNORM : 0);
+	}
+	return POLLIN | POLLRDNORM | POLLOUT | POLLWRNORM;
+}
+
+int __wrap_poll(struct pollfd *fds, nfds_t nfds, int timeout) {
+	struct timespec now;
+	uint64_t start, elapsed;
+	uint32_t seen;
+	nfds_t i, placeholders = 0;
+	int ready;
+	for (i = 0; i < nfds; i++)
+		if (fds[i].fd >= 0 && myGPIO_Bridge_File(fds[i].fd) != NULL)
+			placeholders++;
+	if (placeholders == 0)
+		return __real_poll(fds, nfds, timeout);
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	start = (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+	for (;;) {
+		/* seen viene letto prima della verifica, così che una salita successiva non vada persa */
+		seen = myGPIO_Bridge_Interrupts();
+		for (i = 0, ready = 0; i < nfds; i++) {
+			myGPIO_BridgeFile_t *file = (fds[i].fd < 0 ? NULL : myGPIO_Bridge_File(fds[i].fd));
+			fds[i].revents = 0;
+			if (file != NULL)
+				fds[i].revents = myGPIO_Bridge_Ready(file, seen) & fds[i].events;
+			else if (fds[i].fd >= 0)
+				(void)__real_poll(&fds[i], 1, 0);
+			ready += (fds[i].revents != 0);
+		}
+		if (ready != 0 || timeout == 0)
+			return ready;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		elapsed = (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000 - start;
+		if (timeout > 0 && elapsed >= (uint64_t)timeout)
+			return 0;
+		myGPIO_Bridge_WaitInterruptTimeout(seen, (timeout > 0 && (uint64_t)timeout - elapsed < MYGPIOK_WAIT_MS ? (uint32_t)(timeout - elapsed) : MYGPIOK_WAIT_MS));
+	}
+}
+
+int __wrap_close(int fd) {
+	myGPIO_BridgeFile_t *file = (fd < 0 ? NULL : myGPIO_Bridge_File(fd));
+	if (file != NULL)
+		file->fd = -1;
+	return __real_close(fd);
+}
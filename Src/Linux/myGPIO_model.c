@@ -0,0 +1,232 @@
+/**
+ * @file myGPIO_model.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+#include "myGPIO_model.h"
+
+/**
+ * @brief Livello dei pin: le uscite assumono il valore di WRITE, gli ingressi quello imposto dall'esterno.
+ */
+static uint32_t myGPIO_Model_Pads(const myGPIO_Model_t *model) {
+	uint32_t mode = model->reg[MODE_REG];
+	return ((model->reg[WRITE_REG] & mode) | (model->pins & ~mode)) & model->mask;
+}
+
+/**
+ * @brief Aggiorna IRQ e la linea di interrupt, come avviene ad ogni fronte di clock nel VHDL: finché IACK non
+ * è nullo i suoi bit vengono azzerati in IRQ, e nessun pin viene accumulato.
+ */
+static void myGPIO_Model_Update(myGPIO_Model_t *model) {
+	if (model->iack != 0)
+		model->irq &= ~model->iack;
+	else
+		model->irq |= myGPIO_Model_Pads(model) & ~model->reg[MODE_REG] & model->reg[PIE_REG] & model->mask;
+	model->line = (model->irq != 0 && (model->reg[GIES_REG] & 1) != 0);
+}
+
+/**
+ * @brief Consegna le notifiche pendenti, a meno che non ne sia già in corso una.
+ */
+static void myGPIO_Model_Notify(myGPIO_Model_t *model) {
+	int again = 1;
+	if (model->notifying)
+		return;
+	model->notifying = 1;
+	while (again) {
+		uint32_t outputs = myGPIO_Model_Pads(model) & model->reg[MODE_REG];
+		uint32_t driven = model->reg[MODE_REG] & model->mask;
+		again = 0;
+		if (outputs != model->outputs || driven != model->driven) {
+			model->outputs = outputs;
+			model->driven = driven;
+			if (model->output != NULL)
+				model->output(model, outputs, model->output_arg);
+			again = 1;
+		}
+		if (model->line != model->delivered) {
+			model->delivered = model->line;
+			if (model->interrupt != NULL)
+				model->interrupt(model, model->line, model->interrupt_arg);
+			again = 1;
+		}
+	}
+	model->notifying = 0;
+}
+
+/**
+ * @brief Attribuisce il costo di un accesso, attendendolo attivamente se richiesto.
+ */
+static void myGPIO_Model_Charge(myGPIO_Model_t *model, uint32_t ns) {
+	struct timespec start, now;
+	model->time_ns += ns;
+	if (model->spin && ns != 0) {
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		do
+			clock_gettime(CLOCK_MONOTONIC, &now);
+		while ((uint64_t)(now.tv_sec - start.tv_sec) * 1000000000ULL + (uint64_t)(now.tv_nsec - start.tv_nsec) < ns);
+	}
+	if (model->advance != NULL)
+		model->advance(model, ns, model->advance_arg);
+}
+
+/**
+ * @brief Inizializza il modello nello stato successivo al reset.
+ *
+ * @param[out] model  modello da inizializzare;
+ * @param[in]  width  numero di pin del device, parametro GPIO_width del VHDL, da 1 a 32;
+ */
+void myGPIO_Model_Init(myGPIO_Model_t *model, uint32_t width) {
+	assert(model != NULL);
+	assert(width >= 1 && width <= 32);
+	memset(model, 0, sizeof(*model));
+	model->mask = (width == 32 ? 0xFFFFFFFFU : (1U << width) - 1);
+}
+
+/**
+ * @brief Restituisce il puntatore myGPIO_t da passare alle funzioni del driver.
+ */
+myGPIO_t myGPIO_Model_Gpio(myGPIO_Model_t *model) {
+	assert(model != NULL);
+	return model->reg;
+}
+
+/**
+ * @brief Restituisce il modello a cui appartiene un puntatore restituito da myGPIO_Model_Gpio().
+ */
+myGPIO_Model_t *myGPIO_Model_Of(myGPIO_t gpio) {
+	assert(gpio != NULL);
+	return (myGPIO_Model_t*)((char*)gpio - offsetof(myGPIO_Model_t, reg));
+}
+
+/**
+ * @brief Registra la funzione notificata ad ogni cambiamento della linea di interrupt.
+ *
+ * @param[inout] model      modello;
+ * @param[in]    interrupt  funzione, NULL per nessuna notifica;
+ * @param[in]    arg        argomento passato alla funzione;
+ */
+void myGPIO_Model_SetInterrupt(myGPIO_Model_t *model, myGPIO_ModelInterrupt_t interrupt, void *arg) {
+	assert(model != NULL);
+	model->interrupt = interrupt;
+	model->interrupt_arg = arg;
+}
+
+/**
+ * @brief Registra la funzione notificata ad ogni cambiamento del valore o dell'insieme delle uscite.
+ *
+ * @param[inout] model   modello;
+ * @param[in]    output  funzione, NULL per nessuna notifica;
+ * @param[in]    arg     argomento passato alla funzione;
+ */
+void myGPIO_Model_SetOutput(myGPIO_Model_t *model, myGPIO_ModelOutput_t output, void *arg) {
+	assert(model != NULL);
+	model->output = output;
+	model->output_arg = arg;
+}
+
+/**
+ * @brief Imposta il modello di latenza.
+ *
+ * @param[inout] model     modello;
+ * @param[in]    read_ns   costo di una lettura, in ns;
+ * @param[in]    write_ns  costo di una scrittura, in ns;
+ * @param[in]    spin      se vero, il costo di ciascun accesso viene atteso attivamente, in tempo reale;
+ */
+void myGPIO_Model_SetLatency(myGPIO_Model_t *model, uint32_t read_ns, uint32_t write_ns, int spin) {
+	assert(model != NULL);
+	model->read_ns = read_ns;
+	model->write_ns = write_ns;
+	model->spin = spin;
+}
+
+/**
+ * @brief Registra la funzione notificata del costo di ciascun accesso, prima che esso venga servito.
+ *
+ * @param[inout] model    modello;
+ * @param[in]    advance  funzione, NULL per nessuna notifica;
+ * @param[in]    arg      argomento passato alla funzione;
+ */
+void myGPIO_Model_SetAdvance(myGPIO_Model_t *model, myGPIO_ModelAdvance_t advance, void *arg) {
+	assert(model != NULL);
+	model->advance = advance;
+	model->advance_arg = arg;
+}
+
+/**
+ * @brief Impone dall'esterno il livello dei pin indicati.
+ *
+ * @param[inout] model  modello;
+ * @param[in]    mask   pin su cui agire;
+ * @param[in]    value  livelli, per i pin indicati da mask;
+ *
+ * @details
+ * Il livello imposto è visibile in READ solo per i pin configurati come ingresso, ma viene ricordato anche
+ * per gli altri, e torna visibile se essi vengono configurati come ingresso.
+ */
+void myGPIO_Model_SetPins(myGPIO_Model_t *model, uint32_t mask, uint32_t value) {
+	assert(model != NULL);
+	model->pins = (model->pins & ~mask) | (value & mask);
+	myGPIO_Model_Update(model);
+	myGPIO_Model_Notify(model);
+}
+
+/**
+ * @brief Restituisce il livello dei pin, come visto dall'esterno del device.
+ */
+uint32_t myGPIO_Model_GetPins(const myGPIO_Model_t *model) {
+	assert(model != NULL);
+	return myGPIO_Model_Pads(model);
+}
+
+uint32_t myGPIO_BackendRead(myGPIO_t gpio, uint32_t reg) {
+	myGPIO_Model_t *model = myGPIO_Model_Of(gpio);
+	uint32_t value;
+	model->reads++;
+	myGPIO_Model_Charge(model, model->read_ns);
+	switch (reg) {
+		case READ_REG : value = myGPIO_Model_Pads(model); break;
+		case GIES_REG : value = (model->reg[GIES_REG] & 1) | (model->irq != 0 ? 2 : 0); break;
+		case IRQ_REG : value = model->irq; break;
+		case IACK_REG : value = model->iack; break;
+		default : value = model->reg[reg & 7]; break;
+	}
+	return value;
+}
+
+void myGPIO_BackendWrite(myGPIO_t gpio, uint32_t reg, uint32_t value) {
+	myGPIO_Model_t *model = myGPIO_Model_Of(gpio);
+	model->writes++;
+	myGPIO_Model_Charge(model, model->write_ns);
+	model->iack = 0;
+	switch (reg) {
+		case READ_REG : case IRQ_REG : break;
+		case GIES_REG : model->reg[GIES_REG] = value & 1; break;
+		case IACK_REG : model->iack = value; break;
+		default : model->reg[reg & 7] = value; break;
+	}
+	myGPIO_Model_Update(model);
+	myGPIO_Model_Notify(model);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file myGPIO_model.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_MODEL_HEADER_H
+#define MYGPIO_MODEL_HEADER_H
+
+#include <inttypes.h>
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+
+/**
+ * @brief Modello comportamentale, eseguibile sull'host, del banco di registri di myGPIO_AXI.vhd.
+ *
+ * @details
+ * Il modello fornisce le funzioni myGPIO_BackendRead() e myGPIO_BackendWrite(), per cui i moduli del driver
+ * compilati con MYGPIO_BACKEND definito possono operare su di esso esattamente come su un device reale:
+ * il puntatore myGPIO_t da passare loro è restituito da myGPIO_Model_Gpio(). Più istanze possono coesistere,
+ * ciascuna individuata dal proprio puntatore.
+ *
+ * Il modello riproduce il comportamento del VHDL per registro:
+ *  - MODE, WRITE, PIE ed il registro all'offset 0x1C vengono memorizzati per intero;
+ *  - READ restituisce, per i pin configurati come uscita, il valore di WRITE, per quelli configurati come
+ *    ingresso il livello imposto dall'esterno con myGPIO_Model_SetPins(); i bit oltre la larghezza del
+ *    device vengono letti zero, e le scritture su READ non hanno effetto;
+ *  - GIES memorizza il solo bit IE, mentre il bit IS riporta la or-reduce di IRQ;
+ *  - IRQ accumula, in OR, i pin configurati come ingresso, abilitati in PIE e che si trovano a livello alto,
+ *    indipendentemente da IE; le scritture su IRQ non hanno effetto;
+ *  - IACK mantiene il valore scritto fino alla successiva scrittura su un qualsiasi registro, e viene letto
+ *    come tale; finché non è nullo i bit di IRQ corrispondenti ai suoi bit a '1' restano azzerati, e IRQ
+ *    non accumula le interruzioni di nessun pin: gli impulsi che iniziano e terminano in questo intervallo
+ *    vengono persi, ed un pin ancora alto torna in IRQ solo dopo la scrittura che azzera IACK.
+ *
+ * La linea di interrupt, IS AND IE, viene notificata alla funzione registrata con
+ * myGPIO_Model_SetInterrupt() ad ogni suo cambiamento di livello, al termine dell'accesso o della variazione
+ * degli ingressi che lo ha causato; se la funzione accede a sua volta al device, le notifiche che ne
+ * derivano vengono consegnate dopo il suo ritorno. Analogamente, la funzione registrata con
+ * myGPIO_Model_SetOutput() viene notificata quando cambia il valore presente sui pin configurati come uscita,
+ * oppure l'insieme di tali pin: un pin che passa da ingresso ad uscita a livello basso, come fa una linea
+ * open-drain, viene quindi notificato anche se il valore delle uscite resta nullo. L'insieme dei pin pilotati
+ * è il registro MODE, che la funzione può leggere dal campo reg.
+ *
+ * Il modello di latenza, facoltativo, attribuisce un costo a ciascuna lettura e ciascuna scrittura: i costi
+ * vengono accumulati nel campo time_ns e, se richiesto, attesi attivamente, così che un benchmark che misura
+ * il tempo reale veda il costo di una lettura non cacheable su AXI. Il costo viene inoltre notificato alla
+ * funzione registrata con myGPIO_Model_SetAdvance(), prima che l'accesso venga servito: è il punto
+ * d'aggancio di una simulazione in tempo virtuale, che in questo modo applica gli stimoli che cadono durante
+ * l'accesso.
+ *
+ * @code
+ * myGPIO_Model_t model;
+ * myGPIO_t gpio;
+ * myGPIO_Model_Init(&model, 8);
+ * myGPIO_Model_SetInterrupt(&model, handler, NULL);
+ * gpio = myGPIO_Model_Gpio(&model);
+ * myGPIO_PinInterruptEnable(gpio, MYGPIO_PIN0);
+ * myGPIO_GlobalInterruptEnable(gpio);
+ * myGPIO_Model_SetPins(&model, MYGPIO_PIN0, MYGPIO_PIN0);  // handler(&model, 1, NULL)
+ * @endcode
+ */
+
+typedef struct myGPIO_Model myGPIO_Model_t;
+
+typedef void (*myGPIO_ModelInterrupt_t)(myGPIO_Model_t *model, uint32_t level, void *arg);  //!< notifica della linea di interrupt
+typedef void (*myGPIO_ModelOutput_t)(myGPIO_Model_t *model, uint32_t pins, void *arg);      //!< notifica del valore delle uscite
+typedef void (*myGPIO_ModelAdvance_t)(myGPIO_Model_t *model, uint32_t ns, void *arg);       //!< notifica del costo di un accesso
+
+struct myGPIO_Model {
+	uint32_t                reg[8];      //!< registri memorizzati; il loro indirizzo è il puntatore myGPIO_t
+	uint32_t                mask;        //!< maschera dei pin esistenti, secondo la larghezza del device
+	uint32_t                pins;        //!< livelli imposti dall'esterno sui pin
+	uint32_t                irq;         //!< registro IRQ
+	uint32_t                iack;        //!< registro IACK, azzerato dalla scrittura successiva
+	uint32_t                line;        //!< livello della linea di interrupt
+	uint32_t                delivered;   //!< ultimo livello notificato
+	uint32_t                outputs;     //!< ultimo valore delle uscite notificato
+	uint32_t                driven;      //!< ultimo insieme dei pin configurati come uscita notificato
+	int                     notifying;   //!< vero durante una notifica
+	myGPIO_ModelInterrupt_t interrupt;   //!< funzione notificata al cambiamento della linea di interrupt
+	void                   *interrupt_arg;
+	myGPIO_ModelOutput_t    output;      //!< funzione notificata al cambiamento delle uscite
+	void                   *output_arg;
+	myGPIO_ModelAdvance_t   advance;     //!< funzione notificata del costo di ciascun accesso, prima di servirlo
+	void                   *advance_arg;
+	uint32_t                read_ns;     //!< costo di una lettura, in ns
+	uint32_t                write_ns;    //!< costo di una scrittura, in ns
+	int                     spin;        //!< se vero, il costo degli accessi viene atteso attivamente
+	uint64_t                time_ns;     //!< somma dei costi degli accessi effettuati
+	unsigned long           reads;       //!< letture effettuate
+	unsigned long           writes;      //!< scritture effettuate
+};
+
+void           myGPIO_Model_Init        (myGPIO_Model_t *model, uint32_t width);
+myGPIO_t       myGPIO_Model_Gpio        (myGPIO_Model_t *model);
+myGPIO_Model_t *myGPIO_Model_Of         (myGPIO_t gpio);
+void           myGPIO_Model_SetInterrupt(myGPIO_Model_t *model, myGPIO_ModelInterrupt_t interrupt, void *arg);
+void           myGPIO_Model_SetOutput   (myGPIO_Model_t *model, myGPIO_ModelOutput_t output, void *arg);
+void           myGPIO_Model_SetLatency  (myGPIO_Model_t *model, uint32_t read_ns, uint32_t write_ns, int spin);
+void           myGPIO_Model_SetAdvance  (myGPIO_Model_t *model, myGPIO_ModelAdvance_t advance, void *arg);
+void           myGPIO_Model_SetPins     (myGPIO_Model_t *model, uint32_t mask, uint32_t value);
+uint32_t       myGPIO_Model_GetPins     (const myGPIO_Model_t *model);
+
+#endif
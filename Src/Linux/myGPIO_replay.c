@@ -0,0 +1,274 @@
+/**
+ * @file myGPIO_replay.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "myGPIO_replay.h"
+#include "myGPIO_shadow.h"
+#include "myGPIO_batch.h"
+
+#define MYGPIO_REPLAY_STATE ((1U << MODE_REG) | (1U << WRITE_REG) | (1U << PIE_REG))  //!< registri tradotti in operazioni
+
+/**
+ * @brief Bit significativi, nel confronto con il valore registrato, di una lettura del registro reg.
+ */
+static uint32_t myGPIO_Replay_Compared(uint32_t reg) {
+	if (reg == IRQ_REG)
+		return 0;
+	return (reg == GIES_REG ? 1U : ~0U);
+}
+
+/**
+ * @brief Ricava dalla registrazione i valori iniziali dei registri e la sequenza di operazioni.
+ *
+ * @param[out] replay   oggetto da inizializzare;
+ * @param[in]  record   accessi registrati, che devono restare validi fino a myGPIO_Replay_Destroy();
+ * @param[in]  records  numero di accessi registrati;
+ * @param[in]  width    numero di pin dei device;
+ *
+ * @retval 0 se l'inizializzazione ha successo
+ * @retval -1 se la memoria è insufficiente
+ */
+int myGPIO_Replay_Init(myGPIO_Replay_t *replay, const myGPIO_TraceRecord_t *record, uint32_t records, uint32_t width) {
+	uint32_t value[MYGPIO_TRACE_MAX_DEVICES][8], valid[MYGPIO_TRACE_MAX_DEVICES], written[MYGPIO_TRACE_MAX_DEVICES];
+	uint32_t i, device, reg, old;
+	myGPIO_ReplayOp_t *op;
+	assert(replay != NULL);
+	assert(record != NULL || records == 0);
+	assert(width >= 1 && width <= 32);
+	memset(replay, 0, sizeof(*replay));
+	memset(valid, 0, sizeof(valid));
+	memset(written, 0, sizeof(written));
+	replay->record = record;
+	replay->records = records;
+	replay->width = width;
+	if ((replay->op = malloc((records != 0 ? records : 1) * sizeof(myGPIO_ReplayOp_t))) == NULL)
+		return -1;
+	for (i = 0; i < records; i++) {
+		device = record[i].device;
+		reg = record[i].access & MYGPIO_TRACE_REG;
+		if (device >= MYGPIO_TRACE_MAX_DEVICES)
+			continue;
+		if (device >= replay->devices)
+			replay->devices = device + 1;
+		op = &replay->op[replay->ops];
+		op->device = device;
+		op->access = record[i].access;
+		op->clear = 0;
+		if ((record[i].access & MYGPIO_TRACE_WRITE) == 0) {
+			// la prima lettura di un registro non ancora scritto ne rivela il valore iniziale
+			if ((written[device] & (1U << reg)) == 0 && ((MYGPIO_REPLAY_STATE | (1U << GIES_REG)) & (1U << reg)) != 0) {
+				replay->initial[device][reg] = (reg == GIES_REG ? record[i].value & 1U : record[i].value);
+				replay->known[device] |= 1U << reg;
+				written[device] |= 1U << reg;
+			}
+			if ((MYGPIO_REPLAY_STATE & (1U << reg)) != 0) {
+				value[device][reg] = record[i].value;
+				valid[device] |= 1U << reg;
+				if (i + 1 < records && record[i + 1].device == device && record[i + 1].access == (reg | MYGPIO_TRACE_WRITE))
+					continue;
+			}
+			op->set = record[i].value;
+		} else if ((MYGPIO_REPLAY_STATE & (1U << reg)) != 0) {
+			written[device] |= 1U << reg;
+			old = ((valid[device] & (1U << reg)) != 0 ? value[device][reg] : ~record[i].value);
+			value[device][reg] = record[i].value;
+			valid[device] |= 1U << reg;
+			op->set = record[i].value & ~old;
+			op->clear = old & ~record[i].value;
+			if (op->set == 0 && op->clear == 0)
+				continue;
+		} else {
+			written[device] |= 1U << reg;
+			op->set = record[i].value;
+		}
+		replay->ops++;
+	}
+	return 0;
+}
+
+/**
+ * @brief Esegue un'operazione di scrittura, nel modo di accesso indicato.
+ */
+static void myGPIO_Replay_Apply(myGPIO_t gpio, const myGPIO_ReplayOp_t *op, uint32_t mode, myGPIO_Shadow_t *shadow, myGPIO_Batch_t *batch) {
+	uint32_t set = op->set, clear = op->clear;
+	switch (op->access & MYGPIO_TRACE_REG) {
+		case MODE_REG :
+			if (mode == MYGPIO_REPLAY_RMW) {
+				if (set != 0) myGPIO_SetMode(gpio, set, MYGPIO_MODE_WRITE);
+				if (clear != 0) myGPIO_SetMode(gpio, clear, MYGPIO_MODE_READ);
+			} else if (mode == MYGPIO_REPLAY_SHADOW) {
+				if (set != 0) myGPIO_Shadow_SetMode(shadow, set, MYGPIO_MODE_WRITE);
+				if (clear != 0) myGPIO_Shadow_SetMode(shadow, clear, MYGPIO_MODE_READ);
+			} else {
+				if (set != 0) myGPIO_Batch_SetMode(batch, gpio, set, MYGPIO_MODE_WRITE);
+				if (clear != 0) myGPIO_Batch_SetMode(batch, gpio, clear, MYGPIO_MODE_READ);
+			}
+			break;
+		case WRITE_REG :
+			if (mode == MYGPIO_REPLAY_RMW) {
+				if (set != 0) myGPIO_SetValue(gpio, set, MYGPIO_PIN_SET);
+				if (clear != 0) myGPIO_SetValue(gpio, clear, MYGPIO_PIN_RESET);
+			} else if (mode == MYGPIO_REPLAY_SHADOW) {
+				if (set != 0) myGPIO_Shadow_SetValue(shadow, set, MYGPIO_PIN_SET);
+				if (clear != 0) myGPIO_Shadow_SetValue(shadow, clear, MYGPIO_PIN_RESET);
+			} else {
+				if (set != 0) myGPIO_Batch_SetValue(batch, gpio, set, MYGPIO_PIN_SET);
+				if (clear != 0) myGPIO_Batch_SetValue(batch, gpio, clear, MYGPIO_PIN_RESET);
+			}
+			break;
+		case PIE_REG :
+			if (mode == MYGPIO_REPLAY_RMW) {
+				if (set != 0) myGPIO_PinInterruptEnable(gpio, set);
+				if (clear != 0) myGPIO_PinInterruptDisable(gpio, clear);
+			} else if (mode == MYGPIO_REPLAY_SHADOW) {
+				if (set != 0) myGPIO_Shadow_PinInterruptEnable(shadow, set);
+				if (clear != 0) myGPIO_Shadow_PinInterruptDisable(shadow, clear);
+			} else {
+				if (set != 0) myGPIO_Batch_PinInterruptEnable(batch, gpio, set);
+				if (clear != 0) myGPIO_Batch_PinInterruptDisable(batch, gpio, clear);
+			}
+			break;
+		case GIES_REG :
+			if (mode == MYGPIO_REPLAY_BATCH) {
+				if ((set & 1U) != 0) myGPIO_Batch_GlobalInterruptEnable(batch, gpio);
+				else myGPIO_Batch_GlobalInterruptDisable(batch, gpio);
+			} else {
+				if ((set & 1U) != 0) myGPIO_GlobalInterruptEnable(gpio);
+				else myGPIO_GlobalInterruptDisable(gpio);
+			}
+			break;
+		case IACK_REG :
+			if (mode == MYGPIO_REPLAY_BATCH)
+				myGPIO_Batch_PinInterruptAck(batch, gpio, set);
+			else
+				myGPIO_PinInterruptAck(gpio, set);
+			break;
+		default :
+			// scritture senza effetto sul device (READ, IRQ, registro di riserva)
+			myGPIO_RegWrite(gpio, op->access & MYGPIO_TRACE_REG, set);
+			break;
+	}
+}
+
+/**
+ * @brief Effettua una lettura registrata, imponendo prima ai pin il valore letto sul campo se si tratta
+ * del registro READ, e ne confronta il risultato con il valore registrato.
+ */
+static void myGPIO_Replay_Read(myGPIO_Replay_t *replay, uint32_t device, uint32_t reg, uint32_t value) {
+	myGPIO_Model_t *model = &replay->model[device];
+	if (reg == READ_REG)
+		myGPIO_Model_SetPins(model, ~0U, value);
+	if (((myGPIO_RegRead(myGPIO_Model_Gpio(model), reg) ^ value) & myGPIO_Replay_Compared(reg)) != 0)
+		replay->mismatches++;
+}
+
+/**
+ * @brief Riesegue la registrazione, a partire dai valori iniziali dei registri, nel modo di accesso indicato.
+ *
+ * @param[inout] replay  oggetto inizializzato con myGPIO_Replay_Init();
+ * @param[in]    mode    modo di accesso, da MYGPIO_REPLAY_RAW a MYGPIO_REPLAY_BATCH;
+ *
+ * @details
+ * Al termine, reads, writes e time_ns riportano gli accessi effettuati ed il loro costo, compresi quelli
+ * con cui gli handle shadow acquisiscono il valore dei registri, e mismatches il numero di letture che
+ * hanno restituito un valore diverso da quello registrato.
+ */
+void myGPIO_Replay_Run(myGPIO_Replay_t *replay, uint32_t mode) {
+	myGPIO_Shadow_t shadow[MYGPIO_TRACE_MAX_DEVICES];
+	myGPIO_Batch_t batch;
+	uint32_t pending[MYGPIO_TRACE_MAX_DEVICES];
+	const myGPIO_ReplayOp_t *op;
+	const myGPIO_TraceRecord_t *record;
+	uint32_t i, reg;
+	assert(replay != NULL);
+	assert(mode < MYGPIO_REPLAY_MODES);
+	for (i = 0; i < replay->devices; i++) {
+		myGPIO_Model_Init(&replay->model[i], replay->width);
+		for (reg = 0; reg < 8; reg++)
+			if ((replay->known[i] & (1U << reg)) != 0)
+				myGPIO_RegWrite(myGPIO_Model_Gpio(&replay->model[i]), reg, replay->initial[i][reg]);
+		replay->model[i].reads = replay->model[i].writes = 0;
+		myGPIO_Model_SetLatency(&replay->model[i], replay->read_ns, replay->write_ns, 0);
+		if (mode == MYGPIO_REPLAY_SHADOW)
+			myGPIO_Shadow_Init(&shadow[i], myGPIO_Model_Gpio(&replay->model[i]));
+	}
+	myGPIO_Batch_Init(&batch, 0);
+	memset(pending, 0, sizeof(pending));
+	replay->mismatches = 0;
+
+	if (mode == MYGPIO_REPLAY_RAW) {
+		for (i = 0; i < replay->records; i++) {
+			record = &replay->record[i];
+			reg = record->access & MYGPIO_TRACE_REG;
+			if (record->device >= MYGPIO_TRACE_MAX_DEVICES)
+				continue;
+			if ((record->access & MYGPIO_TRACE_WRITE) != 0)
+				myGPIO_RegWrite(myGPIO_Model_Gpio(&replay->model[record->device]), reg, record->value);
+			else
+				myGPIO_Replay_Read(replay, record->device, reg, record->value);
+		}
+	} else {
+		for (i = 0; i < replay->ops; i++) {
+			op = &replay->op[i];
+			if ((op->access & MYGPIO_TRACE_WRITE) != 0) {
+				// il batch accorpa le operazioni sullo stesso registro: per non perdere i valori intermedi,
+				// viene svuotato prima di tornare su un registro che ha già operazioni in sospeso
+				if (mode == MYGPIO_REPLAY_BATCH) {
+					if ((pending[op->device] & (1U << (op->access & MYGPIO_TRACE_REG))) != 0) {
+						myGPIO_Batch_Flush(&batch);
+						memset(pending, 0, sizeof(pending));
+					}
+					pending[op->device] |= 1U << (op->access & MYGPIO_TRACE_REG);
+				}
+				myGPIO_Replay_Apply(myGPIO_Model_Gpio(&replay->model[op->device]), op, mode, &shadow[op->device], &batch);
+			} else {
+				if (mode == MYGPIO_REPLAY_BATCH) {
+					myGPIO_Batch_Flush(&batch);
+					memset(pending, 0, sizeof(pending));
+				}
+				myGPIO_Replay_Read(replay, op->device, op->access & MYGPIO_TRACE_REG, op->set);
+			}
+		}
+		if (mode == MYGPIO_REPLAY_BATCH)
+			myGPIO_Batch_Flush(&batch);
+	}
+
+	replay->reads = replay->writes = 0;
+	replay->time_ns = 0;
+	for (i = 0; i < replay->devices; i++) {
+		replay->reads += replay->model[i].reads;
+		replay->writes += replay->model[i].writes;
+		replay->time_ns += replay->model[i].time_ns;
+	}
+}
+
+/**
+ * @brief Libera la memoria allocata da myGPIO_Replay_Init().
+ */
+void myGPIO_Replay_Destroy(myGPIO_Replay_t *replay) {
+	assert(replay != NULL);
+	free(replay->op);
+	replay->op = NULL;
+	replay->ops = 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file myGPIO_replay.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+#ifndef MYGPIO_REPLAY_HEADER_H
+#define MYGPIO_REPLAY_HEADER_H
+
+#include <inttypes.h>
+#include "myGPIO.h"
+#include "myGPIO_trace.h"
+#include "myGPIO_model.h"
+
+/**
+ * @brief Riesecuzione, sul modello del device, degli accessi ai registri registrati con myGPIO_trace.h.
+ *
+ * @details
+ * Ciascun device della registrazione viene sostituito da un'istanza di myGPIO_Model_t, inizializzata con i
+ * valori di MODE, WRITE, PIE e GIES letti nella registrazione prima di ogni scrittura, così da ripartire
+ * dallo stato in cui il device si trovava anche se la registrazione è iniziata a sessione già avviata.
+ * Prima di ogni lettura del registro READ, ai pin del modello viene imposto il valore letto sul campo, per cui
+ * il programma vede gli stessi ingressi.
+ *
+ * La registrazione può essere rieseguita così com'è (MYGPIO_REPLAY_RAW) oppure, per confrontare i modi di
+ * accesso sullo stesso traffico, come sequenza di operazioni. Ogni scrittura su MODE, WRITE e PIE viene
+ * tradotta nei bit che ha posto ad uno ed in quelli che ha posto a zero, rispetto all'ultimo valore noto del
+ * registro; le letture di un registro immediatamente seguite da una scrittura sullo stesso registro dello
+ * stesso device sono parte di un read-modify-write, e vengono assorbite dall'operazione; le scritture che
+ * non cambiano il valore del registro vengono scartate. Le operazioni vengono poi eseguite con le funzioni
+ * di myGPIO.h (MYGPIO_REPLAY_RMW), di myGPIO_shadow.h (MYGPIO_REPLAY_SHADOW) o di myGPIO_batch.h
+ * (MYGPIO_REPLAY_BATCH). Le letture restanti sono punti di sincronizzazione: vengono eseguite in tutti i
+ * modi, ed il batch viene svuotato prima di ciascuna di esse, così come prima di un'operazione su un
+ * registro che ha già operazioni in sospeso, perché ogni valore scritto sul campo compaia anche sul modello:
+ * vengono accorpate solo le operazioni consecutive su registri diversi.
+ *
+ * Il valore restituito da ogni lettura viene confrontato con quello registrato, eccetto che per IRQ, il cui
+ * valore dipende dall'andamento degli ingressi tra una lettura di READ e l'altra, che la registrazione non
+ * contiene, e per il bit IS di GIES, che da IRQ dipende. Le differenze rivelano modifiche dei registri
+ * avvenute per altra via (un reset del device, un altro processo) o un modo di accesso che non riproduce
+ * fedelmente il traffico: le letture assorbite dai read-modify-write vengono confrontate solo con
+ * MYGPIO_REPLAY_RAW, per cui i modi che eseguono operazioni vanno confrontati tra loro. Se read_ns e write_ns sono diversi da zero, il modello
+ * attribuisce loro il costo degli accessi, senza attenderlo, e la somma viene riportata in time_ns.
+ *
+ * @code
+ * myGPIO_Replay_t replay;
+ * myGPIO_TraceFile_Load(path, &header, &record);
+ * myGPIO_Replay_Init(&replay, record, header.records, 32);
+ * replay.read_ns = 150;
+ * replay.write_ns = 60;
+ * myGPIO_Replay_Run(&replay, MYGPIO_REPLAY_SHADOW);
+ * printf("%lu letture, %lu scritture\n", replay.reads, replay.writes);
+ * @endcode
+ */
+
+#define MYGPIO_REPLAY_RAW     0U  //!< accessi così come registrati
+#define MYGPIO_REPLAY_RMW     1U  //!< operazioni eseguite con le funzioni di myGPIO.h
+#define MYGPIO_REPLAY_SHADOW  2U  //!< operazioni eseguite con le funzioni di myGPIO_shadow.h
+#define MYGPIO_REPLAY_BATCH   3U  //!< operazioni eseguite con le funzioni di myGPIO_batch.h
+#define MYGPIO_REPLAY_MODES   4U
+
+/**
+ * @brief Operazione ricavata dalla registrazione.
+ */
+typedef struct {
+	uint8_t  device;  //!< indice del device
+	uint8_t  access;  //!< registro, in OR con MYGPIO_TRACE_WRITE se l'operazione è una scrittura
+	uint32_t set;     //!< bit posti ad uno; per le letture, valore registrato
+	uint32_t clear;   //!< bit posti a zero
+} myGPIO_ReplayOp_t;
+
+typedef struct {
+	const myGPIO_TraceRecord_t *record;                              //!< accessi registrati
+	uint32_t                    records;                             //!< numero di accessi registrati
+	myGPIO_ReplayOp_t          *op;                                  //!< operazioni ricavate dalla registrazione
+	uint32_t                    ops;                                 //!< numero di operazioni
+	uint32_t                    devices;                             //!< numero di device
+	uint32_t                    width;                               //!< numero di pin dei device
+	uint32_t                    initial[MYGPIO_TRACE_MAX_DEVICES][8]; //!< valori iniziali dei registri
+	uint32_t                    known[MYGPIO_TRACE_MAX_DEVICES];      //!< registri di cui è noto il valore iniziale, un bit per registro
+	myGPIO_Model_t              model[MYGPIO_TRACE_MAX_DEVICES];     //!< modello di ciascun device
+	uint32_t                    read_ns;                             //!< costo di una lettura attribuito dal modello, in ns
+	uint32_t                    write_ns;                            //!< costo di una scrittura attribuito dal modello, in ns
+	uint64_t                    time_ns;                             //!< costo degli accessi effettuati dall'ultima esecuzione
+	unsigned long               reads;                               //!< letture effettuate dall'ultima esecuzione
+	unsigned long               writes;                              //!< scritture effettuate dall'ultima esecuzione
+	unsigned long               mismatches;                          //!< letture che hanno restituito un valore diverso da quello registrato
+} myGPIO_Replay_t;
+
+int  myGPIO_Replay_Init   (myGPIO_Replay_t *replay, const myGPIO_TraceRecord_t *record, uint32_t records, uint32_t width);
+void myGPIO_Replay_Run    (myGPIO_Replay_t *replay, uint32_t mode);
+void myGPIO_Replay_Destroy(myGPIO_Replay_t *replay);
+
+#endif
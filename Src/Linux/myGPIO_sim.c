@@ -0,0 +1,330 @@
+/**
+ * @file myGPIO_sim.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include <stdlib.h>
+#include <assert.h>
+
+#include "myGPIO_sim.h"
+
+#define MYGPIO_SIM_NEVER (~0ULL)  //!< istante di un evento assente
+
+static myGPIO_Sim_t *myGPIO_Sim_Current = NULL;  //!< simulatore su cui operano le funzioni senza argomento
+
+/**
+ * @brief Vero se l'evento a precede l'evento b.
+ */
+static int myGPIO_Sim_Before(const myGPIO_SimEvent_t *a, const myGPIO_SimEvent_t *b) {
+	return (a->time < b->time || (a->time == b->time && a->seq < b->seq));
+}
+
+static int myGPIO_Sim_Push(myGPIO_SimQueue_t *queue, myGPIO_SimEvent_t event) {
+	uint32_t i, parent;
+	if (queue->count == queue->capacity) {
+		uint32_t capacity = (queue->capacity != 0 ? 2 * queue->capacity : 64);
+		myGPIO_SimEvent_t *grown = realloc(queue->event, capacity * sizeof(myGPIO_SimEvent_t));
+		if (grown == NULL)
+			return -1;
+		queue->event = grown;
+		queue->capacity = capacity;
+	}
+	for (i = queue->count++; i != 0 && myGPIO_Sim_Before(&event, &queue->event[parent = (i - 1) / 2]); i = parent)
+		queue->event[i] = queue->event[parent];
+	queue->event[i] = event;
+	return 0;
+}
+
+static myGPIO_SimEvent_t myGPIO_Sim_Pop(myGPIO_SimQueue_t *queue) {
+	myGPIO_SimEvent_t top = queue->event[0], last = queue->event[--queue->count];
+	uint32_t i = 0, child;
+	while ((child = 2 * i + 1) < queue->count) {
+		if (child + 1 < queue->count && myGPIO_Sim_Before(&queue->event[child + 1], &queue->event[child]))
+			child++;
+		if (!myGPIO_Sim_Before(&queue->event[child], &last))
+			break;
+		queue->event[i] = queue->event[child];
+		i = child;
+	}
+	if (queue->count != 0)
+		queue->event[i] = last;
+	return top;
+}
+
+static uint64_t myGPIO_Sim_Next(const myGPIO_SimQueue_t *queue) {
+	return (queue->count != 0 ? queue->event[0].time : MYGPIO_SIM_NEVER);
+}
+
+/**
+ * @brief Esegue, in ordine, gli eventi che cadono entro limit.
+ *
+ * @details
+ * Mentre la CPU è occupata vengono applicati solo gli stimoli sui pin: azioni ed ISR restano in attesa.
+ * A parità di istante, gli stimoli precedono la ISR, che precede le azioni.
+ */
+static void myGPIO_Sim_Process(myGPIO_Sim_t *sim, uint64_t limit) {
+	for (;;) {
+		uint64_t pins = myGPIO_Sim_Next(&sim->pins);
+		uint64_t isr = (!sim->busy && sim->isr_pending ? sim->isr_time : MYGPIO_SIM_NEVER);
+		uint64_t cpu = (!sim->busy ? myGPIO_Sim_Next(&sim->cpu) : MYGPIO_SIM_NEVER);
+		uint64_t next = (pins <= isr && pins <= cpu ? pins : (isr <= cpu ? isr : cpu));
+		myGPIO_SimEvent_t event;
+		if (next == MYGPIO_SIM_NEVER || next > limit)
+			return;
+		if (next > sim->now)
+			sim->now = next;
+		if (next == pins) {
+			event = myGPIO_Sim_Pop(&sim->pins);
+			myGPIO_Model_SetPins(&sim->model, event.mask, event.value);
+		}
+		else if (next == isr) {
+			sim->isr_pending = 0;
+			if (!sim->model.line)
+				continue;
+			sim->busy = 1;
+			sim->isr(sim->isr_arg);
+			sim->busy = 0;
+			sim->interrupts++;
+			if (sim->model.line && !sim->isr_pending) {
+				sim->isr_pending = 1;
+				sim->isr_time = sim->now + sim->isr_ns;
+			}
+		}
+		else {
+			event = myGPIO_Sim_Pop(&sim->cpu);
+			if (event.period != 0) {
+				event.time += event.period;
+				event.seq = sim->seq++;
+				if (myGPIO_Sim_Push(&sim->cpu, event) != 0)
+					sim->failures++;
+			}
+			sim->busy = 1;
+			event.action(sim, event.arg);
+			sim->busy = 0;
+			sim->actions++;
+		}
+	}
+}
+
+/**
+ * @brief Fa avanzare il tempo di ns nanosecondi, eseguendo gli eventi che cadono nell'intervallo.
+ */
+static void myGPIO_Sim_Advance(myGPIO_Sim_t *sim, uint64_t ns) {
+	uint64_t limit = sim->now + ns;
+	myGPIO_Sim_Process(sim, limit);
+	if (sim->now < limit)
+		sim->now = limit;
+}
+
+static void myGPIO_Sim_OnAccess(myGPIO_Model_t *model, uint32_t ns, void *arg) {
+	(void)model;
+	myGPIO_Sim_Advance((myGPIO_Sim_t*)arg, ns);
+}
+
+static void myGPIO_Sim_OnInterrupt(myGPIO_Model_t *model, uint32_t level, void *arg) {
+	myGPIO_Sim_t *sim = (myGPIO_Sim_t*)arg;
+	(void)model;
+	if (level && !sim->isr_pending && sim->isr != NULL) {
+		sim->isr_pending = 1;
+		sim->isr_time = sim->now + sim->isr_ns;
+	}
+}
+
+/**
+ * @brief Inizializza il simulatore, al tempo zero, e lo rende corrente.
+ *
+ * @param[out] sim    simulatore da inizializzare;
+ * @param[in]  width  numero di pin del device simulato;
+ *
+ * @details
+ * Il modello di latenza del device viene impostato a 150 ns per lettura e 60 ns per scrittura, senza
+ * attesa in tempo reale; il contatore costa 20 ns per lettura, ed un'iterazione di myGPIO_Spin() 4.5 ns,
+ * circa tre cicli di un Cortex-A9 a 667 MHz. Tutti i valori possono essere modificati dopo l'inizializzazione.
+ */
+void myGPIO_Sim_Init(myGPIO_Sim_t *sim, uint32_t width) {
+	assert(sim != NULL);
+	myGPIO_Model_Init(&sim->model, width);
+	myGPIO_Model_SetLatency(&sim->model, 150, 60, 0);
+	myGPIO_Model_SetAdvance(&sim->model, myGPIO_Sim_OnAccess, sim);
+	myGPIO_Model_SetInterrupt(&sim->model, myGPIO_Sim_OnInterrupt, sim);
+	sim->now = 0;
+	sim->pins.event = NULL;
+	sim->pins.count = sim->pins.capacity = 0;
+	sim->cpu.event = NULL;
+	sim->cpu.count = sim->cpu.capacity = 0;
+	sim->seq = 0;
+	sim->clock_ns = 20;
+	sim->spin_ps = 4500;
+	sim->isr = NULL;
+	sim->isr_arg = NULL;
+	sim->isr_ns = 0;
+	sim->isr_pending = 0;
+	sim->isr_time = 0;
+	sim->busy = 0;
+	sim->interrupts = 0;
+	sim->actions = 0;
+	sim->failures = 0;
+	myGPIO_Sim_Current = sim;
+}
+
+/**
+ * @brief Libera le code degli eventi.
+ */
+void myGPIO_Sim_Destroy(myGPIO_Sim_t *sim) {
+	assert(sim != NULL);
+	free(sim->pins.event);
+	free(sim->cpu.event);
+	sim->pins.event = sim->cpu.event = NULL;
+	sim->pins.count = sim->pins.capacity = 0;
+	sim->cpu.count = sim->cpu.capacity = 0;
+	if (myGPIO_Sim_Current == sim)
+		myGPIO_Sim_Current = NULL;
+}
+
+/**
+ * @brief Rende corrente un simulatore.
+ */
+void myGPIO_Sim_Select(myGPIO_Sim_t *sim) {
+	assert(sim != NULL);
+	myGPIO_Sim_Current = sim;
+}
+
+/**
+ * @brief Restituisce il puntatore myGPIO_t del device simulato.
+ */
+myGPIO_t myGPIO_Sim_Gpio(myGPIO_Sim_t *sim) {
+	assert(sim != NULL);
+	return myGPIO_Model_Gpio(&sim->model);
+}
+
+/**
+ * @brief Collega una ISR alla linea di interrupt del device.
+ *
+ * @param[inout] sim         simulatore;
+ * @param[in]    isr         ISR, con la firma usata da XScuGic_Connect(); NULL per scollegarla;
+ * @param[in]    arg         argomento della ISR;
+ * @param[in]    latency_ns  tempo tra la salita della linea e l'ingresso nella ISR;
+ */
+void myGPIO_Sim_SetIsr(myGPIO_Sim_t *sim, void (*isr)(void*), void *arg, uint32_t latency_ns) {
+	assert(sim != NULL);
+	sim->isr = isr;
+	sim->isr_arg = arg;
+	sim->isr_ns = latency_ns;
+	sim->isr_pending = 0;
+	if (isr != NULL && sim->model.line) {
+		sim->isr_pending = 1;
+		sim->isr_time = sim->now + latency_ns;
+	}
+}
+
+/**
+ * @brief Programma uno stimolo sui pin.
+ *
+ * @param[inout] sim    simulatore;
+ * @param[in]    time   istante assoluto, in ns; se già trascorso, lo stimolo viene applicato al più presto;
+ * @param[in]    mask   pin su cui agire;
+ * @param[in]    value  livelli da imporre;
+ *
+ * @retval 0 se lo stimolo è stato programmato
+ * @retval -1 se non è stato possibile allocare memoria per la coda
+ */
+int myGPIO_Sim_SchedulePins(myGPIO_Sim_t *sim, uint64_t time, uint32_t mask, uint32_t value) {
+	myGPIO_SimEvent_t event;
+	assert(sim != NULL);
+	event.time = time;
+	event.seq = sim->seq++;
+	event.period = 0;
+	event.mask = mask;
+	event.value = value;
+	event.action = NULL;
+	event.arg = NULL;
+	return myGPIO_Sim_Push(&sim->pins, event);
+}
+
+/**
+ * @brief Programma un'azione, eseguita dalla CPU simulata.
+ *
+ * @param[inout] sim     simulatore;
+ * @param[in]    time    istante assoluto della prima esecuzione, in ns;
+ * @param[in]    period  periodo, in ns, zero per un'azione singola;
+ * @param[in]    action  azione;
+ * @param[in]    arg     argomento dell'azione;
+ *
+ * @retval 0 se l'azione è stata programmata
+ * @retval -1 se non è stato possibile allocare memoria per la coda
+ */
+int myGPIO_Sim_Schedule(myGPIO_Sim_t *sim, uint64_t time, uint64_t period, myGPIO_SimAction_t action, void *arg) {
+	myGPIO_SimEvent_t event;
+	assert(sim != NULL);
+	assert(action != NULL);
+	event.time = time;
+	event.seq = sim->seq++;
+	event.period = period;
+	event.mask = 0;
+	event.value = 0;
+	event.action = action;
+	event.arg = arg;
+	return myGPIO_Sim_Push(&sim->cpu, event);
+}
+
+/**
+ * @brief Esegue la simulazione fino all'istante assoluto time.
+ */
+void myGPIO_Sim_RunUntil(myGPIO_Sim_t *sim, uint64_t time) {
+	assert(sim != NULL);
+	if (time > sim->now)
+		myGPIO_Sim_Advance(sim, time - sim->now);
+}
+
+/**
+ * @brief Attende ns nanosecondi di tempo virtuale, sul simulatore corrente.
+ */
+void myGPIO_Sim_Delay(uint64_t ns) {
+	assert(myGPIO_Sim_Current != NULL);
+	myGPIO_Sim_Advance(myGPIO_Sim_Current, ns);
+}
+
+/**
+ * @brief Attende us microsecondi di tempo virtuale, sul simulatore corrente.
+ */
+void myGPIO_Sim_DelayUs(uint32_t us) {
+	myGPIO_Sim_Delay((uint64_t)us * 1000);
+}
+
+/**
+ * @brief Contatore libero a 32 bit, in nanosecondi, del simulatore corrente; ogni lettura costa clock_ns.
+ */
+uint32_t myGPIO_Sim_Timestamp(void) {
+	assert(myGPIO_Sim_Current != NULL);
+	myGPIO_Sim_Advance(myGPIO_Sim_Current, myGPIO_Sim_Current->clock_ns);
+	return (uint32_t)myGPIO_Sim_Current->now;
+}
+
+/**
+ * @brief Tempo virtuale del simulatore corrente, in ns, senza costo.
+ */
+uint64_t myGPIO_Sim_Now(void) {
+	assert(myGPIO_Sim_Current != NULL);
+	return myGPIO_Sim_Current->now;
+}
+
+void myGPIO_BackendSpin(uint32_t loops) {
+	assert(myGPIO_Sim_Current != NULL);
+	myGPIO_Sim_Advance(myGPIO_Sim_Current, ((uint64_t)loops * myGPIO_Sim_Current->spin_ps) / 1000);
+}
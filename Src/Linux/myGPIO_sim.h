@@ -0,0 +1,120 @@
+/**
+ * @file myGPIO_sim.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_SIM_HEADER_H
+#define MYGPIO_SIM_HEADER_H
+
+#include <inttypes.h>
+#include "myGPIO_model.h"
+
+/**
+ * @brief Simulatore ad eventi discreti, in tempo virtuale, costruito attorno al modello di myGPIO_model.h.
+ *
+ * @details
+ * Il tempo del simulatore, in nanosecondi a 64 bit, avanza solo per effetto di ciò che il programma fa:
+ *  - ciascun accesso ai registri costa quanto stabilito dal modello di latenza del device;
+ *  - ciascuna lettura del contatore, myGPIO_Sim_Timestamp(), costa clock_ns;
+ *  - ciascuna iterazione dei cicli di attesa attiva del driver, myGPIO_Spin(), costa spin_ps picosecondi;
+ *  - myGPIO_Sim_Delay(), myGPIO_Sim_DelayUs() e myGPIO_Sim_RunUntil() saltano direttamente in avanti,
+ *    eseguendo gli eventi che cadono nell'intervallo, per cui le attese lunghe non costano tempo reale.
+ *
+ * Gli eventi sono di tre tipi. Gli stimoli sui pin, programmati con myGPIO_Sim_SchedulePins(), sono eventi
+ * dell'hardware, e vengono applicati al loro istante anche mentre la CPU simulata sta eseguendo codice.
+ * Le azioni, programmate con myGPIO_Sim_Schedule() ed eventualmente periodiche, rappresentano invece codice
+ * eseguito dalla CPU in risposta ad un timer, così come la ISR, registrata con myGPIO_Sim_SetIsr(), che
+ * viene invocata isr_ns nanosecondi dopo la salita della linea di interrupt e nuovamente, dopo altri isr_ns,
+ * finché la linea resta alta: azioni ed ISR non si interrompono a vicenda, e se la CPU è occupata vengono
+ * eseguite in ritardo, al termine del codice in corso.
+ * Un'azione periodica viene riprogrammata prima di essere eseguita; se ciò non è possibile per mancanza di
+ * memoria, l'azione non viene più eseguita ed il fatto viene contato nel campo failures.
+ * Gli eventi simultanei vengono eseguiti nell'ordine in cui sono stati programmati, per cui, a parità di
+ * programma e di stimoli, la simulazione è deterministica.
+ *
+ * Il simulatore fornisce myGPIO_BackendSpin(), e myGPIO_Sim_Timestamp() e myGPIO_Sim_DelayUs() possono
+ * essere passate, come sorgente di tempo e funzione di attesa, ai moduli del driver che le richiedono; esse
+ * operano sul simulatore corrente, l'ultimo inizializzato o quello selezionato con myGPIO_Sim_Select().
+ *
+ * @code
+ * myGPIO_Sim_t sim;
+ * myGPIO_Sim_Init(&sim, 8);
+ * myGPIO_Sim_SetIsr(&sim, myGPIO_Dispatch_Isr, &dispatch, 500);
+ * myGPIO_Sim_Schedule(&sim, 0, 1000000, every_ms, &debouncer);         // timer da 1 ms
+ * myGPIO_Sim_SchedulePins(&sim, 5000000, MYGPIO_PIN0, MYGPIO_PIN0);    // pin 0 alto a 5 ms
+ * myGPIO_Sim_RunUntil(&sim, 3600ULL * 1000000000ULL);                  // un'ora
+ * myGPIO_Sim_Destroy(&sim);
+ * @endcode
+ */
+
+typedef struct myGPIO_Sim myGPIO_Sim_t;
+
+typedef void (*myGPIO_SimAction_t)(myGPIO_Sim_t *sim, void *arg);  //!< azione programmata
+
+typedef struct {
+	uint64_t           time;    //!< istante dell'evento, in ns
+	uint64_t           seq;     //!< numero d'ordine, per l'ordinamento degli eventi simultanei
+	uint64_t           period;  //!< periodo, per le azioni periodiche, zero altrimenti
+	uint32_t           mask;    //!< pin su cui agire, per gli stimoli
+	uint32_t           value;   //!< livelli da imporre, per gli stimoli
+	myGPIO_SimAction_t action;  //!< azione da eseguire, NULL per gli stimoli
+	void              *arg;     //!< argomento dell'azione
+} myGPIO_SimEvent_t;
+
+typedef struct {
+	myGPIO_SimEvent_t *event;     //!< eventi, ordinati a heap
+	uint32_t           count;     //!< eventi in coda
+	uint32_t           capacity;  //!< dimensione allocata
+} myGPIO_SimQueue_t;
+
+struct myGPIO_Sim {
+	myGPIO_Model_t     model;       //!< modello del device
+	uint64_t           now;         //!< tempo virtuale, in ns
+	myGPIO_SimQueue_t  pins;        //!< stimoli sui pin in attesa
+	myGPIO_SimQueue_t  cpu;         //!< azioni in attesa
+	uint64_t           seq;         //!< eventi programmati
+	uint32_t           clock_ns;    //!< costo di una lettura del contatore
+	uint32_t           spin_ps;     //!< costo di una iterazione di myGPIO_Spin(), in ps
+	void             (*isr)(void*); //!< ISR collegata alla linea di interrupt
+	void              *isr_arg;     //!< argomento della ISR
+	uint32_t           isr_ns;      //!< latenza di ingresso nella ISR
+	int                isr_pending; //!< vero se la ISR è in attesa di essere eseguita
+	uint64_t           isr_time;    //!< istante in cui la ISR verrà eseguita
+	int                busy;        //!< vero mentre la CPU esegue un'azione o la ISR
+	uint64_t           interrupts;  //!< invocazioni della ISR
+	uint64_t           actions;     //!< azioni eseguite
+	uint64_t           failures;    //!< azioni periodiche che non è stato possibile riprogrammare
+};
+
+void     myGPIO_Sim_Init        (myGPIO_Sim_t *sim, uint32_t width);
+void     myGPIO_Sim_Destroy     (myGPIO_Sim_t *sim);
+void     myGPIO_Sim_Select      (myGPIO_Sim_t *sim);
+myGPIO_t myGPIO_Sim_Gpio        (myGPIO_Sim_t *sim);
+void     myGPIO_Sim_SetIsr      (myGPIO_Sim_t *sim, void (*isr)(void*), void *arg, uint32_t latency_ns);
+int      myGPIO_Sim_SchedulePins(myGPIO_Sim_t *sim, uint64_t time, uint32_t mask, uint32_t value);
+int      myGPIO_Sim_Schedule    (myGPIO_Sim_t *sim, uint64_t time, uint64_t period, myGPIO_SimAction_t action, void *arg);
+void     myGPIO_Sim_RunUntil    (myGPIO_Sim_t *sim, uint64_t time);
+void     myGPIO_Sim_Delay       (uint64_t ns);
+void     myGPIO_Sim_DelayUs     (uint32_t us);
+uint32_t myGPIO_Sim_Timestamp   (void);
+uint64_t myGPIO_Sim_Now         (void);
+
+#endif
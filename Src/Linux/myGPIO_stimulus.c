@@ -0,0 +1,306 @@
+/**
+ * @file myGPIO_stimulus.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include "myGPIO_stimulus.h"
+
+#define NS_PER_S 1e9
+
+static uint32_t myGPIO_Stimulus_Random(myGPIO_Stimulus_t *st) {
+	uint32_t x = st->seed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return st->seed = x;
+}
+
+/**
+ * @brief Intervallo esponenziale, in ns, di un processo di Poisson con rate eventi al secondo.
+ */
+static double myGPIO_Stimulus_Exponential(myGPIO_Stimulus_t *st, double rate) {
+	double u = (myGPIO_Stimulus_Random(st) + 1.0) / 4294967296.0;
+	return -log(u) * NS_PER_S / rate;
+}
+
+static int myGPIO_Stimulus_AddEdge(myGPIO_Stimulus_t *st, uint64_t time, uint32_t pin, uint32_t level) {
+	if (st->edges == st->capacity) {
+		uint32_t capacity = st->capacity != 0 ? 2 * st->capacity : 1024;
+		myGPIO_StimulusEdge_t *edge = realloc(st->edge, capacity * sizeof(myGPIO_StimulusEdge_t));
+		if (edge == NULL)
+			return -1;
+		st->edge = edge;
+		st->capacity = capacity;
+	}
+	st->edge[st->edges].time = time;
+	st->edge[st->edges].pin = pin;
+	st->edge[st->edges].level = level;
+	st->edges++;
+	return 0;
+}
+
+static int myGPIO_Stimulus_AddPulse(myGPIO_StimulusPulses_t *pulses, uint64_t start, uint64_t end) {
+	if (pulses->count == pulses->capacity) {
+		uint32_t capacity = pulses->capacity != 0 ? 2 * pulses->capacity : 256;
+		myGPIO_StimulusPulse_t *pulse = realloc(pulses->pulse, capacity * sizeof(myGPIO_StimulusPulse_t));
+		if (pulse == NULL)
+			return -1;
+		pulses->pulse = pulse;
+		pulses->capacity = capacity;
+	}
+	pulses->pulse[pulses->count].start = start;
+	pulses->pulse[pulses->count].end = end;
+	pulses->count++;
+	return 0;
+}
+
+/**
+ * @brief Genera un fronte verso level, seguito dagli eventuali rimbalzi; restituisce l'istante in cui il
+ * pin si assesta.
+ */
+static uint64_t myGPIO_Stimulus_Edge(myGPIO_Stimulus_t *st, uint32_t pin, uint64_t time, uint32_t level, int *error) {
+	const myGPIO_StimulusPin_t *config = &st->config[pin];
+	uint32_t i, n = 0;
+	*error |= myGPIO_Stimulus_AddEdge(st, time, pin, level);
+	if (config->bounces != 0)
+		n = 2 * (myGPIO_Stimulus_Random(st) % (config->bounces + 1));
+	for (i = 0; i < n; i++) {
+		time += 1 + myGPIO_Stimulus_Random(st) % config->bounce_ns;
+		*error |= myGPIO_Stimulus_AddEdge(st, time, pin, (i & 1) ? level : !level);
+	}
+	return time;
+}
+
+static int myGPIO_Stimulus_Compare(const void *a, const void *b) {
+	const myGPIO_StimulusEdge_t *x = a, *y = b;
+	if (x->time != y->time)
+		return x->time < y->time ? -1 : 1;
+	return x->pin < y->pin ? -1 : (x->pin > y->pin);
+}
+
+static int myGPIO_Stimulus_CompareLatency(const void *a, const void *b) {
+	uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+	return x < y ? -1 : (x > y);
+}
+
+/**
+ * @brief Inizializza il generatore, senza alcun pin configurato.
+ *
+ * @param[in] seed seme del generatore pseudo-casuale, non nullo
+ */
+void myGPIO_Stimulus_Init(myGPIO_Stimulus_t *st, uint32_t seed) {
+	assert(st);
+	assert(seed != 0);
+	memset(st, 0, sizeof(myGPIO_Stimulus_t));
+	st->seed = seed;
+}
+
+/**
+ * @brief Libera la memoria allocata dal generatore.
+ */
+void myGPIO_Stimulus_Destroy(myGPIO_Stimulus_t *st) {
+	uint32_t i;
+	assert(st);
+	free(st->edge);
+	free(st->latency);
+	for (i = 0; i < MYGPIO_STIMULUS_PINS; i++)
+		free(st->pulses[i].pulse);
+	memset(st, 0, sizeof(myGPIO_Stimulus_t));
+}
+
+/**
+ * @brief Configura gli stimoli di un pin.
+ */
+void myGPIO_Stimulus_SetPin(myGPIO_Stimulus_t *st, uint32_t pin, const myGPIO_StimulusPin_t *config) {
+	assert(st);
+	assert(pin < MYGPIO_STIMULUS_PINS);
+	assert(config);
+	assert(config->kind <= MYGPIO_STIMULUS_BURST);
+	assert(config->rate > 0);
+	assert(config->kind != MYGPIO_STIMULUS_BURST || (config->burst_rate > 0 && config->burst != 0));
+	assert(config->width_ns != 0);
+	assert(config->bounces == 0 || config->bounce_ns != 0);
+	st->config[pin] = *config;
+	st->pins |= (1U << pin);
+}
+
+/**
+ * @brief Genera i fronti di tutti i pin configurati, per duration_ns nanosecondi.
+ *
+ * @retval 0 in caso di successo
+ * @retval -1 se la memoria non è sufficiente
+ *
+ * @details
+ * I fronti ed i conteggi di una eventuale generazione precedente vengono scartati. Gli impulsi iniziano
+ * tutti prima di duration_ns, ma i loro fronti di discesa possono cadere oltre.
+ */
+int myGPIO_Stimulus_Generate(myGPIO_Stimulus_t *st, uint64_t duration_ns) {
+	uint32_t pin, remaining;
+	int error = 0;
+	assert(st);
+	st->edges = 0;
+	st->generated = st->delivered = st->lost = st->spurious = 0;
+	st->sorted = 0;
+	for (pin = 0; pin < MYGPIO_STIMULUS_PINS; pin++) {
+		const myGPIO_StimulusPin_t *config = &st->config[pin];
+		double t = 0;
+		uint64_t free_at = 0, start, settle, fall;
+		st->pulses[pin].count = st->pulses[pin].next = st->pulses[pin].revivable = 0;
+		if ((st->pins & (1U << pin)) == 0)
+			continue;
+		remaining = 0;
+		if (config->kind == MYGPIO_STIMULUS_PERIODIC)
+			t = (myGPIO_Stimulus_Random(st) % 1000) * NS_PER_S / config->rate / 1000;
+		for (;;) {
+			switch (config->kind) {
+			case MYGPIO_STIMULUS_PERIODIC:
+				t += NS_PER_S / config->rate;
+				break;
+			case MYGPIO_STIMULUS_POISSON:
+				t += myGPIO_Stimulus_Exponential(st, config->rate);
+				break;
+			default:
+				if (remaining == 0) {
+					t += myGPIO_Stimulus_Exponential(st, config->burst_rate);
+					remaining = config->burst;
+				} else {
+					t += myGPIO_Stimulus_Exponential(st, config->rate);
+				}
+				remaining--;
+				break;
+			}
+			if (t >= (double)duration_ns)
+				break;
+			start = (uint64_t)t > free_at ? (uint64_t)t : free_at;
+			settle = myGPIO_Stimulus_Edge(st, pin, start, 1, &error);
+			fall = start + config->width_ns > settle ? start + config->width_ns : settle + 1;
+			settle = myGPIO_Stimulus_Edge(st, pin, fall, 0, &error);
+			error |= myGPIO_Stimulus_AddPulse(&st->pulses[pin], start, settle);
+			free_at = settle + config->width_ns;
+			st->generated++;
+		}
+	}
+	free(st->latency);
+	st->latency = malloc((st->generated != 0 ? st->generated : 1) * sizeof(uint64_t));
+	if (error != 0 || st->latency == NULL)
+		return -1;
+	qsort(st->edge, st->edges, sizeof(myGPIO_StimulusEdge_t), myGPIO_Stimulus_Compare);
+	return 0;
+}
+
+static void myGPIO_Stimulus_Deliver(myGPIO_Stimulus_t *st, myGPIO_StimulusPulses_t *pulses, uint32_t index, uint64_t time) {
+	st->lost += index - pulses->next;
+	st->latency[st->delivered++] = time - pulses->pulse[index].start;
+	st->sorted = 0;
+	pulses->next = index + 1;
+	pulses->revivable = 0;
+}
+
+/**
+ * @brief Segnala che il consumatore ha osservato, leggendo IRQ, un evento sul pin indicato.
+ *
+ * @param[in] time istante in cui il consumatore ha letto IRQ
+ *
+ * @retval 0 se l'osservazione corrisponde ad un impulso
+ * @retval -1 se l'osservazione è spuria
+ */
+int myGPIO_Stimulus_Observe(myGPIO_Stimulus_t *st, uint32_t pin, uint64_t time) {
+	myGPIO_StimulusPulses_t *pulses;
+	uint32_t last;
+	assert(st);
+	assert(pin < MYGPIO_STIMULUS_PINS);
+	pulses = &st->pulses[pin];
+	if (pulses->next == pulses->count || pulses->pulse[pulses->next].start > time) {
+		// un impulso dato per perso, ma in corso alla lettura precedente, ha asserito nuovamente IRQ
+		if (pulses->revivable) {
+			pulses->revivable = 0;
+			st->lost--;
+			st->latency[st->delivered++] = time - pulses->pulse[pulses->next - 1].start;
+			st->sorted = 0;
+			return 0;
+		}
+		st->spurious++;
+		return -1;
+	}
+	for (last = pulses->next + 1; last < pulses->count && pulses->pulse[last].start <= time; last++);
+	myGPIO_Stimulus_Deliver(st, pulses, pulses->next, time);
+	st->lost += last - pulses->next;
+	pulses->revivable = (last > pulses->next && pulses->pulse[last - 1].end >= time);
+	pulses->next = last;
+	return 0;
+}
+
+/**
+ * @brief Segnala che il consumatore ha osservato, leggendo READ, il pin indicato a livello alto.
+ *
+ * @param[in] time istante in cui il consumatore ha letto READ
+ *
+ * @retval 0 se l'osservazione corrisponde ad un impulso
+ * @retval -1 se l'osservazione è spuria
+ */
+int myGPIO_Stimulus_ObserveLevel(myGPIO_Stimulus_t *st, uint32_t pin, uint64_t time) {
+	myGPIO_StimulusPulses_t *pulses;
+	uint32_t index;
+	assert(st);
+	assert(pin < MYGPIO_STIMULUS_PINS);
+	pulses = &st->pulses[pin];
+	for (index = pulses->next; index < pulses->count && pulses->pulse[index].end < time; index++);
+	if (index == pulses->count || pulses->pulse[index].start > time) {
+		st->spurious++;
+		return -1;
+	}
+	myGPIO_Stimulus_Deliver(st, pulses, index, time);
+	return 0;
+}
+
+/**
+ * @brief Conta come persi gli impulsi non ancora osservati; va chiamata al termine della prova.
+ */
+void myGPIO_Stimulus_Finish(myGPIO_Stimulus_t *st) {
+	uint32_t pin;
+	assert(st);
+	for (pin = 0; pin < MYGPIO_STIMULUS_PINS; pin++) {
+		st->lost += st->pulses[pin].count - st->pulses[pin].next;
+		st->pulses[pin].next = st->pulses[pin].count;
+		st->pulses[pin].revivable = 0;
+	}
+}
+
+/**
+ * @brief Restituisce il percentile indicato, tra 0 e 100, delle latenze di consegna; zero se nessun
+ * impulso è stato consegnato.
+ */
+uint64_t myGPIO_Stimulus_Percentile(myGPIO_Stimulus_t *st, double percentile) {
+	uint32_t index;
+	assert(st);
+	assert(percentile >= 0 && percentile <= 100);
+	if (st->delivered == 0)
+		return 0;
+	if (!st->sorted) {
+		qsort(st->latency, st->delivered, sizeof(uint64_t), myGPIO_Stimulus_CompareLatency);
+		st->sorted = 1;
+	}
+	index = (uint32_t)(percentile / 100.0 * (st->delivered - 1) + 0.5);
+	return st->latency[index];
+}
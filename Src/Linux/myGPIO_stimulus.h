@@ -0,0 +1,147 @@
+/**
+ * @file myGPIO_stimulus.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_STIMULUS_HEADER_H
+#define MYGPIO_STIMULUS_HEADER_H
+
+#include <inttypes.h>
+
+/**
+ * @brief Generatore di stimoli per i pin di ingresso di myGPIO, e conteggio degli eventi persi.
+ *
+ * @details
+ * Per ciascun pin viene configurato un processo di arrivo degli impulsi:
+ *  - MYGPIO_STIMULUS_PERIODIC: impulsi equispaziati, rate al secondo, con fase iniziale pseudo-casuale;
+ *  - MYGPIO_STIMULUS_POISSON: arrivi di Poisson, con rate medio al secondo;
+ *  - MYGPIO_STIMULUS_BURST: raffiche di burst impulsi, che arrivano secondo Poisson con burst_rate medio al
+ *    secondo, ed all'interno delle quali gli impulsi arrivano secondo Poisson con rate medio al secondo.
+ * Ciascun impulso porta il pin a livello alto per width_ns; con bounces non nullo, ciascun fronte è seguito
+ * da un numero pseudo-casuale, fino a bounces, di coppie di rimbalzi, distanziati al più bounce_ns, come
+ * avviene per un pulsante. Un impulso che arriva mentre il pin è ancora impegnato dal precedente viene
+ * ritardato, per cui i pin tornano sempre a riposo tra un impulso e l'altro.
+ *
+ * myGPIO_Stimulus_Generate() produce, per una durata assegnata, la sequenza dei fronti di tutti i pin,
+ * ordinata nel tempo, che può essere applicata al modello con myGPIO_Sim_SchedulePins(), oppure in tempo
+ * reale al ponte GHDL o al device QEMU. Il consumatore segnala ogni evento che osserva su un pin:
+ *  - con myGPIO_Stimulus_Observe(), se lo ha ricavato da IRQ, che memorizza gli impulsi fino all'ack:
+ *    l'impulso non ancora osservato più vecchio, tra quelli già iniziati, viene considerato consegnato, e
+ *    la latenza di consegna viene calcolata dal suo fronte di salita; gli altri impulsi già iniziati sullo
+ *    stesso pin vengono considerati persi, perché confusi col primo. Se però l'ultimo di essi era ancora in
+ *    corso, e l'osservazione successiva non trova alcun impulso nuovo, essa viene attribuita a quest'ultimo,
+ *    dal momento che IRQ viene nuovamente asserito se il pin è ancora alto quando IACK, dopo l'ack, viene
+ *    azzerato dalla scrittura successiva sul device;
+ *  - con myGPIO_Stimulus_ObserveLevel(), se lo ha ricavato dal livello del pin, letto da READ: viene
+ *    considerato consegnato l'impulso in corso, e persi quelli precedenti non ancora osservati.
+ * Un'osservazione che non corrisponde ad alcun impulso viene contata come spuria, come avviene per i
+ * rimbalzi o per le interruzioni ripetute mentre un pin resta alto.
+ * A parità di seme e di configurazione, la sequenza generata è sempre la stessa.
+ *
+ * @code
+ * myGPIO_Stimulus_t st;
+ * myGPIO_StimulusPin_t cfg = { .kind = MYGPIO_STIMULUS_POISSON, .rate = 5000, .width_ns = 2000 };
+ * myGPIO_Stimulus_Init(&st, 1);
+ * myGPIO_Stimulus_SetPin(&st, 0, &cfg);
+ * myGPIO_Stimulus_Generate(&st, 1000000000ULL);
+ * for (i = 0; i < st.edges; i++)
+ *     myGPIO_Sim_SchedulePins(&sim, st.edge[i].time, MYGPIO_PIN(st.edge[i].pin), st.edge[i].level ? ~0U : 0);
+ * ...
+ * myGPIO_Stimulus_Observe(&st, pin, now);   // dal consumatore
+ * ...
+ * myGPIO_Stimulus_Finish(&st);
+ * printf("%u/%u, p99 %" PRIu64 " ns\n", st.delivered, st.generated, myGPIO_Stimulus_Percentile(&st, 99));
+ * @endcode
+ */
+
+#define MYGPIO_STIMULUS_PERIODIC 0
+#define MYGPIO_STIMULUS_POISSON  1
+#define MYGPIO_STIMULUS_BURST    2
+
+#define MYGPIO_STIMULUS_PINS     32
+
+/**
+ * @brief Configurazione degli stimoli di un pin.
+ */
+typedef struct {
+	uint32_t kind;        //!< processo di arrivo, MYGPIO_STIMULUS_PERIODIC, POISSON o BURST
+	double   rate;        //!< impulsi al secondo; per BURST, all'interno delle raffiche
+	double   burst_rate;  //!< raffiche al secondo, per BURST
+	uint32_t burst;       //!< impulsi per raffica, per BURST
+	uint32_t width_ns;    //!< durata del livello alto, e minima durata del riposo tra due impulsi
+	uint32_t bounces;     //!< massimo numero di coppie di rimbalzi per fronte, zero per fronti puliti
+	uint32_t bounce_ns;   //!< massima distanza tra due rimbalzi
+} myGPIO_StimulusPin_t;
+
+/**
+ * @brief Fronte di un pin.
+ */
+typedef struct {
+	uint64_t time;   //!< istante, in ns
+	uint32_t pin;    //!< indice del pin
+	uint32_t level;  //!< livello assunto dal pin
+} myGPIO_StimulusEdge_t;
+
+/**
+ * @brief Impulso generato su un pin.
+ */
+typedef struct {
+	uint64_t start;  //!< istante del fronte di salita
+	uint64_t end;    //!< istante in cui il pin si assesta a riposo, dopo il fronte di discesa
+} myGPIO_StimulusPulse_t;
+
+/**
+ * @brief Impulsi di un pin, nell'ordine in cui sono stati generati.
+ */
+typedef struct {
+	myGPIO_StimulusPulse_t *pulse;     //!< impulsi generati
+	uint32_t                count;     //!< impulsi generati
+	uint32_t                capacity;  //!< dimensione allocata
+	uint32_t                next;      //!< primo impulso non ancora osservato né perso
+	uint32_t                revivable; //!< vero se l'impulso next-1 è stato dato per perso mentre era in corso
+} myGPIO_StimulusPulses_t;
+
+typedef struct {
+	myGPIO_StimulusPin_t    config[MYGPIO_STIMULUS_PINS];  //!< configurazione dei pin
+	uint32_t                pins;        //!< maschera dei pin configurati
+	uint32_t                seed;        //!< stato del generatore pseudo-casuale
+	myGPIO_StimulusEdge_t  *edge;        //!< fronti generati, ordinati nel tempo
+	uint32_t                edges;       //!< numero di fronti generati
+	uint32_t                capacity;    //!< dimensione allocata per i fronti
+	myGPIO_StimulusPulses_t pulses[MYGPIO_STIMULUS_PINS];  //!< impulsi generati, per pin
+	uint64_t               *latency;     //!< latenze di consegna, in ns
+	uint32_t                generated;   //!< impulsi generati
+	uint32_t                delivered;   //!< impulsi consegnati
+	uint32_t                lost;        //!< impulsi persi
+	uint32_t                spurious;    //!< osservazioni senza impulso corrispondente
+	int                     sorted;      //!< vero se latency è ordinato
+} myGPIO_Stimulus_t;
+
+void     myGPIO_Stimulus_Init        (myGPIO_Stimulus_t *st, uint32_t seed);
+void     myGPIO_Stimulus_Destroy     (myGPIO_Stimulus_t *st);
+void     myGPIO_Stimulus_SetPin      (myGPIO_Stimulus_t *st, uint32_t pin, const myGPIO_StimulusPin_t *config);
+int      myGPIO_Stimulus_Generate    (myGPIO_Stimulus_t *st, uint64_t duration_ns);
+int      myGPIO_Stimulus_Observe     (myGPIO_Stimulus_t *st, uint32_t pin, uint64_t time);
+int      myGPIO_Stimulus_ObserveLevel(myGPIO_Stimulus_t *st, uint32_t pin, uint64_t time);
+void     myGPIO_Stimulus_Finish      (myGPIO_Stimulus_t *st);
+uint64_t myGPIO_Stimulus_Percentile(myGPIO_Stimulus_t *st, double percentile);
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file myGPIO_tracefile.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "myGPIO_tracefile.h"
+
+
+static int myGPIO_TraceFile_Write(int descriptor, const void *data, size_t size) {
+	const char *p = data;
+	ssize_t n;
+	while (size != 0) {
+		if ((n = write(descriptor, p, size)) <= 0)
+			return -1;
+		p += n;
+		size -= n;
+	}
+	return 0;
+}
+
+/**
+ * @brief Salva su file il contenuto del buffer di registrazione, in ordine cronologico.
+ *
+ * @param[in] path  file da creare o sovrascrivere;
+ *
+ * @retval 0 se il salvataggio ha successo
+ * @retval -1 altrimenti
+ *
+ * @note Fa uso delle sole open(), write() e close(), per cui può essere chiamata da un signal handler.
+ */
+int myGPIO_TraceFile_Save(const char *path) {
+	myGPIO_TraceFile_t header;
+	uint32_t count = myGPIO_Trace_Count(), first, i;
+	int descriptor, error;
+	memset(&header, 0, sizeof(header));
+	header.magic = MYGPIO_TRACEFILE_MAGIC;
+	header.version = MYGPIO_TRACEFILE_VERSION;
+	header.records = count;
+	header.devices = myGPIO_TraceLog.devices;
+	header.dropped = myGPIO_Trace_Dropped();
+	for (i = 0; i < myGPIO_TraceLog.devices; i++)
+		header.device[i] = (uint64_t)(uintptr_t)myGPIO_TraceLog.device[i];
+	if ((descriptor = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+		return -1;
+	error = myGPIO_TraceFile_Write(descriptor, &header, sizeof(header));
+	if (count != 0) {
+		// il buffer, se è stato riempito, va letto a partire dall'elemento più vecchio
+		first = (uint32_t)(header.dropped & myGPIO_TraceLog.mask);
+		if (first + count > myGPIO_TraceLog.mask + 1) {
+			error |= myGPIO_TraceFile_Write(descriptor, &myGPIO_TraceLog.ring[first],
+					(myGPIO_TraceLog.mask + 1 - first) * sizeof(myGPIO_TraceRecord_t));
+			count -= myGPIO_TraceLog.mask + 1 - first;
+			first = 0;
+		}
+		error |= myGPIO_TraceFile_Write(descriptor, &myGPIO_TraceLog.ring[first], count * sizeof(myGPIO_TraceRecord_t));
+	}
+	return (close(descriptor) != 0 || error != 0) ? -1 : 0;
+}
+
+/**
+ * @brief Carica una registrazione salvata con myGPIO_TraceFile_Save().
+ *
+ * @param[in]  path    file da caricare;
+ * @param[out] header  intestazione del file;
+ * @param[out] record  elementi della registrazione, allocati con malloc(), da liberare con free();
+ *
+ * @retval 0 se il caricamento ha successo
+ * @retval -1 se il file non può essere letto o non è una registrazione valida
+ */
+int myGPIO_TraceFile_Load(const char *path, myGPIO_TraceFile_t *header, myGPIO_TraceRecord_t **record) {
+	FILE *file;
+	int error = -1;
+	*record = NULL;
+	if ((file = fopen(path, "rb")) == NULL)
+		return -1;
+	if (fread(header, sizeof(*header), 1, file) == 1 && header->magic == MYGPIO_TRACEFILE_MAGIC &&
+			header->version == MYGPIO_TRACEFILE_VERSION && header->devices <= MYGPIO_TRACE_MAX_DEVICES &&
+			(*record = malloc((header->records != 0 ? header->records : 1) * sizeof(myGPIO_TraceRecord_t))) != NULL &&
+			fread(*record, sizeof(myGPIO_TraceRecord_t), header->records, file) == header->records)
+		error = 0;
+	fclose(file);
+	if (error != 0) {
+		free(*record);
+		*record = NULL;
+	}
+	return error;
+}
+
+#ifdef MYGPIO_TRACE
+
+static const char *myGPIO_TraceFile_Path = NULL;  //!< file in cui salvare la registrazione automatica
+
+static void myGPIO_TraceFile_Exit(void) {
+	myGPIO_Trace_Stop();
+	if (myGPIO_TraceFile_Save(myGPIO_TraceFile_Path) != 0)
+		perror(myGPIO_TraceFile_Path);
+}
+
+static void myGPIO_TraceFile_Signal(int sig) {
+	myGPIO_Trace_Stop();
+	myGPIO_TraceFile_Save(myGPIO_TraceFile_Path);
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+
+/**
+ * @brief Avvia la registrazione automatica, se richiesta con la variabile d'ambiente MYGPIO_TRACE_FILE.
+ */
+static void __attribute__((constructor)) myGPIO_TraceFile_Start(void) {
+	const char *size = getenv("MYGPIO_TRACE_SIZE");
+	myGPIO_TraceRecord_t *ring;
+	uint32_t capacity = 1;
+	unsigned long requested = (size != NULL ? strtoul(size, NULL, 0) : MYGPIO_TRACEFILE_SIZE);
+	if ((myGPIO_TraceFile_Path = getenv("MYGPIO_TRACE_FILE")) == NULL)
+		return;
+	while (capacity < requested && capacity < (1U << 26))
+		capacity <<= 1;
+	if ((ring = malloc(capacity * sizeof(myGPIO_TraceRecord_t))) == NULL) {
+		fprintf(stderr, "myGPIO_trace: memoria insufficiente per %u accessi\n", capacity);
+		return;
+	}
+	myGPIO_Trace_Init(ring, capacity);
+	atexit(myGPIO_TraceFile_Exit);
+	signal(SIGINT, myGPIO_TraceFile_Signal);
+	signal(SIGTERM, myGPIO_TraceFile_Signal);
+	myGPIO_Trace_Start();
+}
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file myGPIO_tracefile.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+#ifndef MYGPIO_TRACEFILE_HEADER_H
+#define MYGPIO_TRACEFILE_HEADER_H
+
+#include <inttypes.h>
+#include "myGPIO.h"
+#include "myGPIO_trace.h"
+
+/**
+ * @brief Salvataggio su file degli accessi ai registri registrati con myGPIO_trace.h.
+ *
+ * @details
+ * Il file contiene l'intestazione myGPIO_TraceFile_t, seguita dagli elementi myGPIO_TraceRecord_t in ordine
+ * cronologico, entrambi nella rappresentazione della macchina che li ha registrati (little endian sia su
+ * Zynq che sull'host).
+ *
+ * Un programma compilato con MYGPIO_TRACE definito e collegato a myGPIO_tracefile.o, anch'esso compilato con
+ * MYGPIO_TRACE definito, registra i propri accessi senza alcuna modifica: se la variabile d'ambiente
+ * MYGPIO_TRACE_FILE è definita, all'avvio viene allocato un buffer di MYGPIO_TRACE_SIZE elementi (di default
+ * MYGPIO_TRACEFILE_SIZE, arrotondati alla potenza di due successiva) e la registrazione viene avviata; il
+ * buffer viene salvato nel file indicato all'uscita dal programma, o alla ricezione di SIGINT o SIGTERM,
+ * dopodiché il segnale viene riconsegnato.
+ *
+ * @code
+ * $ make noDriver-trace
+ * $ MYGPIO_TRACE_FILE=/tmp/noDriver.trace ./noDriver-trace -a 0x43c00000 -m 0xf -w 5
+ * $ ./trace_replay /tmp/noDriver.trace
+ * @endcode
+ */
+
+#define MYGPIO_TRACEFILE_MAGIC   0x5254476DU  //!< "mGTR"
+#define MYGPIO_TRACEFILE_VERSION 1U
+#define MYGPIO_TRACEFILE_SIZE    (1U << 20)   //!< dimensione di default del buffer, in elementi
+
+typedef struct {
+	uint32_t magic;                             //!< MYGPIO_TRACEFILE_MAGIC
+	uint32_t version;                           //!< MYGPIO_TRACEFILE_VERSION
+	uint32_t records;                           //!< numero di elementi che seguono l'intestazione
+	uint32_t devices;                           //!< numero di device incontrati
+	uint64_t dropped;                           //!< accessi sovrascritti, precedenti al primo elemento
+	uint64_t device[MYGPIO_TRACE_MAX_DEVICES];  //!< indirizzo virtuale di ciascun device incontrato
+} myGPIO_TraceFile_t;
+
+int myGPIO_TraceFile_Save(const char *path);
+int myGPIO_TraceFile_Load(const char *path, myGPIO_TraceFile_t *header, myGPIO_TraceRecord_t **record);
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file mygpiok_stress.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example mygpiok_stress.c
+ * Il file mygpiok_stress.c contiene un programma di prova del modulo kernel myGPIOK, da eseguire sul
+ * sistema, reale o emulato con il device QEMU di Src/QEMU/mygpio.c, in cui il modulo è caricato.
+ * Il programma configura i pin indicati come ingressi ed effettua ripetutamente letture bloccanti del
+ * registro READ, eventualmente precedute da una poll(), contando le interruzioni servite. Al termine
+ * riporta il numero di letture completate, il numero di letture al secondo ed il tempo medio e massimo
+ * trascorso in attesa. Durante l'esecuzione, le interruzioni vengono generate dall'esterno, ad esempio
+ * con qemu_ctl -l, che riporta le latenze misurate dal device.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <inttypes.h>
+
+#define MODE_OFFSET	  0U
+#define READ_OFFSET		8U
+
+void howto(void) {
+	printf("Uso:\n");
+	printf("mygpiok_stress -d /dev/myGPIOKx [-i mask] [-n count] [-p]\n");
+	printf("\t-i mask: pin da configurare come ingressi (default 0x1)\n");
+	printf("\t-n count: numero di letture bloccanti da effettuare (default 1000)\n");
+	printf("\t-p: attende con poll() prima di ciascuna lettura\n");
+}
+
+static uint64_t now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+	const char *devfile = NULL;
+	uint32_t inputs = 0x1, mode, value;
+	unsigned long count = 1000, done;
+	uint64_t start, begin, wait, max = 0, total;
+	int use_poll = 0, descriptor, par;
+	struct pollfd pfd;
+
+	while((par = getopt(argc, argv, "d:i:n:p")) != -1) {
+		switch (par) {
+		case 'd' :
+			devfile = optarg;
+			break;
+		case 'i' :
+			inputs = strtoul(optarg, NULL, 0);
+			break;
+		case 'n' :
+			count = strtoul(optarg, NULL, 0);
+			break;
+		case 'p' :
+			use_poll = 1;
+			break;
+		default :
+			howto();
+			return -1;
+		}
+	}
+	if (devfile == NULL) {
+		howto();
+		return -1;
+	}
+	if ((descriptor = open(devfile, O_RDWR)) < 0) {
+		perror(devfile);
+		return -1;
+	}
+
+	mode = ~inputs;
+	pwrite(descriptor, &mode, sizeof(uint32_t), MODE_OFFSET);
+	pfd.fd = descriptor;
+	pfd.events = POLLIN;
+
+	start = now_ns();
+	for (done = 0; done < count; done++) {
+		begin = now_ns();
+		if (use_poll && poll(&pfd, 1, -1) != 1) {
+			perror("poll");
+			break;
+		}
+		if (pread(descriptor, &value, sizeof(uint32_t), READ_OFFSET) != sizeof(uint32_t)) {
+			perror("read");
+			break;
+		}
+		wait = now_ns() - begin;
+		if (wait > max)
+			max = wait;
+	}
+	total = now_ns() - start;
+	close(descriptor);
+
+	printf("letture: %lu/%lu, %.1f letture/s, attesa media %.1f us, massima %.1f us\n",
+			done, count, total != 0 ? done * 1e9 / total : 0.0,
+			done != 0 ? total / 1e3 / done : 0.0, max / 1e3);
+	return done == count ? 0 : -1;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file qemu_ctl.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example qemu_ctl.c
+ * Il file qemu_ctl.c contiene un programma di controllo del device QEMU di Src/QEMU/mygpio.c, che comunica
+ * col device attraverso il socket indicato nell'opzione -chardev di QEMU. Consente di imporre lo stimolo
+ * esterno sui pin, di leggerne lo stato e di leggere le latenze misurate dal device. Con l'opzione -l genera
+ * una sequenza di impulsi: ciascun impulso viene rilasciato quando il gestore dell'interruzione di myGPIOK
+ * ha disabilitato gli interrupt del device, ed il successivo viene generato solo dopo che myGPIOK_read() ha
+ * riconosciuto l'interruzione. In questo modo viene sollecitato il percorso irq_handler, wakeup e read del
+ * modulo, mentre sul sistema emulato è in esecuzione, ad esempio, mygpiok_stress.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define QEMU_CTL_SOCKET  "/tmp/mygpio.sock"
+#define QEMU_CTL_POLL_US 100     //!< intervallo tra due interrogazioni del device durante un impulso
+#define QEMU_CTL_TIMEOUT 20000   //!< numero massimo di interrogazioni per ciascuna fase di un impulso
+
+static FILE *device = NULL;
+
+void howto(void) {
+	printf("Uso:\n");
+	printf("qemu_ctl [-S socket] [-s mask] [-c mask] [-p] [-t] [-z] [-l count -n mask]\n");
+	printf("\t-S socket: socket del chardev del device (default %s)\n", QEMU_CTL_SOCKET);
+	printf("\t-s mask: porta a livello alto lo stimolo esterno sui pin indicati da mask\n");
+	printf("\t-c mask: porta a livello basso lo stimolo esterno sui pin indicati da mask\n");
+	printf("\t-p: stampa lo stato del device\n");
+	printf("\t-t: stampa le latenze misurate dal device\n");
+	printf("\t-z: azzera le latenze misurate dal device\n");
+	printf("\t-l count: genera count impulsi sui pin indicati con -n, che deve precederla\n");
+	printf("Le opzioni vengono eseguite nell'ordine in cui sono indicate.\n");
+}
+
+/**
+ * @brief Invia una richiesta al device e ne restituisce la risposta in reply.
+ */
+static int request(const char *line, char *reply, size_t size) {
+	fprintf(device, "%s\n", line);
+	fflush(device);
+	if (fgets(reply, size, device) == NULL)
+		return -1;
+	return strncmp(reply, "error", 5) == 0 ? -1 : 0;
+}
+
+static int set_pins(uint32_t mask, uint32_t value) {
+	char line[64], reply[256];
+	snprintf(line, sizeof(line), "set 0x%08x 0x%08x", mask, value);
+	return request(line, reply, sizeof(reply));
+}
+
+/**
+ * @brief Attende che la linea di interrupt e, se ack è non nullo, IRQ siano a zero.
+ */
+static int wait_idle(int ack) {
+	char reply[256];
+	unsigned pins, irq, line, i;
+	for (i = 0; i < QEMU_CTL_TIMEOUT; i++) {
+		if (request("get", reply, sizeof(reply)) != 0 ||
+				sscanf(reply, "pins %x irq %x line %u", &pins, &irq, &line) != 3)
+			return -1;
+		if (line == 0 && (!ack || irq == 0))
+			return 0;
+		usleep(QEMU_CTL_POLL_US);
+	}
+	return -1;
+}
+
+/**
+ * @brief Genera count impulsi sui pin indicati da mask.
+ */
+static int pulses(unsigned long count, uint32_t mask) {
+	unsigned long i;
+	for (i = 0; i < count; i++) {
+		if (set_pins(mask, mask) != 0)
+			return -1;
+		// la linea scende quando myGPIOK_irq_handler() disabilita gli interrupt del device
+		usleep(QEMU_CTL_POLL_US);
+		if (wait_idle(0) != 0)
+			break;
+		// myGPIOK_read() riconosce l'interruzione solo dopo che i pin sono tornati a zero
+		if (set_pins(mask, 0) != 0 || wait_idle(1) != 0)
+			break;
+	}
+	printf("impulsi: %lu/%lu\n", i, count);
+	return i == count ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+	const char *path = QEMU_CTL_SOCKET;
+	struct sockaddr_un address;
+	char reply[256];
+	uint32_t mask = 0;
+	int par, descriptor, result = 0;
+
+	if (argc == 1) {
+		howto();
+		return 0;
+	}
+	// il socket va aperto prima di eseguire le altre opzioni
+	while((par = getopt(argc, argv, "S:s:c:ptzl:n:")) != -1)
+		if (par == 'S')
+			path = optarg;
+	optind = 1;
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+	if ((descriptor = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+			connect(descriptor, (struct sockaddr *)&address, sizeof(address)) != 0) {
+		perror(path);
+		return -1;
+	}
+	device = fdopen(descriptor, "r+");
+
+	while(result == 0 && (par = getopt(argc, argv, "S:s:c:ptzl:n:")) != -1) {
+		switch (par) {
+		case 'S' :
+			break;
+		case 's' :
+			result = set_pins(strtoul(optarg, NULL, 0), 0xFFFFFFFFU);
+			break;
+		case 'c' :
+			result = set_pins(strtoul(optarg, NULL, 0), 0);
+			break;
+		case 'p' :
+			if ((result = request("get", reply, sizeof(reply))) == 0)
+				printf("%s", reply);
+			break;
+		case 't' :
+			if ((result = request("stats", reply, sizeof(reply))) == 0)
+				printf("%s", reply);
+			break;
+		case 'z' :
+			result = request("clear", reply, sizeof(reply));
+			break;
+		case 'n' :
+			mask = strtoul(optarg, NULL, 0);
+			break;
+		case 'l' :
+			result = (mask == 0 ? -1 : pulses(strtoul(optarg, NULL, 0), mask));
+			break;
+		default :
+			howto();
+			result = -1;
+		}
+	}
+	fclose(device);
+	return result;
+}
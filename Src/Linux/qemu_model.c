@@ -0,0 +1,336 @@
+/**
+ * @file qemu_model.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example qemu_model.c
+ * Il file qemu_model.c contiene un sostituto del device QEMU di Src/QEMU/mygpio.c, per l'esecuzione di
+ * qemu_ctl e load_gen in assenza di QEMU. Il programma serve, sul socket indicato, il protocollo del chardev
+ * descritto in mygpio.h, con le stesse risposte e le stesse statistiche; i registri sono quelli del modello
+ * di myGPIO_model.h ed il tempo è quello reale, anziché quello virtuale di QEMU.
+ * Al posto del sistema emulato, un thread riproduce la sequenza di accessi di myGPIOK, con mygpiok_stress in
+ * attesa sul device: alla salita della linea di interrupt, come myGPIOK_irq_handler(), disabilita le
+ * interruzioni e risveglia il lettore; questo, come myGPIOK_read(), legge READ, attende che i pin tornino a
+ * zero, invia l'ack e riabilita le interruzioni. Al termine, con SIGINT o SIGTERM, viene riportato il numero
+ * di letture servite.
+ * @code
+ * $ ./qemu_model -S /tmp/mygpio.sock -i 0x1 &
+ * $ ./load_gen -t qemu -S /tmp/mygpio.sock -r 200 -d 2000
+ * @endcode
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_model.h"
+
+#define QEMU_MODEL_SOCKET  "/tmp/mygpio.sock"
+#define QEMU_MODEL_LINE    128    //!< lunghezza massima di una richiesta, come MYGPIO_LINE_LENGTH
+#define QEMU_MODEL_POLL_NS 10000  //!< intervallo tra due letture di READ durante l'attesa del rilascio
+#define QEMU_MODEL_ACKS    1024   //!< voci del registro degli ack, come MYGPIO_ACKS
+
+/**
+ * @brief Statistiche di una delle latenze misurate, come MyGPIOLatency in mygpio.h.
+ */
+typedef struct {
+	uint64_t count;  //!< numero di misure
+	int64_t  sum;    //!< somma delle misure, in ns
+	int64_t  max;    //!< misura massima, in ns
+} latency_t;
+
+/**
+ * @brief Voce del registro degli ack, come MyGPIOAck in mygpio.h.
+ */
+typedef struct {
+	int64_t  time;   //!< istante della scrittura di IACK, in ns
+	uint32_t mask;   //!< bit pendenti riconosciuti
+} ack_t;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  raised_cond = PTHREAD_COND_INITIALIZER;
+static volatile sig_atomic_t stopped = 0;
+
+static myGPIO_Model_t model;
+static myGPIO_t       gpio;
+static int64_t        start;
+static int64_t        raised = -1;  //!< tempo dell'ultima salita della linea, -1 se già riconosciuta
+static int            handled;      //!< la linea è scesa dopo l'ultima salita
+static int            woken;        //!< READ è stato letto dopo la discesa della linea
+static int            by_write;     //!< vero durante una scrittura della CPU
+static uint64_t       interrupts;
+static latency_t      isr, wakeup, ack;
+static ack_t          acked[QEMU_MODEL_ACKS];  //!< registro circolare degli ack
+static uint32_t       logged;       //!< ack registrati
+static uint32_t       fetched;      //!< ack prelevati con "acks"
+static unsigned long  served;       //!< letture servite dal thread che sostituisce il sistema emulato
+
+static int64_t now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec - start;
+}
+
+static void latency(latency_t *l, int64_t value) {
+	l->count++;
+	l->sum += value;
+	if (value > l->max)
+		l->max = value;
+}
+
+static int64_t mean(const latency_t *l) {
+	return l->count != 0 ? l->sum / (int64_t)l->count : 0;
+}
+
+/**
+ * @brief Notifica della linea di interrupt del modello: aggiorna le statistiche come mygpio_update().
+ */
+static void line_changed(myGPIO_Model_t *m, uint32_t level, void *arg) {
+	(void)m;
+	(void)arg;
+	if (level) {
+		interrupts++;
+		raised = now_ns();
+		handled = 0;
+		woken = 0;
+		pthread_cond_broadcast(&raised_cond);
+	} else if (by_write && raised >= 0 && !handled) {
+		handled = 1;
+		latency(&isr, now_ns() - raised);
+	}
+}
+
+/**
+ * @brief Lettura di un registro da parte della CPU, come mygpio_read(); va chiamata con lock acquisito.
+ */
+static uint32_t device_read(uint32_t reg) {
+	if (reg == READ_REG && handled && !woken) {
+		woken = 1;
+		latency(&wakeup, now_ns() - raised);
+	}
+	return myGPIO_BackendRead(gpio, reg);
+}
+
+/**
+ * @brief Scrittura di un registro da parte della CPU, come mygpio_write(); va chiamata con lock acquisito.
+ */
+static void device_write(uint32_t reg, uint32_t value) {
+	if (reg == IACK_REG && raised >= 0 && (model.irq & value) != 0) {
+		latency(&ack, now_ns() - raised);
+		raised = -1;
+	}
+	if (reg == IACK_REG && (model.irq & value) != 0) {
+		acked[logged % QEMU_MODEL_ACKS].time = now_ns();
+		acked[logged % QEMU_MODEL_ACKS].mask = model.irq & value;
+		logged++;
+	}
+	by_write = 1;
+	myGPIO_BackendWrite(gpio, reg, value);
+	by_write = 0;
+}
+
+/**
+ * @brief Sostituto del sistema emulato: la sequenza di accessi di myGPIOK_irq_handler() e myGPIOK_read().
+ */
+static void *guest(void *arg) {
+	uint32_t inputs = *(uint32_t*)arg;
+	struct timespec poll = {0, QEMU_MODEL_POLL_NS};
+	pthread_mutex_lock(&lock);
+	device_write(MODE_REG, device_read(MODE_REG) & ~inputs);
+	device_write(PIE_REG, device_read(PIE_REG) | inputs);
+	device_write(GIES_REG, 1);
+	while (!stopped) {
+		if (!model.line) {
+			pthread_cond_wait(&raised_cond, &lock);
+			continue;
+		}
+		// myGPIOK_irq_handler()
+		device_write(GIES_REG, 0);
+		device_write(PIE_REG, device_read(PIE_REG) & ~inputs);
+		pthread_mutex_unlock(&lock);
+		// myGPIOK_read(), al risveglio
+		pthread_mutex_lock(&lock);
+		device_read(READ_REG);
+		while (!stopped && device_read(READ_REG) != 0) {
+			pthread_mutex_unlock(&lock);
+			nanosleep(&poll, NULL);
+			pthread_mutex_lock(&lock);
+		}
+		device_write(IACK_REG, inputs);
+		device_write(GIES_REG, 1);
+		device_write(PIE_REG, device_read(PIE_REG) | inputs);
+		served++;
+	}
+	pthread_mutex_unlock(&lock);
+	return NULL;
+}
+
+/**
+ * @brief Serve una richiesta ricevuta dal socket, come mygpio_request().
+ */
+static void request(FILE *client, char *line) {
+	char reply[QEMU_MODEL_LINE * 2];
+	char *command = strtok(line, " \t\r\n");
+	char *mask, *value;
+	if (command == NULL)
+		return;
+	pthread_mutex_lock(&lock);
+	if (strcmp(command, "set") == 0 && (mask = strtok(NULL, " \t\r\n")) && (value = strtok(NULL, " \t\r\n"))) {
+		uint32_t m = strtoul(mask, NULL, 0);
+		myGPIO_Model_SetPins(&model, m, strtoul(value, NULL, 0));
+		snprintf(reply, sizeof(reply), "ok %" PRId64 "\n", now_ns());
+	} else if (strcmp(command, "get") == 0) {
+		snprintf(reply, sizeof(reply), "pins 0x%08x irq 0x%08x line %u ns %" PRId64 "\n",
+				myGPIO_Model_GetPins(&model), model.irq, model.line, now_ns());
+	} else if (strcmp(command, "stats") == 0) {
+		snprintf(reply, sizeof(reply), "interrupts %" PRIu64 " acked %" PRIu64 " isr %" PRId64 " %" PRId64
+				" wakeup %" PRId64 " %" PRId64 " ack %" PRId64 " %" PRId64 "\n", interrupts, ack.count,
+				mean(&isr), isr.max, mean(&wakeup), wakeup.max, mean(&ack), ack.max);
+	} else if (strcmp(command, "acks") == 0) {
+		uint32_t overwritten = 0;
+		if (logged - fetched > QEMU_MODEL_ACKS) {
+			overwritten = logged - fetched - QEMU_MODEL_ACKS;
+			fetched = logged - QEMU_MODEL_ACKS;
+		}
+		for (; fetched != logged; fetched++)
+			fprintf(client, "ack %" PRId64 " 0x%08x\n", acked[fetched % QEMU_MODEL_ACKS].time,
+					acked[fetched % QEMU_MODEL_ACKS].mask);
+		snprintf(reply, sizeof(reply), "end %u\n", overwritten);
+	} else if (strcmp(command, "clear") == 0) {
+		logged = 0;
+		fetched = 0;
+		interrupts = 0;
+		memset(&isr, 0, sizeof(isr));
+		memset(&wakeup, 0, sizeof(wakeup));
+		memset(&ack, 0, sizeof(ack));
+		snprintf(reply, sizeof(reply), "ok %" PRId64 "\n", now_ns());
+	} else {
+		snprintf(reply, sizeof(reply), "error\n");
+	}
+	pthread_mutex_unlock(&lock);
+	fputs(reply, client);
+	fflush(client);
+}
+
+static void stop(int signal) {
+	(void)signal;
+	stopped = 1;
+}
+
+void howto(void) {
+	printf("Uso:\n");
+	printf("qemu_model [-S socket] [-w width] [-i mask]\n");
+	printf("\t-S socket: socket su cui servire il protocollo del chardev (default %s)\n", QEMU_MODEL_SOCKET);
+	printf("\t-w width: numero di pin del device (default 32)\n");
+	printf("\t-i mask: pin serviti dal sostituto di myGPIOK; zero per nessuno (default 0x1)\n");
+}
+
+int main(int argc, char **argv) {
+	const char *path = QEMU_MODEL_SOCKET;
+	uint32_t width = 32, inputs = 0x1;
+	struct sockaddr_un address;
+	struct sigaction action;
+	struct timespec ts;
+	char line[QEMU_MODEL_LINE];
+	pthread_t thread;
+	FILE *client;
+	int server, descriptor, par;
+
+	while((par = getopt(argc, argv, "S:w:i:h")) != -1) {
+		switch (par) {
+		case 'S' :
+			path = optarg;
+			break;
+		case 'w' :
+			width = strtoul(optarg, NULL, 0);
+			break;
+		case 'i' :
+			inputs = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			howto();
+			return -1;
+		}
+	}
+	if (width == 0 || width > 32) {
+		howto();
+		return -1;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	start = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+	myGPIO_Model_Init(&model, width);
+	myGPIO_Model_SetInterrupt(&model, line_changed, NULL);
+	gpio = myGPIO_Model_Gpio(&model);
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+	unlink(path);
+	if ((server = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+			bind(server, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(server, 1) != 0) {
+		perror(path);
+		return -1;
+	}
+
+	// senza SA_RESTART, in modo che accept() e fgets() vengano interrotte dal segnale
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = stop;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	if (inputs != 0 && pthread_create(&thread, NULL, guest, &inputs) != 0) {
+		printf("impossibile avviare il sostituto di myGPIOK\n");
+		return -1;
+	}
+	printf("qemu_model: socket %s pronto, %u pin\n", path, width);
+	fflush(stdout);
+
+	while (!stopped) {
+		if ((descriptor = accept(server, NULL, NULL)) < 0) {
+			if (errno != EINTR)
+				perror("accept");
+			continue;
+		}
+		client = fdopen(descriptor, "r+");
+		while (!stopped && fgets(line, sizeof(line), client) != NULL)
+			request(client, line);
+		fclose(client);
+	}
+
+	if (inputs != 0) {
+		pthread_mutex_lock(&lock);
+		pthread_cond_broadcast(&raised_cond);
+		pthread_mutex_unlock(&lock);
+		pthread_join(thread, NULL);
+	}
+	close(server);
+	unlink(path);
+	printf("letture servite: %lu\n", served);
+	return 0;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file sim_capture.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example sim_capture.c
+ * Il file sim_capture.c contiene una simulazione, eseguibile sull'host, dell'acquisizione con codifica
+ * run-length definita in myGPIO_capture.h. Il driver viene compilato con MYGPIO_BACKEND definito, e le
+ * letture del registro READ restituiscono, una dopo l'altra, i campioni di una traccia sintetica generata in
+ * memoria: una linea seriale inattiva attraversata da un burst di caratteri, un'onda quadra lenta, un bus a
+ * 8 bit aggiornato ogni 16 campioni e rumore che cambia ad ogni campione, il caso peggiore.
+ * Per ciascuna traccia vengono riportati i campioni acquisiti al secondo, che sull'host misurano il costo
+ * del ciclo di acquisizione e non quello del bus, il numero di run memorizzati ed il rapporto di
+ * compressione, cioè il rapporto tra la memoria che occuperebbero i campioni grezzi e quella occupata dai
+ * run. Viene verificato che il trigger scatti sul campione atteso, che i run, espansi, riproducano la
+ * traccia, e che dopo il trigger vengano conservati i post campioni richiesti, oppure, se il buffer si
+ * riempie prima, almeno i capacity - pre run riservati. Un buffer di 16 run, con la traccia del bus che
+ * cambia ogni 16 campioni, verifica che la storia che precede il trigger non occupi tutto il buffer, sia
+ * con la riserva di default che con pre impostato a 2.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_capture.h"
+#include "bench.h"
+
+/**
+ * @brief Modello del device: il registro READ restituisce i campioni della traccia, in sequenza.
+ */
+static struct {
+	uint32_t  reg[8];   //!< registri del device
+	uint32_t *trace;    //!< traccia
+	uint32_t  length;   //!< lunghezza della traccia
+	uint32_t  index;    //!< prossimo campione da restituire
+} model;
+
+uint32_t myGPIO_BackendRead(myGPIO_t gpio, uint32_t reg) {
+	(void)gpio;
+	if (reg != READ_REG)
+		return model.reg[reg];
+	return model.trace[model.index < model.length ? model.index++ : model.length - 1];
+}
+
+void myGPIO_BackendWrite(myGPIO_t gpio, uint32_t reg, uint32_t value) {
+	(void)gpio;
+	if (reg != READ_REG)
+		model.reg[reg] = value;
+}
+
+static uint32_t xorshift32(uint32_t *state) {
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+/**
+ * @brief Linea seriale sul pin 0, inattiva alta, con un burst di caratteri 8N1, 8 campioni per bit, a
+ * partire dal campione start; gli altri pin restano fermi.
+ */
+static void trace_uart(uint32_t *trace, uint32_t length, uint32_t start) {
+	static const char message[] = "myGPIO capture";
+	uint32_t i, c, bit, t = start;
+	for (i = 0; i < length; i++)
+		trace[i] = 0xA5A50001U;
+	for (c = 0; c < sizeof(message) - 1; c++) {
+		uint32_t frame = (1U << 9) | ((uint32_t)(uint8_t)message[c] << 1);
+		for (bit = 0; bit < 10; bit++)
+			for (i = 0; i < 8 && t < length; i++, t++)
+				trace[t] = (frame >> bit & 1 ? 0xA5A50001U : 0xA5A50000U);
+		t += 16;
+	}
+}
+
+/**
+ * @brief Onda quadra sul pin 1, con semiperiodo di half campioni.
+ */
+static void trace_square(uint32_t *trace, uint32_t length, uint32_t half) {
+	uint32_t i;
+	for (i = 0; i < length; i++)
+		trace[i] = ((i / half) & 1) << 1;
+}
+
+/**
+ * @brief Bus a 8 bit sui pin 8-15, aggiornato con valori pseudo-casuali ogni 16 campioni.
+ */
+static void trace_bus(uint32_t *trace, uint32_t length) {
+	uint32_t i, state = 0x12345678U, value = 0;
+	for (i = 0; i < length; i++) {
+		if (i % 16 == 0)
+			value = (xorshift32(&state) & 0xFFU) << 8;
+		trace[i] = value;
+	}
+}
+
+/**
+ * @brief Rumore su tutti i pin: ogni campione differisce dal precedente.
+ */
+static void trace_noise(uint32_t *trace, uint32_t length) {
+	uint32_t i, state = 0x9E3779B9U;
+	for (i = 0; i < length; i++)
+		trace[i] = xorshift32(&state);
+}
+
+/**
+ * @brief Implementazione di riferimento della condizione di trigger: indice del primo campione che la
+ * soddisfa, oppure length.
+ */
+static uint32_t reference_trigger(const myGPIO_Capture_t *cap, const uint32_t *trace, uint32_t length) {
+	uint32_t i;
+	for (i = 0; i < length; i++) {
+		uint32_t s = trace[i], p = (i != 0 ? trace[i - 1] : 0);
+		if ((s & cap->mask) != cap->value)
+			continue;
+		if ((cap->rising | cap->falling) == 0)
+			return i;
+		if (i != 0 && ((cap->rising & s & ~p) | (cap->falling & ~s & p)) != 0)
+			return i;
+	}
+	return length;
+}
+
+/**
+ * @brief Acquisisce la traccia, riporta velocità e compressione e verifica i run.
+ */
+static uint32_t scenario(const char *name, uint32_t *trace, uint32_t length, myGPIO_CaptureRun_t *ring, uint32_t capacity,
+		uint32_t pre, uint32_t mask, uint32_t value, uint32_t rising, uint32_t falling, uint32_t post) {
+	myGPIO_Capture_t cap;
+	uint64_t start, elapsed, stored = 0, before = 0, wanted = 0;
+	uint32_t r, k, expected, position, state, errors = 0;
+
+	model.trace = trace;
+	model.length = length;
+	model.index = 0;
+	myGPIO_Capture_Init(&cap, model.reg, ring, capacity);
+	myGPIO_Capture_SetTrigger(&cap, mask, value, rising, falling, post);
+	myGPIO_Capture_SetPretrigger(&cap, pre);
+	expected = reference_trigger(&cap, trace, length);
+
+	start = bench_now_ns();
+	do
+		state = myGPIO_Capture_Run(&cap, length - model.index);
+	while (model.index < length && state != MYGPIO_CAPTURE_DONE);
+	elapsed = bench_now_ns() - start;
+	myGPIO_Capture_Stop(&cap);
+
+	for (r = 0; r < cap.runs; r++) {
+		stored += myGPIO_Capture_Get(&cap, r)->count;
+		if (r < cap.trigger)
+			before += myGPIO_Capture_Get(&cap, r)->count;
+	}
+	// senza trigger il buffer conserva la coda della traccia, altrimenti il run di trigger inizia con il
+	// campione atteso
+	// dopo il trigger vengono conservati i post campioni richiesti, o quelli presenti nella traccia, a meno
+	// che non si riempia il buffer, di cui almeno capacity - pre run sono riservati
+	if (expected == length)
+		errors += (state != MYGPIO_CAPTURE_ARMED || cap.runs > pre);
+	else {
+		wanted = (length - expected < post ? length - expected : post);
+		errors += (state == MYGPIO_CAPTURE_ARMED || cap.trigger >= cap.runs || cap.trigger > pre || stored - before > wanted);
+		if (stored - before < wanted && cap.runs - cap.trigger < capacity - pre) {
+			printf("%s: %" PRIu64 " campioni dopo il trigger, in %u run, richiesti %" PRIu64 "\n", name, stored - before,
+					cap.runs - cap.trigger, wanted);
+			errors++;
+		}
+	}
+	position = (expected == length ? length - (uint32_t)stored : expected - (uint32_t)before);
+	for (r = 0; r < cap.runs && errors == 0; r++) {
+		const myGPIO_CaptureRun_t *run = myGPIO_Capture_Get(&cap, r);
+		for (k = 0; k < run->count && errors == 0; k++, position++)
+			errors += (position >= length || trace[position] != run->value);
+	}
+
+	printf("%-40s %10.1f Ms/s %9" PRIu64 " campioni %7u run %9.1f:1%s\n", name, (double)cap.samples * 1e3 / (double)(elapsed != 0 ? elapsed : 1),
+			cap.samples, cap.runs, (double)stored * sizeof(uint32_t) / ((double)cap.runs * sizeof(myGPIO_CaptureRun_t)), (errors ? "  ERRATO" : ""));
+	return errors;
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("sim_capture [-n campioni] [-r run]\n");
+	printf("\t-n <num>: lunghezza delle tracce, in campioni (default 16777216)\n");
+	printf("\t-r <num>: dimensione del buffer, in run (default 65536)\n");
+}
+
+int main(int argc, char **argv) {
+	uint32_t length = 16777216, capacity = 65536, errors = 0, *trace;
+	myGPIO_CaptureRun_t *ring;
+	int par;
+
+	while ((par = getopt(argc, argv, "n:r:")) != -1) {
+		switch (par) {
+			case 'n' : length = strtoul(optarg, NULL, 0); break;
+			case 'r' : capacity = strtoul(optarg, NULL, 0); break;
+			default : howto(); return -1;
+		}
+	}
+	if (length < 1024 || capacity < 2) {
+		howto();
+		return -1;
+	}
+	trace = malloc(length * sizeof(uint32_t));
+	ring = malloc(capacity * sizeof(myGPIO_CaptureRun_t));
+	printf("tracce da %u campioni, buffer da %u run (%lu byte)\n", length, capacity, (unsigned long)(capacity * sizeof(myGPIO_CaptureRun_t)));
+
+	trace_uart(trace, length, length / 2);
+	errors += scenario("uart, fronte di discesa sul pin 0", trace, length, ring, capacity, capacity / 2, 0, 0, 0, MYGPIO_PIN(0), length / 4);
+	trace_square(trace, length, 50000);
+	errors += scenario("onda quadra lenta, senza trigger", trace, length, ring, capacity, capacity / 2, 0, 0, 0, 0, 0xFFFFFFFFU);
+	trace_bus(trace, length);
+	errors += scenario("bus a 8 bit, valore 0x5A", trace, length, ring, capacity, capacity / 2, 0xFF00U, 0x5A00U, 0, 0, length / 2);
+	errors += scenario("bus a 8 bit, 0x5A, 16 run", trace, length, ring, 16, 8, 0xFF00U, 0x5A00U, 0, 0, 1024);
+	errors += scenario("bus a 8 bit, 0x5A, 16 run, 2 di storia", trace, length, ring, 16, 2, 0xFF00U, 0x5A00U, 0, 0, 1024);
+	trace_noise(trace, length);
+	errors += scenario("rumore, senza trigger", trace, length, ring, capacity, capacity / 2, 0, 0, 0, 0, 0xFFFFFFFFU);
+
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	free(ring);
+	free(trace);
+	return (errors == 0 ? 0 : -1);
+}
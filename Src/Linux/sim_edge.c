@@ -0,0 +1,210 @@
+/**
+ * @file sim_edge.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example sim_edge.c
+ * Il file sim_edge.c contiene una verifica del rilevatore di fronti definito in myGPIO_edge.h, compilato con
+ * MYGPIO_BACKEND definito, sul modello del banco di registri di myGPIO_model.h. I 32 pin del device vengono
+ * pilotati con una sequenza pseudo-casuale, in cui la densità dei cambiamenti varia da un campione all'altro.
+ * Per ciascun campione le maschere prodotte da myGPIO_Edge_Sample(), che legge READ dal modello, e da
+ * myGPIO_Edge_Update(), e gli eventi restituiti dall'iteratore, vengono confrontati con un riferimento che
+ * esamina i pin uno alla volta. I campioni vengono inoltre raccolti in blocchi di lunghezza casuale, anche
+ * nulla, ed elaborati con myGPIO_Edge_Batch(), confrontandone le maschere per campione ed il valore
+ * restituito con lo stesso riferimento.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_edge.h"
+#include "myGPIO_model.h"
+
+#define BLOCK 64  //!< lunghezza massima di un blocco elaborato con myGPIO_Edge_Batch()
+
+static uint32_t errors = 0;
+
+#define CHECK(cond) do {                                  \
+	if (!(cond)) {                                        \
+		printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+		errors++;                                         \
+	}                                                     \
+} while (0)
+
+static uint32_t state;
+
+/**
+ * @brief Generatore pseudo-casuale xorshift32.
+ */
+static uint32_t next_random(void) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+/**
+ * @brief Prossimo valore dei pin: la maschera dei pin che cambiano è la AND di un numero casuale, da zero a
+ * tre, di parole casuali, così che si alternino campioni senza cambiamenti, con pochi e con molti pin che
+ * cambiano.
+ */
+static uint32_t next_pads(uint32_t pads) {
+	uint32_t toggle = next_random(), k = next_random() & 3;
+	if (k == 3)
+		toggle = 0;
+	while (k-- != 0)
+		toggle &= next_random();
+	return pads ^ toggle;
+}
+
+/**
+ * @brief Riferimento: esamina i pin uno alla volta.
+ */
+static void reference(uint32_t previous, uint32_t sample, myGPIO_EdgeMask_t *mask) {
+	uint32_t pin;
+	mask->rising = mask->falling = mask->changed = 0;
+	for (pin = 0; pin < 32; pin++) {
+		uint32_t before = (previous >> pin) & 1, after = (sample >> pin) & 1;
+		if (!before && after)
+			mask->rising |= MYGPIO_PIN(pin);
+		if (before && !after)
+			mask->falling |= MYGPIO_PIN(pin);
+		if (before != after)
+			mask->changed |= MYGPIO_PIN(pin);
+	}
+}
+
+/**
+ * @brief Confronta gli eventi restituiti dall'iteratore con il riferimento, pin per pin.
+ */
+static void check_events(const myGPIO_EdgeMask_t *mask, const myGPIO_EdgeMask_t *ref, uint32_t timestamp) {
+	myGPIO_EdgeIter_t iter;
+	myGPIO_EdgeEvent_t event;
+	uint32_t pin;
+	myGPIO_EdgeIter_Init(&iter, mask, timestamp);
+	for (pin = 0; pin < 32; pin++) {
+		if ((ref->changed & MYGPIO_PIN(pin)) == 0)
+			continue;
+		if (!myGPIO_EdgeIter_Next(&iter, &event)) {
+			CHECK(0);
+			return;
+		}
+		CHECK(event.pin == pin);
+		CHECK(event.edge == ((ref->rising & MYGPIO_PIN(pin)) != 0 ? MYGPIO_EDGE_RISING : MYGPIO_EDGE_FALLING));
+		CHECK(event.timestamp == timestamp);
+	}
+	CHECK(!myGPIO_EdgeIter_Next(&iter, &event));
+	CHECK(!myGPIO_EdgeIter_Next(&iter, &event));
+}
+
+/**
+ * @brief Elabora un blocco con myGPIO_Edge_Batch() e lo confronta con il riferimento.
+ */
+static void check_batch(myGPIO_Edge_t *batch, myGPIO_Edge_t *any_only, const uint32_t *sample, uint32_t count) {
+	uint32_t rising[BLOCK], falling[BLOCK], previous = batch->previous, any = 0, i;
+	myGPIO_EdgeMask_t ref;
+	uint32_t result = myGPIO_Edge_Batch(batch, sample, count, rising, falling);
+	for (i = 0; i < count; i++) {
+		reference(previous, sample[i], &ref);
+		CHECK(rising[i] == ref.rising);
+		CHECK(falling[i] == ref.falling);
+		any |= ref.changed;
+		previous = sample[i];
+	}
+	CHECK(result == any);
+	CHECK(batch->previous == previous);
+	// senza vettori di uscita viene restituita la sola OR dei cambiamenti
+	CHECK(myGPIO_Edge_Batch(any_only, sample, count, NULL, NULL) == any);
+	CHECK(any_only->previous == previous);
+}
+
+/**
+ * @brief Funzione di help
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("sim_edge [-n campioni] [-s seme]\n");
+	printf("\t-n <num>: numero di campioni (default 200000)\n");
+	printf("\t-s <num>: seme della sequenza pseudo-casuale, diverso da zero (default 1)\n");
+}
+
+int main(int argc, char **argv) {
+	myGPIO_Model_t model;
+	myGPIO_t gpio;
+	myGPIO_Edge_t sampled, updated, batch, any_only;
+	myGPIO_EdgeMask_t mask, ref;
+	uint32_t samples = 200000, block[BLOCK], length, filled = 0, pads, previous, i;
+	uint64_t events = 0;
+	int par;
+
+	state = 1;
+	while ((par = getopt(argc, argv, "n:s:")) != -1) {
+		switch (par) {
+			case 'n' : samples = strtoul(optarg, NULL, 0); break;
+			case 's' : state = strtoul(optarg, NULL, 0); break;
+			default : howto(); return -1;
+		}
+	}
+	if (samples == 0 || state == 0) {
+		howto();
+		return -1;
+	}
+
+	myGPIO_Model_Init(&model, 32);
+	gpio = myGPIO_Model_Gpio(&model);
+	pads = next_random();
+	myGPIO_Model_SetPins(&model, 0xFFFFFFFFU, pads);
+	myGPIO_Edge_Init(&sampled, gpio);
+	CHECK(sampled.previous == pads);
+	myGPIO_Edge_Init(&updated, gpio);
+	myGPIO_Edge_Init(&batch, gpio);
+	myGPIO_Edge_Init(&any_only, gpio);
+	length = next_random() % (BLOCK + 1);
+
+	for (i = 0; i < samples; i++) {
+		previous = pads;
+		pads = next_pads(pads);
+		reference(previous, pads, &ref);
+		events += __builtin_popcount(ref.changed);
+
+		myGPIO_Model_SetPins(&model, 0xFFFFFFFFU, pads);
+		myGPIO_Edge_Sample(&sampled, &mask);
+		CHECK(mask.rising == ref.rising && mask.falling == ref.falling && mask.changed == ref.changed);
+		check_events(&mask, &ref, i);
+
+		myGPIO_Edge_Update(&updated, pads, &mask);
+		CHECK(mask.rising == ref.rising && mask.falling == ref.falling && mask.changed == ref.changed);
+
+		// i blocchi vuoti non devono alterare lo stato del rilevatore
+		while (filled == length) {
+			check_batch(&batch, &any_only, block, filled);
+			filled = 0;
+			length = next_random() % (BLOCK + 1);
+		}
+		block[filled++] = pads;
+	}
+	check_batch(&batch, &any_only, block, filled);
+
+	printf("campioni: %u, eventi: %" PRIu64 ", accessi al modello: %lu letture, %lu scritture\n",
+			samples, events, model.reads, model.writes);
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	return (errors == 0 ? 0 : -1);
+}
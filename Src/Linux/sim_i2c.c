@@ -0,0 +1,428 @@
+/**
+ * @file sim_i2c.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example sim_i2c.c
+ * Il file sim_i2c.c contiene una simulazione, in tempo virtuale, del master I2C definito in myGPIO_i2c.h,
+ * compilato con MYGPIO_BACKEND definito ed eseguito sul simulatore di myGPIO_sim.h. Le due linee sono
+ * open-drain: ciascuna è bassa se il master configura il pin come uscita, o se lo slave la forza bassa.
+ * Lo slave simulato, una memoria di MEMORY byte con puntatore di indirizzo, osserva le linee ad ogni loro
+ * cambiamento e riconosce start, start ripetuto e stop; conferma il proprio indirizzo ed i byte scritti
+ * entro il limite di scrittura, rifiuta gli altri, registra l'acknowledge del master sui byte letti e,
+ * se richiesto, allunga il semiperiodo basso di SCL dopo ciascun acknowledge (clock stretching).
+ * Vengono verificati:
+ *  - scrittura, lettura e scrittura seguita da lettura con start ripetuto;
+ *  - NACK sull'indirizzo e sui byte oltre il limite di scrittura, ACK e NACK del master in lettura;
+ *  - clock stretching entro il timeout, fino al limite esatto di timeout letture di READ, ed oltre;
+ *  - il numero di letture di READ effettuate prima di dichiarare il timeout, pari a timeout;
+ *  - che ogni trasferimento termini con uno stop e lasci entrambe le linee rilasciate.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_shadow.h"
+#include "myGPIO_i2c.h"
+#include "myGPIO_sim.h"
+
+#define SDA_PIN  0
+#define SCL_PIN  1
+#define SDA      MYGPIO_PIN(SDA_PIN)
+#define SCL      MYGPIO_PIN(SCL_PIN)
+#define ADDRESS  0x50  //!< indirizzo dello slave
+#define MEMORY   16    //!< dimensione della memoria dello slave
+
+#define STRETCH_FOREVER UINT64_MAX  //!< lo slave non rilascia mai SCL
+
+static uint32_t errors = 0;
+
+#define CHECK(cond) do {                                  \
+	if (!(cond)) {                                        \
+		printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+		errors++;                                         \
+	}                                                     \
+} while (0)
+
+enum { SLAVE_IDLE, SLAVE_RECEIVE, SLAVE_TRANSMIT, SLAVE_IGNORE };
+
+/**
+ * @brief Slave I2C simulato.
+ */
+static struct {
+	myGPIO_Sim_t *sim;
+	uint32_t      state;          //!< SLAVE_IDLE, SLAVE_RECEIVE, SLAVE_TRANSMIT oppure SLAVE_IGNORE
+	uint32_t      bit;            //!< bit del byte corrente già ricevuti o trasmessi; 9 durante l'acknowledge
+	uint32_t      shift;          //!< byte in ricezione
+	uint32_t      byte;           //!< byte in trasmissione
+	int           address_phase;  //!< vero se il byte in ricezione è l'indirizzo
+	int           pointer_phase;  //!< vero se il byte in ricezione è il puntatore
+	int           reading;        //!< vero se il master ha richiesto una lettura
+	int           acked;          //!< acknowledge del master sull'ultimo byte trasmesso
+	uint8_t       memory[MEMORY]; //!< contenuto della memoria
+	uint32_t      pointer;        //!< puntatore di indirizzo
+	uint32_t      limit;          //!< i byte scritti ad indirizzi non inferiori vengono rifiutati
+	uint32_t      scl, sda;       //!< livelli delle linee all'ultima osservazione
+	uint32_t      hold_scl;       //!< vero se lo slave forza bassa SCL
+	uint32_t      hold_sda;       //!< vero se lo slave forza bassa SDA
+	uint64_t      stretch_ns;     //!< allungamento di SCL dopo ogni acknowledge, zero per nessuno
+	uint32_t      starts;         //!< condizioni di start, inclusi gli start ripetuti
+	uint32_t      repeated;       //!< start ripetuti
+	uint32_t      stops;          //!< condizioni di stop
+	uint32_t      nacks;          //!< byte rifiutati dallo slave
+	uint32_t      master_acks;    //!< byte letti confermati dal master
+	uint32_t      master_nacks;   //!< byte letti non confermati dal master
+	uint32_t      stretches;      //!< allungamenti di SCL
+} slave;
+
+/**
+ * @brief Livelli delle linee: ciascuna è bassa se il master la pilota o se lo slave la forza bassa.
+ */
+static void bus_levels(uint32_t *scl, uint32_t *sda) {
+	const myGPIO_Model_t *model = &slave.sim->model;
+	uint32_t low = model->reg[MODE_REG] & ~model->reg[WRITE_REG];
+	*scl = ((low & SCL) == 0 && !slave.hold_scl);
+	*sda = ((low & SDA) == 0 && !slave.hold_sda);
+}
+
+static void slave_release(myGPIO_Sim_t *sim, void *arg);
+
+/**
+ * @brief Conferma il byte ricevuto ed, eventualmente, allunga il semiperiodo basso di SCL.
+ */
+static void slave_ack(void) {
+	slave.hold_sda = 1;
+	slave.bit = 9;
+	if (slave.stretch_ns == 0)
+		return;
+	slave.hold_scl = 1;
+	slave.stretches++;
+	if (slave.stretch_ns != STRETCH_FOREVER &&
+			myGPIO_Sim_Schedule(slave.sim, myGPIO_Sim_Now() + slave.stretch_ns, 0, slave_release, NULL) != 0) {
+		printf("impossibile programmare il rilascio di SCL\n");
+		errors++;
+	}
+}
+
+/**
+ * @brief Rifiuta il byte ricevuto: lo slave ignora il bus fino al prossimo start o stop.
+ */
+static void slave_nack(void) {
+	slave.nacks++;
+	slave.state = SLAVE_IGNORE;
+	slave.hold_sda = 0;
+}
+
+/**
+ * @brief Presenta su SDA il prossimo bit del byte in trasmissione.
+ */
+static void slave_transmit(void) {
+	slave.hold_sda = ((slave.byte >> (7 - slave.bit)) & 1) == 0;
+	slave.bit++;
+}
+
+/**
+ * @brief Carica il prossimo byte da trasmettere e ne presenta il primo bit.
+ */
+static void slave_load(void) {
+	slave.state = SLAVE_TRANSMIT;
+	slave.byte = slave.memory[slave.pointer];
+	slave.pointer = (slave.pointer + 1) % MEMORY;
+	slave.bit = 0;
+	slave_transmit();
+}
+
+/**
+ * @brief Byte ricevuto, sul fronte di discesa di SCL che segue l'ottavo bit.
+ */
+static void slave_received(void) {
+	if (slave.address_phase) {
+		if ((slave.shift >> 1) != ADDRESS) {
+			slave_nack();
+			return;
+		}
+		slave.address_phase = 0;
+		slave.reading = slave.shift & 1;
+		slave.pointer_phase = !slave.reading;
+	}
+	else if (slave.pointer_phase) {
+		slave.pointer = slave.shift % MEMORY;
+		slave.pointer_phase = 0;
+	}
+	else if (slave.pointer < slave.limit) {
+		slave.memory[slave.pointer] = (uint8_t)slave.shift;
+		slave.pointer = (slave.pointer + 1) % MEMORY;
+	}
+	else {
+		slave_nack();
+		return;
+	}
+	slave_ack();
+}
+
+static void slave_scl_rising(void) {
+	if (slave.state == SLAVE_RECEIVE && slave.bit < 8) {
+		slave.shift = (slave.shift << 1) | slave.sda;
+		slave.bit++;
+	}
+	else if (slave.state == SLAVE_TRANSMIT && slave.bit == 9) {
+		slave.acked = !slave.sda;
+		if (slave.acked)
+			slave.master_acks++;
+		else
+			slave.master_nacks++;
+	}
+}
+
+static void slave_scl_falling(void) {
+	if (slave.state == SLAVE_RECEIVE) {
+		if (slave.bit == 8)
+			slave_received();
+		else if (slave.bit == 9) {
+			slave.hold_sda = 0;
+			slave.bit = 0;
+			slave.shift = 0;
+			if (slave.reading)
+				slave_load();
+		}
+	}
+	else if (slave.state == SLAVE_TRANSMIT) {
+		if (slave.bit < 8)
+			slave_transmit();
+		else if (slave.bit == 8) {
+			slave.hold_sda = 0;
+			slave.bit = 9;
+		}
+		else if (slave.acked)
+			slave_load();
+		else {
+			slave.state = SLAVE_IGNORE;
+			slave.hold_sda = 0;
+		}
+	}
+}
+
+static void slave_start(void) {
+	slave.starts++;
+	if (slave.state != SLAVE_IDLE)
+		slave.repeated++;
+	slave.state = SLAVE_RECEIVE;
+	slave.address_phase = 1;
+	slave.bit = 0;
+	slave.shift = 0;
+	slave.hold_sda = 0;
+}
+
+static void slave_stop(void) {
+	slave.stops++;
+	slave.state = SLAVE_IDLE;
+	slave.hold_sda = 0;
+}
+
+/**
+ * @brief Osserva le linee e reagisce ai loro cambiamenti, finché non si stabilizzano; impone poi sui pin del
+ * device, configurati come ingresso, i livelli risultanti.
+ */
+static void slave_observe(void) {
+	uint32_t scl, sda;
+	for (bus_levels(&scl, &sda); scl != slave.scl || sda != slave.sda; bus_levels(&scl, &sda)) {
+		if (scl != slave.scl) {
+			slave.scl = scl;
+			slave.sda = sda;
+			if (scl)
+				slave_scl_rising();
+			else
+				slave_scl_falling();
+		}
+		else {
+			slave.sda = sda;
+			if (scl && !sda)
+				slave_start();
+			else if (scl)
+				slave_stop();
+		}
+	}
+	myGPIO_Model_SetPins(&slave.sim->model, SDA | SCL, (scl ? SCL : 0) | (sda ? SDA : 0));
+}
+
+static void slave_release(myGPIO_Sim_t *sim, void *arg) {
+	(void)sim;
+	(void)arg;
+	slave.hold_scl = 0;
+	slave_observe();
+}
+
+static void slave_output(myGPIO_Model_t *model, uint32_t pins, void *arg) {
+	(void)model;
+	(void)pins;
+	(void)arg;
+	slave_observe();
+}
+
+/**
+ * @brief Riporta lo slave allo stato iniziale, con entrambe le linee rilasciate, senza generare eventi.
+ */
+static void slave_reset(uint64_t stretch_ns, uint32_t limit) {
+	slave.state = SLAVE_IDLE;
+	slave.hold_scl = slave.hold_sda = 0;
+	slave.stretch_ns = stretch_ns;
+	slave.limit = limit;
+	slave.starts = slave.repeated = slave.stops = slave.nacks = 0;
+	slave.master_acks = slave.master_nacks = slave.stretches = 0;
+	bus_levels(&slave.scl, &slave.sda);
+	myGPIO_Model_SetPins(&slave.sim->model, SDA | SCL, (slave.scl ? SCL : 0) | (slave.sda ? SDA : 0));
+}
+
+/**
+ * @brief Verifica che il master abbia rilasciato entrambe le linee e che lo slave sia libero.
+ */
+static void check_idle(void) {
+	CHECK((slave.sim->model.reg[MODE_REG] & (SDA | SCL)) == 0);
+	CHECK(slave.scl && slave.sda);
+	CHECK(slave.state == SLAVE_IDLE);
+}
+
+/**
+ * @brief Funzione di help
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("sim_i2c [-p iterazioni] [-t letture] [-s ns]\n");
+	printf("\t-p <num>: mezzo periodo di SCL, in iterazioni di myGPIO_Spin() (default 1111, circa 100 kHz)\n");
+	printf("\t-t <num>: timeout, in letture di READ, in attesa del rilascio di SCL (default 100)\n");
+	printf("\t-s <ns>: clock stretching, entro il timeout, dopo ogni acknowledge (default 10000)\n");
+}
+
+int main(int argc, char **argv) {
+	static const uint8_t data[] = {0x10, 0xDE, 0xAD, 0xBE, 0xEF};
+	myGPIO_Sim_t sim;
+	myGPIO_Shadow_t port;
+	myGPIO_I2c_t bus;
+	uint32_t half_period = 1111, timeout = 100, i;
+	uint64_t stretch_ns = 10000, limit_ns, start;
+	unsigned long reads;
+	uint8_t rx[4];
+	int par, status;
+
+	while ((par = getopt(argc, argv, "p:t:s:")) != -1) {
+		switch (par) {
+			case 'p' : half_period = strtoul(optarg, NULL, 0); break;
+			case 't' : timeout = strtoul(optarg, NULL, 0); break;
+			case 's' : stretch_ns = strtoull(optarg, NULL, 0); break;
+			default : howto(); return -1;
+		}
+	}
+	if (timeout == 0 || stretch_ns == 0) {
+		howto();
+		return -1;
+	}
+
+	myGPIO_Sim_Init(&sim, 8);
+	myGPIO_Model_SetOutput(&sim.model, slave_output, NULL);
+	slave.sim = &sim;
+	for (i = 0; i < MEMORY; i++)
+		slave.memory[i] = (uint8_t)(0xA0 + i);
+	slave_reset(0, MEMORY);
+	myGPIO_Shadow_Init(&port, myGPIO_Sim_Gpio(&sim));
+	myGPIO_I2c_Init(&bus, &port, SDA_PIN, SCL_PIN, half_period, timeout);
+	check_idle();
+
+	// scrittura: puntatore e quattro byte
+	start = myGPIO_Sim_Now();
+	CHECK(myGPIO_I2c_Write(&bus, ADDRESS, data, sizeof(data)) == MYGPIO_I2C_OK);
+	printf("scrittura di %u byte: %.1f us, %.1f kHz\n", (unsigned)sizeof(data),
+			(myGPIO_Sim_Now() - start) / 1e3, (sizeof(data) + 1) * 9 * 1e6 / (double)(myGPIO_Sim_Now() - start));
+	CHECK(memcmp(&slave.memory[0x10 % MEMORY], &data[1], sizeof(data) - 1) == 0);
+	CHECK(slave.starts == 1 && slave.repeated == 0 && slave.stops == 1 && slave.nacks == 0);
+	check_idle();
+
+	// scrittura del puntatore e lettura, con start ripetuto; il master non conferma l'ultimo byte
+	slave_reset(0, MEMORY);
+	memset(rx, 0, sizeof(rx));
+	CHECK(myGPIO_I2c_WriteRead(&bus, ADDRESS, data, 1, rx, sizeof(rx)) == MYGPIO_I2C_OK);
+	CHECK(memcmp(rx, &data[1], sizeof(rx)) == 0);
+	CHECK(slave.starts == 2 && slave.repeated == 1 && slave.stops == 1);
+	CHECK(slave.master_acks == sizeof(rx) - 1 && slave.master_nacks == 1);
+	check_idle();
+
+	// lettura dal puntatore corrente, che prosegue dall'ultima lettura
+	slave_reset(0, MEMORY);
+	CHECK(myGPIO_I2c_Read(&bus, ADDRESS, rx, 2) == MYGPIO_I2C_OK);
+	CHECK(rx[0] == slave.memory[(0x10 + 4) % MEMORY] && rx[1] == slave.memory[(0x10 + 5) % MEMORY]);
+	CHECK(slave.master_acks == 1 && slave.master_nacks == 1 && slave.stops == 1);
+	check_idle();
+
+	// NACK sull'indirizzo
+	slave_reset(0, MEMORY);
+	CHECK(myGPIO_I2c_Write(&bus, ADDRESS + 1, data, sizeof(data)) == MYGPIO_I2C_NACK);
+	CHECK(slave.nacks == 1 && slave.stops == 1);
+	check_idle();
+
+	// NACK sul terzo byte di dati: solo i primi due vengono scritti
+	slave_reset(0, 2);
+	memset(slave.memory, 0, sizeof(slave.memory));
+	status = myGPIO_I2c_Write(&bus, ADDRESS, (const uint8_t[]){0x00, 1, 2, 3, 4}, 5);
+	CHECK(status == MYGPIO_I2C_NACK);
+	CHECK(slave.memory[0] == 1 && slave.memory[1] == 2 && slave.memory[2] == 0);
+	CHECK(slave.nacks == 1 && slave.stops == 1);
+	check_idle();
+
+	// clock stretching entro il timeout
+	slave_reset(stretch_ns, MEMORY);
+	memcpy(&slave.memory[0x10 % MEMORY], &data[1], sizeof(data) - 1);
+	start = myGPIO_Sim_Now();
+	CHECK(myGPIO_I2c_WriteRead(&bus, ADDRESS, data, 1, rx, sizeof(rx)) == MYGPIO_I2C_OK);
+	CHECK(memcmp(rx, &data[1], sizeof(rx)) == 0);
+	CHECK(slave.stretches == 3 && slave.repeated == 1 && slave.stops == 1);
+	printf("scrittura e lettura con clock stretching di %" PRIu64 " ns: %.1f us\n", stretch_ns, (myGPIO_Sim_Now() - start) / 1e3);
+	check_idle();
+
+	// Lo stretching più lungo tollerato: dopo il fronte di discesa di SCL il master rilascia SDA e poi SCL,
+	// con due scritture, attende mezzo periodo, ed effettua al più timeout letture; la lettura k-esima
+	// vede la linea all'istante in cui viene servita, k letture dopo il rilascio di SCL.
+	limit_ns = 2ULL * sim.model.write_ns + ((uint64_t)half_period * sim.spin_ps) / 1000 + (uint64_t)timeout * sim.model.read_ns;
+	slave_reset(limit_ns, MEMORY);
+	CHECK(myGPIO_I2c_Write(&bus, ADDRESS, data, 1) == MYGPIO_I2C_OK);
+	check_idle();
+	slave_reset(limit_ns + 1, MEMORY);
+	CHECK(myGPIO_I2c_Write(&bus, ADDRESS, data, 1) == MYGPIO_I2C_TIMEOUT);
+	CHECK((sim.model.reg[MODE_REG] & (SDA | SCL)) == 0);
+	myGPIO_Sim_Delay(limit_ns);
+	printf("stretching massimo tollerato: %" PRIu64 " ns\n", limit_ns);
+
+	// SCL mai rilasciata: timeout letture sull'acknowledge dell'indirizzo, altrettante sullo stop; gli otto
+	// bit dell'indirizzo costano una lettura ciascuno
+	slave_reset(STRETCH_FOREVER, MEMORY);
+	reads = sim.model.reads;
+	CHECK(myGPIO_I2c_Write(&bus, ADDRESS, data, sizeof(data)) == MYGPIO_I2C_TIMEOUT);
+	CHECK(sim.model.reads - reads == 8 + 2UL * timeout);
+	CHECK((sim.model.reg[MODE_REG] & (SDA | SCL)) == 0);
+	printf("letture di READ prima del timeout: %lu, timeout %u\n", (sim.model.reads - reads - 8) / 2, timeout);
+	slave_reset(0, MEMORY);
+	CHECK(myGPIO_I2c_Read(&bus, ADDRESS, rx, 1) == MYGPIO_I2C_OK);
+	check_idle();
+
+	myGPIO_Sim_Destroy(&sim);
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	return (errors == 0 ? 0 : -1);
+}
@@ -0,0 +1,187 @@
+/**
+ * @file sim_keypad.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example sim_keypad.c
+ * Il file sim_keypad.c contiene una simulazione, eseguibile sull'host, dello scanner di tastiera a matrice
+ * definito in myGPIO_keypad.h. Il driver viene compilato con MYGPIO_BACKEND definito, e gli accessi ai
+ * registri vengono serviti da un modello del device a cui è collegata una matrice 8x8 di tasti con diodi:
+ * una colonna legge basso se almeno uno dei suoi tasti chiusi appartiene ad una riga pilotata bassa, ossia
+ * in modalità scrittura con valore 0 nel registro WRITE, mentre le righe in modalità lettura sono in alta
+ * impedenza. I tasti vengono premuti e rilasciati casualmente, con rimbalzi dopo ogni transizione.
+ * Viene verificato che gli eventi restituiti da myGPIO_Keypad_Scan() coincidano con quelli di un debouncer
+ * di riferimento applicato allo stato dei contatti, e che ciascuna scansione costi esattamente una
+ * scrittura ed una lettura per riga.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_keypad.h"
+
+#define ROWS    8
+#define COLS    8
+#define ROW_PIN 0
+#define COL_PIN 8
+
+/**
+ * @brief Modello del device e della matrice di tasti.
+ */
+static struct {
+	uint32_t reg[8];         //!< registri del device
+	uint64_t closed;         //!< contatti chiusi: bit r * 8 + c per il tasto (r, c)
+	unsigned long reads;     //!< letture effettuate
+	unsigned long writes;    //!< scritture effettuate
+} model;
+
+uint32_t myGPIO_BackendRead(myGPIO_t gpio, uint32_t reg) {
+	uint32_t row, columns = 0;
+	(void)gpio;
+	model.reads++;
+	if (reg != READ_REG)
+		return model.reg[reg];
+	for (row = 0; row < ROWS; row++) {
+		uint32_t pin = MYGPIO_PIN(ROW_PIN + row);
+		if ((model.reg[MODE_REG] & pin) != 0 && (model.reg[WRITE_REG] & pin) == 0)
+			columns |= (uint32_t)(model.closed >> (8 * row)) & 0xFF;
+	}
+	// colonne con pull-up, righe pilotate o lette come alte
+	return ~(columns << COL_PIN) & ~(model.reg[MODE_REG] & ~model.reg[WRITE_REG]);
+}
+
+void myGPIO_BackendWrite(myGPIO_t gpio, uint32_t reg, uint32_t value) {
+	(void)gpio;
+	model.writes++;
+	if (reg != READ_REG)
+		model.reg[reg] = value;
+}
+
+/**
+ * @brief Generatore pseudo-casuale xorshift32
+ */
+static uint32_t xorshift32(uint32_t *x) {
+	*x ^= *x << 13;
+	*x ^= *x >> 17;
+	*x ^= *x << 5;
+	return *x;
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("sim_keypad [-n scansioni] [-s scansioni-consecutive]\n");
+	printf("\t-n <num>: numero di scansioni simulate (default 100000)\n");
+	printf("\t-s <num>: scansioni consecutive necessarie per il cambiamento di stato (default 4, max %u)\n", MYGPIO_DEBOUNCE_MAX_SAMPLES);
+}
+
+/**
+ * @brief Il modello non ha ritardi di propagazione: l'attesa tra la selezione di una riga e la lettura delle
+ * colonne non consuma tempo.
+ */
+void myGPIO_BackendSpin(uint32_t loops) {
+	(void)loops;
+}
+
+int main(int argc, char **argv) {
+	uint32_t scans = 100000, samples = 4, seed = 0xBADC0DE5U, scan, key, events = 0, errors = 0;
+	uint32_t level[64] = {0}, next_edge[64], bounce_end[64], stable[64] = {0}, count[64] = {0};
+	myGPIO_Keypad_t keypad;
+	myGPIO_KeyEvent_t event[64];
+	int par;
+
+	while((par = getopt(argc, argv, "n:s:")) != -1) {
+		switch (par) {
+		case 'n' :
+			scans = strtoul(optarg, NULL, 0);
+			break;
+		case 's' :
+			samples = strtoul(optarg, NULL, 0);
+			break;
+		default :
+			printf("%c: parametro sconosciuto.\n", par);
+			howto();
+			return -1;
+		}
+	}
+	if (scans == 0 || samples == 0 || samples > MYGPIO_DEBOUNCE_MAX_SAMPLES) {
+		howto();
+		return -1;
+	}
+	for (key = 0; key < 64; key++) {
+		next_edge[key] = xorshift32(&seed) % 2000;
+		bounce_end[key] = 0;
+	}
+
+	myGPIO_Keypad_Init(&keypad, model.reg, ROWS, ROW_PIN, COLS, COL_PIN, samples, 0);
+	for (scan = 0; scan < scans; scan++) {
+		unsigned long reads, writes;
+		uint32_t n, expected = 0;
+
+		// evoluzione dei contatti
+		model.closed = 0;
+		for (key = 0; key < 64; key++) {
+			if (scan == next_edge[key]) {
+				level[key] ^= 1;
+				bounce_end[key] = scan + 1 + xorshift32(&seed) % samples;
+				next_edge[key] = scan + samples + 1 + xorshift32(&seed) % 2000;
+			}
+			if ((level[key] ^ (scan < bounce_end[key] && (xorshift32(&seed) & 1))) != 0)
+				model.closed |= 1ULL << key;
+		}
+
+		reads = model.reads;
+		writes = model.writes;
+		n = myGPIO_Keypad_Scan(&keypad, event, 64);
+		if (model.reads - reads != ROWS || model.writes - writes != ROWS) {
+			printf("scansione %u: %lu letture, %lu scritture\n", scan, model.reads - reads, model.writes - writes);
+			errors++;
+		}
+
+		// debouncer di riferimento, tasto per tasto; gli eventi sono attesi in ordine di indice
+		for (key = 0; key < 64; key++) {
+			uint32_t contact = (model.closed >> key) & 1;
+			if (contact == stable[key])
+				count[key] = 0;
+			else if (++count[key] == samples) {
+				count[key] = 0;
+				stable[key] = contact;
+				if (expected >= n || event[expected].key != key || event[expected].pressed != contact) {
+					printf("scansione %u: evento atteso per il tasto %u non restituito\n", scan, key);
+					errors++;
+				}
+				expected++;
+			}
+		}
+		if (expected != n) {
+			printf("scansione %u: %u eventi restituiti, %u attesi\n", scan, n, expected);
+			errors++;
+		}
+		events += n;
+	}
+
+	printf("%u scansioni, %u eventi, %u letture e %u scritture per scansione\n", scans, events, ROWS, ROWS);
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	return (errors == 0 ? 0 : -1);
+}
@@ -0,0 +1,204 @@
+/**
+ * @file sim_lcd.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example sim_lcd.c
+ * Il file sim_lcd.c contiene una simulazione, eseguibile sull'host, del framebuffer per display HD44780
+ * definito in myGPIO_lcd.h. Il driver viene compilato con MYGPIO_BACKEND definito, e gli accessi ai
+ * registri vengono serviti da un modello del device collegato ad un display: sul fronte di discesa di E il
+ * modello campiona D0-D7 ed RS, ed esegue i comandi "clear display", "return home" e "set DDRAM address" e
+ * le scritture in DDRAM, verificando inoltre che RS non cambi insieme al fronte di salita di E.
+ * Per alcuni scenari tipici (primo disegno dello schermo, ridisegno invariato, aggiornamento di un campo,
+ * modifiche sparse) vengono riportati celle inviate e scritture sul registro WRITE, confrontandole con la
+ * riscrittura dell'intero schermo su bus a 4 bit attraverso myGPIO_SetValue(), e viene verificato che il
+ * contenuto della DDRAM del modello coincida con il framebuffer.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_lcd.h"
+
+#define DATA_PIN 0
+#define RS_PIN   8
+#define E_PIN    9
+
+/**
+ * @brief Modello del device e del display.
+ */
+static struct {
+	uint32_t reg[8];        //!< registri del device
+	uint32_t rows;          //!< righe del display
+	uint8_t  ddram[128];    //!< DDRAM del display, indicizzata per indirizzo
+	uint32_t ac;            //!< contatore di indirizzo
+	uint32_t violations;    //!< fronti di salita di E contemporanei ad un cambiamento di RS
+	unsigned long reads;    //!< letture effettuate
+	unsigned long writes;   //!< scritture effettuate
+} model;
+
+static uint32_t model_next(uint32_t address) {
+	if (model.rows == 1)
+		return (address == 0x4FU ? 0x00U : address + 1);
+	if (address == 0x27U)
+		return 0x40U;
+	return (address == 0x67U ? 0x00U : address + 1);
+}
+
+uint32_t myGPIO_BackendRead(myGPIO_t gpio, uint32_t reg) {
+	(void)gpio;
+	model.reads++;
+	return model.reg[reg];
+}
+
+void myGPIO_BackendWrite(myGPIO_t gpio, uint32_t reg, uint32_t value) {
+	uint32_t previous = model.reg[WRITE_REG];
+	(void)gpio;
+	model.writes++;
+	if (reg == READ_REG)
+		return;
+	model.reg[reg] = value;
+	if (reg != WRITE_REG)
+		return;
+	if ((value & ~previous & MYGPIO_PIN(E_PIN)) != 0 && ((value ^ previous) & MYGPIO_PIN(RS_PIN)) != 0)
+		model.violations++;
+	if ((previous & ~value & MYGPIO_PIN(E_PIN)) != 0) {
+		uint8_t byte = (uint8_t)(value >> DATA_PIN);
+		if ((value & MYGPIO_PIN(RS_PIN)) != 0) {
+			model.ddram[model.ac] = byte;
+			model.ac = model_next(model.ac);
+		}
+		else if ((byte & 0x80) != 0)
+			model.ac = byte & 0x7F;
+		else if (byte == 0x01) {
+			memset(model.ddram, ' ', sizeof(model.ddram));
+			model.ac = 0;
+		}
+		else if ((byte & 0xFE) == 0x02)
+			model.ac = 0;
+	}
+}
+
+/**
+ * @brief Riscrittura dell'intero schermo su bus a 4 bit (D4-D7 sui pin DATA_PIN + 4 ... DATA_PIN + 7),
+ * con una chiamata a myGPIO_SetValue() per ciascuna linea, come farebbe un driver privo di framebuffer.
+ */
+static void nibble(myGPIO_t gpio, uint32_t rs, uint8_t value) {
+	myGPIO_SetValue(gpio, MYGPIO_PIN(RS_PIN), rs);
+	myGPIO_SetValue(gpio, (uint32_t)(value & 0x0F) << (DATA_PIN + 4), MYGPIO_PIN_SET);
+	myGPIO_SetValue(gpio, (uint32_t)(~value & 0x0F) << (DATA_PIN + 4), MYGPIO_PIN_RESET);
+	myGPIO_SetValue(gpio, MYGPIO_PIN(E_PIN), MYGPIO_PIN_SET);
+	myGPIO_SetValue(gpio, MYGPIO_PIN(E_PIN), MYGPIO_PIN_RESET);
+}
+
+static void naive_redraw(myGPIO_t gpio, const myGPIO_Lcd_t *lcd) {
+	static const uint8_t offset[4] = {0x00, 0x40, 0x14, 0x54};
+	uint32_t row, col;
+	for (row = 0; row < lcd->rows; row++) {
+		uint8_t command = (uint8_t)(0x80 | (offset[row] - (row >= 2 ? 20 - lcd->cols : 0)));
+		nibble(gpio, MYGPIO_PIN_RESET, command >> 4);
+		nibble(gpio, MYGPIO_PIN_RESET, command);
+		for (col = 0; col < lcd->cols; col++) {
+			uint8_t c = lcd->frame[row * lcd->cols + col];
+			nibble(gpio, MYGPIO_PIN_SET, c >> 4);
+			nibble(gpio, MYGPIO_PIN_SET, c);
+		}
+	}
+}
+
+/**
+ * @brief Verifica che la DDRAM del modello coincida con il framebuffer.
+ */
+static uint32_t verify(const myGPIO_Lcd_t *lcd) {
+	uint32_t row, col, errors = 0;
+	for (row = 0; row < lcd->rows; row++)
+		for (col = 0; col < lcd->cols; col++) {
+			uint32_t address = (row & 1 ? 0x40U : 0x00U) + (row >> 1) * lcd->cols + col;
+			errors += (model.ddram[address] != lcd->frame[row * lcd->cols + col]);
+		}
+	return errors;
+}
+
+/**
+ * @brief Esegue myGPIO_Lcd_Flush() e riporta celle inviate e scritture effettuate.
+ */
+static uint32_t flush(myGPIO_Lcd_t *lcd, const char *name) {
+	unsigned long reads = model.reads, writes = model.writes;
+	uint32_t cells = myGPIO_Lcd_Flush(lcd), errors = verify(lcd);
+	printf("%-40s %4u celle %6lu read %6lu write%s\n", name, cells, model.reads - reads, model.writes - writes, (errors ? "  ERRATO" : ""));
+	return errors;
+}
+
+static uint32_t scenario(uint32_t rows, uint32_t cols) {
+	myGPIO_Lcd_t lcd;
+	unsigned long reads, writes;
+	uint32_t errors = 0, row, col;
+	char line[MYGPIO_LCD_MAX_COLS + 1];
+
+	memset(&model, 0, sizeof(model));
+	model.rows = rows;
+	myGPIO_Lcd_Init(&lcd, model.reg, rows, cols, DATA_PIN, RS_PIN, E_PIN, NULL);
+	printf("display %ux%u\n", rows, cols);
+
+	for (row = 0; row < rows; row++) {
+		for (col = 0; col < cols; col++)
+			line[col] = (char)('A' + (row * cols + col) % 26);
+		line[cols] = '\0';
+		myGPIO_Lcd_SetCursor(&lcd, row, 0);
+		myGPIO_Lcd_Print(&lcd, line);
+	}
+	errors += flush(&lcd, "primo disegno");
+	errors += flush(&lcd, "ridisegno invariato");
+
+	myGPIO_Lcd_SetCursor(&lcd, 0, 2);
+	myGPIO_Lcd_Print(&lcd, "21.5");
+	errors += flush(&lcd, "aggiornamento di un campo (4 celle)");
+
+	for (row = 0; row < rows; row++)
+		for (col = row & 1; col < cols; col += 3) {
+			myGPIO_Lcd_SetCursor(&lcd, row, col);
+			myGPIO_Lcd_PutChar(&lcd, '#');
+		}
+	errors += flush(&lcd, "modifiche sparse");
+
+	myGPIO_Lcd_Clear(&lcd);
+	errors += flush(&lcd, "cancellazione del framebuffer");
+
+	reads = model.reads;
+	writes = model.writes;
+	naive_redraw(model.reg, &lcd);
+	printf("%-40s %4u celle %6lu read %6lu write\n", "riscrittura a 4 bit con myGPIO_SetValue", rows * cols, model.reads - reads, model.writes - writes);
+
+	if (model.violations != 0) {
+		printf("RS cambiato insieme al fronte di salita di E %u volte\n", model.violations);
+		errors++;
+	}
+	return errors;
+}
+
+int main(void) {
+	uint32_t errors = 0;
+	errors += scenario(2, 16);
+	errors += scenario(4, 20);
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	return (errors == 0 ? 0 : -1);
+}
@@ -0,0 +1,394 @@
+/**
+ * @file sim_load.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example sim_load.c
+ * Il file sim_load.c contiene una prova di carico dei percorsi di servizio delle interruzioni, condotta con
+ * il simulatore in tempo virtuale di myGPIO_sim.h e con gli stimoli generati da myGPIO_stimulus.h.
+ * Vengono confrontati tre consumatori:
+ *  - latch: il percorso di uio-int.c e di myGPIOK_read(); la ISR del kernel disabilita gli interrupt del
+ *    device e risveglia il processo, che legge READ, attende che i pin tornino a zero, riconosce tutte le
+ *    interruzioni pendenti e le riabilita;
+ *  - pending: come latch, ma il processo legge IRQ e riconosce solo i pin che ha letto, senza attendere;
+ *  - dispatch: le interruzioni vengono servite direttamente nella ISR, da myGPIO_Dispatch_Isr().
+ * Per ciascun consumatore e per rate crescenti vengono riportati gli impulsi generati, consegnati, persi e
+ * le osservazioni spurie, i percentili della latenza di consegna e, infine, il massimo throughput con
+ * perdite inferiori all'1%, o il carico del rate più basso, preceduto da "<", se già questo perde oltre l'1%
+ * degli impulsi. Seguono una prova con raffiche ed una con rimbalzi.
+ * Il modello riproduce IACK come myGPIO_AXI.vhd: il registro resta attivo fino alla scrittura successiva, e
+ * nel frattempo IRQ non accumula. Tutti i consumatori lo azzerano subito dopo l'ack, con la scrittura su
+ * GIES o, in myGPIO_Dispatch_Isr(), con una seconda scrittura su IACK; dopodiché un pin ancora alto torna in
+ * IRQ. Per questo, nella prova con rimbalzi, pending e dispatch riportano un'osservazione spuria per ogni
+ * interruzione servita mentre il pulsante resta premuto, oltre a quelle dovute ai rimbalzi.
+ * Con l'opzione -c viene invece eseguita una sola prova, con i parametri indicati.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_dispatch.h"
+#include "myGPIO_sim.h"
+#include "myGPIO_stimulus.h"
+#include "bench.h"
+
+#define NS_PER_MS 1000000ULL
+
+#define CONSUMER_LATCH    0
+#define CONSUMER_PENDING  1
+#define CONSUMER_DISPATCH 2
+
+static const char *consumer_name[] = { "latch", "pending", "dispatch" };
+
+typedef struct {
+	uint32_t             consumer;    //!< consumatore
+	uint32_t             pins;        //!< numero di pin stimolati
+	myGPIO_StimulusPin_t config;      //!< stimoli, uguali per tutti i pin
+	uint64_t             duration;    //!< durata della generazione, in ns
+	uint32_t             isr_ns;      //!< latenza di ingresso nella ISR
+	uint32_t             wakeup_ns;   //!< latenza di risveglio del processo
+	uint32_t             seed;        //!< seme degli stimoli
+} load_t;
+
+typedef struct {
+	uint32_t generated, delivered, lost, spurious;
+	uint64_t p50, p90, p99, max;
+	double   throughput;  //!< impulsi consegnati al secondo
+} result_t;
+
+static struct {
+	myGPIO_Sim_t      sim;
+	myGPIO_Stimulus_t st;
+	myGPIO_Dispatch_t dispatch;
+	uint32_t          mask;
+	uint32_t          wakeup_ns;
+} run;
+
+static void observe(uint32_t pins, uint64_t time, int level) {
+	uint32_t i;
+	for (i = 0; i < MYGPIO_STIMULUS_PINS; i++)
+		if ((pins & MYGPIO_PIN(i)) != 0) {
+			if (level)
+				myGPIO_Stimulus_ObserveLevel(&run.st, i, time);
+			else
+				myGPIO_Stimulus_Observe(&run.st, i, time);
+		}
+}
+
+/**
+ * @brief Processo risvegliato da uio-int.c o da myGPIOK_read().
+ */
+static void process_latch(myGPIO_Sim_t *sim, void *arg) {
+	myGPIO_t gpio = myGPIO_Sim_Gpio(sim);
+	uint32_t pins = myGPIO_GetRead(gpio) & run.mask;
+	(void)arg;
+	observe(pins, myGPIO_Sim_Now(), 1);
+	while ((myGPIO_GetRead(gpio) & run.mask) != 0)
+		myGPIO_Sim_Delay(1000);
+	myGPIO_PinInterruptAck(gpio, myGPIO_PendingPinInterrupt(gpio));
+	myGPIO_GlobalInterruptEnable(gpio);
+}
+
+/**
+ * @brief Processo che riconosce solo le interruzioni che ha letto.
+ */
+static void process_pending(myGPIO_Sim_t *sim, void *arg) {
+	myGPIO_t gpio = myGPIO_Sim_Gpio(sim);
+	uint32_t pending = myGPIO_PendingPinInterrupt(gpio);
+	(void)arg;
+	observe(pending, myGPIO_Sim_Now(), 0);
+	myGPIO_PinInterruptAck(gpio, pending);
+	myGPIO_GlobalInterruptEnable(gpio);
+}
+
+/**
+ * @brief ISR del kernel: disabilita gli interrupt del device e risveglia il processo.
+ */
+static void kernel_isr(void *arg) {
+	myGPIO_GlobalInterruptDisable(myGPIO_Sim_Gpio(&run.sim));
+	myGPIO_Sim_Schedule(&run.sim, run.sim.now + run.wakeup_ns, 0, (myGPIO_SimAction_t)arg, NULL);
+}
+
+static void on_pins(myGPIO_t gpio, uint32_t pins, void *arg) {
+	(void)gpio;
+	(void)arg;
+	observe(pins, myGPIO_Sim_Now(), 0);
+}
+
+static int execute(const load_t *load, result_t *result) {
+	myGPIO_t gpio;
+	uint32_t i;
+
+	myGPIO_Sim_Init(&run.sim, 32);
+	gpio = myGPIO_Sim_Gpio(&run.sim);
+	myGPIO_Stimulus_Init(&run.st, load->seed);
+	run.mask = (load->pins >= 32 ? 0xFFFFFFFFU : MYGPIO_PIN(load->pins) - 1);
+	run.wakeup_ns = load->wakeup_ns;
+	for (i = 0; i < load->pins; i++)
+		myGPIO_Stimulus_SetPin(&run.st, i, &load->config);
+	if (myGPIO_Stimulus_Generate(&run.st, load->duration) != 0) {
+		printf("memoria insufficiente\n");
+		return -1;
+	}
+	for (i = 0; i < run.st.edges; i++)
+		if (myGPIO_Sim_SchedulePins(&run.sim, run.st.edge[i].time, MYGPIO_PIN(run.st.edge[i].pin),
+				run.st.edge[i].level ? 0xFFFFFFFFU : 0) != 0) {
+			printf("memoria insufficiente\n");
+			return -1;
+		}
+
+	switch (load->consumer) {
+	case CONSUMER_LATCH:
+		myGPIO_Sim_SetIsr(&run.sim, kernel_isr, (void*)process_latch, load->isr_ns);
+		break;
+	case CONSUMER_PENDING:
+		myGPIO_Sim_SetIsr(&run.sim, kernel_isr, (void*)process_pending, load->isr_ns);
+		break;
+	default:
+		myGPIO_Dispatch_Init(&run.dispatch, gpio);
+		myGPIO_Dispatch_Register(&run.dispatch, run.mask, on_pins, NULL);
+		myGPIO_Sim_SetIsr(&run.sim, myGPIO_Dispatch_Isr, &run.dispatch, load->isr_ns);
+		break;
+	}
+	myGPIO_PinInterruptEnable(gpio, run.mask);
+	myGPIO_GlobalInterruptEnable(gpio);
+
+	// gli impulsi iniziati poco prima del termine devono poter essere consegnati
+	myGPIO_Sim_RunUntil(&run.sim, load->duration + 50 * NS_PER_MS);
+	myGPIO_Stimulus_Finish(&run.st);
+
+	result->generated = run.st.generated;
+	result->delivered = run.st.delivered;
+	result->lost = run.st.lost;
+	result->spurious = run.st.spurious;
+	result->p50 = myGPIO_Stimulus_Percentile(&run.st, 50);
+	result->p90 = myGPIO_Stimulus_Percentile(&run.st, 90);
+	result->p99 = myGPIO_Stimulus_Percentile(&run.st, 99);
+	result->max = myGPIO_Stimulus_Percentile(&run.st, 100);
+	result->throughput = (double)run.st.delivered * 1e9 / (double)load->duration;
+	myGPIO_Stimulus_Destroy(&run.st);
+	myGPIO_Sim_Destroy(&run.sim);
+	if (run.sim.failures != 0) {
+		printf("%" PRIu64 " azioni periodiche non riprogrammate\n", run.sim.failures);
+		return -1;
+	}
+	return 0;
+}
+
+static void print_header(void) {
+	printf("%-9s %10s %9s %9s %7s %8s %9s %9s %9s %9s\n", "consum.", "rate/pin", "generati", "consegn.", "persi%", "spurie",
+			"p50 us", "p90 us", "p99 us", "max us");
+}
+
+static void print_result(const load_t *load, const result_t *r) {
+	printf("%-9s %10.0f %9u %9u %7.2f %8u %9.2f %9.2f %9.2f %9.2f\n", consumer_name[load->consumer], load->config.rate,
+			r->generated, r->delivered, r->generated != 0 ? 100.0 * r->lost / r->generated : 0.0, r->spurious,
+			r->p50 / 1e3, r->p90 / 1e3, r->p99 / 1e3, r->max / 1e3);
+}
+
+/**
+ * @brief Verifica che ciascun impulso generato sia stato consegnato o perso.
+ */
+static uint32_t check_conservation(const result_t *r) {
+	if (r->generated == r->delivered + r->lost)
+		return 0;
+	printf("\t%u generati, ma %u consegnati e %u persi\n", r->generated, r->delivered, r->lost);
+	return 1;
+}
+
+static void load_defaults(load_t *load) {
+	memset(load, 0, sizeof(load_t));
+	load->consumer = CONSUMER_DISPATCH;
+	load->pins = 4;
+	load->config.kind = MYGPIO_STIMULUS_POISSON;
+	load->config.rate = 1000;
+	load->config.width_ns = 1000;
+	load->duration = 200 * NS_PER_MS;
+	load->isr_ns = 2000;
+	load->wakeup_ns = 20000;
+	load->seed = 0x9E3779B9U;
+}
+
+static uint32_t suite(void) {
+	static const double rates[] = { 1000, 3000, 10000, 30000, 100000 };
+	load_t load;
+	result_t r, again;
+	uint32_t c, i, errors = 0;
+	double saturation;
+
+	printf("Arrivi di Poisson su 4 pin, impulsi da 1 us, ISR dopo 2 us, processo risvegliato dopo 20 us\n");
+	print_header();
+	for (c = CONSUMER_LATCH; c <= CONSUMER_DISPATCH; c++) {
+		saturation = 0;
+		for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+			load_defaults(&load);
+			load.consumer = c;
+			load.config.rate = rates[i];
+			if (execute(&load, &r) != 0)
+				return errors + 1;
+			print_result(&load, &r);
+			errors += check_conservation(&r);
+			if (r.lost * 100 < r.generated && r.throughput > saturation)
+				saturation = r.throughput;
+			// a basso carico, servendo le interruzioni nella ISR, non devono andare persi impulsi
+			if (c == CONSUMER_DISPATCH && i == 0 && r.lost != 0) {
+				printf("\timpulsi persi a basso carico\n");
+				errors++;
+			}
+		}
+		// se già il rate più basso perde oltre l'1% il throughput è inferiore al carico di quel rate
+		if (saturation != 0)
+			printf("%-9s throughput massimo con perdite < 1%%: %.0f impulsi/s\n", consumer_name[c], saturation);
+		else
+			printf("%-9s throughput massimo con perdite < 1%%: < %.0f impulsi/s\n", consumer_name[c], rates[0] * load.pins);
+	}
+
+	printf("\nRaffiche di 8 impulsi a 200000/s, 500 raffiche/s, su 4 pin\n");
+	print_header();
+	for (c = CONSUMER_LATCH; c <= CONSUMER_DISPATCH; c++) {
+		load_defaults(&load);
+		load.consumer = c;
+		load.config.kind = MYGPIO_STIMULUS_BURST;
+		load.config.rate = 200000;
+		load.config.burst = 8;
+		load.config.burst_rate = 500;
+		if (execute(&load, &r) != 0)
+			return errors + 1;
+		print_result(&load, &r);
+		errors += check_conservation(&r);
+	}
+
+	printf("\nPulsante con rimbalzi su 1 pin: 20 pressioni/s da 10 ms, fino a 4 coppie di rimbalzi entro 50 us\n");
+	print_header();
+	for (c = CONSUMER_LATCH; c <= CONSUMER_DISPATCH; c++) {
+		load_defaults(&load);
+		load.consumer = c;
+		load.pins = 1;
+		load.config.kind = MYGPIO_STIMULUS_PERIODIC;
+		load.config.rate = 20;
+		load.config.width_ns = 10 * NS_PER_MS;
+		load.config.bounces = 4;
+		load.config.bounce_ns = 50000;
+		load.duration = 5000 * NS_PER_MS;
+		if (execute(&load, &r) != 0)
+			return errors + 1;
+		print_result(&load, &r);
+		errors += check_conservation(&r);
+	}
+
+	// a parità di seme, la prova è deterministica
+	load_defaults(&load);
+	load.config.rate = 30000;
+	execute(&load, &r);
+	execute(&load, &again);
+	if (memcmp(&r, &again, sizeof(result_t)) != 0) {
+		printf("la seconda esecuzione differisce dalla prima\n");
+		errors++;
+	}
+	return errors;
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("sim_load [-c consumatore [opzioni]]\n");
+	printf("\t-c latch|pending|dispatch: esegue una sola prova col consumatore indicato\n");
+	printf("\t-k periodic|poisson|burst: processo di arrivo (default poisson)\n");
+	printf("\t-r <num>: impulsi al secondo per pin (default 1000)\n");
+	printf("\t-n <num>: numero di pin stimolati (default 4)\n");
+	printf("\t-w <num>: durata degli impulsi in ns (default 1000)\n");
+	printf("\t-B <num>: impulsi per raffica (default 8)\n");
+	printf("\t-R <num>: raffiche al secondo (default 100)\n");
+	printf("\t-b <num>: massimo numero di coppie di rimbalzi per fronte (default 0)\n");
+	printf("\t-j <num>: massima distanza tra due rimbalzi in ns (default 50000)\n");
+	printf("\t-i <num>: latenza di ingresso nella ISR in ns (default 2000)\n");
+	printf("\t-u <num>: latenza di risveglio del processo in ns (default 20000)\n");
+	printf("\t-d <num>: durata in ms (default 200)\n");
+	printf("\t-s <num>: seme degli stimoli\n");
+	printf("Senza opzioni viene eseguita la prova completa.\n");
+}
+
+static int lookup(const char *name, const char *const *names, uint32_t count) {
+	uint32_t i;
+	for (i = 0; i < count; i++)
+		if (strcmp(name, names[i]) == 0)
+			return i;
+	return -1;
+}
+
+int main(int argc, char **argv) {
+	static const char *kind_name[] = { "periodic", "poisson", "burst" };
+	load_t load;
+	result_t r;
+	uint32_t errors;
+	int par, single = 0, index;
+
+	load_defaults(&load);
+	load.config.burst = 8;
+	load.config.burst_rate = 100;
+	load.config.bounce_ns = 50000;
+	while ((par = getopt(argc, argv, "c:k:r:n:w:B:R:b:j:i:u:d:s:")) != -1) {
+		switch (par) {
+			case 'c' :
+				if ((index = lookup(optarg, consumer_name, 3)) < 0) { howto(); return -1; }
+				load.consumer = index;
+				single = 1;
+				break;
+			case 'k' :
+				if ((index = lookup(optarg, kind_name, 3)) < 0) { howto(); return -1; }
+				load.config.kind = index;
+				break;
+			case 'r' : load.config.rate = strtod(optarg, NULL); break;
+			case 'n' : load.pins = strtoul(optarg, NULL, 0); break;
+			case 'w' : load.config.width_ns = strtoul(optarg, NULL, 0); break;
+			case 'B' : load.config.burst = strtoul(optarg, NULL, 0); break;
+			case 'R' : load.config.burst_rate = strtod(optarg, NULL); break;
+			case 'b' : load.config.bounces = strtoul(optarg, NULL, 0); break;
+			case 'j' : load.config.bounce_ns = strtoul(optarg, NULL, 0); break;
+			case 'i' : load.isr_ns = strtoul(optarg, NULL, 0); break;
+			case 'u' : load.wakeup_ns = strtoul(optarg, NULL, 0); break;
+			case 'd' : load.duration = strtoull(optarg, NULL, 0) * NS_PER_MS; break;
+			case 's' : load.seed = strtoul(optarg, NULL, 0); break;
+			default : howto(); return -1;
+		}
+	}
+	if (!single) {
+		errors = suite();
+		printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+		return (errors == 0 ? 0 : -1);
+	}
+	if (load.pins == 0 || load.pins > 32 || load.config.rate <= 0 || load.config.width_ns == 0 || load.seed == 0 ||
+			load.config.burst == 0 || load.config.burst_rate <= 0 || load.config.bounce_ns == 0) {
+		howto();
+		return -1;
+	}
+	if (execute(&load, &r) != 0)
+		return -1;
+	print_header();
+	print_result(&load, &r);
+	printf("throughput: %.0f impulsi/s consegnati\n", r.throughput);
+	return check_conservation(&r) == 0 ? 0 : -1;
+}
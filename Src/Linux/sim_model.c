@@ -0,0 +1,232 @@
+/**
+ * @file sim_model.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example sim_model.c
+ * Il file sim_model.c contiene una verifica del modello del banco di registri definito in myGPIO_model.h,
+ * condotta attraverso le funzioni di myGPIO.c, compilate con MYGPIO_BACKEND definito. Vengono verificati
+ * la configurazione tri-state dei pin, la larghezza del device, il bit IS di GIES, l'accumulo in OR di IRQ
+ * indipendente da IE, la semantica di IACK, che resta attivo fino alla scrittura successiva, e la consegna delle notifiche della linea di interrupt, anche
+ * quando la funzione notificata serve l'interruzione accedendo al device. Infine viene riportato il tempo
+ * medio di myGPIO_Toggle() e di myGPIO_GetRead() senza latenza e con il modello di latenza attivo.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_model.h"
+#include "bench.h"
+
+static uint32_t errors = 0;
+
+#define CHECK(cond) do {                                  \
+	if (!(cond)) {                                        \
+		printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+		errors++;                                         \
+	}                                                     \
+} while (0)
+
+static uint32_t rises, falls, served;
+
+/**
+ * @brief Conta i cambiamenti della linea di interrupt.
+ */
+static void count_interrupt(myGPIO_Model_t *model, uint32_t level, void *arg) {
+	(void)model;
+	(void)arg;
+	if (level)
+		rises++;
+	else
+		falls++;
+}
+
+/**
+ * @brief Serve l'interruzione come farebbe una ISR: legge i pin pendenti e li riconosce.
+ */
+static void serve_interrupt(myGPIO_Model_t *model, uint32_t level, void *arg) {
+	myGPIO_t gpio = myGPIO_Model_Gpio(model);
+	uint32_t pending;
+	(void)arg;
+	count_interrupt(model, level, NULL);
+	if (!level)
+		return;
+	pending = myGPIO_PendingPinInterrupt(gpio);
+	served |= pending;
+	myGPIO_PinInterruptAck(gpio, pending);
+}
+
+static void check_registers(void) {
+	myGPIO_Model_t model;
+	myGPIO_t gpio;
+
+	myGPIO_Model_Init(&model, 8);
+	myGPIO_Model_SetInterrupt(&model, count_interrupt, NULL);
+	gpio = myGPIO_Model_Gpio(&model);
+	CHECK(myGPIO_Model_Of(gpio) == &model);
+
+	// tri-state: le uscite leggono WRITE, gli ingressi i livelli esterni; oltre la larghezza si legge zero
+	myGPIO_Model_SetPins(&model, 0xFFFFFFFFU, 0x0000F0A5U);
+	myGPIO_SetMode(gpio, 0x0F, MYGPIO_MODE_WRITE);
+	myGPIO_SetValue(gpio, 0xFFFFFFFFU, MYGPIO_PIN_SET);
+	myGPIO_SetValue(gpio, 0x03, MYGPIO_PIN_RESET);
+	CHECK(myGPIO_GetRead(gpio) == 0xAC);
+	CHECK(model.reg[WRITE_REG] == 0xFFFFFFFCU);
+	CHECK(myGPIO_Model_GetPins(&model) == 0xAC);
+	myGPIO_RegWrite(gpio, READ_REG, 0x12345678U);
+	CHECK(myGPIO_GetRead(gpio) == 0xAC);
+
+	// IRQ accumula in OR gli ingressi abilitati in PIE, anche con IE a zero; IS ne riporta la or-reduce
+	myGPIO_Model_SetPins(&model, 0xF0, 0x00);
+	myGPIO_PinInterruptEnable(gpio, 0x30 | 0x01);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0);
+	CHECK((myGPIO_RegRead(gpio, GIES_REG) & 2) == 0);
+	myGPIO_Model_SetPins(&model, 0xF1, 0x11);
+	myGPIO_Model_SetPins(&model, 0xF1, 0x20);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0x30);
+	CHECK(myGPIO_PendingInterrupt(gpio) != 0);
+	CHECK(rises == 0);
+
+	// solo il bit IE di GIES viene scritto; abilitandolo la linea sale
+	myGPIO_RegWrite(gpio, GIES_REG, 0xFFFFFFFFU);
+	CHECK(myGPIO_RegRead(gpio, GIES_REG) == 3);
+	CHECK(rises == 1 && model.line == 1);
+
+	// IACK: viene letto come scritto e resetta IRQ; scrivere IRQ non ha effetto
+	myGPIO_RegWrite(gpio, IRQ_REG, 0);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0x30);
+	myGPIO_PinInterruptAck(gpio, 0x30);
+	CHECK(myGPIO_RegRead(gpio, IACK_REG) == 0x30);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0);
+	CHECK(falls == 1 && model.line == 0);
+	// finché IACK non viene azzerato da un'altra scrittura IRQ non accumula: l'impulso sul pin 4 va perso,
+	// ed il pin 5, ancora alto, torna in IRQ solo dopo la scrittura
+	myGPIO_Model_SetPins(&model, 0x10, 0x10);
+	myGPIO_Model_SetPins(&model, 0x10, 0x00);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0);
+	myGPIO_RegWrite(gpio, IACK_REG, 0);
+	CHECK(myGPIO_RegRead(gpio, IACK_REG) == 0);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0x20);
+	CHECK(rises == 2 && model.line == 1);
+	myGPIO_Model_SetPins(&model, 0x20, 0x00);
+	myGPIO_PinInterruptAck(gpio, 0x20);
+	myGPIO_RegWrite(gpio, GIES_REG, 1);
+	CHECK(myGPIO_RegRead(gpio, IACK_REG) == 0);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0);
+	CHECK(falls == 2 && model.line == 0);
+	CHECK((myGPIO_RegRead(gpio, GIES_REG) & 2) == 0);
+	// con IACK azzerato un impulso viene nuovamente registrato
+	myGPIO_Model_SetPins(&model, 0x10, 0x10);
+	myGPIO_Model_SetPins(&model, 0x10, 0x00);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0x10);
+	myGPIO_PinInterruptAck(gpio, 0x10);
+	myGPIO_RegWrite(gpio, IACK_REG, 0);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0);
+
+	// un pin configurato come uscita non genera interruzioni
+	myGPIO_PinInterruptEnable(gpio, 0x02);
+	CHECK(myGPIO_PendingPinInterrupt(gpio) == 0);
+	myGPIO_GlobalInterruptDisable(gpio);
+	CHECK(myGPIO_IsGlobalInterruptEnabled(gpio) == 0);
+}
+
+static void check_isr(void) {
+	myGPIO_Model_t model;
+	myGPIO_t gpio;
+	uint32_t i;
+
+	rises = falls = served = 0;
+	myGPIO_Model_Init(&model, 32);
+	myGPIO_Model_SetInterrupt(&model, serve_interrupt, NULL);
+	gpio = myGPIO_Model_Gpio(&model);
+	myGPIO_PinInterruptEnable(gpio, 0xFFFF0000U);
+	// un impulso su un pin resta memorizzato in IRQ: abilitando IE la ISR viene invocata, lo riconosce e
+	// la linea scende, all'interno della stessa notifica
+	for (i = 16; i < 32; i++) {
+		myGPIO_Model_SetPins(&model, MYGPIO_PIN(i), MYGPIO_PIN(i));
+		myGPIO_Model_SetPins(&model, MYGPIO_PIN(i), 0);
+		myGPIO_GlobalInterruptEnable(gpio);
+		myGPIO_GlobalInterruptDisable(gpio);
+	}
+	CHECK(served == 0xFFFF0000U);
+	CHECK(rises == 16 && falls == 16);
+	CHECK(myGPIO_PendingInterrupt(gpio) == 0);
+}
+
+static void measure(const char *name, myGPIO_Model_t *model, uint32_t iterations) {
+	myGPIO_t gpio = myGPIO_Model_Gpio(model);
+	uint64_t start;
+	uint32_t i, sink = 0;
+
+	start = bench_now_ns();
+	for (i = 0; i < iterations; i++)
+		myGPIO_Toggle(gpio, MYGPIO_PIN0);
+	printf("%-28s myGPIO_Toggle  %8.1f ns\n", name, (double)(bench_now_ns() - start) / iterations);
+	start = bench_now_ns();
+	for (i = 0; i < iterations; i++)
+		sink += myGPIO_GetRead(gpio);
+	printf("%-28s myGPIO_GetRead %8.1f ns\n", name, (double)(bench_now_ns() - start) / iterations);
+	(void)sink;
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("sim_model [-r ns] [-w ns] [-n iterazioni]\n");
+	printf("\t-r <ns>: costo di una lettura nel modello di latenza (default 150)\n");
+	printf("\t-w <ns>: costo di una scrittura nel modello di latenza (default 60)\n");
+	printf("\t-n <num>: iterazioni per misura (default 100000)\n");
+}
+
+int main(int argc, char **argv) {
+	myGPIO_Model_t model;
+	uint32_t read_ns = 150, write_ns = 60, iterations = 100000;
+	int par;
+
+	while ((par = getopt(argc, argv, "r:w:n:")) != -1) {
+		switch (par) {
+			case 'r' : read_ns = strtoul(optarg, NULL, 0); break;
+			case 'w' : write_ns = strtoul(optarg, NULL, 0); break;
+			case 'n' : iterations = strtoul(optarg, NULL, 0); break;
+			default : howto(); return -1;
+		}
+	}
+	if (iterations == 0) {
+		howto();
+		return -1;
+	}
+
+	check_registers();
+	check_isr();
+
+	myGPIO_Model_Init(&model, 32);
+	measure("senza latenza", &model, iterations);
+	myGPIO_Model_SetLatency(&model, read_ns, write_ns, 1);
+	model.reads = model.writes = 0;
+	measure("con latenza", &model, iterations);
+	printf("tempo attribuito agli accessi: %" PRIu64 " ns per %lu letture e %lu scritture\n", model.time_ns, model.reads, model.writes);
+
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	return (errors == 0 ? 0 : -1);
+}
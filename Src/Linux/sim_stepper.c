@@ -0,0 +1,387 @@
+/**
+ * @file sim_stepper.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example sim_stepper.c
+ * Il file sim_stepper.c contiene una simulazione, eseguibile sull'host, del generatore di impulsi STEP/DIR
+ * definito in myGPIO_stepper.h. Il driver viene compilato con MYGPIO_BACKEND definito, ed opera sul
+ * simulatore in tempo virtuale di myGPIO_sim.h: ogni accesso ai registri ed ogni lettura del contatore
+ * fanno avanzare il tempo, mentre il resto del codice eseguito dalla CPU, compreso il riempimento dei
+ * buffer, non ne consuma. Sui fronti di salita delle linee STEP viene registrato l'istante dell'impulso e
+ * verificato il livello della linea DIR.
+ * Il movimento di quattro assi, due con profilo trapezoidale e due con profilo ad S, viene riprodotto con
+ * myGPIO_Stepper_Run() e poi generato asse per asse, come farebbe un driver senza tabelle fuse: ciascun asse
+ * ha un proprio timer, il cui gestore emette l'impulso con due chiamate a myGPIO_Toggle() e programma
+ * l'impulso successivo. L'ingresso nel gestore costa una latenza pseudo-casuale, compresa fra
+ * TIMER_NS - TIMER_JITTER / 2 e TIMER_NS + TIMER_JITTER / 2, che occupa la CPU; i timer vengono anticipati
+ * della latenza media, ed i gestori, che non si interrompono a vicenda, serializzano gli impulsi vicini.
+ * In entrambi i casi la CPU viene inoltre interrotta, ogni millisecondo, dal tick di sistema, il cui
+ * gestore la occupa per un tempo pseudo-casuale fra TICK_NS e TICK_NS + TICK_JITTER; le sequenze
+ * pseudo-casuali sono le stesse nelle due esecuzioni.
+ * Per entrambi vengono riportati il numero di scritture e, rispetto allo stesso riferimento, il profilo
+ * ideale calcolato con myGPIO_Stepper_Time(), l'errore minimo, massimo e quadratico medio e la sua
+ * escursione (massimo meno minimo). Per la sequenza fusa viene inoltre riportato lo scostamento dal tick
+ * programmato, dovuto al solo tick di sistema, ed il solo errore di quantizzazione degli istanti ideali al
+ * tick, che ne costituisce il limite inferiore.
+ * L'errore della sequenza fusa è dominato dalla quantizzazione, uniforme entro mezzo tick, con valore
+ * quadratico medio pari a circa il tick diviso per radice di 12: alla frequenza di default di 1 MHz, circa
+ * 290 ns, contro gli 1.7 us della generazione asse per asse, la cui latenza varia ad ogni impulso e cresce
+ * con il numero di assi e con la coincidenza dei loro impulsi. Il rapporto si riduce con la frequenza del
+ * tick: sotto i 400 kHz la verifica seguente fallisce, e sotto i 170 kHz circa la quantizzazione
+ * supera l'errore dei timer, per cui il vantaggio della sequenza fusa resta il solo numero di interruzioni.
+ * Viene verificato che ogni asse riceva il numero di impulsi atteso, con DIR corretto, che ogni impulso
+ * della sequenza fusa disti dal profilo ideale al più mezzo tick, oltre all'eventuale tick di sistema, e
+ * che l'errore quadratico medio della sequenza fusa sia al più la metà di quello della generazione asse
+ * per asse.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_playback.h"
+#include "myGPIO_stepper.h"
+#include "myGPIO_sim.h"
+
+#define AXES          4
+#define TIMER_NS      2000     //!< latenza media di ingresso nel gestore del timer di un asse, in ns
+#define TIMER_JITTER  1000     //!< ampiezza dell'intervallo di variazione di tale latenza, in ns
+#define TICK_PERIOD   1000000  //!< periodo del tick di sistema, in ns
+#define TICK_NS       2000     //!< durata minima del gestore del tick di sistema, in ns
+#define TICK_JITTER   2000     //!< variazione massima della durata del gestore del tick di sistema, in ns
+
+/**
+ * @brief Movimento simulato: pin e profilo di ciascun asse.
+ */
+static const struct {
+	uint32_t step_pin, dir_pin;
+	int32_t  steps;
+	double   velocity, acceleration;
+	uint32_t profile;
+} move[AXES] = {
+	{0, 1,  3200, 20000, 100000, MYGPIO_STEPPER_TRAPEZOID},
+	{2, 3, -3200, 20000, 100000, MYGPIO_STEPPER_TRAPEZOID},
+	{4, 5,  2000, 15000,  60000, MYGPIO_STEPPER_SCURVE},
+	{6, 7, -1200, 10000,  50000, MYGPIO_STEPPER_SCURVE}
+};
+
+/**
+ * @brief Stato di una esecuzione.
+ */
+static struct {
+	myGPIO_Sim_t  sim;             //!< simulatore
+	uint64_t      origin;          //!< istante a cui corrisponde l'inizio del profilo ideale
+	int           armed;           //!< vero finché l'origine della sequenza fusa non è stata fissata
+	uint32_t      period;          //!< periodo del tick della sequenza fusa, in ns
+	uint32_t      outputs;         //!< ultimo valore notificato delle uscite
+	uint32_t      next[AXES];      //!< prossimo impulso di ciascun asse, nella generazione asse per asse
+	uint32_t      timer_seed;      //!< stato del generatore della latenza dei timer
+	uint32_t      tick_seed;       //!< stato del generatore della durata del tick di sistema
+	uint64_t     *edge[AXES];      //!< istanti dei fronti di salita di STEP, per asse
+	uint32_t      edges[AXES];     //!< numero di fronti di salita registrati, per asse
+	uint32_t      wrong_dir;       //!< fronti di salita di STEP con DIR errato
+	uint32_t      overflow;        //!< fronti di salita di STEP in eccesso
+	unsigned long writes;          //!< scritture precedenti l'inizio del movimento
+} run;
+
+/**
+ * @brief Generatore pseudo-casuale xorshift32
+ */
+static uint32_t xorshift32(uint32_t *x) {
+	*x ^= *x << 13;
+	*x ^= *x >> 17;
+	*x ^= *x << 5;
+	return *x;
+}
+
+/**
+ * @brief Registra i fronti di salita di STEP, al termine della scrittura che li produce.
+ */
+static void on_output(myGPIO_Model_t *model, uint32_t pins, void *arg) {
+	uint32_t a, rising = pins & ~run.outputs;
+	(void)model;
+	(void)arg;
+	run.outputs = pins;
+	for (a = 0; a < AXES; a++)
+		if ((rising & MYGPIO_PIN(move[a].step_pin)) != 0) {
+			int forward = ((pins & MYGPIO_PIN(move[a].dir_pin)) != 0);
+			if (forward != (move[a].steps >= 0))
+				run.wrong_dir++;
+			if (run.edges[a] < (uint32_t)abs(move[a].steps))
+				run.edge[a][run.edges[a]++] = run.sim.now;
+			else
+				run.overflow++;
+		}
+}
+
+/**
+ * @brief Gestore del tick di sistema: occupa la CPU per un tempo pseudo-casuale.
+ */
+static void system_tick(myGPIO_Sim_t *sim, void *arg) {
+	(void)sim;
+	(void)arg;
+	myGPIO_Sim_Delay(TICK_NS + xorshift32(&run.tick_seed) % (TICK_JITTER + 1));
+}
+
+/**
+ * @brief Inizializza il simulatore per una nuova esecuzione.
+ */
+static void run_reset(void) {
+	uint32_t a;
+	for (a = 0; a < AXES; a++) {
+		run.edges[a] = 0;
+		run.next[a] = 0;
+	}
+	run.wrong_dir = 0;
+	run.overflow = 0;
+	run.outputs = 0;
+	run.armed = 0;
+	run.timer_seed = 0x2545F491U;
+	run.tick_seed = 0x9E3779B9U;
+	myGPIO_Sim_Init(&run.sim, 8);
+	myGPIO_Model_SetOutput(&run.sim.model, on_output, NULL);
+	myGPIO_Sim_Schedule(&run.sim, TICK_PERIOD / 2, TICK_PERIOD, system_tick, NULL);
+}
+
+/**
+ * @brief Contatore del motore di playback: fissa l'origine della sequenza fusa alla prima scadenza,
+ * che myGPIO_Playback_Start() calcola a partire dalla prima lettura successiva all'armamento.
+ */
+static uint32_t playback_clock(void) {
+	uint32_t now = myGPIO_Sim_Timestamp();
+	if (run.armed) {
+		run.armed = 0;
+		run.origin = run.sim.now + run.period;
+	}
+	return now;
+}
+
+/**
+ * @brief Statistiche degli scostamenti, in ns.
+ */
+typedef struct {
+	double min, max, sum2;
+	unsigned long count;
+} stats_t;
+
+static void stats_init(stats_t *s) {
+	s->min = 1e30;
+	s->max = -1e30;
+	s->sum2 = 0;
+	s->count = 0;
+}
+
+static void stats_add(stats_t *s, double value) {
+	if (value < s->min)
+		s->min = value;
+	if (value > s->max)
+		s->max = value;
+	s->sum2 += value * value;
+	s->count++;
+}
+
+static double period_ns;
+static uint32_t *table[AXES];
+
+/**
+ * @brief Istante ideale, in ns dall'inizio del movimento, dell'impulso k-esimo dell'asse a.
+ */
+static double ideal_ns(uint32_t a, uint32_t k) {
+	return 1e9 * myGPIO_Stepper_Time((uint32_t)abs(move[a].steps), move[a].velocity, move[a].acceleration, move[a].profile, k + 1);
+}
+
+/**
+ * @brief Verifica il numero di impulsi e DIR, e stampa errore e jitter.
+ *
+ * @param[in]  scheduled istante programmato dell'impulso k-esimo dell'asse a, in ns dall'origine
+ * @param[in]  bound     massimo errore ammesso rispetto al profilo ideale, in ns; negativo se non verificato
+ * @param[out] rms       errore quadratico medio rispetto al profilo ideale, in ns
+ */
+static uint32_t report(const char *name, double (*scheduled)(uint32_t a, uint32_t k), double bound, double *rms) {
+	stats_t error, deviation;
+	uint32_t a, k, errors = 0;
+	stats_init(&error);
+	stats_init(&deviation);
+	for (a = 0; a < AXES; a++) {
+		if (run.edges[a] != (uint32_t)abs(move[a].steps)) {
+			printf("asse %u: %u impulsi, attesi %d\n", a, run.edges[a], abs(move[a].steps));
+			errors++;
+		}
+		for (k = 0; k < run.edges[a]; k++) {
+			double t = (double)(int64_t)(run.edge[a][k] - run.origin);
+			stats_add(&error, t - ideal_ns(a, k));
+			if (scheduled != NULL)
+				stats_add(&deviation, t - scheduled(a, k));
+			if (bound >= 0 && fabs(t - ideal_ns(a, k)) > bound)
+				errors++;
+		}
+	}
+	errors += run.wrong_dir + run.overflow;
+	*rms = sqrt(error.sum2 / error.count);
+	printf("%-30s %8lu %10.0f %10.0f %10.0f %10.0f", name, run.sim.model.writes - run.writes, error.min, error.max, *rms, error.max - error.min);
+	if (scheduled != NULL)
+		printf(" %10.0f", deviation.max - deviation.min);
+	printf("\n");
+	return errors;
+}
+
+/**
+ * @brief Stampa l'errore dovuto alla sola quantizzazione degli istanti ideali al tick.
+ */
+static void report_quantization(void) {
+	stats_t error;
+	uint32_t a, k;
+	stats_init(&error);
+	for (a = 0; a < AXES; a++)
+		for (k = 0; k < (uint32_t)abs(move[a].steps); k++)
+			stats_add(&error, table[a][k] * period_ns - ideal_ns(a, k));
+	printf("%-30s %8s %10.0f %10.0f %10.0f %10.0f   (rms uniforme: %.0f)\n", "quantizzazione al tick", "", error.min,
+			error.max, sqrt(error.sum2 / error.count), error.max - error.min, period_ns / sqrt(12));
+}
+
+static double scheduled_tick(uint32_t a, uint32_t k) {
+	return table[a][k] * period_ns;
+}
+
+/**
+ * @brief Gestore del timer dell'asse arg: emette l'impulso con due chiamate a myGPIO_Toggle() e programma
+ * il timer per l'impulso successivo, in anticipo della latenza media.
+ */
+static void axis_timer(myGPIO_Sim_t *sim, void *arg) {
+	uint32_t a = (uint32_t)(uintptr_t)arg;
+	myGPIO_t gpio = myGPIO_Sim_Gpio(sim);
+	myGPIO_Sim_Delay(TIMER_NS - TIMER_JITTER / 2 + xorshift32(&run.timer_seed) % (TIMER_JITTER + 1));
+	myGPIO_Toggle(gpio, MYGPIO_PIN(move[a].step_pin));
+	myGPIO_Toggle(gpio, MYGPIO_PIN(move[a].step_pin));
+	if (++run.next[a] < (uint32_t)abs(move[a].steps))
+		myGPIO_Sim_Schedule(sim, run.origin + (uint64_t)(ideal_ns(a, run.next[a]) + 0.5) - TIMER_NS, 0, axis_timer, arg);
+}
+
+/**
+ * @brief Genera il movimento asse per asse, con un timer per ciascun asse.
+ */
+static void toggle_run(void) {
+	myGPIO_t gpio = myGPIO_Sim_Gpio(&run.sim);
+	uint32_t a, dir = 0, mode = 0;
+	double end = 0;
+	for (a = 0; a < AXES; a++) {
+		mode |= MYGPIO_PIN(move[a].step_pin) | MYGPIO_PIN(move[a].dir_pin);
+		if (move[a].steps >= 0)
+			dir |= MYGPIO_PIN(move[a].dir_pin);
+		if (ideal_ns(a, abs(move[a].steps) - 1) > end)
+			end = ideal_ns(a, abs(move[a].steps) - 1);
+	}
+	myGPIO_SetMode(gpio, mode, MYGPIO_MODE_WRITE);
+	myGPIO_SetValue(gpio, dir, MYGPIO_PIN_SET);
+	run.writes = run.sim.model.writes;
+	run.origin = run.sim.now + 10000;
+	for (a = 0; a < AXES; a++)
+		myGPIO_Sim_Schedule(&run.sim, run.origin + (uint64_t)(ideal_ns(a, 0) + 0.5) - TIMER_NS, 0, axis_timer, (void*)(uintptr_t)a);
+	myGPIO_Sim_RunUntil(&run.sim, run.origin + (uint64_t)end + TICK_PERIOD);
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("sim_stepper [-r frequenza] [-l lunghezza]\n");
+	printf("\t-r <Hz>: frequenza di aggiornamento del motore di playback, divisore di 1 GHz (default 1000000)\n");
+	printf("\t-l <num>: lunghezza di ciascuno dei due buffer (default 256)\n");
+}
+
+int main(int argc, char **argv) {
+	myGPIO_Stepper_t st;
+	myGPIO_Playback_t pb;
+	uint32_t *buffer, rate = 1000000, length = 256, a, errors = 0;
+	double fused_rms, toggle_rms;
+	int par, status;
+
+	while ((par = getopt(argc, argv, "r:l:")) != -1) {
+		switch (par) {
+			case 'r' : rate = strtoul(optarg, NULL, 0); break;
+			case 'l' : length = strtoul(optarg, NULL, 0); break;
+			default : howto(); return -1;
+		}
+	}
+	if (rate == 0 || rate > 1000000 || length == 0) {
+		howto();
+		return -1;
+	}
+	if (1000000000U % rate != 0) {
+		printf("il tick deve durare un numero intero di ns: la frequenza deve essere un divisore di 1 GHz\n");
+		return -1;
+	}
+	for (a = 0; a < AXES; a++)
+		if (4 * move[a].velocity > rate) {
+			printf("la frequenza deve essere almeno pari a %.0f Hz\n", 4 * move[a].velocity);
+			return -1;
+		}
+	period_ns = 1000000000U / rate;
+	buffer = malloc(2 * length * sizeof(uint32_t));
+	for (a = 0; a < AXES; a++) {
+		table[a] = malloc(abs(move[a].steps) * sizeof(uint32_t));
+		run.edge[a] = malloc(abs(move[a].steps) * sizeof(uint64_t));
+	}
+
+	printf("%u assi, tick da %.0f ns, buffer da %u parole\n", AXES, period_ns, length);
+	printf("errori rispetto al profilo ideale, in ns; \"scost.tick\": escursione dello scostamento dal tick programmato\n");
+	printf("%-30s %8s %10s %10s %10s %10s %10s\n", "", "write", "err min", "err max", "err rms", "escursione", "scost.tick");
+
+	run_reset();
+	myGPIO_Stepper_Init(&st, myGPIO_Sim_Gpio(&run.sim), rate);
+	for (a = 0; a < AXES; a++)
+		myGPIO_Stepper_AddAxis(&st, move[a].step_pin, move[a].dir_pin, table[a], abs(move[a].steps), move[a].steps, move[a].velocity, move[a].acceleration, move[a].profile);
+	run.period = 1000000000U / rate;
+	myGPIO_Playback_Init(&pb, myGPIO_Sim_Gpio(&run.sim), playback_clock, run.period, MYGPIO_PLAYBACK_DOUBLE);
+	run.writes = run.sim.model.writes;
+	run.armed = 1;
+	status = myGPIO_Stepper_Run(&st, &pb, buffer, length);
+	report_quantization();
+	errors += report("sequenza fusa (playback)", scheduled_tick, period_ns / 2 + pb.spin + run.sim.model.write_ns + TICK_NS + TICK_JITTER, &fused_rms);
+	if (status != 0) {
+		printf("underrun durante il movimento\n");
+		errors++;
+	}
+	myGPIO_Sim_Destroy(&run.sim);
+
+	run_reset();
+	toggle_run();
+	errors += report("asse per asse (myGPIO_Toggle)", NULL, -1, &toggle_rms);
+	myGPIO_Sim_Destroy(&run.sim);
+
+	if (2 * fused_rms > toggle_rms) {
+		printf("errore quadratico medio della sequenza fusa superiore alla metà di quello asse per asse\n");
+		errors++;
+	}
+	else
+		printf("errore quadratico medio della sequenza fusa %.1f volte inferiore a quello asse per asse\n", toggle_rms / fused_rms);
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	for (a = 0; a < AXES; a++) {
+		free(table[a]);
+		free(run.edge[a]);
+	}
+	free(buffer);
+	return (errors == 0 ? 0 : -1);
+}
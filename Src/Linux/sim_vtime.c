@@ -0,0 +1,308 @@
+/**
+ * @file sim_vtime.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example sim_vtime.c
+ * Il file sim_vtime.c contiene alcuni scenari eseguiti con il simulatore in tempo virtuale definito in
+ * myGPIO_sim.h, ciascuno dei quali dipende dal tempo e sarebbe lento ed instabile da verificare in tempo
+ * reale:
+ *  - due ore di pressioni di un pulsante con rimbalzi, campionato da myGPIO_Debounce_Sample() ad ogni
+ *    millisecondo, verificando che ogni pressione venga riconosciuta una ed una sola volta;
+ *  - la latenza di servizio di impulsi su 16 pin, serviti da myGPIO_Dispatch_Isr();
+ *  - otto canali di bit-angle modulation, con il timer riprogrammato ad ogni slot secondo quanto restituito
+ *    da myGPIO_Pwm_Tick(), verificando il duty-cycle misurato sui pin;
+ *  - la riproduzione di una sequenza con il motore di playback, che usa myGPIO_Sim_Timestamp() come
+ *    contatore ed il cui ciclo di ritardo fine avanza il tempo virtuale attraverso myGPIO_Spin().
+ * Per ciascuno scenario vengono riportati il tempo simulato, il tempo reale impiegato ed i risultati; lo
+ * scenario degli interrupt viene eseguito due volte, verificando che i risultati coincidano.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_debounce.h"
+#include "myGPIO_dispatch.h"
+#include "myGPIO_pwm.h"
+#include "myGPIO_playback.h"
+#include "myGPIO_sim.h"
+#include "bench.h"
+
+#define NS_PER_MS 1000000ULL
+#define NS_PER_S  1000000000ULL
+
+static uint64_t failures;  //!< azioni periodiche non riprogrammate, in tutti gli scenari
+
+static uint32_t xorshift32(uint32_t *state) {
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+static void report(const char *name, const myGPIO_Sim_t *sim, uint64_t real_ns) {
+	printf("%-26s %12.3f s simulati in %8.3f s (x%.0f), %" PRIu64 " azioni, %" PRIu64 " interrupt\n", name, (double)sim->now / NS_PER_S,
+			(double)real_ns / NS_PER_S, (double)sim->now / (double)(real_ns != 0 ? real_ns : 1), sim->actions, sim->interrupts);
+	if (sim->failures != 0) {
+		printf("\t%" PRIu64 " azioni periodiche non riprogrammate\n", sim->failures);
+		failures += sim->failures;
+	}
+}
+
+/*
+ * Pulsante con rimbalzi sul pin 0, campionato ogni millisecondo.
+ */
+static myGPIO_Debounce_t button;
+static uint32_t presses_detected;
+
+static void sample_button(myGPIO_Sim_t *sim, void *arg) {
+	uint32_t changed = myGPIO_Debounce_Sample(&button, myGPIO_Sim_Gpio(sim));
+	(void)arg;
+	if ((changed & button.state & MYGPIO_PIN0) != 0)
+		presses_detected++;
+}
+
+/**
+ * @brief Programma un fronte con rimbalzi: da 2 a 16 commutazioni, distanziate da 20 a 200 us.
+ */
+static uint64_t bounce(myGPIO_Sim_t *sim, uint64_t t, uint32_t level, uint32_t *state) {
+	uint32_t i, n = 2 + 2 * (xorshift32(state) % 8);
+	for (i = 0; i < n; i++) {
+		myGPIO_Sim_SchedulePins(sim, t, MYGPIO_PIN0, (i & 1) ? !level : level);
+		t += 20000 + (xorshift32(state) % 180) * 1000;
+	}
+	myGPIO_Sim_SchedulePins(sim, t, MYGPIO_PIN0, level);
+	return t;
+}
+
+static uint32_t scenario_debounce(uint64_t duration) {
+	myGPIO_Sim_t sim;
+	uint32_t state = 0xC0FFEE11U, presses = 0;
+	uint64_t t = 100 * NS_PER_MS, start;
+
+	myGPIO_Sim_Init(&sim, 8);
+	myGPIO_Debounce_Init(&button, 0, 4);
+	presses_detected = 0;
+	while (t + 10 * NS_PER_S < duration) {
+		t = bounce(&sim, t, MYGPIO_PIN0, &state);
+		t += (50 + xorshift32(&state) % 700) * NS_PER_MS;
+		t = bounce(&sim, t, 0, &state);
+		t += (1000 + xorshift32(&state) % 9000) * NS_PER_MS;
+		presses++;
+	}
+	myGPIO_Sim_Schedule(&sim, 0, NS_PER_MS, sample_button, NULL);
+	start = bench_now_ns();
+	myGPIO_Sim_RunUntil(&sim, duration);
+	report("debounce", &sim, bench_now_ns() - start);
+	printf("\t%u pressioni, %u riconosciute\n", presses, presses_detected);
+	myGPIO_Sim_Destroy(&sim);
+	return (presses_detected != presses);
+}
+
+/*
+ * Impulsi su 16 pin, serviti da myGPIO_Dispatch_Isr().
+ */
+static uint64_t pulse_time[16];
+static uint64_t latency_min, latency_max, latency_sum, served;
+
+static void on_pulse(myGPIO_t gpio, uint32_t pins, void *arg) {
+	uint32_t i;
+	(void)gpio;
+	(void)arg;
+	for (i = 0; i < 16; i++)
+		if ((pins & MYGPIO_PIN(i)) != 0) {
+			uint64_t latency = myGPIO_Sim_Now() - pulse_time[i];
+			if (latency < latency_min)
+				latency_min = latency;
+			if (latency > latency_max)
+				latency_max = latency;
+			latency_sum += latency;
+			served++;
+		}
+}
+
+/**
+ * @brief Azione che genera il prossimo impulso, su un pin pseudo-casuale, e ne annota l'istante.
+ */
+static uint32_t pulse_state;
+static void next_pulse(myGPIO_Sim_t *sim, void *arg) {
+	uint32_t pin = xorshift32(&pulse_state) % 16;
+	uint64_t t = sim->now + 1000 + xorshift32(&pulse_state) % 20000;
+	(void)arg;
+	pulse_time[pin] = t;
+	myGPIO_Sim_SchedulePins(sim, t, MYGPIO_PIN(pin), MYGPIO_PIN(pin));
+	myGPIO_Sim_SchedulePins(sim, t + 500, MYGPIO_PIN(pin), 0);
+}
+
+static uint64_t scenario_interrupt(uint32_t pulses) {
+	myGPIO_Sim_t sim;
+	myGPIO_Dispatch_t dispatch;
+	uint64_t start;
+
+	myGPIO_Sim_Init(&sim, 16);
+	myGPIO_Dispatch_Init(&dispatch, myGPIO_Sim_Gpio(&sim));
+	myGPIO_Dispatch_Register(&dispatch, 0xFFFF, on_pulse, NULL);
+	myGPIO_PinInterruptEnable(myGPIO_Sim_Gpio(&sim), 0xFFFF);
+	myGPIO_GlobalInterruptEnable(myGPIO_Sim_Gpio(&sim));
+	myGPIO_Sim_SetIsr(&sim, myGPIO_Dispatch_Isr, &dispatch, 400);
+	pulse_state = 0x2545F491U;
+	latency_min = ~0ULL;
+	latency_max = latency_sum = served = 0;
+	myGPIO_Sim_Schedule(&sim, 0, 25000, next_pulse, NULL);
+	start = bench_now_ns();
+	myGPIO_Sim_RunUntil(&sim, (uint64_t)pulses * 25000);
+	report("interrupt", &sim, bench_now_ns() - start);
+	printf("\t%" PRIu64 " impulsi serviti, latenza min %" PRIu64 " ns, media %.1f ns, max %" PRIu64 " ns\n", served, latency_min,
+			(double)latency_sum / (double)(served != 0 ? served : 1), latency_max);
+	myGPIO_Sim_Destroy(&sim);
+	return latency_sum ^ (latency_max << 32) ^ served;
+}
+
+/*
+ * Bit-angle modulation su 8 canali, con il timer riprogrammato ad ogni slot.
+ */
+#define PWM_UNIT_NS 2000ULL
+static struct {
+	myGPIO_Pwm_t pwm;
+	uint64_t     next;             //!< istante programmato del prossimo slot
+	uint64_t     changed;          //!< istante dell'ultimo cambiamento delle uscite
+	uint32_t     outputs;          //!< valore delle uscite dall'ultimo cambiamento
+	uint64_t     high[8];          //!< tempo trascorso a livello alto, per canale
+} bam;
+
+static void bam_tick(myGPIO_Sim_t *sim, void *arg) {
+	(void)arg;
+	bam.next += PWM_UNIT_NS * myGPIO_Pwm_Tick(&bam.pwm);
+	myGPIO_Sim_Schedule(sim, bam.next, 0, bam_tick, NULL);
+}
+
+static void bam_output(myGPIO_Model_t *model, uint32_t pins, void *arg) {
+	uint32_t i;
+	uint64_t now = ((myGPIO_Sim_t*)arg)->now;
+	(void)model;
+	for (i = 0; i < 8; i++)
+		if ((bam.outputs & MYGPIO_PIN(i)) != 0)
+			bam.high[i] += now - bam.changed;
+	bam.outputs = pins;
+	bam.changed = now;
+}
+
+static uint32_t scenario_bam(uint64_t duration) {
+	static const uint32_t duty[8] = {0, 1, 16, 64, 100, 128, 200, 255};
+	myGPIO_Sim_t sim;
+	uint64_t start, measured;
+	uint32_t i, errors = 0;
+
+	myGPIO_Sim_Init(&sim, 8);
+	myGPIO_Model_SetOutput(&sim.model, bam_output, &sim);
+	myGPIO_Pwm_Init(&bam.pwm, myGPIO_Sim_Gpio(&sim), 0xFF, MYGPIO_PWM_MODE_BAM, 8);
+	for (i = 0; i < 8; i++) {
+		myGPIO_Pwm_SetDuty(&bam.pwm, i, duty[i]);
+		bam.high[i] = 0;
+	}
+	myGPIO_Pwm_Commit(&bam.pwm);
+	bam.next = 0;
+	bam.changed = 0;
+	bam.outputs = 0;
+	myGPIO_Sim_Schedule(&sim, 0, 0, bam_tick, NULL);
+	start = bench_now_ns();
+	myGPIO_Sim_RunUntil(&sim, duration);
+	bam_output(&sim.model, bam.outputs, &sim);
+	report("bit-angle modulation", &sim, bench_now_ns() - start);
+	measured = duration;
+	printf("\tduty-cycle misurato:");
+	for (i = 0; i < 8; i++) {
+		double expected = duty[i] / 255.0, actual = (double)bam.high[i] / (double)measured;
+		printf(" %.4f", actual);
+		if (actual < expected - 0.001 || actual > expected + 0.001)
+			errors++;
+	}
+	printf("\n");
+	myGPIO_Sim_Destroy(&sim);
+	return errors;
+}
+
+/*
+ * Riproduzione di una sequenza con il motore di playback.
+ */
+static uint32_t scenario_playback(uint32_t words, uint32_t period_ns) {
+	myGPIO_Sim_t sim;
+	myGPIO_Playback_t pb;
+	uint32_t *buffer = malloc(words * sizeof(uint32_t)), i, errors;
+	uint64_t start;
+
+	for (i = 0; i < words; i++)
+		buffer[i] = i;
+	myGPIO_Sim_Init(&sim, 32);
+	myGPIO_Playback_Init(&pb, myGPIO_Sim_Gpio(&sim), myGPIO_Sim_Timestamp, period_ns, MYGPIO_PLAYBACK_ONESHOT);
+	myGPIO_Playback_Submit(&pb, buffer, words);
+	myGPIO_Playback_Start(&pb);
+	start = bench_now_ns();
+	myGPIO_Playback_Run(&pb, 0);
+	report("playback", &sim, bench_now_ns() - start);
+	printf("\t%u aggiornamenti, ritardo min %" PRId32 " ns, medio %.1f ns, max %" PRId32 " ns\n", pb.stats.ticks, pb.stats.late_min,
+			(double)pb.stats.late_sum / (double)pb.stats.ticks, pb.stats.late_max);
+	errors = (pb.stats.ticks != words || sim.model.reg[WRITE_REG] != words - 1 || pb.stats.late_max > (int32_t)period_ns);
+	myGPIO_Sim_Destroy(&sim);
+	free(buffer);
+	return errors;
+}
+
+/**
+ * @brief Stampa un messaggio che fornisce indicazioni sull'utilizzo del programma
+ */
+void howto(void) {
+	printf("Uso:\n");
+	printf("sim_vtime [-d secondi]\n");
+	printf("\t-d <num>: durata simulata dello scenario del pulsante (default 7200)\n");
+}
+
+int main(int argc, char **argv) {
+	uint32_t seconds = 7200, errors = 0;
+	uint64_t first;
+	int par;
+
+	while ((par = getopt(argc, argv, "d:")) != -1) {
+		switch (par) {
+			case 'd' : seconds = strtoul(optarg, NULL, 0); break;
+			default : howto(); return -1;
+		}
+	}
+	if (seconds < 20) {
+		howto();
+		return -1;
+	}
+
+	errors += scenario_debounce((uint64_t)seconds * NS_PER_S);
+	first = scenario_interrupt(100000);
+	if (scenario_interrupt(100000) != first) {
+		printf("\tla seconda esecuzione differisce dalla prima\n");
+		errors++;
+	}
+	errors += scenario_bam(NS_PER_S);
+	errors += scenario_playback(100000, 1000);
+	errors += (failures != 0);
+
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	return (errors == 0 ? 0 : -1);
+}
@@ -0,0 +1,173 @@
+/**
+ * @file test_hpp.cpp
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ * @example test_hpp.cpp
+ * Il file test_hpp.cpp contiene una verifica del layer C++ definito in myGPIO.hpp, compilata con
+ * -std=c++11 e MYGPIO_COUNT_ACCESS definito. Il banco di registri è una pagina di memoria anonima mappata
+ * all'indirizzo fisso MYGPIO_TEST_BASE, così da poter essere usata come parametro Base di Port. Per ciascuna
+ * operazione vengono verificati il contenuto dei registri ed il numero di letture e scritture effettuate:
+ * una sola store per le configurazioni che coprono tutti i pin del device, una sola read-modify-write per le
+ * altre, nessun accesso per le configurazioni vuote. Viene infine verificato che l'handle restituito da
+ * Port::regs() possa essere usato con le funzioni C di myGPIO.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include "myGPIO.hpp"
+
+#ifndef MYGPIO_TEST_BASE
+#define MYGPIO_TEST_BASE 0x43C00000UL  //!< indirizzo a cui viene mappato il banco di registri simulato
+#endif
+
+using namespace myGPIO;
+
+static unsigned errors = 0;
+
+#define CHECK(cond) do {                                  \
+	if (!(cond)) {                                        \
+		printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+		errors++;                                         \
+	}                                                     \
+} while (0)
+
+typedef PinSet<Pin<0>, Pin<1>, Pin<2>, Pin<3> > Low4;
+typedef PinSet<Pin<4>, Pin<5> >                 Mid2;
+typedef Port<MYGPIO_TEST_BASE, 4>               Narrow;
+typedef Port<MYGPIO_TEST_BASE, 32>              Wide;
+
+static unsigned long reads, writes;
+
+/**
+ * @brief Azzera i conteggi degli accessi.
+ */
+static void start() {
+	reads = myGPIO_BusReads;
+	writes = myGPIO_BusWrites;
+}
+
+/**
+ * @brief Verifica il numero di letture e scritture effettuate dall'ultima chiamata a start().
+ */
+#define CHECK_ACCESS(r, w) do {                  \
+	CHECK(myGPIO_BusReads - reads == (r));       \
+	CHECK(myGPIO_BusWrites - writes == (w));     \
+} while (0)
+
+static void check_masks() {
+	static_assert(Pin<7>::mask == 0x80U, "Pin");
+	static_assert(Low4::mask == 0x0FU, "PinSet");
+	static_assert(PinSet<Low4, Mid2>::mask == 0x3FU, "PinSet annidati");
+	static_assert(Narrow::width_mask == 0x0FU && Wide::width_mask == 0xFFFFFFFFU, "width_mask");
+	typedef Config<Output<Low4, MYGPIO_PIN_SET>, Input<PinSet<Pin<2> > > > C;
+	static_assert(C::mode_set == 0x0BU && C::mode_clear == 0x04U, "Config, MODE");
+	static_assert(C::write_set == 0x0FU && C::write_clear == 0, "Config, WRITE");
+}
+
+static void check_narrow(myGPIO_t regs) {
+	regs[MODE_REG] = 0;
+	regs[WRITE_REG] = 0xA;
+
+	// tutti i pin del device: una store per registro, senza letture
+	start();
+	Narrow::configure<Output<Low4, MYGPIO_PIN_RESET> >();
+	CHECK_ACCESS(0, 2);
+	CHECK(regs[MODE_REG] == 0x0F && regs[WRITE_REG] == 0);
+
+	// solo MODE viene toccato
+	start();
+	Narrow::configure<Input<Low4> >();
+	CHECK_ACCESS(0, 1);
+	CHECK(regs[MODE_REG] == 0 && regs[WRITE_REG] == 0);
+
+	// configurazione vuota: nessun accesso
+	start();
+	Narrow::configure<>();
+	CHECK_ACCESS(0, 0);
+
+	// una parte dei pin: una read-modify-write per registro
+	start();
+	Narrow::configure<Output<PinSet<Pin<0>, Pin<1> >, MYGPIO_PIN_SET> >();
+	CHECK_ACCESS(2, 2);
+	CHECK(regs[MODE_REG] == 0x3 && regs[WRITE_REG] == 0x3);
+
+	start();
+	Narrow::set<Pin<3> >();
+	Narrow::clear<Pin<0> >();
+	Narrow::toggle<Low4>();
+	CHECK_ACCESS(3, 3);
+	CHECK(regs[WRITE_REG] == 0x5);
+
+	start();
+	Narrow::write(0xFFFFFFFF);
+	CHECK_ACCESS(0, 1);
+	CHECK(regs[WRITE_REG] == 0x0F);
+
+	regs[READ_REG] = 0xF4;
+	start();
+	CHECK(Narrow::read() == 0x4);
+	CHECK(Narrow::get<Pin<2> >() && !Narrow::get<Pin<1> >());
+	CHECK_ACCESS(3, 0);
+}
+
+static void check_wide(myGPIO_t regs) {
+	regs[MODE_REG] = 0xFFFF0000;
+	regs[WRITE_REG] = 0xFFFF0000;
+
+	// Low4 non copre i 32 pin del device: read-modify-write, che preserva gli altri pin
+	start();
+	Wide::configure<Output<Low4, MYGPIO_PIN_SET>, Input<Mid2> >();
+	CHECK_ACCESS(2, 2);
+	CHECK(regs[MODE_REG] == 0xFFFF000F && regs[WRITE_REG] == 0xFFFF000F);
+
+	start();
+	Wide::configure<Output<PinSet<Low4, Mid2> >, Input<PinSet<Pin<31> > > >();
+	CHECK_ACCESS(2, 2);
+	CHECK(regs[MODE_REG] == 0x7FFF003F && regs[WRITE_REG] == 0xFFFF0000);
+}
+
+static void check_c_api(myGPIO_t regs) {
+	regs[WRITE_REG] = 0;
+	start();
+	myGPIO_Toggle(Wide::regs(), MYGPIO_PIN(8));
+	myGPIO_SetValue(Wide::regs(), MYGPIO_PIN(9), MYGPIO_PIN_SET);
+	CHECK_ACCESS(2, 2);
+	CHECK(regs[WRITE_REG] == 0x300);
+}
+
+int main() {
+	void *page = mmap((void*)MYGPIO_TEST_BASE, 4096, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (page == MAP_FAILED || page != (void*)MYGPIO_TEST_BASE) {
+		perror("mmap");
+		return -1;
+	}
+	myGPIO_t regs = (myGPIO_t)page;
+
+	check_masks();
+	check_narrow(regs);
+	check_wide(regs);
+	check_c_api(regs);
+
+	munmap(page, 4096);
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	return (errors == 0 ? 0 : -1);
+}
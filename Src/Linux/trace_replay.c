@@ -0,0 +1,136 @@
+/**
+ * @file trace_replay.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @example trace_replay.c
+ * Il file trace_replay.c riesegue sul modello del device, alla massima velocità, una registrazione degli
+ * accessi ai registri salvata con myGPIO_tracefile.h, ad esempio da noDriver-trace sul campo o da
+ * sim_lcd-trace e sim_keypad-trace sull'host, e confronta sullo stesso traffico i modi di accesso di
+ * myGPIO_replay.h: gli accessi così come registrati, le funzioni read-modify-write di myGPIO.h, gli handle
+ * shadow ed il batch. Per ciascun modo vengono riportati letture e scritture sul bus, il costo attribuito
+ * dal modello di latenza, il tempo impiegato dall'host per rieseguire la registrazione e le letture che
+ * hanno restituito un valore diverso da quello registrato. Viene infine verificato che tutti i modi
+ * lascino i device nello stesso stato e che shadow e batch riproducano le letture come read-modify-write.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+#include "myGPIO_tracefile.h"
+#include "myGPIO_replay.h"
+#include "bench.h"
+
+void howto(void) {
+	printf("Uso:\n");
+	printf("trace_replay [opzioni] file\n");
+	printf("\t-W <num>: numero di pin dei device (default 32)\n");
+	printf("\t-r <ns>: costo di una lettura nel modello di latenza (default 150)\n");
+	printf("\t-w <ns>: costo di una scrittura nel modello di latenza (default 60)\n");
+	printf("\t-n <num>: riesecuzioni per misura (default 10)\n");
+	printf("\t-p: stampa gli accessi registrati\n");
+}
+
+static void print_records(const myGPIO_TraceFile_t *header, const myGPIO_TraceRecord_t *record) {
+	static const char *reg_name[] = { "MODE", "WRITE", "READ", "GIES", "PIE", "IRQ", "IACK", "0x1C" };
+	uint32_t i;
+	for (i = 0; i < header->devices; i++)
+		printf("device %u: 0x%08" PRIx64 "\n", i, header->device[i]);
+	for (i = 0; i < header->records; i++)
+		printf("%12" PRIu64 " %3u %-5s %s 0x%08x\n", record[i].time - record[0].time, record[i].device,
+				reg_name[record[i].access & MYGPIO_TRACE_REG], (record[i].access & MYGPIO_TRACE_WRITE) ? "<-" : "->",
+				record[i].value);
+}
+
+int main(int argc, char **argv) {
+	static const char *mode_name[] = { "accessi registrati", "read-modify-write", "shadow", "batch" };
+	myGPIO_TraceFile_t header;
+	myGPIO_TraceRecord_t *record;
+	myGPIO_Replay_t replay;
+	uint32_t width = 32, read_ns = 150, write_ns = 60, iterations = 10, errors = 0, mode, i, d, reg;
+	uint32_t state[MYGPIO_TRACE_MAX_DEVICES][8];
+	unsigned long reference = 0;
+	uint64_t start;
+	int par, print = 0;
+
+	while ((par = getopt(argc, argv, "W:r:w:n:p")) != -1) {
+		switch (par) {
+			case 'W' : width = strtoul(optarg, NULL, 0); break;
+			case 'r' : read_ns = strtoul(optarg, NULL, 0); break;
+			case 'w' : write_ns = strtoul(optarg, NULL, 0); break;
+			case 'n' : iterations = strtoul(optarg, NULL, 0); break;
+			case 'p' : print = 1; break;
+			default : howto(); return -1;
+		}
+	}
+	if (optind != argc - 1 || width == 0 || width > 32 || iterations == 0) {
+		howto();
+		return -1;
+	}
+	if (myGPIO_TraceFile_Load(argv[optind], &header, &record) != 0) {
+		printf("%s: registrazione non valida\n", argv[optind]);
+		return -1;
+	}
+	if (print)
+		print_records(&header, record);
+	if (myGPIO_Replay_Init(&replay, record, header.records, width) != 0) {
+		printf("memoria insufficiente\n");
+		return -1;
+	}
+	replay.read_ns = read_ns;
+	replay.write_ns = write_ns;
+	printf("%u accessi registrati (%" PRIu64 " sovrascritti), %u device, %u operazioni\n", header.records,
+			header.dropped, replay.devices, replay.ops);
+
+	for (mode = MYGPIO_REPLAY_RAW; mode < MYGPIO_REPLAY_MODES; mode++) {
+		start = bench_now_ns();
+		for (i = 0; i < iterations; i++)
+			myGPIO_Replay_Run(&replay, mode);
+		printf("%-20s %8lu letture %8lu scritture %12.1f us sul bus %10.1f us sull'host %6lu differenze\n",
+				mode_name[mode], replay.reads, replay.writes, replay.time_ns / 1e3,
+				(bench_now_ns() - start) / 1e3 / iterations, replay.mismatches);
+		// lo stato finale dei device deve coincidere con quello della riesecuzione degli accessi registrati
+		for (d = 0; d < replay.devices; d++) {
+			for (reg = 0; reg < 8; reg++) {
+				uint32_t value = (reg == GIES_REG ? replay.model[d].reg[reg] & 1U : replay.model[d].reg[reg]);
+				if (reg == READ_REG || reg == IRQ_REG || reg == IACK_REG)
+					continue;
+				if (mode == MYGPIO_REPLAY_RAW)
+					state[d][reg] = value;
+				else if (state[d][reg] != value) {
+					printf("%s: device %u, registro %u: 0x%08x anziché 0x%08x\n", mode_name[mode], d, reg, value, state[d][reg]);
+					errors++;
+				}
+			}
+		}
+		if (mode == MYGPIO_REPLAY_RMW)
+			reference = replay.mismatches;
+		else if (mode != MYGPIO_REPLAY_RAW && replay.mismatches != reference)
+			errors++;
+	}
+
+	myGPIO_Replay_Destroy(&replay);
+	free(record);
+	printf("verifica: %s\n", (errors == 0 ? "ok" : "FALLITA"));
+	return (errors == 0 ? 0 : -1);
+}
@@ -0,0 +1,320 @@
+/**
+ * @file mygpio.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @brief Modello QEMU del device myGPIO; si veda mygpio.h.
+ */
+#include "qemu/osdep.h"
+#include "qapi/error.h"
+#include "qemu/log.h"
+#include "qemu/module.h"
+#include "qemu/timer.h"
+#include "hw/irq.h"
+#include "hw/qdev-properties.h"
+#include "hw/qdev-properties-system.h"
+#include "migration/vmstate.h"
+#include "hw/gpio/mygpio.h"
+
+#define MYGPIO_MODE  0
+#define MYGPIO_WRITE 1
+#define MYGPIO_READ  2
+#define MYGPIO_GIES  3
+#define MYGPIO_PIE   4
+#define MYGPIO_IRQ   5
+#define MYGPIO_IACK  6
+#define MYGPIO_REG7  7
+
+static int64_t mygpio_now(void) {
+	return qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
+}
+
+static void mygpio_latency(MyGPIOLatency *latency, int64_t value) {
+	latency->count++;
+	latency->sum += value;
+	if (value > latency->max)
+		latency->max = value;
+}
+
+static int64_t mygpio_mean(const MyGPIOLatency *latency) {
+	return latency->count != 0 ? latency->sum / (int64_t)latency->count : 0;
+}
+
+/**
+ * @brief Livello dei pin: le uscite assumono il valore di WRITE, gli ingressi quello dello stimolo esterno.
+ */
+static uint32_t mygpio_pads(MyGPIOState *s) {
+	return ((s->mode & s->write) | (~s->mode & s->pins)) & s->mask;
+}
+
+/**
+ * @brief Accumula in IRQ gli ingressi abilitati ed aggiorna la linea di interrupt; finché IACK non è nullo,
+ * come in myGPIO_AXI.vhd, i suoi bit vengono invece azzerati in IRQ e nessun pin viene accumulato.
+ *
+ * @param[in] by_write non nullo se l'aggiornamento è causato da una scrittura della CPU
+ */
+static void mygpio_update(MyGPIOState *s, bool by_write) {
+	uint32_t line;
+	if (s->iack != 0)
+		s->irq_reg &= ~s->iack;
+	else
+		s->irq_reg |= mygpio_pads(s) & ~s->mode & s->pie;
+	line = (s->irq_reg != 0) && (s->gies & 1);
+	if (line == s->line)
+		return;
+	s->line = line;
+	qemu_set_irq(s->irq, line);
+	if (line) {
+		s->interrupts++;
+		s->raised = mygpio_now();
+		s->handled = false;
+		s->woken = false;
+	} else if (by_write && s->raised >= 0 && !s->handled) {
+		s->handled = true;
+		mygpio_latency(&s->isr, mygpio_now() - s->raised);
+	}
+}
+
+static uint64_t mygpio_read(void *opaque, hwaddr offset, unsigned size) {
+	MyGPIOState *s = MYGPIO(opaque);
+	switch ((offset & 0x1F) >> 2) {
+	case MYGPIO_MODE:
+		return s->mode;
+	case MYGPIO_WRITE:
+		return s->write;
+	case MYGPIO_READ:
+		if (s->handled && !s->woken) {
+			s->woken = true;
+			mygpio_latency(&s->wakeup, mygpio_now() - s->raised);
+		}
+		return mygpio_pads(s);
+	case MYGPIO_GIES:
+		return ((s->irq_reg != 0) << 1) | (s->gies & 1);
+	case MYGPIO_PIE:
+		return s->pie;
+	case MYGPIO_IRQ:
+		return s->irq_reg;
+	case MYGPIO_IACK:
+		return s->iack;
+	case MYGPIO_REG7:
+		return s->reg7;
+	default:
+		return 0;
+	}
+}
+
+static void mygpio_write(void *opaque, hwaddr offset, uint64_t value, unsigned size) {
+	MyGPIOState *s = MYGPIO(opaque);
+	s->iack = 0;
+	switch ((offset & 0x1F) >> 2) {
+	case MYGPIO_MODE:
+		s->mode = value;
+		break;
+	case MYGPIO_WRITE:
+		s->write = value;
+		break;
+	case MYGPIO_GIES:
+		s->gies = value & 1;
+		break;
+	case MYGPIO_PIE:
+		s->pie = value;
+		break;
+	case MYGPIO_IACK:
+		if (s->raised >= 0 && (s->irq_reg & value) != 0) {
+			mygpio_latency(&s->ack, mygpio_now() - s->raised);
+			s->raised = -1;
+		}
+		if ((s->irq_reg & value) != 0) {
+			s->acked[s->logged % MYGPIO_ACKS].time = mygpio_now();
+			s->acked[s->logged % MYGPIO_ACKS].mask = s->irq_reg & value;
+			s->logged++;
+		}
+		s->iack = value;
+		break;
+	case MYGPIO_REG7:
+		s->reg7 = value;
+		break;
+	default:
+		qemu_log_mask(LOG_GUEST_ERROR, "%s: scrittura su registro a sola lettura 0x%" HWADDR_PRIx "\n",
+				__func__, offset);
+		break;
+	}
+	mygpio_update(s, true);
+}
+
+static const MemoryRegionOps mygpio_ops = {
+	.read = mygpio_read,
+	.write = mygpio_write,
+	.endianness = DEVICE_NATIVE_ENDIAN,
+	.valid = {
+		.min_access_size = 4,
+		.max_access_size = 4,
+	},
+};
+
+static void mygpio_reply(MyGPIOState *s, const char *reply) {
+	qemu_chr_fe_write_all(&s->chr, (const uint8_t *)reply, strlen(reply));
+}
+
+/**
+ * @brief Serve una richiesta ricevuta dal chardev.
+ */
+static void mygpio_request(MyGPIOState *s, char *request) {
+	char reply[MYGPIO_LINE_LENGTH * 2];
+	char *command = strtok(request, " \t\r");
+	char *mask, *value;
+	if (command == NULL)
+		return;
+	if (strcmp(command, "set") == 0 && (mask = strtok(NULL, " \t\r")) && (value = strtok(NULL, " \t\r"))) {
+		uint32_t m = strtoul(mask, NULL, 0);
+		s->pins = (s->pins & ~m) | (strtoul(value, NULL, 0) & m);
+		mygpio_update(s, false);
+		snprintf(reply, sizeof(reply), "ok %" PRId64 "\n", mygpio_now());
+	} else if (strcmp(command, "get") == 0) {
+		snprintf(reply, sizeof(reply), "pins 0x%08x irq 0x%08x line %u ns %" PRId64 "\n",
+				mygpio_pads(s), s->irq_reg, s->line, mygpio_now());
+	} else if (strcmp(command, "stats") == 0) {
+		snprintf(reply, sizeof(reply), "interrupts %" PRIu64 " acked %" PRIu64 " isr %" PRId64 " %" PRId64
+				" wakeup %" PRId64 " %" PRId64 " ack %" PRId64 " %" PRId64 "\n", s->interrupts, s->ack.count,
+				mygpio_mean(&s->isr), s->isr.max, mygpio_mean(&s->wakeup), s->wakeup.max,
+				mygpio_mean(&s->ack), s->ack.max);
+	} else if (strcmp(command, "acks") == 0) {
+		uint32_t overwritten = 0;
+		if (s->logged - s->fetched > MYGPIO_ACKS) {
+			overwritten = s->logged - s->fetched - MYGPIO_ACKS;
+			s->fetched = s->logged - MYGPIO_ACKS;
+		}
+		for (; s->fetched != s->logged; s->fetched++) {
+			snprintf(reply, sizeof(reply), "ack %" PRId64 " 0x%08x\n", s->acked[s->fetched % MYGPIO_ACKS].time,
+					s->acked[s->fetched % MYGPIO_ACKS].mask);
+			mygpio_reply(s, reply);
+		}
+		snprintf(reply, sizeof(reply), "end %u\n", overwritten);
+	} else if (strcmp(command, "clear") == 0) {
+		s->logged = 0;
+		s->fetched = 0;
+		s->interrupts = 0;
+		memset(&s->isr, 0, sizeof(s->isr));
+		memset(&s->wakeup, 0, sizeof(s->wakeup));
+		memset(&s->ack, 0, sizeof(s->ack));
+		snprintf(reply, sizeof(reply), "ok %" PRId64 "\n", mygpio_now());
+	} else {
+		snprintf(reply, sizeof(reply), "error\n");
+	}
+	mygpio_reply(s, reply);
+}
+
+static int mygpio_can_receive(void *opaque) {
+	return MYGPIO_LINE_LENGTH;
+}
+
+static void mygpio_receive(void *opaque, const uint8_t *buf, int size) {
+	MyGPIOState *s = MYGPIO(opaque);
+	int i;
+	for (i = 0; i < size; i++) {
+		if (buf[i] == '\n') {
+			s->request[s->length] = '\0';
+			mygpio_request(s, s->request);
+			s->length = 0;
+		} else if (s->length < MYGPIO_LINE_LENGTH - 1) {
+			s->request[s->length++] = buf[i];
+		}
+	}
+}
+
+static void mygpio_reset(DeviceState *dev) {
+	MyGPIOState *s = MYGPIO(dev);
+	s->mode = 0;
+	s->write = 0;
+	s->gies = 0;
+	s->pie = 0;
+	s->irq_reg = 0;
+	s->iack = 0;
+	s->reg7 = 0;
+	s->line = 0;
+	s->raised = -1;
+	s->handled = false;
+	s->woken = false;
+	qemu_set_irq(s->irq, 0);
+}
+
+static void mygpio_realize(DeviceState *dev, Error **errp) {
+	MyGPIOState *s = MYGPIO(dev);
+	if (s->width == 0 || s->width > 32) {
+		error_setg(errp, "width deve essere compreso tra 1 e 32");
+		return;
+	}
+	s->mask = (s->width == 32 ? 0xFFFFFFFFU : (1U << s->width) - 1);
+	qemu_chr_fe_set_handlers(&s->chr, mygpio_can_receive, mygpio_receive, NULL, NULL, s, NULL, true);
+}
+
+static void mygpio_init(Object *obj) {
+	MyGPIOState *s = MYGPIO(obj);
+	memory_region_init_io(&s->iomem, obj, &mygpio_ops, s, TYPE_MYGPIO, MYGPIO_MMIO_SIZE);
+	sysbus_init_mmio(SYS_BUS_DEVICE(obj), &s->iomem);
+	sysbus_init_irq(SYS_BUS_DEVICE(obj), &s->irq);
+}
+
+static const VMStateDescription vmstate_mygpio = {
+	.name = TYPE_MYGPIO,
+	.version_id = 3,
+	.minimum_version_id = 1,
+	.fields = (VMStateField[]) {
+		VMSTATE_UINT32(mode, MyGPIOState),
+		VMSTATE_UINT32(write, MyGPIOState),
+		VMSTATE_UINT32(gies, MyGPIOState),
+		VMSTATE_UINT32(pie, MyGPIOState),
+		VMSTATE_UINT32(irq_reg, MyGPIOState),
+		VMSTATE_UINT32(pins, MyGPIOState),
+		VMSTATE_UINT32(line, MyGPIOState),
+		VMSTATE_UINT32_V(reg7, MyGPIOState, 2),
+		VMSTATE_UINT32_V(iack, MyGPIOState, 3),
+		VMSTATE_END_OF_LIST()
+	}
+};
+
+static Property mygpio_properties[] = {
+	DEFINE_PROP_UINT32("width", MyGPIOState, width, 32),
+	DEFINE_PROP_CHR("chardev", MyGPIOState, chr),
+	DEFINE_PROP_END_OF_LIST(),
+};
+
+static void mygpio_class_init(ObjectClass *klass, void *data) {
+	DeviceClass *dc = DEVICE_CLASS(klass);
+	dc->realize = mygpio_realize;
+	dc->reset = mygpio_reset;
+	dc->vmsd = &vmstate_mygpio;
+	dc->user_creatable = true;
+	device_class_set_props(dc, mygpio_properties);
+}
+
+static const TypeInfo mygpio_info = {
+	.name          = TYPE_MYGPIO,
+	.parent        = TYPE_SYS_BUS_DEVICE,
+	.instance_size = sizeof(MyGPIOState),
+	.instance_init = mygpio_init,
+	.class_init    = mygpio_class_init,
+};
+
+static void mygpio_register_types(void) {
+	type_register_static(&mygpio_info);
+}
+
+type_init(mygpio_register_types)
@@ -0,0 +1,156 @@
+/**
+ * @file mygpio.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef HW_GPIO_MYGPIO_H
+#define HW_GPIO_MYGPIO_H
+
+#include "hw/sysbus.h"
+#include "chardev/char-fe.h"
+#include "qom/object.h"
+
+/**
+ * @brief Modello QEMU del device myGPIO, per i test del modulo kernel myGPIOK su un sistema ARM emulato.
+ *
+ * @details
+ * Il device implementa la mappa dei registri ed il comportamento di myGPIO_AXI.vhd: MODE, WRITE, READ, GIES,
+ * PIE, IRQ ed IACK ad offset multipli di quattro, IRQ che accumula in OR i pin di ingresso abilitati in PIE,
+ * indipendentemente da IE, e linea di interrupt pari alla or-reduce di IRQ in AND con IE. Come in
+ * myGPIO_AXI.vhd, MODE, WRITE, PIE ed il registro all'offset 0x1C memorizzano la parola intera, anche oltre
+ * la larghezza del device, mentre READ riporta zero sui bit oltre la larghezza. IACK mantiene il valore
+ * scritto, e viene letto come tale, fino alla successiva scrittura su un qualsiasi registro: nel frattempo
+ * i suoi bit restano azzerati in IRQ, ed IRQ non accumula le interruzioni di nessun pin. Solo i 5 bit meno
+ * significativi dell'indirizzo vengono decodificati.
+ *
+ * Lo stimolo esterno sui pin configurati come ingresso viene imposto attraverso un chardev, indicato dalla
+ * proprietà "chardev", col seguente protocollo testuale, una richiesta per riga:
+ *  - "set <mask> <value>": impone value sui pin indicati da mask; risponde "ok <ns>", col tempo virtuale;
+ *  - "get": risponde "pins <pins> irq <irq> line <line> ns <ns>";
+ *  - "stats": risponde "interrupts <n> acked <n> isr <media> <max> wakeup <media> <max> ack <media> <max>",
+ *    col numero di salite della linea di interrupt e di interruzioni riconosciute con IACK;
+ *  - "acks": risponde, per ciascun ack registrato e non ancora prelevato, "ack <ns> <mask>", col tempo
+ *    virtuale della scrittura di IACK ed i bit pendenti riconosciuti, seguiti da "end <n>", col numero di
+ *    ack sovrascritti prima di essere prelevati;
+ *  - "clear": azzera le statistiche ed il registro degli ack, e risponde "ok <ns>".
+ * I valori numerici delle richieste possono essere indicati in decimale o, col prefisso 0x, in esadecimale.
+ *
+ * Le statistiche misurano, in nanosecondi di tempo virtuale e per ogni salita della linea di interrupt:
+ *  - isr: il tempo fino alla discesa della linea causata da una scrittura, cioè fino alla disabilitazione
+ *    degli interrupt effettuata da myGPIOK_irq_handler();
+ *  - wakeup: il tempo fino alla prima lettura di READ successiva, cioè fino al risveglio del processo in
+ *    attesa in myGPIOK_read();
+ *  - ack: il tempo fino alla scrittura di IACK.
+ * Il registro degli ack, circolare e di MYGPIO_ACKS voci, consente a load_gen di ricavare gli eventi
+ * effettivamente osservati dal consumatore sul sistema emulato.
+ * Per misure ripetibili, QEMU va avviato con -icount.
+ *
+ * <h4>Integrazione nella board virt</h4>
+ * Il device va copiato in hw/gpio/mygpio.c, e questo file in include/hw/gpio/mygpio.h; in hw/gpio/Kconfig
+ * e in hw/gpio/meson.build vanno aggiunti
+ * @code
+ * config MYGPIO
+ *     bool
+ *     default y if ARM_VIRT
+ *
+ * system_ss.add(when: 'CONFIG_MYGPIO', if_true: files('mygpio.c'))
+ * @endcode
+ * In virt_machine_class_init(), in hw/arm/virt.c, va consentita l'istanziazione del device sul platform-bus
+ * @code
+ * machine_class_allow_dynamic_sysbus_dev(mc, TYPE_MYGPIO);
+ * @endcode
+ * ed in hw/arm/sysbus-fdt.c va aggiunta a add_fdt_node_functions[] la voce
+ * @code
+ * TYPE_BINDING(TYPE_MYGPIO, add_mygpio_fdt_node),
+ * @endcode
+ * dove add_mygpio_fdt_node() è definita come add_tpm_tis_fdt_node(), con compatible pari a MYGPIO_COMPATIBLE
+ * ed interrupts pari a <GIC_FDT_IRQ_TYPE_SPI irq GIC_FDT_IRQ_FLAGS_LEVEL_HI>: la board genera il nodo del
+ * device-tree descritto in mygpio.dtsi. Il device viene infine istanziato con
+ * @code
+ * qemu-system-arm -M virt -icount shift=0 ... \
+ *     -chardev socket,id=gpio,path=/tmp/mygpio.sock,server=on,wait=off \
+ *     -device mygpio,width=8,chardev=gpio
+ * @endcode
+ * Il modello è scritto per le API di QEMU 8. In assenza di QEMU, qemu_model, in Src/Linux, serve lo stesso
+ * protocollo con il modello di myGPIO_model.h, così che qemu_ctl e load_gen possano essere verificati.
+ */
+
+#define TYPE_MYGPIO        "mygpio"
+#define MYGPIO_COMPATIBLE  "myGPIOK"  //!< deve coincidere con DRIVER_NAME del modulo myGPIOK
+#define MYGPIO_MMIO_SIZE   0x1000
+#define MYGPIO_REGS        8
+#define MYGPIO_LINE_LENGTH 128
+#define MYGPIO_ACKS        1024  //!< voci del registro degli ack
+
+OBJECT_DECLARE_SIMPLE_TYPE(MyGPIOState, MYGPIO)
+
+/**
+ * @brief Statistiche di una delle latenze misurate dal device.
+ */
+typedef struct MyGPIOLatency {
+	uint64_t count;  //!< numero di misure
+	int64_t  sum;    //!< somma delle misure, in ns
+	int64_t  max;    //!< misura massima, in ns
+} MyGPIOLatency;
+
+/**
+ * @brief Voce del registro degli ack.
+ */
+typedef struct MyGPIOAck {
+	int64_t  time;   //!< tempo virtuale della scrittura di IACK, in ns
+	uint32_t mask;   //!< bit pendenti riconosciuti
+} MyGPIOAck;
+
+struct MyGPIOState {
+	SysBusDevice parent_obj;
+
+	MemoryRegion iomem;
+	qemu_irq     irq;
+	CharBackend  chr;
+
+	uint32_t width;     //!< numero di pin
+	uint32_t mask;      //!< maschera dei pin esistenti
+	uint32_t mode;      //!< registro MODE
+	uint32_t write;     //!< registro WRITE
+	uint32_t gies;      //!< bit IE del registro GIES
+	uint32_t pie;       //!< registro PIE
+	uint32_t irq_reg;   //!< registro IRQ
+	uint32_t iack;      //!< registro IACK, azzerato dalla scrittura successiva
+	uint32_t reg7;      //!< registro all'offset 0x1C, memorizzato ma privo di effetti
+	uint32_t pins;      //!< stimolo esterno
+	uint32_t line;      //!< livello della linea di interrupt
+
+	int64_t  raised;    //!< tempo virtuale dell'ultima salita della linea, -1 se già riconosciuta
+	bool     handled;   //!< la linea è scesa dopo l'ultima salita
+	bool     woken;     //!< READ è stato letto dopo la discesa della linea
+	uint64_t interrupts;
+	MyGPIOLatency isr;
+	MyGPIOLatency wakeup;
+	MyGPIOLatency ack;
+	MyGPIOAck     acked[MYGPIO_ACKS];  //!< registro circolare degli ack
+	uint32_t      logged;              //!< ack registrati
+	uint32_t      fetched;             //!< ack prelevati con "acks"
+
+	char     request[MYGPIO_LINE_LENGTH];  //!< richiesta in corso di ricezione dal chardev
+	uint32_t length;
+};
+
+#endif
@@ -0,0 +1,235 @@
+--! @file myGPIO_bridge_tb.vhd
+--! @author Salvatore Barone <salvator.barone@gmail.com>
+--! @date 17 10 2026
+--! 
+--! @copyright
+--! Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+--! 
+--! This file is part of Zynq7000DriverPack
+--! 
+--! Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+--! the GNU General Public License as published by the Free Software Foundation; either version 3 of
+--! the License, or any later version.
+--! 
+--! Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+--! without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+--! GNU General Public License for more details.
+--! 
+--! You should have received a copy of the GNU General Public License along with this program; if not,
+--! write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+--! USA.
+--!
+--! @addtogroup myGPIO
+--! @{
+--! @addtogroup AXI-device
+--! @{
+
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+--! @brief Testbench di co-simulazione di myGPIO con i programmi C, per GHDL.
+--!
+--! @details
+--! Il testbench istanzia myGPIO ed un master AXI4-Lite che, ad ogni ciclo di clock, preleva dalla mailbox
+--! in memoria condivisa descritta in Src/Linux/myGPIO_bridge.h una eventuale richiesta di lettura o
+--! scrittura di un registro, la esegue sul bus, e ne pubblica il completamento. Ad ogni ciclo vengono inoltre
+--! pubblicati il livello della linea di interrupt ed il livello dei pin, e prelevato lo stimolo esterno.
+--! Lo stimolo viene imposto con forza debole ('H'/'L'), per cui i pin configurati come uscita assumono il
+--! valore imposto dal device.
+--!
+--! L'accesso alla mailbox avviene attraverso le funzioni VHPIDIRECT definite in myGPIO_bridge_vhpi.c.
+--! Il numero di pin del device può essere scelto all'avvio della simulazione:
+--! @code
+--! $ ./myGPIO_bridge_tb -gGPIO_width=8
+--! @endcode
+--! La simulazione termina quando un programma C deposita la richiesta MYGPIO_BRIDGE_QUIT.
+entity myGPIO_bridge_tb is
+	generic (
+		GPIO_width 		: natural := 32;		--! numero di GPIO del device simulato
+		clock_period	: time := 10 ns			--! periodo del clock AXI
+	);
+end myGPIO_bridge_tb;
+
+architecture behavioral of myGPIO_bridge_tb is
+
+	--! crea la mailbox; restituisce zero in caso di successo
+	impure function bridge_open(width : integer) return integer is
+	begin
+		assert false report "VHPIDIRECT bridge_open" severity failure;
+		return -1;
+	end function;
+	attribute foreign of bridge_open : function is "VHPIDIRECT myGPIO_Bridge_VhpiOpen";
+
+	--! preleva una eventuale richiesta (0 nessuna, 1 lettura, 2 scrittura, 3 termine); i cicli di clock
+	--! vengono contati da bridge_exchange
+	impure function bridge_poll return integer is
+	begin
+		assert false report "VHPIDIRECT bridge_poll" severity failure;
+		return 0;
+	end function;
+	attribute foreign of bridge_poll : function is "VHPIDIRECT myGPIO_Bridge_VhpiPoll";
+
+	--! indice del registro della richiesta prelevata
+	impure function bridge_reg return integer is
+	begin
+		assert false report "VHPIDIRECT bridge_reg" severity failure;
+		return 0;
+	end function;
+	attribute foreign of bridge_reg : function is "VHPIDIRECT myGPIO_Bridge_VhpiReg";
+
+	--! dato da scrivere della richiesta prelevata
+	impure function bridge_value return integer is
+	begin
+		assert false report "VHPIDIRECT bridge_value" severity failure;
+		return 0;
+	end function;
+	attribute foreign of bridge_value : function is "VHPIDIRECT myGPIO_Bridge_VhpiValue";
+
+	--! pubblica il completamento della richiesta, col dato letto
+	procedure bridge_complete(value : integer) is
+	begin
+		assert false report "VHPIDIRECT bridge_complete" severity failure;
+	end procedure;
+	attribute foreign of bridge_complete : procedure is "VHPIDIRECT myGPIO_Bridge_VhpiComplete";
+
+	--! conta un ciclo di clock, pubblica il livello della linea di interrupt ed il livello dei pin, e
+	--! restituisce lo stimolo esterno
+	impure function bridge_exchange(interrupt : integer; pads : integer) return integer is
+	begin
+		assert false report "VHPIDIRECT bridge_exchange" severity failure;
+		return 0;
+	end function;
+	attribute foreign of bridge_exchange : function is "VHPIDIRECT myGPIO_Bridge_VhpiExchange";
+
+	constant C_DATA_WIDTH : integer := 32;
+	constant C_ADDR_WIDTH : integer := 5;
+
+	signal aclk			: std_logic := '0';
+	signal aresetn		: std_logic := '0';
+	signal awaddr		: std_logic_vector(C_ADDR_WIDTH-1 downto 0) := (others => '0');
+	signal awvalid		: std_logic := '0';
+	signal awready		: std_logic;
+	signal wdata		: std_logic_vector(C_DATA_WIDTH-1 downto 0) := (others => '0');
+	signal wvalid		: std_logic := '0';
+	signal wready		: std_logic;
+	signal bresp		: std_logic_vector(1 downto 0);
+	signal bvalid		: std_logic;
+	signal bready		: std_logic := '0';
+	signal araddr		: std_logic_vector(C_ADDR_WIDTH-1 downto 0) := (others => '0');
+	signal arvalid		: std_logic := '0';
+	signal arready		: std_logic;
+	signal rdata		: std_logic_vector(C_DATA_WIDTH-1 downto 0);
+	signal rresp		: std_logic_vector(1 downto 0);
+	signal rvalid		: std_logic;
+	signal rready		: std_logic := '0';
+
+	signal GPIO_inout	: std_logic_vector(GPIO_width-1 downto 0);
+	signal interrupt	: std_logic;
+	signal stimulus		: std_logic_vector(C_DATA_WIDTH-1 downto 0) := (others => '0');
+	signal stopped		: boolean := false;
+
+begin
+
+	dut : entity work.myGPIO
+		generic map (
+			GPIO_width				=> GPIO_width,
+			C_S00_AXI_DATA_WIDTH	=> C_DATA_WIDTH,
+			C_S00_AXI_ADDR_WIDTH	=> C_ADDR_WIDTH
+		)
+		port map (
+			GPIO_inout		=> GPIO_inout,
+			interrupt		=> interrupt,
+			s00_axi_aclk	=> aclk,
+			s00_axi_aresetn	=> aresetn,
+			s00_axi_awaddr	=> awaddr,
+			s00_axi_awprot	=> "000",
+			s00_axi_awvalid	=> awvalid,
+			s00_axi_awready	=> awready,
+			s00_axi_wdata	=> wdata,
+			s00_axi_wstrb	=> "1111",
+			s00_axi_wvalid	=> wvalid,
+			s00_axi_wready	=> wready,
+			s00_axi_bresp	=> bresp,
+			s00_axi_bvalid	=> bvalid,
+			s00_axi_bready	=> bready,
+			s00_axi_araddr	=> araddr,
+			s00_axi_arprot	=> "000",
+			s00_axi_arvalid	=> arvalid,
+			s00_axi_arready	=> arready,
+			s00_axi_rdata	=> rdata,
+			s00_axi_rresp	=> rresp,
+			s00_axi_rvalid	=> rvalid,
+			s00_axi_rready	=> rready
+		);
+
+	aclk <= not aclk after clock_period / 2 when not stopped;
+
+	--! stimolo esterno, con forza debole: i pin configurati come uscita assumono il valore imposto dal device
+	pads : for i in 0 to GPIO_width-1 generate
+		GPIO_inout(i) <= 'H' when stimulus(i) = '1' else 'L';
+	end generate;
+
+	--! scambio, ad ogni ciclo, del livello della linea di interrupt, dei pin e dello stimolo esterno
+	exchange : process (aclk)
+		variable levels : std_logic_vector(C_DATA_WIDTH-1 downto 0);
+		variable level : integer;
+	begin
+		if rising_edge(aclk) then
+			levels := (others => '0');
+			levels(GPIO_width-1 downto 0) := to_X01(GPIO_inout);
+			level := 0;
+			if interrupt = '1' then
+				level := 1;
+			end if;
+			stimulus <= std_logic_vector(to_signed(bridge_exchange(level, to_integer(signed(levels))), C_DATA_WIDTH));
+		end if;
+	end process;
+
+	--! master AXI4-Lite: serve una richiesta alla volta, secondo gli handshake di myGPIO_AXI
+	master : process
+		variable op : integer;
+		variable address : std_logic_vector(C_ADDR_WIDTH-1 downto 0);
+	begin
+		assert bridge_open(GPIO_width) = 0 report "impossibile creare la mailbox" severity failure;
+		for i in 1 to 4 loop
+			wait until rising_edge(aclk);
+		end loop;
+		aresetn <= '1';
+		loop
+			wait until rising_edge(aclk);
+			op := bridge_poll;
+			address := std_logic_vector(to_unsigned(bridge_reg * 4, C_ADDR_WIDTH));
+			if op = 1 then
+				araddr <= address;
+				arvalid <= '1';
+				rready <= '1';
+				wait until rising_edge(aclk) and arready = '1';
+				arvalid <= '0';
+				wait until rising_edge(aclk) and rvalid = '1';
+				rready <= '0';
+				bridge_complete(to_integer(signed(to_X01(rdata))));
+			elsif op = 2 then
+				awaddr <= address;
+				wdata <= std_logic_vector(to_signed(bridge_value, C_DATA_WIDTH));
+				awvalid <= '1';
+				wvalid <= '1';
+				bready <= '1';
+				wait until rising_edge(aclk) and awready = '1' and wready = '1';
+				awvalid <= '0';
+				wvalid <= '0';
+				wait until rising_edge(aclk) and bvalid = '1';
+				bready <= '0';
+				bridge_complete(0);
+			elsif op = 3 then
+				stopped <= true;
+				wait;
+			end if;
+		end loop;
+	end process;
+
+end behavioral;
+
+--! @}
+--! @}
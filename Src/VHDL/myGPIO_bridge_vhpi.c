@@ -0,0 +1,158 @@
+/**
+ * @file myGPIO_bridge_vhpi.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+/**
+ * @brief Funzioni VHPIDIRECT con cui il testbench myGPIO_bridge_tb.vhd accede alla mailbox condivisa con i
+ * programmi C, descritta in Src/Linux/myGPIO_bridge.h.
+ *
+ * @details
+ * Le funzioni vengono chiamate dal simulatore, che è l'unico processo a scrivere response, interrupts,
+ * interrupt, pads e cycles; i programmi C in attesa su response o su interrupts vengono risvegliati col futex.
+ * La memoria condivisa viene rimossa al termine della simulazione.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "myGPIO_bridge.h"
+
+static myGPIO_BridgeMailbox_t *mailbox = NULL;
+static const char *mailbox_name = MYGPIO_BRIDGE_NAME;
+static uint32_t pending = 0;  //!< numero d'ordine della richiesta in corso
+static uint32_t loop_out = 0;  //!< pin di uscita del collegamento indicato da MYGPIO_BRIDGE_LOOPBACK
+static uint32_t loop_in = 0;   //!< pin di ingresso su cui viene riportato
+
+static void futex_wake(uint32_t *address) {
+	syscall(SYS_futex, address, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static void remove_mailbox(void) {
+	shm_unlink(mailbox_name);
+}
+
+/**
+ * @brief Crea la mailbox e la pubblica.
+ *
+ * @param[in] width numero di pin del device simulato
+ *
+ * @return zero in caso di successo, -1 altrimenti
+ */
+int32_t myGPIO_Bridge_VhpiOpen(int32_t width) {
+	const char *name = getenv("MYGPIO_BRIDGE"), *loopback = getenv("MYGPIO_BRIDGE_LOOPBACK");
+	unsigned out, in;
+	void *mapped;
+	int descriptor;
+	if (name != NULL)
+		mailbox_name = name;
+	if (loopback != NULL) {
+		if (sscanf(loopback, "%u:%u", &out, &in) != 2 || out >= (unsigned)width || in >= (unsigned)width || out == in) {
+			fprintf(stderr, "MYGPIO_BRIDGE_LOOPBACK: atteso out:in, con pin distinti e minori di %d\n", width);
+			return -1;
+		}
+		loop_out = MYGPIO_PIN(out);
+		loop_in = MYGPIO_PIN(in);
+	}
+	descriptor = shm_open(mailbox_name, O_CREAT | O_RDWR, 0600);
+	if (descriptor < 0) {
+		perror("shm_open");
+		return -1;
+	}
+	if (ftruncate(descriptor, sizeof(myGPIO_BridgeMailbox_t)) != 0) {
+		perror("ftruncate");
+		close(descriptor);
+		return -1;
+	}
+	mapped = mmap(NULL, sizeof(myGPIO_BridgeMailbox_t), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (mapped == MAP_FAILED) {
+		perror("mmap");
+		return -1;
+	}
+	mailbox = (myGPIO_BridgeMailbox_t*)mapped;
+	memset(mailbox, 0, sizeof(myGPIO_BridgeMailbox_t));
+	mailbox->width = width;
+	atexit(remove_mailbox);
+	__atomic_store_n(&mailbox->magic, MYGPIO_BRIDGE_MAGIC, __ATOMIC_RELEASE);
+	printf("myGPIO_bridge: mailbox %s pronta, %d pin\n", mailbox_name, width);
+	fflush(stdout);
+	return 0;
+}
+
+/**
+ * @brief Preleva una eventuale richiesta non ancora servita.
+ *
+ * @return MYGPIO_BRIDGE_NONE se non vi sono richieste, il tipo di richiesta altrimenti
+ */
+int32_t myGPIO_Bridge_VhpiPoll(void) {
+	uint32_t request = __atomic_load_n(&mailbox->request, __ATOMIC_ACQUIRE);
+	if (request == pending)
+		return MYGPIO_BRIDGE_NONE;
+	pending = request;
+	if (mailbox->op == MYGPIO_BRIDGE_QUIT) {
+		__atomic_store_n(&mailbox->magic, 0, __ATOMIC_RELEASE);
+		remove_mailbox();
+	}
+	return mailbox->op;
+}
+
+int32_t myGPIO_Bridge_VhpiReg(void) {
+	return mailbox->reg;
+}
+
+int32_t myGPIO_Bridge_VhpiValue(void) {
+	return mailbox->value;
+}
+
+/**
+ * @brief Pubblica il completamento della richiesta in corso.
+ */
+void myGPIO_Bridge_VhpiComplete(int32_t value) {
+	mailbox->value = value;
+	__atomic_store_n(&mailbox->response, pending, __ATOMIC_RELEASE);
+	futex_wake(&mailbox->response);
+}
+
+/**
+ * @brief Conta un ciclo di clock, pubblica la linea di interrupt ed il livello dei pin.
+ *
+ * @return lo stimolo esterno da imporre ai pin, in cui il pin di ingresso indicato da MYGPIO_BRIDGE_LOOPBACK
+ * riporta il livello del pin di uscita
+ */
+int32_t myGPIO_Bridge_VhpiExchange(int32_t interrupt, int32_t pads) {
+	uint32_t pins;
+	__atomic_store_n(&mailbox->cycles, mailbox->cycles + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&mailbox->pads, (uint32_t)pads, __ATOMIC_RELEASE);
+	if (interrupt && !mailbox->interrupt) {
+		__atomic_store_n(&mailbox->interrupts, mailbox->interrupts + 1, __ATOMIC_RELEASE);
+		futex_wake(&mailbox->interrupts);
+	}
+	mailbox->interrupt = interrupt;
+	pins = __atomic_load_n(&mailbox->pins, __ATOMIC_ACQUIRE);
+	if (loop_out != 0)
+		pins = (pins & ~loop_in) | ((uint32_t)pads & loop_out ? loop_in : 0);
+	return pins;
+}
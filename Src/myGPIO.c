@@ -20,16 +20,16 @@
  * USA.
  */
 #include "myGPIO.h"
+#include "myGPIO_regs.h"
 #include <stdlib.h>
-#include <assert.h>
 
-#define  MODE_REG   0   /**< indice del registro "mode" */
-#define  WRITE_REG  1   /**< indice del registro "write" */
-#define  READ_REG   2   /**< indice del registro "read" */
-#define  GIES_REG   3   /**< indice del registro "gies" */
-#define  PIE_REG    4   /**< indice del registro "pie" */
-#define  IRQ_REG    5   /**< indice del registro "irq" */
-#define  IACK_REG   6   /**< indice del registro "iack" */
+#ifdef MYGPIO_COUNT_ACCESS
+unsigned long myGPIO_BusReads = 0;
+unsigned long myGPIO_BusWrites = 0;
+#endif
+
+/* Se MYGPIO_INLINE è definito, le funzioni sono definite in myGPIO_inline.h */
+#ifndef MYGPIO_INLINE
 
 /**
  * @brief Inizializza un device myGPIO.
@@ -38,7 +38,7 @@
  * @param[in]    base_address  indirizzo di memoria a cui è mappato il device myGPIO;
  */
 void myGPIO_Init(myGPIO_t *gpio, uint32_t base_address) {
-	assert(base_address != 0);
+	myGPIO_Assert(base_address != 0);
 	*gpio = (volatile uint32_t*)base_address;
 }
 
@@ -50,9 +50,9 @@ void myGPIO_Init(myGPIO_t *gpio, uint32_t base_address) {
  * @param[in]  mode  modalità di funzionamento dei pin;
  */
 void myGPIO_SetMode(myGPIO_t gpio, uint32_t mask, uint32_t mode) {
-	assert(gpio != NULL);
-	uint32_t value = gpio[MODE_REG];
-	gpio[MODE_REG] = (MYGPIO_MODE_WRITE == mode ?  value | mask : value &(~mask));
+	myGPIO_Assert(gpio != NULL);
+	uint32_t value = myGPIO_RegRead(gpio, MODE_REG);
+	myGPIO_RegWrite(gpio, MODE_REG, (MYGPIO_MODE_WRITE == mode ?  value | mask : value &(~mask)));
 }
 
 /**
@@ -63,9 +63,9 @@ void myGPIO_SetMode(myGPIO_t gpio, uint32_t mask, uint32_t mode) {
  * @param[in]  value  valore dei pin
  */
 void myGPIO_SetValue(myGPIO_t gpio, uint32_t mask, uint32_t value) {
-	assert(gpio != NULL);
-	uint32_t actual_value = gpio[WRITE_REG];
-	gpio[WRITE_REG] = (MYGPIO_PIN_SET == value ?  actual_value|mask : actual_value&(~mask));
+	myGPIO_Assert(gpio != NULL);
+	uint32_t actual_value = myGPIO_RegRead(gpio, WRITE_REG);
+	myGPIO_RegWrite(gpio, WRITE_REG, (MYGPIO_PIN_SET == value ?  actual_value|mask : actual_value&(~mask)));
 }
 
 /**
@@ -77,9 +77,9 @@ void myGPIO_SetValue(myGPIO_t gpio, uint32_t mask, uint32_t value) {
  * @warning Usa la macro assert per verificare che gpio non sia un puntatore nullo
  */
 void myGPIO_Toggle(myGPIO_t gpio, uint32_t mask) {
-	assert(gpio != NULL);
-	uint32_t actual_value = gpio[WRITE_REG];
-	gpio[WRITE_REG] = actual_value ^ mask;
+	myGPIO_Assert(gpio != NULL);
+	uint32_t actual_value = myGPIO_RegRead(gpio, WRITE_REG);
+	myGPIO_RegWrite(gpio, WRITE_REG, actual_value ^ mask);
 }
 
 /**
@@ -95,8 +95,8 @@ void myGPIO_Toggle(myGPIO_t gpio, uint32_t mask) {
  * @warning Usa la macro assert per verificare che gpio non sia un puntatore nullo
  */
 uint32_t myGPIO_GetValue(myGPIO_t gpio, uint32_t mask) {
-	assert(gpio != NULL);
-	return ((gpio[READ_REG] & mask) == 0 ? MYGPIO_PIN_RESET : MYGPIO_PIN_SET);
+	myGPIO_Assert(gpio != NULL);
+	return ((myGPIO_RegRead(gpio, READ_REG) & mask) == 0 ? MYGPIO_PIN_RESET : MYGPIO_PIN_SET);
 }
 
 /**
@@ -107,8 +107,8 @@ uint32_t myGPIO_GetValue(myGPIO_t gpio, uint32_t mask) {
  * @return maschera dei pin settati di un device myGPIO
  */
 uint32_t myGPIO_GetRead(myGPIO_t gpio) {
-	assert(gpio != NULL);
-	return gpio[READ_REG];
+	myGPIO_Assert(gpio != NULL);
+	return myGPIO_RegRead(gpio, READ_REG);
 }
 
 /**
@@ -117,8 +117,8 @@ uint32_t myGPIO_GetRead(myGPIO_t gpio) {
  * @param [in] gpio istanza myGPIO, che astrae un device myGPIO;
  */
 void myGPIO_GlobalInterruptEnable(myGPIO_t gpio) {
-	assert(gpio != NULL);
-	gpio[GIES_REG] = 1;
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, GIES_REG, 1);
 }
 
 /**
@@ -127,8 +127,8 @@ void myGPIO_GlobalInterruptEnable(myGPIO_t gpio) {
  * @param [in] gpio istanza myGPIO, che astrae un device myGPIO;
  */
 void myGPIO_GlobalInterruptDisable(myGPIO_t gpio) {
-	assert(gpio != NULL);
-	gpio[GIES_REG] = 0;
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, GIES_REG, 0);
 }
 
 /**
@@ -140,8 +140,8 @@ void myGPIO_GlobalInterruptDisable(myGPIO_t gpio) {
  * @retval MYGPIO_PIN_RESET se il bit 0 del registro GIES è resettato, ad indicare che gli interrupt non sono abilitati
  */
 uint32_t myGPIO_IsGlobalInterruptEnabled(myGPIO_t gpio) {
-	assert(gpio != NULL);
-	return ((gpio[GIES_REG] & 1) == 0 ? MYGPIO_PIN_RESET : MYGPIO_PIN_SET);
+	myGPIO_Assert(gpio != NULL);
+	return ((myGPIO_RegRead(gpio, GIES_REG) & 1) == 0 ? MYGPIO_PIN_RESET : MYGPIO_PIN_SET);
 }
 
 /**
@@ -153,8 +153,8 @@ uint32_t myGPIO_IsGlobalInterruptEnabled(myGPIO_t gpio) {
  * @retval MYGPIO_PIN_RESET se il bit 1 del registro GIES è resettato, ad indicare che non esistono interrupt pending
  */
 uint32_t myGPIO_PendingInterrupt(myGPIO_t gpio) {
-	assert(gpio != NULL);
-	return ((gpio[GIES_REG] & 2) == 0 ? MYGPIO_PIN_RESET : MYGPIO_PIN_SET);
+	myGPIO_Assert(gpio != NULL);
+	return ((myGPIO_RegRead(gpio, GIES_REG) & 2) == 0 ? MYGPIO_PIN_RESET : MYGPIO_PIN_SET);
 }
 
 /**
@@ -165,8 +165,8 @@ uint32_t myGPIO_PendingInterrupt(myGPIO_t gpio) {
  * vengono abilitati;
  */
 void myGPIO_PinInterruptEnable(myGPIO_t gpio, uint32_t mask) {
-	assert(gpio != NULL);
-	gpio[PIE_REG] |= mask;
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, PIE_REG, myGPIO_RegRead(gpio, PIE_REG) | mask);
 }
 
 /**
@@ -177,8 +177,8 @@ void myGPIO_PinInterruptEnable(myGPIO_t gpio, uint32_t mask) {
  * vengono disabilitati;
  */
 void myGPIO_PinInterruptDisable(myGPIO_t gpio, uint32_t mask) {
-	assert(gpio != NULL);
-	gpio[PIE_REG] &= ~mask;
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, PIE_REG, myGPIO_RegRead(gpio, PIE_REG) & ~mask);
 }
 
 /**
@@ -189,8 +189,8 @@ void myGPIO_PinInterruptDisable(myGPIO_t gpio, uint32_t mask) {
  * @return maschera che riporta i pin per i quali gli interrupt sono stati abilitati;
  */
 uint32_t myGPIO_EnabledPinInterrupt(myGPIO_t gpio) {
-	assert(gpio != NULL);
-	return gpio[PIE_REG];
+	myGPIO_Assert(gpio != NULL);
+	return myGPIO_RegRead(gpio, PIE_REG);
 }
 
 /**
@@ -201,8 +201,8 @@ uint32_t myGPIO_EnabledPinInterrupt(myGPIO_t gpio) {
  * @return maschera che riporta i pin per i quali gli interrupt non sono stati ancora serviti;
  */
 uint32_t myGPIO_PendingPinInterrupt(myGPIO_t gpio) {
-	assert(gpio != NULL);
-	return gpio[IRQ_REG];
+	myGPIO_Assert(gpio != NULL);
+	return myGPIO_RegRead(gpio, IRQ_REG);
 }
 
 /**
@@ -212,6 +212,8 @@ uint32_t myGPIO_PendingPinInterrupt(myGPIO_t gpio) {
  * @param [in] mask maschera di selezione dei bit;
  */
 void myGPIO_PinInterruptAck(myGPIO_t gpio, uint32_t mask) {
-	assert(gpio != NULL);
-	gpio[IACK_REG] = mask;
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, IACK_REG, mask);
 }
+
+#endif
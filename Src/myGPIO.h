@@ -26,6 +26,10 @@
 
 #include <inttypes.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * @addtogroup myGPIO
  * @{
@@ -73,13 +77,15 @@ typedef volatile uint32_t* myGPIO_t;
 #define MYGPIO_PIN30  0x40000000U  //!< maschera di selezione del pin 30 
 #define MYGPIO_PIN31  0x80000000U  //!< maschera di selezione del pin 31 
 
-#define MYGPIO_PIN(i) ((uint32_t)(1<<(i)))
+#define MYGPIO_PIN(i) ((uint32_t)(1U<<(i)))
 
 #define MYGPIO_MODE_READ  0U //!< modalità lettura
 #define MYGPIO_MODE_WRITE 1U //!< modalità scrittura
 #define MYGPIO_PIN_RESET  0U
 #define MYGPIO_PIN_SET    1U
 
+#ifndef MYGPIO_INLINE
+
 void     myGPIO_Init                    (myGPIO_t *gpio, uint32_t base_address);
 void     myGPIO_SetMode                 (myGPIO_t gpio, uint32_t mask,          uint32_t mode);
 void     myGPIO_SetValue                (myGPIO_t gpio, uint32_t mask,          uint32_t value);
@@ -96,9 +102,26 @@ uint32_t myGPIO_EnabledPinInterrupt     (myGPIO_t gpio);
 uint32_t myGPIO_PendingPinInterrupt     (myGPIO_t gpio);
 void     myGPIO_PinInterruptAck         (myGPIO_t gpio, uint32_t mask);
 
+#endif
+
 /**
  * @}
  * @}
  */
 
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * Definendo MYGPIO_INLINE in compilazione, le funzioni del driver vengono definite "static inline" da
+ * myGPIO_inline.h, anziché essere dichiarate qui ed implementate in myGPIO.c. L'inclusione avviene fuori
+ * dal blocco extern "C", dato che myGPIO_inline.h include a sua volta header di sistema. Se myGPIO.h viene
+ * incluso da myGPIO_regs.h, è quest'ultimo ad includere myGPIO_inline.h, al termine, quando registri e
+ * primitive di accesso sono già definiti.
+ */
+#if defined(MYGPIO_INLINE) && !defined(MYGPIO_REGS_HEADER_H)
+#include "myGPIO_inline.h"
+#endif
+
 #endif
@@ -0,0 +1,242 @@
+/**
+ * @file myGPIO.hpp
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_DRIVER_HEADER_HPP
+#define MYGPIO_DRIVER_HEADER_HPP
+
+#include <stdint.h>
+#include "myGPIO.h"
+#include "myGPIO_regs.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Layer C++ header-only, basato su template, sulla mappa dei registri myGPIO.
+ *
+ * @details
+ * Pin, insiemi di pin e configurazioni sono tipi; le maschere corrispondenti sono costanti calcolate in
+ * compilazione a partire da MYGPIO_PIN(). Port::configure() accorpa la configurazione di modalità e valore
+ * di un numero qualsiasi di pin in, al più, una operazione sul registro MODE ed una sul registro WRITE:
+ * quando la configurazione copre tutti i GPIO_width pin del device l'operazione è una singola store,
+ * altrimenti è una sola sequenza read-modify-write.
+ * Maschere che selezionano pin oltre GPIO_width vengono rifiutate in compilazione.
+ *
+ * La sequenza di configurazione di interrupt_bare.c, ad esempio, si riduce a
+ * @code
+ * using namespace myGPIO;
+ * typedef PinSet<Pin<0>, Pin<1>, Pin<2>, Pin<3> > Low4;
+ * typedef Port<XPAR_MYGPIO_0_S00_AXI_BASEADDR, 4> Leds;
+ * typedef Port<XPAR_MYGPIO_1_S00_AXI_BASEADDR, 4> Buttons;
+ * Leds::configure<Output<Low4, MYGPIO_PIN_RESET> >();  // una store su MODE ed una su WRITE
+ * Buttons::configure<Input<Low4> >();                  // una store su MODE
+ * Leds::set<Pin<2> >();
+ * @endcode
+ */
+namespace myGPIO {
+
+/**
+ * @brief Singolo pin del device.
+ */
+template <unsigned N>
+struct Pin {
+	static_assert(N < 32, "myGPIO: indice di pin fuori dal registro a 32 bit");
+	static constexpr uint32_t mask = MYGPIO_PIN(N);
+};
+
+/**
+ * @brief Insieme di pin (o di altri PinSet); la maschera è la OR delle maschere dei componenti.
+ */
+template <typename... Pins>
+struct PinSet;
+
+template <>
+struct PinSet<> {
+	static constexpr uint32_t mask = 0;
+};
+
+template <typename First, typename... Rest>
+struct PinSet<First, Rest...> {
+	static constexpr uint32_t mask = First::mask | PinSet<Rest...>::mask;
+};
+
+/**
+ * @brief Configurazione: i pin di S vengono posti in uscita, al valore iniziale Level.
+ */
+template <typename S, uint32_t Level = MYGPIO_PIN_RESET>
+struct Output {
+	static constexpr uint32_t mode_set   = S::mask;
+	static constexpr uint32_t mode_clear = 0;
+	static constexpr uint32_t write_set   = (Level == MYGPIO_PIN_SET ? S::mask : 0);
+	static constexpr uint32_t write_clear = (Level == MYGPIO_PIN_SET ? 0 : S::mask);
+};
+
+/**
+ * @brief Configurazione: i pin di S vengono posti in ingresso (alta impedenza); WRITE non viene toccato.
+ */
+template <typename S>
+struct Input {
+	static constexpr uint32_t mode_set   = 0;
+	static constexpr uint32_t mode_clear = S::mask;
+	static constexpr uint32_t write_set   = 0;
+	static constexpr uint32_t write_clear = 0;
+};
+
+/**
+ * @brief Accorpa più configurazioni; in caso di sovrapposizione prevale l'ultima.
+ */
+template <typename... Cfg>
+struct Config;
+
+template <>
+struct Config<> {
+	static constexpr uint32_t mode_set    = 0;
+	static constexpr uint32_t mode_clear  = 0;
+	static constexpr uint32_t write_set   = 0;
+	static constexpr uint32_t write_clear = 0;
+};
+
+template <typename First, typename... Rest>
+struct Config<First, Rest...> {
+	typedef Config<Rest...> Tail;
+	static constexpr uint32_t mode_set    = (First::mode_set & ~(Tail::mode_set | Tail::mode_clear)) | Tail::mode_set;
+	static constexpr uint32_t mode_clear  = (First::mode_clear & ~(Tail::mode_set | Tail::mode_clear)) | Tail::mode_clear;
+	static constexpr uint32_t write_set   = (First::write_set & ~(Tail::write_set | Tail::write_clear)) | Tail::write_set;
+	static constexpr uint32_t write_clear = (First::write_clear & ~(Tail::write_set | Tail::write_clear)) | Tail::write_clear;
+};
+
+/**
+ * @brief Device myGPIO mappato all'indirizzo Base, con GPIO_width pari a Width.
+ */
+template <uintptr_t Base, unsigned Width = 32>
+class Port {
+	static_assert(Base != 0, "myGPIO: indirizzo del device nullo");
+	static_assert(Width >= 1 && Width <= 32, "myGPIO: GPIO_width deve essere compreso tra 1 e 32");
+
+public:
+	static constexpr uint32_t width_mask = (Width == 32 ? 0xFFFFFFFFU : ((1U << (Width % 32)) - 1U));
+
+	/**
+	 * @brief Restituisce l'handle C del device, da usare con le funzioni di myGPIO.h
+	 */
+	static myGPIO_t regs() {
+		return reinterpret_cast<myGPIO_t>(Base);
+	}
+
+	/**
+	 * @brief Applica le configurazioni Cfg con, al più, una operazione su MODE ed una su WRITE.
+	 */
+	template <typename... Cfg>
+	static void configure() {
+		typedef Config<Cfg...> C;
+		static_assert(((C::mode_set | C::mode_clear | C::write_set | C::write_clear) & ~width_mask) == 0,
+				"myGPIO: la configurazione seleziona pin oltre GPIO_width");
+		update<MODE_REG, C::mode_set, C::mode_clear>();
+		update<WRITE_REG, C::write_set, C::write_clear>();
+	}
+
+	/**
+	 * @brief Porta a livello alto i pin di S.
+	 */
+	template <typename S>
+	static void set() {
+		check<S>();
+		update<WRITE_REG, S::mask, 0>();
+	}
+
+	/**
+	 * @brief Porta a livello basso i pin di S.
+	 */
+	template <typename S>
+	static void clear() {
+		check<S>();
+		update<WRITE_REG, 0, S::mask>();
+	}
+
+	/**
+	 * @brief Inverte il valore dei pin di S.
+	 */
+	template <typename S>
+	static void toggle() {
+		check<S>();
+		myGPIO_RegWrite(regs(), WRITE_REG, myGPIO_RegRead(regs(), WRITE_REG) ^ S::mask);
+	}
+
+	/**
+	 * @brief Scrive l'intero registro WRITE con una sola store.
+	 */
+	static void write(uint32_t value) {
+		myGPIO_RegWrite(regs(), WRITE_REG, value & width_mask);
+	}
+
+	/**
+	 * @brief Restituisce il contenuto del registro READ.
+	 */
+	static uint32_t read() {
+		return myGPIO_RegRead(regs(), READ_REG) & width_mask;
+	}
+
+	/**
+	 * @brief Restituisce true se almeno uno dei pin di S è a livello alto.
+	 */
+	template <typename S>
+	static bool get() {
+		check<S>();
+		return (read() & S::mask) != 0;
+	}
+
+private:
+	template <typename S>
+	static void check() {
+		static_assert((S::mask & ~width_mask) == 0, "myGPIO: la maschera seleziona pin oltre GPIO_width");
+	}
+
+	/**
+	 * @brief Porta ad uno i bit SetMask e a zero i bit ClearMask del registro Reg.
+	 *
+	 * @details
+	 * Se nessun bit viene coinvolto non si accede al device; se vengono coinvolti tutti i pin del device il
+	 * nuovo valore è noto in compilazione e basta una store; negli altri casi si effettua una sola sequenza
+	 * read-modify-write.
+	 */
+	template <unsigned Reg, uint32_t SetMask, uint32_t ClearMask>
+	static void update() {
+		if ((SetMask | ClearMask) == 0)
+			return;
+		if (((SetMask | ClearMask) & width_mask) == width_mask)
+			myGPIO_RegWrite(regs(), Reg, SetMask);
+		else
+			myGPIO_RegWrite(regs(), Reg, (myGPIO_RegRead(regs(), Reg) & ~ClearMask) | SetMask);
+	}
+};
+
+}
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * @file myGPIO_batch.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_batch.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Riporta un registro nello stato "nessuna operazione".
+ */
+static void myGPIO_BatchReg_Clear(myGPIO_BatchReg_t *reg) {
+	reg->keep   = 0xFFFFFFFFU;
+	reg->set    = 0;
+	reg->toggle = 0;
+}
+
+/**
+ * @brief Registra l'operazione "bit di mask al valore bit" su un registro.
+ */
+static void myGPIO_BatchReg_Assign(myGPIO_BatchReg_t *reg, uint32_t mask, uint32_t bit) {
+	reg->keep   &= ~mask;
+	reg->toggle &= ~mask;
+	reg->set     = (bit != 0 ? reg->set | mask : reg->set & ~mask);
+}
+
+/**
+ * @brief Scrive un registro, se sono state registrate operazioni su di esso.
+ *
+ * @details
+ * Il valore corrente del registro viene letto solo se il nuovo valore dipende da esso; se il batch assume
+ * che il device sia nello stato di reset, il valore corrente è zero.
+ */
+static void myGPIO_BatchReg_Flush(const myGPIO_BatchReg_t *reg, myGPIO_t gpio, uint32_t index, uint32_t flags) {
+	uint32_t old = 0;
+	if (reg->keep == 0xFFFFFFFFU && reg->toggle == 0)
+		return;
+	if (reg->keep != 0 && (flags & MYGPIO_BATCH_ASSUME_RESET) == 0)
+		old = myGPIO_RegRead(gpio, index);
+	myGPIO_RegWrite(gpio, index, ((old & reg->keep) | reg->set) ^ reg->toggle);
+}
+
+/**
+ * @brief Restituisce l'elemento del batch relativo ad un device, aggiungendolo se necessario.
+ */
+static myGPIO_BatchDev_t* myGPIO_Batch_Lookup(myGPIO_Batch_t *batch, myGPIO_t gpio) {
+	uint32_t i;
+	myGPIO_BatchDev_t *dev;
+	assert(batch != NULL);
+	assert(gpio != NULL);
+	for (i = 0; i < batch->count; i++)
+		if (batch->dev[i].gpio == gpio)
+			return &batch->dev[i];
+	assert(batch->count < MYGPIO_BATCH_MAX_DEVICES);
+	dev = &batch->dev[batch->count++];
+	dev->gpio = gpio;
+	myGPIO_BatchReg_Clear(&dev->mode);
+	myGPIO_BatchReg_Clear(&dev->write);
+	myGPIO_BatchReg_Clear(&dev->pie);
+	dev->iack = 0;
+	dev->gies = 0;
+	dev->gies_set = 0;
+	return dev;
+}
+
+/**
+ * @brief Inizializza un batch vuoto.
+ *
+ * @param[out] batch  batch da inizializzare;
+ * @param[in]  flags  0, oppure MYGPIO_BATCH_ASSUME_RESET se i device si trovano nello stato di reset;
+ */
+void myGPIO_Batch_Init(myGPIO_Batch_t *batch, uint32_t flags) {
+	assert(batch != NULL);
+	batch->count = 0;
+	batch->flags = flags;
+}
+
+/**
+ * @brief Registra una myGPIO_SetMode()
+ *
+ * @param[inout] batch  batch;
+ * @param[in]    gpio   istanza myGPIO;
+ * @param[in]    mask   maschera dei pin su cui agire;
+ * @param[in]    mode   modalità di funzionamento dei pin;
+ */
+void myGPIO_Batch_SetMode(myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask, uint32_t mode) {
+	myGPIO_BatchReg_Assign(&myGPIO_Batch_Lookup(batch, gpio)->mode, mask, MYGPIO_MODE_WRITE == mode);
+}
+
+/**
+ * @brief Registra una myGPIO_SetValue()
+ *
+ * @param[inout] batch  batch;
+ * @param[in]    gpio   istanza myGPIO;
+ * @param[in]    mask   maschera dei pin su cui agire;
+ * @param[in]    value  valore dei pin;
+ */
+void myGPIO_Batch_SetValue(myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask, uint32_t value) {
+	myGPIO_BatchReg_Assign(&myGPIO_Batch_Lookup(batch, gpio)->write, mask, MYGPIO_PIN_SET == value);
+}
+
+/**
+ * @brief Registra una myGPIO_Toggle()
+ *
+ * @param[inout] batch  batch;
+ * @param[in]    gpio   istanza myGPIO;
+ * @param[in]    mask   maschera dei pin su cui agire;
+ */
+void myGPIO_Batch_Toggle(myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Batch_Lookup(batch, gpio)->write.toggle ^= mask;
+}
+
+/**
+ * @brief Registra una myGPIO_PinInterruptEnable()
+ *
+ * @param[inout] batch  batch;
+ * @param[in]    gpio   istanza myGPIO;
+ * @param[in]    mask   maschera di selezione degli interrupt da abilitare;
+ */
+void myGPIO_Batch_PinInterruptEnable(myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask) {
+	myGPIO_BatchReg_Assign(&myGPIO_Batch_Lookup(batch, gpio)->pie, mask, 1);
+}
+
+/**
+ * @brief Registra una myGPIO_PinInterruptDisable()
+ *
+ * @param[inout] batch  batch;
+ * @param[in]    gpio   istanza myGPIO;
+ * @param[in]    mask   maschera di selezione degli interrupt da disabilitare;
+ */
+void myGPIO_Batch_PinInterruptDisable(myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask) {
+	myGPIO_BatchReg_Assign(&myGPIO_Batch_Lookup(batch, gpio)->pie, mask, 0);
+}
+
+/**
+ * @brief Registra una myGPIO_PinInterruptAck(); più ack sullo stesso device vengono accorpati.
+ *
+ * @param[inout] batch  batch;
+ * @param[in]    gpio   istanza myGPIO;
+ * @param[in]    mask   maschera di selezione dei bit;
+ */
+void myGPIO_Batch_PinInterruptAck(myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Batch_Lookup(batch, gpio)->iack |= mask;
+}
+
+/**
+ * @brief Registra una myGPIO_GlobalInterruptEnable()
+ *
+ * @param[inout] batch  batch;
+ * @param[in]    gpio   istanza myGPIO;
+ */
+void myGPIO_Batch_GlobalInterruptEnable(myGPIO_Batch_t *batch, myGPIO_t gpio) {
+	myGPIO_BatchDev_t *dev = myGPIO_Batch_Lookup(batch, gpio);
+	dev->gies = 1;
+	dev->gies_set = 1;
+}
+
+/**
+ * @brief Registra una myGPIO_GlobalInterruptDisable()
+ *
+ * @param[inout] batch  batch;
+ * @param[in]    gpio   istanza myGPIO;
+ */
+void myGPIO_Batch_GlobalInterruptDisable(myGPIO_Batch_t *batch, myGPIO_t gpio) {
+	myGPIO_BatchDev_t *dev = myGPIO_Batch_Lookup(batch, gpio);
+	dev->gies = 0;
+	dev->gies_set = 1;
+}
+
+/**
+ * @brief Applica ai device le operazioni registrate e svuota il batch.
+ *
+ * @param[inout] batch  batch;
+ *
+ * @details
+ * I device vengono aggiornati nell'ordine in cui sono stati aggiunti al batch; per ciascuno di essi i
+ * registri vengono scritti nell'ordine WRITE, MODE, PIE, IACK, GIES, con una sola scrittura per registro.
+ * Dopo il primo flush i device non si trovano più nello stato di reset, per cui il flag
+ * MYGPIO_BATCH_ASSUME_RESET viene rimosso.
+ */
+void myGPIO_Batch_Flush(myGPIO_Batch_t *batch) {
+	uint32_t i;
+	assert(batch != NULL);
+	for (i = 0; i < batch->count; i++) {
+		myGPIO_BatchDev_t *dev = &batch->dev[i];
+		myGPIO_BatchReg_Flush(&dev->write, dev->gpio, WRITE_REG, batch->flags);
+		myGPIO_BatchReg_Flush(&dev->mode, dev->gpio, MODE_REG, batch->flags);
+		myGPIO_BatchReg_Flush(&dev->pie, dev->gpio, PIE_REG, batch->flags);
+		if (dev->iack != 0)
+			myGPIO_RegWrite(dev->gpio, IACK_REG, dev->iack);
+		if (dev->gies_set != 0)
+			myGPIO_RegWrite(dev->gpio, GIES_REG, dev->gies);
+	}
+	batch->count = 0;
+	batch->flags &= ~MYGPIO_BATCH_ASSUME_RESET;
+}
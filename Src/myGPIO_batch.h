@@ -0,0 +1,110 @@
+/**
+ * @file myGPIO_batch.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_BATCH_HEADER_H
+#define MYGPIO_BATCH_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Registrazione differita delle operazioni sui registri di uno o più device myGPIO.
+ *
+ * @details
+ * Un oggetto myGPIO_Batch_t registra le operazioni richieste senza accedere ai device. Le operazioni che
+ * insistono sullo stesso registro dello stesso device vengono accorpate: ciascun registro viene descritto
+ * dalla funzione nuovo = ((vecchio & keep) | set) ^ toggle, aggiornata ad ogni operazione.
+ * myGPIO_Batch_Flush() effettua poi una sola scrittura per ogni registro coinvolto, preceduta da una sola
+ * lettura solo se il nuovo valore dipende da quello corrente. Se il batch viene inizializzato con il flag
+ * MYGPIO_BATCH_ASSUME_RESET, i registri dei device vengono considerati nello stato di reset (tutti i bit a
+ * zero) e non viene effettuata alcuna lettura; il flag va usato solo nella configurazione iniziale dei
+ * device, quando nessuno vi ha ancora scritto, e vale fino al primo myGPIO_Batch_Flush().
+ *
+ * I device vengono aggiornati nell'ordine in cui sono comparsi per la prima volta nel batch; per ciascun
+ * device i registri vengono scritti nell'ordine WRITE, MODE, PIE, IACK, GIES: il valore delle uscite è
+ * impostato prima che i pin vengano posti in uscita, e gli interrupt vengono abilitati per ultimi.
+ *
+ * La sequenza di configurazione di interrupt_bare.c diventa, ad esempio
+ * @code
+ * myGPIO_Batch_t batch;
+ * myGPIO_Batch_Init(&batch, MYGPIO_BATCH_ASSUME_RESET);
+ * myGPIO_Batch_SetMode(&batch, led_gpio, MYGPIO_PIN0 | MYGPIO_PIN1 | MYGPIO_PIN2 | MYGPIO_PIN3, MYGPIO_MODE_WRITE);
+ * myGPIO_Batch_SetValue(&batch, led_gpio, MYGPIO_PIN0 | MYGPIO_PIN1 | MYGPIO_PIN2 | MYGPIO_PIN3, MYGPIO_PIN_RESET);
+ * myGPIO_Batch_PinInterruptEnable(&batch, btn_gpio, MYGPIO_PIN0 | MYGPIO_PIN1 | MYGPIO_PIN2 | MYGPIO_PIN3);
+ * myGPIO_Batch_GlobalInterruptEnable(&batch, btn_gpio);
+ * myGPIO_Batch_Flush(&batch);
+ * @endcode
+ */
+
+#define MYGPIO_BATCH_MAX_DEVICES   8    //!< numero massimo di device distinti in un batch
+#define MYGPIO_BATCH_ASSUME_RESET  0x1U //!< i registri dei device si trovano nello stato di reset
+
+/**
+ * @brief Operazioni accumulate su un registro: nuovo = ((vecchio & keep) | set) ^ toggle
+ */
+typedef struct {
+	uint32_t keep;    //!< bit che conservano il valore corrente
+	uint32_t set;     //!< bit posti ad uno
+	uint32_t toggle;  //!< bit invertiti
+} myGPIO_BatchReg_t;
+
+/**
+ * @brief Operazioni accumulate su un device.
+ */
+typedef struct {
+	myGPIO_t          gpio;      //!< device cui le operazioni si riferiscono
+	myGPIO_BatchReg_t mode;      //!< operazioni sul registro MODE
+	myGPIO_BatchReg_t write;     //!< operazioni sul registro WRITE
+	myGPIO_BatchReg_t pie;       //!< operazioni sul registro PIE
+	uint32_t          iack;      //!< OR delle maschere di ack
+	uint32_t          gies;      //!< valore da scrivere nel registro GIES
+	uint32_t          gies_set;  //!< impostato ad 1 se GIES va scritto
+} myGPIO_BatchDev_t;
+
+typedef struct {
+	myGPIO_BatchDev_t dev[MYGPIO_BATCH_MAX_DEVICES];  //!< device coinvolti, in ordine di comparsa
+	uint32_t          count;                          //!< numero di device coinvolti
+	uint32_t          flags;                          //!< flag specificati in inizializzazione
+} myGPIO_Batch_t;
+
+void myGPIO_Batch_Init                  (myGPIO_Batch_t *batch, uint32_t flags);
+void myGPIO_Batch_SetMode               (myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask, uint32_t mode);
+void myGPIO_Batch_SetValue              (myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask, uint32_t value);
+void myGPIO_Batch_Toggle                (myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask);
+void myGPIO_Batch_PinInterruptEnable    (myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask);
+void myGPIO_Batch_PinInterruptDisable   (myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask);
+void myGPIO_Batch_PinInterruptAck       (myGPIO_Batch_t *batch, myGPIO_t gpio, uint32_t mask);
+void myGPIO_Batch_GlobalInterruptEnable (myGPIO_Batch_t *batch, myGPIO_t gpio);
+void myGPIO_Batch_GlobalInterruptDisable(myGPIO_Batch_t *batch, myGPIO_t gpio);
+void myGPIO_Batch_Flush                 (myGPIO_Batch_t *batch);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
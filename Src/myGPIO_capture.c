@@ -0,0 +1,239 @@
+/**
+ * @file myGPIO_capture.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_capture.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Inizializza ed arma l'acquisizione, senza condizione di trigger e senza limite di campioni, con
+ * metà del buffer riservata alla storia che precede il trigger.
+ *
+ * @param[out] cap       acquisizione da inizializzare;
+ * @param[in]  gpio      istanza myGPIO, già inizializzata con myGPIO_Init();
+ * @param[out] ring      buffer dei run;
+ * @param[in]  capacity  dimensione del buffer, in run, almeno 2;
+ */
+void myGPIO_Capture_Init(myGPIO_Capture_t *cap, myGPIO_t gpio, myGPIO_CaptureRun_t *ring, uint32_t capacity) {
+	assert(cap != NULL);
+	assert(gpio != NULL);
+	assert(ring != NULL && capacity >= 2);
+	cap->gpio = gpio;
+	cap->ring = ring;
+	cap->capacity = capacity;
+	cap->pre = capacity / 2;
+	myGPIO_Capture_SetTrigger(cap, 0, 0, 0, 0, 0xFFFFFFFFU);
+}
+
+/**
+ * @brief Imposta la condizione di trigger e riarma l'acquisizione, scartando i run memorizzati.
+ *
+ * @param[inout] cap      acquisizione;
+ * @param[in]    mask     pin su cui valutare la corrispondenza con value;
+ * @param[in]    value    valore atteso sui pin indicati da mask;
+ * @param[in]    rising   pin su cui è richiesto un fronte di salita;
+ * @param[in]    falling  pin su cui è richiesto un fronte di discesa;
+ * @param[in]    post     campioni da acquisire a partire da quello di trigger, almeno 1;
+ *
+ * @details
+ * Se rising e falling sono entrambi nulli, basta la corrispondenza; altrimenti deve presentarsi anche
+ * almeno uno dei fronti indicati, rispetto al campione precedente. Con mask, rising e falling nulli il
+ * trigger scatta al primo campione.
+ */
+void myGPIO_Capture_SetTrigger(myGPIO_Capture_t *cap, uint32_t mask, uint32_t value, uint32_t rising, uint32_t falling, uint32_t post) {
+	assert(cap != NULL);
+	assert((value & ~mask) == 0);
+	assert(post != 0);
+	cap->mask = mask;
+	cap->value = value;
+	cap->rising = rising;
+	cap->falling = falling;
+	cap->post = post;
+	cap->remaining = post;
+	cap->state = MYGPIO_CAPTURE_ARMED;
+	cap->first = 0;
+	cap->runs = 0;
+	cap->current.value = 0;
+	cap->current.count = 0;
+	cap->trigger = 0;
+	cap->dropped = 0;
+	cap->samples = 0;
+}
+
+/**
+ * @brief Scarta il run più vecchio.
+ */
+static void myGPIO_Capture_Drop(myGPIO_Capture_t *cap) {
+	cap->first = (cap->first + 1 == cap->capacity ? 0 : cap->first + 1);
+	cap->runs--;
+	cap->dropped++;
+}
+
+/**
+ * @brief Imposta il numero massimo di run conservati prima del trigger.
+ *
+ * @param[inout] cap  acquisizione;
+ * @param[in]    pre  run conservati al più prima del trigger, minore della dimensione del buffer;
+ *
+ * @details
+ * Prima del trigger il buffer viene usato in modo circolare su non più di pre run: i restanti, almeno
+ * capacity - pre, restano riservati al run di trigger ed a quelli successivi. Con pre nullo la storia che
+ * precede il trigger non viene conservata. L'impostazione sopravvive a myGPIO_Capture_SetTrigger(); se
+ * l'acquisizione è armata e conserva più di pre run, i più vecchi vengono scartati.
+ */
+void myGPIO_Capture_SetPretrigger(myGPIO_Capture_t *cap, uint32_t pre) {
+	assert(cap != NULL);
+	assert(pre < cap->capacity);
+	cap->pre = pre;
+	while (cap->state == MYGPIO_CAPTURE_ARMED && cap->runs > pre)
+		myGPIO_Capture_Drop(cap);
+}
+
+/**
+ * @brief Memorizza un run completo; prima del trigger, scarta i più vecchi oltre i pre run di storia.
+ *
+ * @details
+ * Dopo il trigger il buffer non viene mai trovato pieno: l'acquisizione termina non appena si riempie.
+ */
+static void myGPIO_Capture_Push(myGPIO_Capture_t *cap, uint32_t value, uint32_t count) {
+	uint32_t position;
+	if (cap->state == MYGPIO_CAPTURE_ARMED) {
+		if (cap->pre == 0) {
+			cap->dropped++;
+			return;
+		}
+		while (cap->runs >= cap->pre)
+			myGPIO_Capture_Drop(cap);
+	}
+	position = cap->first + cap->runs;
+	if (position >= cap->capacity)
+		position -= cap->capacity;
+	cap->ring[position].value = value;
+	cap->ring[position].count = count;
+	cap->runs++;
+}
+
+/**
+ * @brief Acquisisce al più samples campioni, ritornando prima se l'acquisizione termina.
+ *
+ * @param[inout] cap      acquisizione;
+ * @param[in]    samples  numero massimo di campioni da acquisire in questa chiamata;
+ *
+ * @details
+ * Può essere chiamata ripetutamente, intervallandola con altre attività: lo stato, compreso il run in
+ * corso, viene conservato nella struttura. I due cicli di acquisizione, prima e dopo il trigger, sono
+ * distinti, così che dopo il trigger ciascun campione costi una lettura, un confronto ed un incremento.
+ *
+ * @return stato dell'acquisizione: MYGPIO_CAPTURE_ARMED, MYGPIO_CAPTURE_TRIGGERED o MYGPIO_CAPTURE_DONE
+ */
+uint32_t myGPIO_Capture_Run(myGPIO_Capture_t *cap, uint32_t samples) {
+	uint32_t v, n, s, budget, i;
+	assert(cap != NULL);
+	v = cap->current.value;
+	n = cap->current.count;
+	i = 0;
+	while (cap->state == MYGPIO_CAPTURE_ARMED && i < samples) {
+		s = myGPIO_RegRead(cap->gpio, READ_REG);
+		i++;
+		if ((s & cap->mask) == cap->value && ((cap->rising | cap->falling) == 0 ||
+				(n != 0 && ((cap->rising & s & ~v) | (cap->falling & ~s & v)) != 0))) {
+			if (n != 0)
+				myGPIO_Capture_Push(cap, v, n);
+			cap->state = MYGPIO_CAPTURE_TRIGGERED;
+			cap->trigger = cap->runs;
+			v = s;
+			n = 1;
+			cap->remaining--;
+		}
+		else if (s == v && n != 0xFFFFFFFFU)
+			n++;
+		else {
+			if (n != 0)
+				myGPIO_Capture_Push(cap, v, n);
+			v = s;
+			n = 1;
+		}
+	}
+	if (cap->state == MYGPIO_CAPTURE_TRIGGERED) {
+		budget = (samples - i < cap->remaining ? samples - i : cap->remaining);
+		cap->remaining -= budget;
+		i += budget;
+		while (budget != 0) {
+			s = myGPIO_RegRead(cap->gpio, READ_REG);
+			budget--;
+			if (s == v && n != 0xFFFFFFFFU)
+				n++;
+			else {
+				myGPIO_Capture_Push(cap, v, n);
+				n = 0;
+				if (cap->runs == cap->capacity) {
+					cap->state = MYGPIO_CAPTURE_DONE;
+					i -= budget + 1;
+					break;
+				}
+				v = s;
+				n = 1;
+			}
+		}
+		if (cap->remaining == 0 && cap->state == MYGPIO_CAPTURE_TRIGGERED) {
+			cap->state = MYGPIO_CAPTURE_DONE;
+			myGPIO_Capture_Push(cap, v, n);
+			n = 0;
+		}
+	}
+	cap->current.value = v;
+	cap->current.count = n;
+	cap->samples += i;
+	return cap->state;
+}
+
+/**
+ * @brief Termina l'acquisizione, memorizzando il run in corso se c'è spazio nel buffer.
+ *
+ * @param[inout] cap  acquisizione;
+ */
+void myGPIO_Capture_Stop(myGPIO_Capture_t *cap) {
+	assert(cap != NULL);
+	if (cap->state == MYGPIO_CAPTURE_DONE)
+		return;
+	if (cap->current.count != 0) {
+		myGPIO_Capture_Push(cap, cap->current.value, cap->current.count);
+		cap->current.count = 0;
+	}
+	cap->state = MYGPIO_CAPTURE_DONE;
+}
+
+/**
+ * @brief Restituisce il run di indice cronologico index, a partire dal più vecchio memorizzato.
+ *
+ * @param[in] cap    acquisizione;
+ * @param[in] index  indice del run, minore di cap->runs;
+ */
+const myGPIO_CaptureRun_t* myGPIO_Capture_Get(const myGPIO_Capture_t *cap, uint32_t index) {
+	uint32_t position;
+	assert(cap != NULL);
+	assert(index < cap->runs);
+	position = cap->first + index;
+	if (position >= cap->capacity)
+		position -= cap->capacity;
+	return &cap->ring[position];
+}
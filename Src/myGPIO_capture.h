@@ -0,0 +1,108 @@
+/**
+ * @file myGPIO_capture.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_CAPTURE_HEADER_H
+#define MYGPIO_CAPTURE_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Acquisizione del registro READ, alla massima velocità, con codifica run-length.
+ *
+ * @details
+ * myGPIO_Capture_Run() legge il registro READ alla massima velocità consentita dal bus e memorizza i campioni
+ * in un buffer circolare, fornito dal chiamante, sotto forma di coppie (valore, ripetizioni): un campione
+ * uguale al precedente costa un incremento, per cui lunghi periodi di inattività occupano un solo elemento
+ * del buffer. Si noti che l'intervallo tra due campioni è quello di una lettura dal bus, che non è costante,
+ * per cui le ripetizioni misurano il tempo solo approssimativamente.
+ *
+ * L'acquisizione parte armata: finché la condizione di trigger non è verificata il buffer viene usato in
+ * modo circolare, scartando i run più vecchi, così da conservare la storia che precede il trigger. La storia
+ * è limitata a pre run, impostati con myGPIO_Capture_SetPretrigger(), di default metà del buffer, così che
+ * almeno capacity - pre run restino riservati al trigger ed a ciò che lo segue. Il campione che soddisfa la
+ * condizione apre sempre un nuovo run, il cui indice è riportato nel campo trigger; da quel momento vengono
+ * acquisiti al più post campioni, dopodiché l'acquisizione termina, così come termina quando il buffer si
+ * riempie. La condizione di trigger è la corrispondenza del campione con un
+ * valore, sui pin indicati da una maschera, eventualmente insieme ad un fronte di salita o di discesa su
+ * uno dei pin indicati; senza condizione, l'acquisizione scatta al primo campione.
+ *
+ * @code
+ * myGPIO_CaptureRun_t ring[4096];
+ * myGPIO_Capture_t cap;
+ * myGPIO_Capture_Init(&cap, gpio, ring, 4096);
+ * myGPIO_Capture_SetTrigger(&cap, 0, 0, 0, MYGPIO_PIN(0), 1000000); // fronte di discesa sul pin 0
+ * myGPIO_Capture_SetPretrigger(&cap, 512);                          // 3584 run per il resto
+ * while (myGPIO_Capture_Run(&cap, 65536) != MYGPIO_CAPTURE_DONE)
+ * 	do_other_work();
+ * for (i = 0; i < cap.runs; i++)
+ * 	printf("%08x x %u\n", myGPIO_Capture_Get(&cap, i)->value, myGPIO_Capture_Get(&cap, i)->count);
+ * @endcode
+ */
+
+#define MYGPIO_CAPTURE_ARMED      0U  //!< in attesa della condizione di trigger
+#define MYGPIO_CAPTURE_TRIGGERED  1U  //!< trigger avvenuto, acquisizione in corso
+#define MYGPIO_CAPTURE_DONE       2U  //!< acquisizione terminata
+
+typedef struct {
+	uint32_t value;  //!< valore del registro READ
+	uint32_t count;  //!< numero di campioni consecutivi con tale valore
+} myGPIO_CaptureRun_t;
+
+typedef struct {
+	myGPIO_t             gpio;      //!< device myGPIO
+	myGPIO_CaptureRun_t *ring;      //!< buffer dei run, fornito dal chiamante
+	uint32_t             capacity;  //!< dimensione del buffer
+	uint32_t             first;     //!< posizione, nel buffer, del run più vecchio
+	uint32_t             runs;      //!< numero di run completi memorizzati
+	myGPIO_CaptureRun_t  current;   //!< run in corso, non ancora memorizzato
+	uint32_t             mask;      //!< maschera dei pin su cui valutare value
+	uint32_t             value;     //!< valore atteso sui pin indicati da mask
+	uint32_t             rising;    //!< pin su cui è richiesto un fronte di salita
+	uint32_t             falling;   //!< pin su cui è richiesto un fronte di discesa
+	uint32_t             pre;       //!< run conservati al più prima del trigger
+	uint32_t             post;      //!< campioni da acquisire dopo il trigger, compreso quello di trigger
+	uint32_t             remaining; //!< campioni ancora da acquisire dopo il trigger
+	uint32_t             state;     //!< stato dell'acquisizione
+	uint32_t             trigger;   //!< indice cronologico del run che inizia con il campione di trigger
+	uint32_t             dropped;   //!< run scartati prima del trigger
+	uint64_t             samples;   //!< campioni acquisiti
+} myGPIO_Capture_t;
+
+void                       myGPIO_Capture_Init         (myGPIO_Capture_t *cap, myGPIO_t gpio, myGPIO_CaptureRun_t *ring, uint32_t capacity);
+void                       myGPIO_Capture_SetTrigger   (myGPIO_Capture_t *cap, uint32_t mask, uint32_t value, uint32_t rising, uint32_t falling, uint32_t post);
+void                       myGPIO_Capture_SetPretrigger(myGPIO_Capture_t *cap, uint32_t pre);
+uint32_t                   myGPIO_Capture_Run          (myGPIO_Capture_t *cap, uint32_t samples);
+void                       myGPIO_Capture_Stop         (myGPIO_Capture_t *cap);
+const myGPIO_CaptureRun_t* myGPIO_Capture_Get          (const myGPIO_Capture_t *cap, uint32_t index);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
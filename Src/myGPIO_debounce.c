@@ -0,0 +1,83 @@
+/**
+ * @file myGPIO_debounce.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_debounce.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Inizializza un debouncer.
+ *
+ * @param[out] debounce  debouncer da inizializzare;
+ * @param[in]  state     stato stabile iniziale dei pin, tipicamente una prima lettura del registro READ;
+ * @param[in]  samples   numero di campioni consecutivi discordanti necessari perché un pin cambi stato,
+ *                       compreso tra 1 e MYGPIO_DEBOUNCE_MAX_SAMPLES;
+ */
+void myGPIO_Debounce_Init(myGPIO_Debounce_t *debounce, uint32_t state, uint32_t samples) {
+	uint32_t k;
+	assert(debounce != NULL);
+	assert(samples >= 1 && samples <= MYGPIO_DEBOUNCE_MAX_SAMPLES);
+	debounce->state = state;
+	debounce->threshold = samples - 1;
+	for (debounce->bits = 1; (debounce->threshold >> debounce->bits) != 0; debounce->bits++);
+	for (k = 0; k < MYGPIO_DEBOUNCE_BITS; k++)
+		debounce->count[k] = 0;
+}
+
+/**
+ * @brief Elabora un campione.
+ *
+ * @param[inout] debounce  debouncer;
+ * @param[in]    sample    campione del registro READ;
+ *
+ * @return maschera dei pin che hanno cambiato stato stabile; il nuovo stato è in debounce->state.
+ */
+uint32_t myGPIO_Debounce_Update(myGPIO_Debounce_t *debounce, uint32_t sample) {
+	uint32_t k;
+	uint32_t delta = sample ^ debounce->state;  // pin discordanti dallo stato stabile
+	uint32_t hit = delta;                        // pin discordanti il cui contatore ha raggiunto la soglia
+	uint32_t carry = delta;
+	for (k = 0; k < debounce->bits; k++)
+		hit &= ((debounce->threshold >> k) & 1 ? debounce->count[k] : ~debounce->count[k]);
+	/* incremento dei contatori dei pin discordanti, azzeramento degli altri e di quelli che cambiano stato */
+	for (k = 0; k < debounce->bits; k++) {
+		uint32_t next = debounce->count[k] & carry;
+		debounce->count[k] = (debounce->count[k] ^ carry) & delta & ~hit;
+		carry = next;
+	}
+	debounce->state ^= hit;
+	return hit;
+}
+
+/**
+ * @brief Legge il registro READ di un device ed elabora il campione.
+ *
+ * @param[inout] debounce  debouncer;
+ * @param[in]    gpio      istanza myGPIO;
+ *
+ * @return maschera dei pin che hanno cambiato stato stabile
+ */
+uint32_t myGPIO_Debounce_Sample(myGPIO_Debounce_t *debounce, myGPIO_t gpio) {
+	assert(debounce != NULL);
+	assert(gpio != NULL);
+	return myGPIO_Debounce_Update(debounce, myGPIO_RegRead(gpio, READ_REG));
+}
@@ -0,0 +1,74 @@
+/**
+ * @file myGPIO_debounce.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_DEBOUNCE_HEADER_H
+#define MYGPIO_DEBOUNCE_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Debouncer bit-parallelo, a contatori verticali, per i 32 ingressi di un device myGPIO.
+ *
+ * @details
+ * Il debouncer viene alimentato con campioni periodici del registro READ, ad esempio dal tick di un timer,
+ * anziché attendere in busy-wait il rilascio dei pulsanti. Un pin cambia stato stabile quando il suo
+ * valore differisce dallo stato stabile per "samples" campioni consecutivi.
+ * Per ciascun pin viene mantenuto un contatore dei campioni consecutivi discordanti; i contatori sono
+ * memorizzati "in verticale": la parola count[k] contiene il bit k-esimo dei contatori di tutti i 32 pin,
+ * per cui ogni campione viene elaborato, per tutti i pin contemporaneamente, con un numero costante di
+ * operazioni bit-a-bit, proporzionale al numero di bit dei contatori.
+ *
+ * @code
+ * myGPIO_Debounce_t buttons;
+ * myGPIO_Debounce_Init(&buttons, myGPIO_GetRead(btn_gpio), 4);
+ * // ogni millisecondo
+ * uint32_t changed = myGPIO_Debounce_Sample(&buttons, btn_gpio);
+ * uint32_t pressed = changed & buttons.state;
+ * @endcode
+ */
+
+#define MYGPIO_DEBOUNCE_BITS        4U  //!< numero massimo di bit dei contatori verticali
+#define MYGPIO_DEBOUNCE_MAX_SAMPLES 16U //!< numero massimo di campioni consecutivi richiesti
+
+typedef struct {
+	uint32_t state;                        //!< stato stabile dei pin
+	uint32_t count[MYGPIO_DEBOUNCE_BITS];  //!< contatori verticali, count[k] contiene il bit k-esimo
+	uint32_t bits;                         //!< numero di bit dei contatori effettivamente usati
+	uint32_t threshold;                    //!< valore dei contatori al quale il cambiamento è accettato
+} myGPIO_Debounce_t;
+
+void     myGPIO_Debounce_Init  (myGPIO_Debounce_t *debounce, uint32_t state, uint32_t samples);
+uint32_t myGPIO_Debounce_Update(myGPIO_Debounce_t *debounce, uint32_t sample);
+uint32_t myGPIO_Debounce_Sample(myGPIO_Debounce_t *debounce, myGPIO_t gpio);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
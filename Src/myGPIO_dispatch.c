@@ -0,0 +1,134 @@
+/**
+ * @file myGPIO_dispatch.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_dispatch.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Inizializza una tabella di dispatch vuota.
+ *
+ * @param[out] dispatch  tabella da inizializzare;
+ * @param[in]  gpio      istanza myGPIO i cui interrupt vanno smistati;
+ */
+void myGPIO_Dispatch_Init(myGPIO_Dispatch_t *dispatch, myGPIO_t gpio) {
+	uint32_t i;
+	assert(dispatch != NULL);
+	assert(gpio != NULL);
+	dispatch->gpio = gpio;
+	dispatch->unhandled = 0;
+	for (i = 0; i < 32; i++) {
+		dispatch->slot[i] = MYGPIO_DISPATCH_NONE;
+		dispatch->entry[i].handler = NULL;
+		dispatch->entry[i].arg = NULL;
+		dispatch->entry[i].mask = 0;
+	}
+}
+
+/**
+ * @brief Registra un handler per un gruppo di pin.
+ *
+ * @param[inout] dispatch  tabella di dispatch;
+ * @param[in]    mask      pin gestiti dall'handler; eventuali handler precedentemente registrati per
+ *                         questi pin smettono di gestirli;
+ * @param[in]    handler   handler da chiamare;
+ * @param[in]    arg       argomento da passare all'handler;
+ *
+ * @retval 0 se la registrazione ha successo
+ * @retval -1 se la maschera è nulla
+ *
+ * @warning Non va chiamata mentre la ISR può essere in esecuzione.
+ */
+int myGPIO_Dispatch_Register(myGPIO_Dispatch_t *dispatch, uint32_t mask, myGPIO_PinHandler_t handler, void *arg) {
+	uint32_t i, pins;
+	assert(dispatch != NULL);
+	assert(handler != NULL);
+	if (mask == 0)
+		return -1;
+	myGPIO_Dispatch_Unregister(dispatch, mask);
+	/* dopo la rimozione c'è sicuramente uno slot libero: gli handler registrati sono al più 31 */
+	for (i = 0; dispatch->entry[i].mask != 0; i++);
+	dispatch->entry[i].handler = handler;
+	dispatch->entry[i].arg = arg;
+	dispatch->entry[i].mask = mask;
+	for (pins = mask; pins != 0; pins &= pins - 1)
+		dispatch->slot[myGPIO_ctz(pins)] = (uint8_t)i;
+	return 0;
+}
+
+/**
+ * @brief Rimuove gli handler dei pin selezionati dalla maschera.
+ *
+ * @param[inout] dispatch  tabella di dispatch;
+ * @param[in]    mask      pin per i quali rimuovere l'handler;
+ *
+ * @warning Non va chiamata mentre la ISR può essere in esecuzione.
+ */
+void myGPIO_Dispatch_Unregister(myGPIO_Dispatch_t *dispatch, uint32_t mask) {
+	uint32_t pins, pin;
+	assert(dispatch != NULL);
+	for (pins = mask; pins != 0; pins &= pins - 1) {
+		pin = myGPIO_ctz(pins);
+		if (dispatch->slot[pin] != MYGPIO_DISPATCH_NONE) {
+			dispatch->entry[dispatch->slot[pin]].mask &= ~MYGPIO_PIN(pin);
+			dispatch->slot[pin] = MYGPIO_DISPATCH_NONE;
+		}
+	}
+}
+
+/**
+ * @brief ISR condivisa: smista le interruzioni pendenti agli handler registrati.
+ *
+ * @param[in] dispatch  puntatore alla tabella di dispatch (myGPIO_Dispatch_t*), nella forma richiesta da
+ *                      XScuGic_Connect();
+ *
+ * @details
+ * Effettua una sola lettura del registro IRQ e, se vi sono interruzioni pendenti, due scritture sul
+ * registro IACK: la prima notifica il servizio dei pin letti, la seconda azzera IACK. Nel VHDL, infatti,
+ * IACK mantiene il valore scritto fino alla successiva scrittura su un qualsiasi registro, e finché non è
+ * nullo IRQ non accumula le interruzioni di nessun pin: senza la seconda scrittura, quelle manifestatesi
+ * dopo il ritorno della ISR andrebbero perse fino al successivo accesso in scrittura al device.
+ */
+void myGPIO_Dispatch_Isr(void *dispatch) {
+	myGPIO_Dispatch_t *d = (myGPIO_Dispatch_t*) dispatch;
+	assert(d != NULL);
+	uint32_t pending = myGPIO_RegRead(d->gpio, IRQ_REG);
+	uint32_t serviced = pending;
+	while (pending != 0) {
+		uint32_t pin = myGPIO_ctz(pending);
+		uint8_t slot = d->slot[pin];
+		if (slot == MYGPIO_DISPATCH_NONE) {
+			d->unhandled++;
+			pending &= pending - 1;
+		}
+		else {
+			myGPIO_DispatchEntry_t *e = &d->entry[slot];
+			uint32_t fired = pending & e->mask;
+			e->handler(d->gpio, fired, e->arg);
+			pending &= ~fired;
+		}
+	}
+	if (serviced != 0) {
+		myGPIO_RegWrite(d->gpio, IACK_REG, serviced);
+		myGPIO_RegWrite(d->gpio, IACK_REG, 0);
+	}
+}
@@ -0,0 +1,96 @@
+/**
+ * @file myGPIO_dispatch.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_DISPATCH_HEADER_H
+#define MYGPIO_DISPATCH_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Tabella di dispatch, per pin, degli interrupt di un device myGPIO.
+ *
+ * @details
+ * Anziché servire tutti i pin in un'unica callback, l'applicazione registra un handler per ciascun pin, o
+ * per ciascun gruppo di pin, di interesse. La ISR condivisa, myGPIO_Dispatch_Isr(), legge una sola volta
+ * il registro IRQ, scorre i bit asseriti con count-trailing-zeros e chiama, una sola volta, ciascun handler
+ * coinvolto, passandogli la maschera dei pin del proprio gruppo che hanno generato l'interruzione.
+ * Al termine viene scritta su IACK la maschera letta all'ingresso: le interruzioni manifestatesi nel
+ * frattempo restano pendenti e verranno servite alla successiva chiamata. Una seconda scrittura azzera IACK,
+ * che altrimenti resterebbe attivo fino alla successiva scrittura sul device, impedendo ad IRQ di
+ * registrare nuove interruzioni.
+ * I pin pendenti privi di handler vengono comunque notificati al device, per evitare che la linea di
+ * interruzione resti asserita, e conteggiati in myGPIO_Dispatch_t::unhandled.
+ * Il tempo di esecuzione della ISR dipende quindi dal numero di handler coinvolti, non dal numero di pin.
+ *
+ * @code
+ * myGPIO_Dispatch_t btn_dispatch;
+ * myGPIO_Dispatch_Init(&btn_dispatch, btn_gpio);
+ * myGPIO_Dispatch_Register(&btn_dispatch, MYGPIO_PIN0, on_start, NULL);
+ * myGPIO_Dispatch_Register(&btn_dispatch, MYGPIO_PIN1 | MYGPIO_PIN2, on_jog, &axis);
+ * XScuGic_Connect(&gic, XPAR_FABRIC_MYGPIO_1_INTERRUPT_INTR, (Xil_InterruptHandler)myGPIO_Dispatch_Isr, &btn_dispatch);
+ * @endcode
+ */
+
+#define MYGPIO_DISPATCH_NONE 0xFFU  //!< pin privo di handler
+
+/**
+ * @brief Handler di interruzione per un pin o gruppo di pin.
+ *
+ * @param[in] gpio  device che ha generato l'interruzione;
+ * @param[in] pins  maschera dei pin del gruppo che hanno generato l'interruzione;
+ * @param[in] arg   argomento specificato in fase di registrazione;
+ */
+typedef void (*myGPIO_PinHandler_t)(myGPIO_t gpio, uint32_t pins, void *arg);
+
+/**
+ * @brief Handler registrato, con il gruppo di pin cui si riferisce.
+ */
+typedef struct {
+	myGPIO_PinHandler_t handler;  //!< handler
+	void               *arg;      //!< argomento dell'handler
+	uint32_t            mask;     //!< pin gestiti dall'handler
+} myGPIO_DispatchEntry_t;
+
+typedef struct {
+	myGPIO_t               gpio;       //!< device i cui interrupt vengono smistati
+	uint8_t                slot[32];   //!< per ciascun pin, indice dell'handler in entry[]
+	myGPIO_DispatchEntry_t entry[32];  //!< handler registrati
+	uint32_t               unhandled;  //!< numero di interruzioni notificate da pin privi di handler
+} myGPIO_Dispatch_t;
+
+void myGPIO_Dispatch_Init      (myGPIO_Dispatch_t *dispatch, myGPIO_t gpio);
+int  myGPIO_Dispatch_Register  (myGPIO_Dispatch_t *dispatch, uint32_t mask, myGPIO_PinHandler_t handler, void *arg);
+void myGPIO_Dispatch_Unregister(myGPIO_Dispatch_t *dispatch, uint32_t mask);
+void myGPIO_Dispatch_Isr       (void *dispatch);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file myGPIO_edge.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_edge.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Inizializza un rilevatore di fronti, leggendo il valore iniziale del registro READ.
+ *
+ * @param[out] edge  rilevatore da inizializzare;
+ * @param[in]  gpio  istanza myGPIO, già inizializzata con myGPIO_Init();
+ */
+void myGPIO_Edge_Init(myGPIO_Edge_t *edge, myGPIO_t gpio) {
+	assert(edge != NULL);
+	assert(gpio != NULL);
+	edge->gpio = gpio;
+	edge->previous = myGPIO_RegRead(gpio, READ_REG);
+}
+
+/**
+ * @brief Elabora un campione del registro READ fornito dal chiamante.
+ *
+ * @param[inout] edge    rilevatore;
+ * @param[in]    sample  campione;
+ * @param[out]   mask    fronti rilevati rispetto al campione precedente;
+ */
+void myGPIO_Edge_Update(myGPIO_Edge_t *edge, uint32_t sample, myGPIO_EdgeMask_t *mask) {
+	assert(edge != NULL);
+	assert(mask != NULL);
+	mask->changed = sample ^ edge->previous;
+	mask->rising  = mask->changed & sample;
+	mask->falling = mask->changed & edge->previous;
+	edge->previous = sample;
+}
+
+/**
+ * @brief Legge il registro READ ed elabora il campione.
+ *
+ * @param[inout] edge  rilevatore;
+ * @param[out]   mask  fronti rilevati rispetto al campione precedente;
+ */
+void myGPIO_Edge_Sample(myGPIO_Edge_t *edge, myGPIO_EdgeMask_t *mask) {
+	assert(edge != NULL);
+	myGPIO_Edge_Update(edge, myGPIO_RegRead(edge->gpio, READ_REG), mask);
+}
+
+/**
+ * @brief Elabora, in una sola passata, un vettore di campioni catturati.
+ *
+ * @param[inout] edge     rilevatore; il primo campione viene confrontato con l'ultimo elaborato;
+ * @param[in]    sample   vettore di campioni;
+ * @param[in]    count    numero di campioni;
+ * @param[out]   rising   se non NULL, per ciascun campione, maschera dei fronti di salita;
+ * @param[out]   falling  se non NULL, per ciascun campione, maschera dei fronti di discesa;
+ *
+ * @return OR delle maschere dei pin che hanno cambiato valore in almeno un campione
+ */
+uint32_t myGPIO_Edge_Batch(myGPIO_Edge_t *edge, const uint32_t *sample, uint32_t count, uint32_t *rising, uint32_t *falling) {
+	uint32_t i, previous, any = 0;
+	assert(edge != NULL);
+	assert(sample != NULL || count == 0);
+	previous = edge->previous;
+	for (i = 0; i < count; i++) {
+		uint32_t changed = sample[i] ^ previous;
+		if (rising != NULL)
+			rising[i] = changed & sample[i];
+		if (falling != NULL)
+			falling[i] = changed & previous;
+		any |= changed;
+		previous = sample[i];
+	}
+	edge->previous = previous;
+	return any;
+}
+
+/**
+ * @brief Inizializza un iteratore sugli eventi di un campione.
+ *
+ * @param[out] iter       iteratore;
+ * @param[in]  mask       fronti rilevati sul campione;
+ * @param[in]  timestamp  timestamp da associare agli eventi;
+ */
+void myGPIO_EdgeIter_Init(myGPIO_EdgeIter_t *iter, const myGPIO_EdgeMask_t *mask, uint32_t timestamp) {
+	assert(iter != NULL);
+	assert(mask != NULL);
+	iter->rising = mask->rising;
+	iter->pending = mask->rising | mask->falling;
+	iter->timestamp = timestamp;
+}
+
+/**
+ * @brief Restituisce il prossimo evento, in ordine crescente di indice del pin.
+ *
+ * @param[inout] iter   iteratore;
+ * @param[out]   event  evento;
+ *
+ * @retval 1 se è stato restituito un evento
+ * @retval 0 se gli eventi del campione sono esauriti
+ */
+int myGPIO_EdgeIter_Next(myGPIO_EdgeIter_t *iter, myGPIO_EdgeEvent_t *event) {
+	assert(iter != NULL);
+	assert(event != NULL);
+	if (iter->pending == 0)
+		return 0;
+	event->pin = myGPIO_ctz(iter->pending);
+	event->edge = ((iter->rising & MYGPIO_PIN(event->pin)) != 0 ? MYGPIO_EDGE_RISING : MYGPIO_EDGE_FALLING);
+	event->timestamp = iter->timestamp;
+	iter->pending &= iter->pending - 1;
+	return 1;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file myGPIO_edge.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_EDGE_HEADER_H
+#define MYGPIO_EDGE_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Rilevazione dei fronti sui pin di un device myGPIO.
+ *
+ * @details
+ * Un oggetto myGPIO_Edge_t mantiene l'ultimo valore del registro READ e, per ciascun nuovo campione,
+ * restituisce le maschere dei pin che hanno avuto un fronte di salita, di discesa o un cambiamento
+ * qualsiasi. Il campione può essere letto dal device (myGPIO_Edge_Sample()), oppure fornito dal chiamante
+ * (myGPIO_Edge_Update()), ad esempio il valore di READ catturato da una ISR: il funzionamento è lo stesso
+ * sia per chi effettua polling sia per chi è guidato dalle interruzioni.
+ * Un iteratore, myGPIO_EdgeIter_t, trasforma le maschere in una sequenza di eventi (pin, fronte,
+ * timestamp), scorrendo i soli bit asseriti con count-trailing-zeros.
+ * myGPIO_Edge_Batch() elabora in una sola passata un vettore di campioni catturati, con sole operazioni
+ * sulla parola intera.
+ *
+ * @code
+ * myGPIO_Edge_t edge;
+ * myGPIO_EdgeMask_t mask;
+ * myGPIO_EdgeIter_t it;
+ * myGPIO_EdgeEvent_t ev;
+ * myGPIO_Edge_Init(&edge, btn_gpio);
+ * myGPIO_Edge_Sample(&edge, &mask);
+ * myGPIO_EdgeIter_Init(&it, &mask, now());
+ * while (myGPIO_EdgeIter_Next(&it, &ev))
+ *   printf("pin %u: %s\n", ev.pin, ev.edge == MYGPIO_EDGE_RISING ? "salita" : "discesa");
+ * @endcode
+ */
+
+#define MYGPIO_EDGE_RISING  1U  //!< fronte di salita
+#define MYGPIO_EDGE_FALLING 2U  //!< fronte di discesa
+
+typedef struct {
+	myGPIO_t gpio;      //!< device campionato
+	uint32_t previous;  //!< ultimo campione del registro READ
+} myGPIO_Edge_t;
+
+/**
+ * @brief Fronti rilevati su un campione.
+ */
+typedef struct {
+	uint32_t rising;   //!< pin con fronte di salita
+	uint32_t falling;  //!< pin con fronte di discesa
+	uint32_t changed;  //!< pin che hanno cambiato valore (rising | falling)
+} myGPIO_EdgeMask_t;
+
+/**
+ * @brief Evento relativo ad un singolo pin.
+ */
+typedef struct {
+	uint32_t pin;        //!< indice del pin
+	uint32_t edge;       //!< MYGPIO_EDGE_RISING oppure MYGPIO_EDGE_FALLING
+	uint32_t timestamp;  //!< timestamp del campione
+} myGPIO_EdgeEvent_t;
+
+/**
+ * @brief Iteratore sugli eventi di un campione.
+ */
+typedef struct {
+	uint32_t rising;     //!< fronti di salita non ancora restituiti
+	uint32_t pending;    //!< pin non ancora restituiti
+	uint32_t timestamp;  //!< timestamp del campione
+} myGPIO_EdgeIter_t;
+
+void     myGPIO_Edge_Init    (myGPIO_Edge_t *edge, myGPIO_t gpio);
+void     myGPIO_Edge_Update  (myGPIO_Edge_t *edge, uint32_t sample, myGPIO_EdgeMask_t *mask);
+void     myGPIO_Edge_Sample  (myGPIO_Edge_t *edge, myGPIO_EdgeMask_t *mask);
+uint32_t myGPIO_Edge_Batch   (myGPIO_Edge_t *edge, const uint32_t *sample, uint32_t count, uint32_t *rising, uint32_t *falling);
+void     myGPIO_EdgeIter_Init(myGPIO_EdgeIter_t *iter, const myGPIO_EdgeMask_t *mask, uint32_t timestamp);
+int      myGPIO_EdgeIter_Next(myGPIO_EdgeIter_t *iter, myGPIO_EdgeEvent_t *event);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * @file myGPIO_group.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_group.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Inizializza un gruppo di device myGPIO.
+ *
+ * @param[out] group  gruppo da inizializzare;
+ * @param[in]  gpio   vettore di istanze myGPIO, già inizializzate con myGPIO_Init(); l'istanza i-esima
+ *                    corrisponde ai bit da 32*i a 32*i+31 del bus;
+ * @param[in]  count  numero di istanze, al più MYGPIO_GROUP_MAX_DEVICES;
+ */
+void myGPIO_Group_Init(myGPIO_Group_t *group, const myGPIO_t *gpio, uint32_t count) {
+	uint32_t i;
+	assert(group != NULL);
+	assert(gpio != NULL);
+	assert(count > 0 && count <= MYGPIO_GROUP_MAX_DEVICES);
+	group->count = count;
+	for (i = 0; i < count; i++)
+		myGPIO_Shadow_Init(&group->dev[i], gpio[i]);
+}
+
+/**
+ * @brief Ricarica le copie shadow di tutti i device del gruppo.
+ *
+ * @param[inout] group  gruppo di device;
+ */
+void myGPIO_Group_Resync(myGPIO_Group_t *group) {
+	uint32_t i;
+	assert(group != NULL);
+	for (i = 0; i < group->count; i++)
+		myGPIO_Shadow_Resync(&group->dev[i]);
+}
+
+/**
+ * @brief Imposta la modalità di funzionamento dei pin del bus.
+ *
+ * @param[inout] group  gruppo di device;
+ * @param[in]    mask   maschera dei pin su cui agire, una parola per device;
+ * @param[in]    mode   modalità di funzionamento dei pin;
+ */
+void myGPIO_Group_SetMode(myGPIO_Group_t *group, const uint32_t *mask, uint32_t mode) {
+	uint32_t i, dirty = 0;
+	assert(group != NULL);
+	assert(mask != NULL);
+	for (i = 0; i < group->count; i++)
+		if (mask[i] != 0) {
+			group->dev[i].mode = (MYGPIO_MODE_WRITE == mode ? group->dev[i].mode | mask[i] : group->dev[i].mode & ~mask[i]);
+			dirty |= 1U << i;
+		}
+	for (i = 0; i < group->count; i++)
+		if ((dirty & (1U << i)) != 0)
+			myGPIO_RegWrite(group->dev[i].gpio, MODE_REG, group->dev[i].mode);
+}
+
+/**
+ * @brief Porta tutti i pin selezionati dalla maschera al valore value.
+ *
+ * @param[inout] group  gruppo di device;
+ * @param[in]    mask   maschera dei pin su cui agire, una parola per device;
+ * @param[in]    value  valore dei pin;
+ */
+void myGPIO_Group_SetValue(myGPIO_Group_t *group, const uint32_t *mask, uint32_t value) {
+	uint32_t i, dirty = 0;
+	assert(group != NULL);
+	assert(mask != NULL);
+	for (i = 0; i < group->count; i++)
+		if (mask[i] != 0) {
+			group->dev[i].write = (MYGPIO_PIN_SET == value ? group->dev[i].write | mask[i] : group->dev[i].write & ~mask[i]);
+			dirty |= 1U << i;
+		}
+	for (i = 0; i < group->count; i++)
+		if ((dirty & (1U << i)) != 0)
+			myGPIO_RegWrite(group->dev[i].gpio, WRITE_REG, group->dev[i].write);
+}
+
+/**
+ * @brief Scrive un valore sul bus: ciascun pin selezionato dalla maschera assume il valore del bit
+ * corrispondente di value.
+ *
+ * @param[inout] group  gruppo di device;
+ * @param[in]    mask   maschera dei pin su cui agire, una parola per device;
+ * @param[in]    value  valore dei pin, una parola per device;
+ */
+void myGPIO_Group_Write(myGPIO_Group_t *group, const uint32_t *mask, const uint32_t *value) {
+	uint32_t i, dirty = 0;
+	assert(group != NULL);
+	assert(mask != NULL);
+	assert(value != NULL);
+	for (i = 0; i < group->count; i++)
+		if (mask[i] != 0) {
+			group->dev[i].write = (group->dev[i].write & ~mask[i]) | (value[i] & mask[i]);
+			dirty |= 1U << i;
+		}
+	for (i = 0; i < group->count; i++)
+		if ((dirty & (1U << i)) != 0)
+			myGPIO_RegWrite(group->dev[i].gpio, WRITE_REG, group->dev[i].write);
+}
+
+/**
+ * @brief Inverte il valore dei pin del bus selezionati dalla maschera.
+ *
+ * @param[inout] group  gruppo di device;
+ * @param[in]    mask   maschera dei pin su cui agire, una parola per device;
+ */
+void myGPIO_Group_Toggle(myGPIO_Group_t *group, const uint32_t *mask) {
+	uint32_t i, dirty = 0;
+	assert(group != NULL);
+	assert(mask != NULL);
+	for (i = 0; i < group->count; i++)
+		if (mask[i] != 0) {
+			group->dev[i].write ^= mask[i];
+			dirty |= 1U << i;
+		}
+	for (i = 0; i < group->count; i++)
+		if ((dirty & (1U << i)) != 0)
+			myGPIO_RegWrite(group->dev[i].gpio, WRITE_REG, group->dev[i].write);
+}
+
+/**
+ * @brief Legge il registro READ di tutti i device del gruppo, uno di seguito all'altro.
+ *
+ * @param[in]  group  gruppo di device;
+ * @param[out] value  valore letto, una parola per device;
+ */
+void myGPIO_Group_Read(myGPIO_Group_t *group, uint32_t *value) {
+	uint32_t i;
+	assert(group != NULL);
+	assert(value != NULL);
+	for (i = 0; i < group->count; i++)
+		value[i] = myGPIO_RegRead(group->dev[i].gpio, READ_REG);
+}
+
+/**
+ * @brief Equivalente a myGPIO_Group_Write(), per un bus di al più 64 bit.
+ *
+ * @param[inout] group  gruppo di device, composto da almeno due device;
+ * @param[in]    mask   maschera dei pin su cui agire;
+ * @param[in]    value  valore dei pin;
+ */
+void myGPIO_Group_Write64(myGPIO_Group_t *group, uint64_t mask, uint64_t value) {
+	uint32_t m[MYGPIO_GROUP_MAX_DEVICES] = {(uint32_t)mask, (uint32_t)(mask >> 32), 0, 0};
+	uint32_t v[MYGPIO_GROUP_MAX_DEVICES] = {(uint32_t)value, (uint32_t)(value >> 32), 0, 0};
+	assert(group != NULL);
+	assert(group->count >= 2);
+	myGPIO_Group_Write(group, m, v);
+}
+
+/**
+ * @brief Equivalente a myGPIO_Group_Read(), per un bus di al più 64 bit.
+ *
+ * @param[in] group  gruppo di device, composto da almeno due device;
+ *
+ * @return valore letto dai primi due device del gruppo
+ */
+uint64_t myGPIO_Group_Read64(myGPIO_Group_t *group) {
+	assert(group != NULL);
+	assert(group->count >= 2);
+	uint32_t low  = myGPIO_RegRead(group->dev[0].gpio, READ_REG);
+	uint32_t high = myGPIO_RegRead(group->dev[1].gpio, READ_REG);
+	return ((uint64_t)high << 32) | low;
+}
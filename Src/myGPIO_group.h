@@ -0,0 +1,83 @@
+/**
+ * @file myGPIO_group.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_GROUP_HEADER_H
+#define MYGPIO_GROUP_HEADER_H
+
+#include "myGPIO.h"
+#include "myGPIO_shadow.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Porta virtuale ottenuta affiancando più device myGPIO.
+ *
+ * @details
+ * Un oggetto myGPIO_Group_t raggruppa fino a MYGPIO_GROUP_MAX_DEVICES device myGPIO, ciascuno dei quali
+ * contribuisce con 32 bit ad un bus più ampio: il device i-esimo corrisponde alla parola i-esima delle
+ * maschere e dei valori passati alle funzioni del gruppo (la parola 0 contiene i bit meno significativi).
+ * Le funzioni myGPIO_Group_Write64() e myGPIO_Group_Read64() operano sui primi due device, con un valore
+ * a 64 bit.
+ *
+ * Il gruppo mantiene un handle myGPIO_Shadow_t per ciascun device, per cui l'aggiornamento del bus non
+ * richiede letture. I nuovi valori dei registri vengono calcolati prima di accedere ai device, e le
+ * scritture vengono poi effettuate una di seguito all'altra, in modo da ridurre lo sfasamento tra le
+ * uscite dei diversi device; i device la cui porzione di maschera è nulla non vengono acceduti.
+ *
+ * @code
+ * myGPIO_t bus_gpio[3] = {gpio0, gpio1, gpio2};
+ * myGPIO_Group_t bus;
+ * uint32_t mask[3]  = {0xFFFFFFFF, 0, 0x000000FF};
+ * uint32_t value[3] = {0x12345678, 0, 0x000000AB};
+ * myGPIO_Group_Init(&bus, bus_gpio, 3);
+ * myGPIO_Group_SetMode(&bus, mask, MYGPIO_MODE_WRITE);
+ * myGPIO_Group_Write(&bus, mask, value); // due store, il device 1 non viene acceduto
+ * @endcode
+ */
+
+#define MYGPIO_GROUP_MAX_DEVICES 4  //!< numero massimo di device in un gruppo (bus a 128 bit)
+
+typedef struct {
+	myGPIO_Shadow_t dev[MYGPIO_GROUP_MAX_DEVICES];  //!< handle shadow dei device del gruppo
+	uint32_t        count;                          //!< numero di device del gruppo
+} myGPIO_Group_t;
+
+void     myGPIO_Group_Init     (myGPIO_Group_t *group, const myGPIO_t *gpio, uint32_t count);
+void     myGPIO_Group_Resync   (myGPIO_Group_t *group);
+void     myGPIO_Group_SetMode  (myGPIO_Group_t *group, const uint32_t *mask, uint32_t mode);
+void     myGPIO_Group_SetValue (myGPIO_Group_t *group, const uint32_t *mask, uint32_t value);
+void     myGPIO_Group_Write    (myGPIO_Group_t *group, const uint32_t *mask, const uint32_t *value);
+void     myGPIO_Group_Toggle   (myGPIO_Group_t *group, const uint32_t *mask);
+void     myGPIO_Group_Read     (myGPIO_Group_t *group, uint32_t *value);
+void     myGPIO_Group_Write64  (myGPIO_Group_t *group, uint64_t mask, uint64_t value);
+uint64_t myGPIO_Group_Read64   (myGPIO_Group_t *group);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
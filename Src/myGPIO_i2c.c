@@ -0,0 +1,284 @@
+/**
+ * @file myGPIO_i2c.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_i2c.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Attende mezzo periodo di SCL.
+ */
+static void myGPIO_I2c_Delay(const myGPIO_I2c_t *bus) {
+	myGPIO_Spin(bus->half_period);
+}
+
+/**
+ * @brief Forza basse le linee specificate: una scrittura sul registro MODE.
+ */
+static void myGPIO_I2c_Low(myGPIO_I2c_t *bus, uint32_t lines) {
+	myGPIO_Shadow_SetMode(bus->port, lines, MYGPIO_MODE_WRITE);
+}
+
+/**
+ * @brief Rilascia le linee specificate: una scrittura sul registro MODE.
+ */
+static void myGPIO_I2c_Release(myGPIO_I2c_t *bus, uint32_t lines) {
+	myGPIO_Shadow_SetMode(bus->port, lines, MYGPIO_MODE_READ);
+}
+
+/**
+ * @brief Rilascia SCL ed attende che la linea sia effettivamente alta (clock stretching).
+ *
+ * @return valore del registro READ letto con SCL alta, oppure 0 se scade il timeout; poiché in tal caso
+ * il bit di SCL è nullo, il chiamante distingue i due casi verificando quel bit.
+ */
+static uint32_t myGPIO_I2c_SclHigh(myGPIO_I2c_t *bus) {
+	uint32_t polls, read;
+	myGPIO_I2c_Release(bus, bus->scl);
+	for (polls = 0; polls < bus->timeout; polls++) {
+		read = myGPIO_RegRead(bus->port->gpio, READ_REG);
+		if ((read & bus->scl) != 0)
+			return read;
+	}
+	return 0;
+}
+
+/**
+ * @brief Trasmette un bit: SDA viene impostata con SCL bassa, e mantenuta per tutto il semiperiodo alto.
+ */
+static int myGPIO_I2c_WriteBit(myGPIO_I2c_t *bus, uint32_t bit) {
+	if (bit)
+		myGPIO_I2c_Release(bus, bus->sda);
+	else
+		myGPIO_I2c_Low(bus, bus->sda);
+	myGPIO_I2c_Delay(bus);
+	if ((myGPIO_I2c_SclHigh(bus) & bus->scl) == 0)
+		return MYGPIO_I2C_TIMEOUT;
+	myGPIO_I2c_Delay(bus);
+	myGPIO_I2c_Low(bus, bus->scl);
+	return MYGPIO_I2C_OK;
+}
+
+/**
+ * @brief Riceve un bit, campionando SDA al termine del semiperiodo alto di SCL.
+ *
+ * @return 0 o 1, oppure MYGPIO_I2C_TIMEOUT
+ */
+static int myGPIO_I2c_ReadBit(myGPIO_I2c_t *bus) {
+	uint32_t bit;
+	myGPIO_I2c_Release(bus, bus->sda);
+	myGPIO_I2c_Delay(bus);
+	if ((myGPIO_I2c_SclHigh(bus) & bus->scl) == 0)
+		return MYGPIO_I2C_TIMEOUT;
+	myGPIO_I2c_Delay(bus);
+	bit = ((myGPIO_RegRead(bus->port->gpio, READ_REG) & bus->sda) != 0);
+	myGPIO_I2c_Low(bus, bus->scl);
+	return (int)bit;
+}
+
+/**
+ * @brief Inizializza un bus I2C.
+ *
+ * @param[out]   bus          bus da inizializzare;
+ * @param[inout] port         handle shadow del device, già inizializzato con myGPIO_Shadow_Init(); può
+ *                            essere condiviso tra più bus;
+ * @param[in]    sda_pin      pin della linea SDA;
+ * @param[in]    scl_pin      pin della linea SCL;
+ * @param[in]    half_period  durata di mezzo periodo di SCL, in iterazioni di un ciclo di ritardo;
+ * @param[in]    timeout      numero massimo di letture di READ in attesa del rilascio di SCL, almeno una;
+ *
+ * @details
+ * Il valore dei pin nel registro WRITE viene azzerato e le linee vengono rilasciate: due scritture.
+ */
+void myGPIO_I2c_Init(myGPIO_I2c_t *bus, myGPIO_Shadow_t *port, uint32_t sda_pin, uint32_t scl_pin, uint32_t half_period, uint32_t timeout) {
+	assert(bus != NULL);
+	assert(port != NULL);
+	assert(sda_pin < 32 && scl_pin < 32 && sda_pin != scl_pin);
+	assert(timeout != 0);
+	bus->port = port;
+	bus->sda = MYGPIO_PIN(sda_pin);
+	bus->scl = MYGPIO_PIN(scl_pin);
+	bus->half_period = half_period;
+	bus->timeout = timeout;
+	myGPIO_Shadow_SetValue(port, bus->sda | bus->scl, MYGPIO_PIN_RESET);
+	myGPIO_I2c_Release(bus, bus->sda | bus->scl);
+}
+
+/**
+ * @brief Genera una condizione di start, oppure di start ripetuto se il bus è già impegnato.
+ *
+ * @param[inout] bus  bus I2C;
+ *
+ * @retval MYGPIO_I2C_OK
+ * @retval MYGPIO_I2C_TIMEOUT
+ */
+int myGPIO_I2c_Start(myGPIO_I2c_t *bus) {
+	assert(bus != NULL);
+	if ((bus->port->mode & bus->scl) != 0) {
+		myGPIO_I2c_Release(bus, bus->sda);
+		myGPIO_I2c_Delay(bus);
+		if ((myGPIO_I2c_SclHigh(bus) & bus->scl) == 0)
+			return MYGPIO_I2C_TIMEOUT;
+		myGPIO_I2c_Delay(bus);
+	}
+	myGPIO_I2c_Low(bus, bus->sda);
+	myGPIO_I2c_Delay(bus);
+	myGPIO_I2c_Low(bus, bus->scl);
+	return MYGPIO_I2C_OK;
+}
+
+/**
+ * @brief Genera una condizione di stop, lasciando il bus libero.
+ *
+ * @param[inout] bus  bus I2C;
+ *
+ * @retval MYGPIO_I2C_OK
+ * @retval MYGPIO_I2C_TIMEOUT, nel qual caso entrambe le linee vengono comunque rilasciate
+ */
+int myGPIO_I2c_Stop(myGPIO_I2c_t *bus) {
+	int status = MYGPIO_I2C_OK;
+	assert(bus != NULL);
+	myGPIO_I2c_Low(bus, bus->sda);
+	myGPIO_I2c_Delay(bus);
+	if ((myGPIO_I2c_SclHigh(bus) & bus->scl) == 0)
+		status = MYGPIO_I2C_TIMEOUT;
+	myGPIO_I2c_Delay(bus);
+	myGPIO_I2c_Release(bus, bus->sda);
+	myGPIO_I2c_Delay(bus);
+	return status;
+}
+
+/**
+ * @brief Trasmette un byte, MSB per primo, e riceve il bit di acknowledge.
+ *
+ * @param[inout] bus   bus I2C;
+ * @param[in]    byte  byte da trasmettere;
+ *
+ * @retval MYGPIO_I2C_OK se lo slave ha confermato il byte
+ * @retval MYGPIO_I2C_NACK
+ * @retval MYGPIO_I2C_TIMEOUT
+ */
+int myGPIO_I2c_WriteByte(myGPIO_I2c_t *bus, uint8_t byte) {
+	uint32_t i;
+	int ack;
+	assert(bus != NULL);
+	for (i = 0; i < 8; i++, byte <<= 1)
+		if (myGPIO_I2c_WriteBit(bus, byte & 0x80) != MYGPIO_I2C_OK)
+			return MYGPIO_I2C_TIMEOUT;
+	if ((ack = myGPIO_I2c_ReadBit(bus)) == MYGPIO_I2C_TIMEOUT)
+		return MYGPIO_I2C_TIMEOUT;
+	return (ack == 0 ? MYGPIO_I2C_OK : MYGPIO_I2C_NACK);
+}
+
+/**
+ * @brief Riceve un byte, MSB per primo, e trasmette il bit di acknowledge.
+ *
+ * @param[inout] bus   bus I2C;
+ * @param[out]   byte  byte ricevuto;
+ * @param[in]    ack   diverso da zero per confermare il byte, zero per l'ultimo byte di una lettura;
+ *
+ * @retval MYGPIO_I2C_OK
+ * @retval MYGPIO_I2C_TIMEOUT
+ */
+int myGPIO_I2c_ReadByte(myGPIO_I2c_t *bus, uint8_t *byte, int ack) {
+	uint32_t i, value = 0;
+	int bit;
+	assert(bus != NULL);
+	assert(byte != NULL);
+	for (i = 0; i < 8; i++) {
+		if ((bit = myGPIO_I2c_ReadBit(bus)) == MYGPIO_I2C_TIMEOUT)
+			return MYGPIO_I2C_TIMEOUT;
+		value = (value << 1) | (uint32_t)bit;
+	}
+	*byte = (uint8_t)value;
+	return myGPIO_I2c_WriteBit(bus, !ack);
+}
+
+/**
+ * @brief Fase di indirizzamento e trasferimento dei byte, senza condizione di stop.
+ */
+static int myGPIO_I2c_Transfer(myGPIO_I2c_t *bus, uint8_t address, const uint8_t *tx, uint8_t *rx, uint32_t length) {
+	uint32_t i;
+	int status;
+	if ((status = myGPIO_I2c_Start(bus)) != MYGPIO_I2C_OK)
+		return status;
+	if ((status = myGPIO_I2c_WriteByte(bus, (uint8_t)((address << 1) | (rx != NULL)))) != MYGPIO_I2C_OK)
+		return status;
+	for (i = 0; i < length && status == MYGPIO_I2C_OK; i++)
+		status = (rx != NULL ? myGPIO_I2c_ReadByte(bus, &rx[i], i + 1 < length) : myGPIO_I2c_WriteByte(bus, tx[i]));
+	return status;
+}
+
+/**
+ * @brief Scrive length byte sullo slave con indirizzo (a 7 bit) address.
+ *
+ * @return MYGPIO_I2C_OK, MYGPIO_I2C_NACK oppure MYGPIO_I2C_TIMEOUT; in ogni caso il trasferimento
+ * termina con una condizione di stop.
+ */
+int myGPIO_I2c_Write(myGPIO_I2c_t *bus, uint8_t address, const uint8_t *data, uint32_t length) {
+	int status;
+	assert(bus != NULL);
+	assert(address < 0x80);
+	assert(data != NULL || length == 0);
+	status = myGPIO_I2c_Transfer(bus, address, data, NULL, length);
+	if (myGPIO_I2c_Stop(bus) != MYGPIO_I2C_OK)
+		status = MYGPIO_I2C_TIMEOUT;
+	return status;
+}
+
+/**
+ * @brief Legge length byte dallo slave con indirizzo (a 7 bit) address.
+ *
+ * @return MYGPIO_I2C_OK, MYGPIO_I2C_NACK oppure MYGPIO_I2C_TIMEOUT; in ogni caso il trasferimento
+ * termina con una condizione di stop.
+ */
+int myGPIO_I2c_Read(myGPIO_I2c_t *bus, uint8_t address, uint8_t *data, uint32_t length) {
+	int status;
+	assert(bus != NULL);
+	assert(address < 0x80);
+	assert(data != NULL);
+	status = myGPIO_I2c_Transfer(bus, address, NULL, data, length);
+	if (myGPIO_I2c_Stop(bus) != MYGPIO_I2C_OK)
+		status = MYGPIO_I2C_TIMEOUT;
+	return status;
+}
+
+/**
+ * @brief Scrive tx_length byte e, dopo uno start ripetuto, legge rx_length byte dallo stesso slave,
+ * come avviene tipicamente per la lettura di un registro.
+ *
+ * @return MYGPIO_I2C_OK, MYGPIO_I2C_NACK oppure MYGPIO_I2C_TIMEOUT; in ogni caso il trasferimento
+ * termina con una condizione di stop.
+ */
+int myGPIO_I2c_WriteRead(myGPIO_I2c_t *bus, uint8_t address, const uint8_t *tx, uint32_t tx_length, uint8_t *rx, uint32_t rx_length) {
+	int status;
+	assert(bus != NULL);
+	assert(address < 0x80);
+	assert(tx != NULL || tx_length == 0);
+	assert(rx != NULL);
+	status = myGPIO_I2c_Transfer(bus, address, tx, NULL, tx_length);
+	if (status == MYGPIO_I2C_OK)
+		status = myGPIO_I2c_Transfer(bus, address, NULL, rx, rx_length);
+	if (myGPIO_I2c_Stop(bus) != MYGPIO_I2C_OK)
+		status = MYGPIO_I2C_TIMEOUT;
+	return status;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file myGPIO_i2c.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_I2C_HEADER_H
+#define MYGPIO_I2C_HEADER_H
+
+#include "myGPIO.h"
+#include "myGPIO_shadow.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Master I2C bit-bang open-drain, basato sul registro MODE.
+ *
+ * @details
+ * Un pin myGPIO in modalità lettura è in alta impedenza ('Z'), per cui una linea open-drain può essere
+ * emulata lasciando a zero il bit corrispondente del registro WRITE e agendo soltanto sul registro MODE:
+ * in modalità scrittura il pin forza la linea bassa, in modalità lettura la rilascia, ed il pull-up
+ * esterno la porta alta. Il registro WRITE viene azzerato una sola volta, da myGPIO_I2c_Init(); ogni
+ * transizione di SDA o SCL costa poi una sola scrittura sul registro MODE, effettuata attraverso la copia
+ * shadow di un myGPIO_Shadow_t, invece delle due sequenze read-modify-write che richiederebbero
+ * myGPIO_SetMode() e myGPIO_SetValue().
+ *
+ * Dopo aver rilasciato SCL, il master legge il registro READ finché la linea non risulta effettivamente
+ * alta, supportando così il clock stretching da parte degli slave; l'attesa è limitata a timeout letture.
+ *
+ * Più bus indipendenti possono coesistere sullo stesso device, ciascuno con la propria coppia di pin,
+ * condividendo lo stesso myGPIO_Shadow_t: i bus non devono però essere usati da contesti che possano
+ * interrompersi a vicenda, né il device deve essere modificato per altra via, pena la perdita di coerenza
+ * della copia shadow del registro MODE.
+ *
+ * @code
+ * myGPIO_Shadow_t port;
+ * myGPIO_I2c_t sensors, eeprom;
+ * uint8_t reg = 0x0F, id;
+ * myGPIO_Shadow_Init(&port, gpio);
+ * myGPIO_I2c_Init(&sensors, &port, 0, 1, 100, 10000);
+ * myGPIO_I2c_Init(&eeprom, &port, 2, 3, 100, 10000);
+ * if (myGPIO_I2c_WriteRead(&sensors, 0x6B, &reg, 1, &id, 1) != MYGPIO_I2C_OK)
+ *   ...
+ * @endcode
+ */
+
+#define MYGPIO_I2C_OK        0   //!< trasferimento completato
+#define MYGPIO_I2C_NACK     -1   //!< lo slave non ha confermato un byte
+#define MYGPIO_I2C_TIMEOUT  -2   //!< SCL non è stata rilasciata entro il timeout
+
+typedef struct {
+	myGPIO_Shadow_t *port;         //!< handle shadow del device, condiviso tra i bus
+	uint32_t         sda;          //!< maschera del pin SDA
+	uint32_t         scl;          //!< maschera del pin SCL
+	uint32_t         half_period;  //!< durata di mezzo periodo di SCL, in iterazioni di un ciclo di ritardo
+	uint32_t         timeout;      //!< numero massimo di letture di READ in attesa del rilascio di SCL
+} myGPIO_I2c_t;
+
+void myGPIO_I2c_Init     (myGPIO_I2c_t *bus, myGPIO_Shadow_t *port, uint32_t sda_pin, uint32_t scl_pin, uint32_t half_period, uint32_t timeout);
+int  myGPIO_I2c_Start    (myGPIO_I2c_t *bus);
+int  myGPIO_I2c_Stop     (myGPIO_I2c_t *bus);
+int  myGPIO_I2c_WriteByte(myGPIO_I2c_t *bus, uint8_t byte);
+int  myGPIO_I2c_ReadByte (myGPIO_I2c_t *bus, uint8_t *byte, int ack);
+int  myGPIO_I2c_Write    (myGPIO_I2c_t *bus, uint8_t address, const uint8_t *data, uint32_t length);
+int  myGPIO_I2c_Read     (myGPIO_I2c_t *bus, uint8_t address, uint8_t *data, uint32_t length);
+int  myGPIO_I2c_WriteRead(myGPIO_I2c_t *bus, uint8_t address, const uint8_t *tx, uint32_t tx_length, uint8_t *rx, uint32_t rx_length);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ * @file myGPIO_inline.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_INLINE_HEADER_H
+#define MYGPIO_INLINE_HEADER_H
+
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Variante header-only, "static inline", del driver myGPIO.
+ *
+ * @details
+ * Le funzioni definite in myGPIO.c sono compilate out-of-line: ogni chiamata costa un salto a sottoprogramma,
+ * una assert() sul puntatore al device ed il confronto sul parametro mode/value, anche quando la maschera
+ * ed il valore sono costanti note in compilazione.
+ *
+ * Questo header definisce:
+ * - sempre, un insieme di entry-point specializzati per modalità e valore, come myGPIO_SetPins() o
+ *   myGPIO_ClearPins(), che non richiedono alcun confronto a run-time; con maschera costante ciascuno di
+ *   essi si riduce ad una coppia load/store, mentre myGPIO_WritePins() e myGPIO_WriteMode() si riducono
+ *   ad una singola store;
+ * - se MYGPIO_INLINE è definito in compilazione, l'intera API di myGPIO.h, con le stesse firme, come
+ *   funzioni "static inline". In tal caso non occorre compilare e collegare myGPIO.c.
+ *
+ * Definendo MYGPIO_NO_ASSERT le verifiche sul puntatore al device vengono rimosse, qui come in myGPIO.c,
+ * indipendentemente da NDEBUG, che continua a governare le assert() del resto dell'applicazione.
+ *
+ * @code
+ * // gcc -DMYGPIO_INLINE -DMYGPIO_NO_ASSERT ...
+ * #include "myGPIO.h"
+ * myGPIO_SetValue(led_gpio, MYGPIO_PIN0 | MYGPIO_PIN1, MYGPIO_PIN_SET); // equivale a myGPIO_SetPins()
+ * @endcode
+ */
+
+/**
+ * @brief Configura come output i pin selezionati dalla maschera.
+ */
+static inline void myGPIO_SetOutput(myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, MODE_REG, myGPIO_RegRead(gpio, MODE_REG) | mask);
+}
+
+/**
+ * @brief Configura come input i pin selezionati dalla maschera.
+ */
+static inline void myGPIO_SetInput(myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, MODE_REG, myGPIO_RegRead(gpio, MODE_REG) & ~mask);
+}
+
+/**
+ * @brief Scrive l'intero registro MODE con una sola store.
+ */
+static inline void myGPIO_WriteMode(myGPIO_t gpio, uint32_t mode) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, MODE_REG, mode);
+}
+
+/**
+ * @brief Porta a livello alto i pin selezionati dalla maschera.
+ */
+static inline void myGPIO_SetPins(myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, WRITE_REG, myGPIO_RegRead(gpio, WRITE_REG) | mask);
+}
+
+/**
+ * @brief Porta a livello basso i pin selezionati dalla maschera.
+ */
+static inline void myGPIO_ClearPins(myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, WRITE_REG, myGPIO_RegRead(gpio, WRITE_REG) & ~mask);
+}
+
+/**
+ * @brief Scrive l'intero registro WRITE con una sola store.
+ */
+static inline void myGPIO_WritePins(myGPIO_t gpio, uint32_t value) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, WRITE_REG, value);
+}
+
+#ifdef MYGPIO_INLINE
+
+/**
+ * @brief Vedi myGPIO_Init() in myGPIO.c
+ */
+static inline void myGPIO_Init(myGPIO_t *gpio, uint32_t base_address) {
+	myGPIO_Assert(base_address != 0);
+	*gpio = (myGPIO_t)(uintptr_t)base_address;
+}
+
+/**
+ * @brief Vedi myGPIO_SetMode() in myGPIO.c
+ */
+static inline void myGPIO_SetMode(myGPIO_t gpio, uint32_t mask, uint32_t mode) {
+	if (MYGPIO_MODE_WRITE == mode)
+		myGPIO_SetOutput(gpio, mask);
+	else
+		myGPIO_SetInput(gpio, mask);
+}
+
+/**
+ * @brief Vedi myGPIO_SetValue() in myGPIO.c
+ */
+static inline void myGPIO_SetValue(myGPIO_t gpio, uint32_t mask, uint32_t value) {
+	if (MYGPIO_PIN_SET == value)
+		myGPIO_SetPins(gpio, mask);
+	else
+		myGPIO_ClearPins(gpio, mask);
+}
+
+/**
+ * @brief Vedi myGPIO_Toggle() in myGPIO.c
+ */
+static inline void myGPIO_Toggle(myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, WRITE_REG, myGPIO_RegRead(gpio, WRITE_REG) ^ mask);
+}
+
+/**
+ * @brief Vedi myGPIO_GetValue() in myGPIO.c
+ */
+static inline uint32_t myGPIO_GetValue(myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Assert(gpio != NULL);
+	return ((myGPIO_RegRead(gpio, READ_REG) & mask) == 0 ? MYGPIO_PIN_RESET : MYGPIO_PIN_SET);
+}
+
+/**
+ * @brief Vedi myGPIO_GetRead() in myGPIO.c
+ */
+static inline uint32_t myGPIO_GetRead(myGPIO_t gpio) {
+	myGPIO_Assert(gpio != NULL);
+	return myGPIO_RegRead(gpio, READ_REG);
+}
+
+/**
+ * @brief Vedi myGPIO_GlobalInterruptEnable() in myGPIO.c
+ */
+static inline void myGPIO_GlobalInterruptEnable(myGPIO_t gpio) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, GIES_REG, 1);
+}
+
+/**
+ * @brief Vedi myGPIO_GlobalInterruptDisable() in myGPIO.c
+ */
+static inline void myGPIO_GlobalInterruptDisable(myGPIO_t gpio) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, GIES_REG, 0);
+}
+
+/**
+ * @brief Vedi myGPIO_IsGlobalInterruptEnabled() in myGPIO.c
+ */
+static inline uint32_t myGPIO_IsGlobalInterruptEnabled(myGPIO_t gpio) {
+	myGPIO_Assert(gpio != NULL);
+	return ((myGPIO_RegRead(gpio, GIES_REG) & 1) == 0 ? MYGPIO_PIN_RESET : MYGPIO_PIN_SET);
+}
+
+/**
+ * @brief Vedi myGPIO_PendingInterrupt() in myGPIO.c
+ */
+static inline uint32_t myGPIO_PendingInterrupt(myGPIO_t gpio) {
+	myGPIO_Assert(gpio != NULL);
+	return ((myGPIO_RegRead(gpio, GIES_REG) & 2) == 0 ? MYGPIO_PIN_RESET : MYGPIO_PIN_SET);
+}
+
+/**
+ * @brief Vedi myGPIO_PinInterruptEnable() in myGPIO.c
+ */
+static inline void myGPIO_PinInterruptEnable(myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, PIE_REG, myGPIO_RegRead(gpio, PIE_REG) | mask);
+}
+
+/**
+ * @brief Vedi myGPIO_PinInterruptDisable() in myGPIO.c
+ */
+static inline void myGPIO_PinInterruptDisable(myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, PIE_REG, myGPIO_RegRead(gpio, PIE_REG) & ~mask);
+}
+
+/**
+ * @brief Vedi myGPIO_EnabledPinInterrupt() in myGPIO.c
+ */
+static inline uint32_t myGPIO_EnabledPinInterrupt(myGPIO_t gpio) {
+	myGPIO_Assert(gpio != NULL);
+	return myGPIO_RegRead(gpio, PIE_REG);
+}
+
+/**
+ * @brief Vedi myGPIO_PendingPinInterrupt() in myGPIO.c
+ */
+static inline uint32_t myGPIO_PendingPinInterrupt(myGPIO_t gpio) {
+	myGPIO_Assert(gpio != NULL);
+	return myGPIO_RegRead(gpio, IRQ_REG);
+}
+
+/**
+ * @brief Vedi myGPIO_PinInterruptAck() in myGPIO.c
+ */
+static inline void myGPIO_PinInterruptAck(myGPIO_t gpio, uint32_t mask) {
+	myGPIO_Assert(gpio != NULL);
+	myGPIO_RegWrite(gpio, IACK_REG, mask);
+}
+
+#endif
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file myGPIO_keypad.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_keypad.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Inizializza lo scanner e configura i pin.
+ *
+ * @param[out] keypad   scanner da inizializzare;
+ * @param[in]  gpio     istanza myGPIO, già inizializzata con myGPIO_Init();
+ * @param[in]  rows     numero di righe, da 1 a MYGPIO_KEYPAD_MAX_ROWS;
+ * @param[in]  row_pin  pin della riga 0;
+ * @param[in]  cols     numero di colonne, da 1 a MYGPIO_KEYPAD_MAX_COLS;
+ * @param[in]  col_pin  pin della colonna 0;
+ * @param[in]  samples  scansioni consecutive necessarie per accettare un cambiamento di stato di un tasto,
+ *                      da 1 a MYGPIO_DEBOUNCE_MAX_SAMPLES;
+ * @param[in]  settle   iterazioni di myGPIO_Spin() tra la selezione di una riga e la lettura delle
+ *                      colonne, per linee con capacità elevata; 0 se non necessario;
+ *
+ * @details
+ * Il valore delle righe nel registro WRITE viene azzerato, e righe e colonne vengono poste in modalità
+ * lettura; il contenuto del registro MODE viene letto una sola volta. Tutti i tasti sono inizialmente
+ * considerati rilasciati.
+ */
+void myGPIO_Keypad_Init(myGPIO_Keypad_t *keypad, myGPIO_t gpio, uint32_t rows, uint32_t row_pin, uint32_t cols, uint32_t col_pin, uint32_t samples, uint32_t settle) {
+	uint32_t row_mask, col_mask;
+	assert(keypad != NULL);
+	assert(gpio != NULL);
+	assert(rows >= 1 && rows <= MYGPIO_KEYPAD_MAX_ROWS && row_pin + rows <= 32);
+	assert(cols >= 1 && cols <= MYGPIO_KEYPAD_MAX_COLS && col_pin + cols <= 32);
+	row_mask = (MYGPIO_PIN(rows) - 1) << row_pin;
+	col_mask = (MYGPIO_PIN(cols) - 1) << col_pin;
+	assert((row_mask & col_mask) == 0);
+	keypad->gpio = gpio;
+	keypad->rows = rows;
+	keypad->row_pin = row_pin;
+	keypad->cols = cols;
+	keypad->col_pin = col_pin;
+	keypad->settle = settle;
+	myGPIO_RegWrite(gpio, WRITE_REG, myGPIO_RegRead(gpio, WRITE_REG) & ~row_mask);
+	keypad->mode = myGPIO_RegRead(gpio, MODE_REG) & ~(row_mask | col_mask);
+	myGPIO_RegWrite(gpio, MODE_REG, keypad->mode);
+	myGPIO_Debounce_Init(&keypad->debounce[0], 0, samples);
+	myGPIO_Debounce_Init(&keypad->debounce[1], 0, samples);
+}
+
+/**
+ * @brief Effettua una scansione della matrice, senza debouncing.
+ *
+ * @param[inout] keypad  scanner;
+ *
+ * @return stato istantaneo dei tasti: il bit r * 8 + c è alto se il tasto (r, c) è premuto
+ */
+uint64_t myGPIO_Keypad_Read(myGPIO_Keypad_t *keypad) {
+	uint32_t row, col_mask;
+	uint64_t keys = 0;
+	assert(keypad != NULL);
+	col_mask = MYGPIO_PIN(keypad->cols) - 1;
+	for (row = 0; row < keypad->rows; row++) {
+		uint32_t columns;
+		myGPIO_RegWrite(keypad->gpio, MODE_REG, keypad->mode | MYGPIO_PIN(keypad->row_pin + row));
+		myGPIO_Spin(keypad->settle);
+		columns = ~(myGPIO_RegRead(keypad->gpio, READ_REG) >> keypad->col_pin) & col_mask;
+		keys |= (uint64_t)columns << (8 * row);
+	}
+	return keys;
+}
+
+/**
+ * @brief Effettua una scansione della matrice e restituisce gli eventi di pressione e rilascio.
+ *
+ * @details
+ * Gli eventi vengono restituiti in ordine di indice del tasto; quelli in eccesso rispetto a max vanno
+ * persi, per cui max dovrebbe essere pari al numero di tasti per cui sono attesi eventi contemporanei.
+ *
+ * @param[inout] keypad  scanner;
+ * @param[out]   event   vettore degli eventi;
+ * @param[in]    max     dimensione del vettore;
+ *
+ * @return numero di eventi restituiti
+ */
+uint32_t myGPIO_Keypad_Scan(myGPIO_Keypad_t *keypad, myGPIO_KeyEvent_t *event, uint32_t max) {
+	uint64_t keys;
+	uint32_t half, n = 0;
+	assert(event != NULL || max == 0);
+	keys = myGPIO_Keypad_Read(keypad);
+	for (half = 0; half < 2; half++) {
+		myGPIO_Debounce_t *debounce = &keypad->debounce[half];
+		uint32_t changed = myGPIO_Debounce_Update(debounce, (uint32_t)(keys >> (32 * half)));
+		for (; changed != 0 && n < max; changed &= changed - 1, n++) {
+			uint32_t bit = myGPIO_ctz(changed);
+			event[n].key = 32 * half + bit;
+			event[n].pressed = ((debounce->state >> bit) & 1);
+		}
+	}
+	return n;
+}
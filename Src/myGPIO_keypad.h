@@ -0,0 +1,98 @@
+/**
+ * @file myGPIO_keypad.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_KEYPAD_HEADER_H
+#define MYGPIO_KEYPAD_HEADER_H
+
+#include "myGPIO.h"
+#include "myGPIO_debounce.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Scansione di una tastiera a matrice, fino a 8x8 tasti.
+ *
+ * @details
+ * Le righe occupano pin consecutivi a partire da row_pin, le colonne pin consecutivi a partire da
+ * col_pin; le colonne sono ingressi con pull-up, ed un tasto premuto collega la propria colonna alla
+ * propria riga. Il valore delle righe nel registro WRITE viene azzerato una sola volta, in
+ * myGPIO_Keypad_Init(): una riga viene quindi pilotata bassa ponendone il bit del registro MODE in modalità
+ * scrittura, mentre le altre righe, in modalità lettura, restano in alta impedenza ('Z'), come avviene in
+ * GPIOsingle. La scansione di ciascuna riga costa quindi una scrittura sul registro MODE, il cui valore
+ * viene calcolato a partire da una copia, ed una lettura del registro READ, che restituisce tutte le
+ * colonne: una scansione completa della matrice 8x8 costa 8 coppie scrittura/lettura, senza alcuna
+ * sequenza read-modify-write. Al termine della scansione l'ultima riga resta pilotata, il che è innocuo.
+ *
+ * Lo stato dei tasti, in cui il tasto (r, c) corrisponde al bit r * 8 + c, viene filtrato da due
+ * myGPIO_Debounce_t, uno per le righe 0-3 ed uno per le righe 4-7; myGPIO_Keypad_Scan() restituisce gli
+ * eventi di pressione e di rilascio dei tasti il cui stato stabile è cambiato.
+ *
+ * @warning Senza diodi in serie ai tasti, la pressione contemporanea di tre tasti ai vertici di un
+ * rettangolo della matrice fa apparire premuto anche il quarto (ghosting).
+ *
+ * @code
+ * myGPIO_Keypad_t keypad;
+ * myGPIO_KeyEvent_t ev[8];
+ * myGPIO_Keypad_Init(&keypad, gpio, 4, 0, 4, 8, 4, 0);
+ * // ogni 5 millisecondi
+ * uint32_t i, n = myGPIO_Keypad_Scan(&keypad, ev, 8);
+ * for (i = 0; i < n; i++)
+ *   printf("tasto %u %s\n", ev[i].key, ev[i].pressed ? "premuto" : "rilasciato");
+ * @endcode
+ */
+
+#define MYGPIO_KEYPAD_MAX_ROWS 8U  //!< numero massimo di righe
+#define MYGPIO_KEYPAD_MAX_COLS 8U  //!< numero massimo di colonne
+
+/**
+ * @brief Evento di pressione o rilascio di un tasto.
+ */
+typedef struct {
+	uint32_t key;      //!< indice del tasto, riga * 8 + colonna
+	uint32_t pressed;  //!< 1 se il tasto è stato premuto, 0 se è stato rilasciato
+} myGPIO_KeyEvent_t;
+
+typedef struct {
+	myGPIO_t gpio;                   //!< device myGPIO
+	uint32_t rows;                   //!< numero di righe
+	uint32_t row_pin;                //!< pin della riga 0
+	uint32_t cols;                   //!< numero di colonne
+	uint32_t col_pin;                //!< pin della colonna 0
+	uint32_t mode;                   //!< registro MODE con tutte le righe in alta impedenza
+	uint32_t settle;                 //!< iterazioni di attesa tra la selezione della riga e la lettura
+	myGPIO_Debounce_t debounce[2];   //!< debouncer delle righe 0-3 e 4-7
+} myGPIO_Keypad_t;
+
+void     myGPIO_Keypad_Init(myGPIO_Keypad_t *keypad, myGPIO_t gpio, uint32_t rows, uint32_t row_pin, uint32_t cols, uint32_t col_pin, uint32_t samples, uint32_t settle);
+uint64_t myGPIO_Keypad_Read(myGPIO_Keypad_t *keypad);
+uint32_t myGPIO_Keypad_Scan(myGPIO_Keypad_t *keypad, myGPIO_KeyEvent_t *event, uint32_t max);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
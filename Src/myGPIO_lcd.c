@@ -0,0 +1,246 @@
+/**
+ * @file myGPIO_lcd.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_lcd.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define MYGPIO_LCD_CLEAR        0x01U  //!< comando "clear display"
+#define MYGPIO_LCD_HOME         0x02U  //!< comando "return home"
+#define MYGPIO_LCD_ENTRY_INC    0x06U  //!< comando "entry mode set", incremento, senza shift
+#define MYGPIO_LCD_DISPLAY_OFF  0x08U  //!< comando "display on/off control", display spento
+#define MYGPIO_LCD_DISPLAY_ON   0x0CU  //!< comando "display on/off control", display acceso, cursore nascosto
+#define MYGPIO_LCD_FUNCTION_8   0x30U  //!< comando "function set", bus a 8 bit, una riga
+#define MYGPIO_LCD_FUNCTION_2L  0x08U  //!< bit "due righe" del comando "function set"
+#define MYGPIO_LCD_SET_DDRAM    0x80U  //!< comando "set DDRAM address"
+
+#define MYGPIO_LCD_EXEC_US      37U    //!< tempo di esecuzione di un comando o di una scrittura
+#define MYGPIO_LCD_CLEAR_US     1520U  //!< tempo di esecuzione di "clear display" e "return home"
+
+/**
+ * @brief Righe in ordine di indirizzo DDRAM, per numero di righe: nei display a 4 righe la riga 2
+ * prosegue la riga 0, e la riga 3 prosegue la riga 1.
+ */
+static const uint8_t myGPIO_Lcd_Order[MYGPIO_LCD_MAX_ROWS][MYGPIO_LCD_MAX_ROWS] = {
+	{0}, {0, 1}, {0, 2, 1}, {0, 2, 1, 3}
+};
+
+/**
+ * @brief Indirizzo DDRAM della prima cella di una riga.
+ */
+static uint32_t myGPIO_Lcd_Offset(const myGPIO_Lcd_t *lcd, uint32_t row) {
+	return (row & 1 ? 0x40U : 0x00U) + (row >> 1) * lcd->cols;
+}
+
+/**
+ * @brief Valore del contatore di indirizzo dopo una scrittura all'indirizzo address.
+ */
+static uint32_t myGPIO_Lcd_Next(const myGPIO_Lcd_t *lcd, uint32_t address) {
+	if (lcd->rows == 1)
+		return (address == 0x4FU ? 0x00U : address + 1);
+	if (address == 0x27U)
+		return 0x40U;
+	return (address == 0x67U ? 0x00U : address + 1);
+}
+
+static void myGPIO_Lcd_Delay(const myGPIO_Lcd_t *lcd, uint32_t us) {
+	if (lcd->delay_us != NULL)
+		lcd->delay_us(us);
+}
+
+/**
+ * @brief Trasferisce un byte: dati, RS ed E vengono impostati insieme, con due scritture sul registro
+ * WRITE, più una se RS cambia.
+ */
+static void myGPIO_Lcd_Transfer(myGPIO_Lcd_t *lcd, uint32_t rs, uint8_t byte) {
+	uint32_t word = (lcd->write & ~((0xFFU << lcd->data_pin) | lcd->rs | lcd->e)) | ((uint32_t)byte << lcd->data_pin) | (rs ? lcd->rs : 0);
+	if (((word ^ lcd->write) & lcd->rs) != 0)
+		myGPIO_RegWrite(lcd->gpio, WRITE_REG, word);
+	myGPIO_RegWrite(lcd->gpio, WRITE_REG, word | lcd->e);
+	myGPIO_RegWrite(lcd->gpio, WRITE_REG, word);
+	lcd->write = word;
+}
+
+/**
+ * @brief Invia un carattere alla cella puntata dal contatore di indirizzo.
+ */
+static void myGPIO_Lcd_Data(myGPIO_Lcd_t *lcd, uint8_t c) {
+	myGPIO_Lcd_Transfer(lcd, 1, c);
+	lcd->ac = myGPIO_Lcd_Next(lcd, lcd->ac);
+	myGPIO_Lcd_Delay(lcd, MYGPIO_LCD_EXEC_US);
+}
+
+/**
+ * @brief Inizializza il display, configurando i pin, ed azzera display e framebuffer.
+ *
+ * @param[out] lcd       display da inizializzare;
+ * @param[in]  gpio      istanza myGPIO, già inizializzata con myGPIO_Init();
+ * @param[in]  rows      numero di righe, da 1 a MYGPIO_LCD_MAX_ROWS;
+ * @param[in]  cols      numero di colonne; rows * cols non può superare MYGPIO_LCD_MAX_CELLS;
+ * @param[in]  data_pin  pin della linea D0; D1-D7 occupano i pin successivi;
+ * @param[in]  rs_pin    pin della linea RS;
+ * @param[in]  e_pin     pin della linea E;
+ * @param[in]  delay_us  funzione di attesa, in microsecondi; NULL solo se il display è simulato;
+ *
+ * @details
+ * I pin vengono configurati come output con due sequenze read-modify-write, le sole effettuate dal
+ * driver; viene poi eseguita la sequenza di inizializzazione "by instruction" prevista dal datasheet.
+ */
+void myGPIO_Lcd_Init(myGPIO_Lcd_t *lcd, myGPIO_t gpio, uint32_t rows, uint32_t cols, uint32_t data_pin, uint32_t rs_pin, uint32_t e_pin, void (*delay_us)(uint32_t)) {
+	uint32_t pins, row;
+	uint8_t function;
+	assert(lcd != NULL);
+	assert(gpio != NULL);
+	assert(rows >= 1 && rows <= MYGPIO_LCD_MAX_ROWS);
+	assert(cols >= 1 && cols <= MYGPIO_LCD_MAX_COLS && rows * cols <= MYGPIO_LCD_MAX_CELLS);
+	assert(data_pin + 8 <= 32 && rs_pin < 32 && e_pin < 32 && rs_pin != e_pin);
+	pins = (0xFFU << data_pin) | MYGPIO_PIN(rs_pin) | MYGPIO_PIN(e_pin);
+	assert(((0xFFU << data_pin) & (MYGPIO_PIN(rs_pin) | MYGPIO_PIN(e_pin))) == 0);
+	lcd->gpio = gpio;
+	lcd->data_pin = data_pin;
+	lcd->rs = MYGPIO_PIN(rs_pin);
+	lcd->e = MYGPIO_PIN(e_pin);
+	lcd->rows = rows;
+	lcd->cols = cols;
+	lcd->delay_us = delay_us;
+	for (row = 0; row < rows; row++)
+		lcd->order[row] = myGPIO_Lcd_Order[rows - 1][row];
+
+	lcd->write = myGPIO_RegRead(gpio, WRITE_REG) & ~pins;
+	myGPIO_RegWrite(gpio, WRITE_REG, lcd->write);
+	myGPIO_RegWrite(gpio, MODE_REG, myGPIO_RegRead(gpio, MODE_REG) | pins);
+
+	function = (uint8_t)(MYGPIO_LCD_FUNCTION_8 | (rows > 1 ? MYGPIO_LCD_FUNCTION_2L : 0));
+	myGPIO_Lcd_Delay(lcd, 15000);
+	myGPIO_Lcd_Transfer(lcd, 0, MYGPIO_LCD_FUNCTION_8);
+	myGPIO_Lcd_Delay(lcd, 4100);
+	myGPIO_Lcd_Transfer(lcd, 0, MYGPIO_LCD_FUNCTION_8);
+	myGPIO_Lcd_Delay(lcd, 100);
+	myGPIO_Lcd_Command(lcd, MYGPIO_LCD_FUNCTION_8);
+	myGPIO_Lcd_Command(lcd, function);
+	myGPIO_Lcd_Command(lcd, MYGPIO_LCD_DISPLAY_OFF);
+	myGPIO_Lcd_Command(lcd, MYGPIO_LCD_CLEAR);
+	myGPIO_Lcd_Command(lcd, MYGPIO_LCD_ENTRY_INC);
+	myGPIO_Lcd_Command(lcd, MYGPIO_LCD_DISPLAY_ON);
+	myGPIO_Lcd_Clear(lcd);
+}
+
+/**
+ * @brief Invia un comando al display.
+ *
+ * @details
+ * I comandi "clear display", "return home" e "set DDRAM address" aggiornano la copia della DDRAM ed il
+ * contatore di indirizzo tracciati dal driver. Comandi che modificano il contenuto della DDRAM o il verso
+ * di incremento del contatore di indirizzo per altra via (ad esempio "entry mode set" con decremento)
+ * rendono incoerente la copia della DDRAM, e non vanno usati assieme a myGPIO_Lcd_Flush().
+ *
+ * @param[inout] lcd      display;
+ * @param[in]    command  comando;
+ */
+void myGPIO_Lcd_Command(myGPIO_Lcd_t *lcd, uint8_t command) {
+	assert(lcd != NULL);
+	myGPIO_Lcd_Transfer(lcd, 0, command);
+	if ((command & MYGPIO_LCD_SET_DDRAM) != 0)
+		lcd->ac = command & 0x7FU;
+	else if ((command & 0xFEU) == MYGPIO_LCD_HOME)
+		lcd->ac = 0;
+	else if (command == MYGPIO_LCD_CLEAR) {
+		lcd->ac = 0;
+		memset(lcd->shadow, ' ', sizeof(lcd->shadow));
+	}
+	myGPIO_Lcd_Delay(lcd, (command == MYGPIO_LCD_CLEAR || (command & 0xFEU) == MYGPIO_LCD_HOME ? MYGPIO_LCD_CLEAR_US : MYGPIO_LCD_EXEC_US));
+}
+
+/**
+ * @brief Riempie il framebuffer di spazi e riporta la posizione di scrittura all'origine; non accede al bus.
+ */
+void myGPIO_Lcd_Clear(myGPIO_Lcd_t *lcd) {
+	assert(lcd != NULL);
+	memset(lcd->frame, ' ', sizeof(lcd->frame));
+	lcd->cursor = 0;
+}
+
+/**
+ * @brief Imposta la posizione di scrittura nel framebuffer; non accede al bus.
+ */
+void myGPIO_Lcd_SetCursor(myGPIO_Lcd_t *lcd, uint32_t row, uint32_t col) {
+	assert(lcd != NULL);
+	assert(row < lcd->rows && col < lcd->cols);
+	lcd->cursor = row * lcd->cols + col;
+}
+
+/**
+ * @brief Scrive un carattere nel framebuffer ed avanza la posizione di scrittura; '\\n' porta all'inizio
+ * della riga successiva. Non accede al bus.
+ */
+void myGPIO_Lcd_PutChar(myGPIO_Lcd_t *lcd, char c) {
+	assert(lcd != NULL);
+	if (c == '\n')
+		lcd->cursor = (lcd->cursor / lcd->cols + 1) * lcd->cols;
+	else
+		lcd->frame[lcd->cursor++] = (uint8_t)c;
+	if (lcd->cursor >= lcd->rows * lcd->cols)
+		lcd->cursor = 0;
+}
+
+/**
+ * @brief Scrive una stringa nel framebuffer, a partire dalla posizione di scrittura; non accede al bus.
+ */
+void myGPIO_Lcd_Print(myGPIO_Lcd_t *lcd, const char *string) {
+	assert(string != NULL);
+	while (*string != '\0')
+		myGPIO_Lcd_PutChar(lcd, *string++);
+}
+
+/**
+ * @brief Invia al display le celle del framebuffer che differiscono dal contenuto della DDRAM.
+ *
+ * @param[inout] lcd  display;
+ *
+ * @return numero di celle inviate al display
+ */
+uint32_t myGPIO_Lcd_Flush(myGPIO_Lcd_t *lcd) {
+	uint32_t r, row, col, cell, address, sent = 0;
+	assert(lcd != NULL);
+	for (r = 0; r < lcd->rows; r++) {
+		row = lcd->order[r];
+		for (col = 0; col < lcd->cols; col++) {
+			cell = row * lcd->cols + col;
+			if (lcd->frame[cell] == lcd->shadow[cell])
+				continue;
+			address = myGPIO_Lcd_Offset(lcd, row) + col;
+			if (address != lcd->ac) {
+				if (col > 0 && myGPIO_Lcd_Next(lcd, lcd->ac) == address) {
+					myGPIO_Lcd_Data(lcd, lcd->shadow[cell - 1]);
+					sent++;
+				}
+				else
+					myGPIO_Lcd_Command(lcd, (uint8_t)(MYGPIO_LCD_SET_DDRAM | address));
+			}
+			myGPIO_Lcd_Data(lcd, lcd->frame[cell]);
+			lcd->shadow[cell] = lcd->frame[cell];
+			sent++;
+		}
+	}
+	return sent;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file myGPIO_lcd.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_LCD_HEADER_H
+#define MYGPIO_LCD_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Display lcd alfanumerico Hitachi HD44780 con framebuffer, su bus a 8 bit.
+ *
+ * @details
+ * Le linee D0-D7 occupano pin consecutivi a partire da data_pin; RS ed E occupano due pin qualsiasi,
+ * mentre R/W va collegato a massa: il busy-flag non viene letto, ed i tempi di esecuzione dei comandi
+ * sono rispettati attraverso la funzione di attesa fornita a myGPIO_Lcd_Init().
+ *
+ * Il contenuto del registro WRITE viene mantenuto in una copia, per cui ogni trasferimento è composto
+ * soltanto da scritture, ciascuna delle quali imposta insieme dati, RS ed E: un byte costa due scritture,
+ * la prima con E alto, la seconda con E basso, sul cui fronte di discesa il display campiona i dati (che
+ * devono essere stabili solo prima del fronte di discesa); quando RS cambia viene effettuata una scrittura
+ * in più, per rispettarne il tempo di setup rispetto al fronte di salita di E.
+ *
+ * Le funzioni di scrittura (myGPIO_Lcd_Clear(), myGPIO_Lcd_SetCursor(), myGPIO_Lcd_Print(),
+ * myGPIO_Lcd_PutChar()) agiscono soltanto su un framebuffer in memoria; myGPIO_Lcd_Flush() lo confronta
+ * con una copia del contenuto della DDRAM del display ed invia soltanto le celle cambiate, in ordine di
+ * indirizzo DDRAM. Il contatore di indirizzo del display, che si incrementa ad ogni carattere, viene
+ * tracciato: il comando "set DDRAM address" viene inviato solo all'inizio di una sequenza di celle non
+ * contigue con la precedente, e le sequenze separate da una sola cella invariata vengono unite,
+ * riscrivendo quella cella, il che costa meno di un cambio di indirizzo. Ridisegnare uno schermo invariato
+ * non costa alcun accesso al bus.
+ *
+ * @code
+ * myGPIO_Lcd_t lcd;
+ * myGPIO_Lcd_Init(&lcd, gpio, 2, 16, 0, 8, 9, usleep);
+ * myGPIO_Lcd_SetCursor(&lcd, 0, 0);
+ * myGPIO_Lcd_Print(&lcd, "T = 21.5 C");
+ * myGPIO_Lcd_Flush(&lcd);
+ * @endcode
+ */
+
+#define MYGPIO_LCD_MAX_ROWS   4U   //!< numero massimo di righe
+#define MYGPIO_LCD_MAX_COLS   40U  //!< numero massimo di colonne
+#define MYGPIO_LCD_MAX_CELLS  80U  //!< dimensione della DDRAM
+
+typedef struct {
+	myGPIO_t gpio;                          //!< device myGPIO
+	uint32_t data_pin;                      //!< pin della linea D0
+	uint32_t rs;                            //!< maschera del pin RS
+	uint32_t e;                             //!< maschera del pin E
+	uint32_t write;                         //!< copia del registro WRITE
+	uint32_t rows;                          //!< numero di righe
+	uint32_t cols;                          //!< numero di colonne
+	uint32_t ac;                            //!< contatore di indirizzo DDRAM del display
+	uint32_t cursor;                        //!< posizione di scrittura nel framebuffer, riga * cols + colonna
+	void   (*delay_us)(uint32_t);           //!< funzione di attesa, in microsecondi, NULL se non necessaria
+	uint8_t  order[MYGPIO_LCD_MAX_ROWS];    //!< righe in ordine di indirizzo DDRAM
+	uint8_t  frame[MYGPIO_LCD_MAX_CELLS];   //!< framebuffer
+	uint8_t  shadow[MYGPIO_LCD_MAX_CELLS];  //!< contenuto della DDRAM del display
+} myGPIO_Lcd_t;
+
+void     myGPIO_Lcd_Init     (myGPIO_Lcd_t *lcd, myGPIO_t gpio, uint32_t rows, uint32_t cols, uint32_t data_pin, uint32_t rs_pin, uint32_t e_pin, void (*delay_us)(uint32_t));
+void     myGPIO_Lcd_Command  (myGPIO_Lcd_t *lcd, uint8_t command);
+void     myGPIO_Lcd_Clear    (myGPIO_Lcd_t *lcd);
+void     myGPIO_Lcd_SetCursor(myGPIO_Lcd_t *lcd, uint32_t row, uint32_t col);
+void     myGPIO_Lcd_PutChar  (myGPIO_Lcd_t *lcd, char c);
+void     myGPIO_Lcd_Print    (myGPIO_Lcd_t *lcd, const char *string);
+uint32_t myGPIO_Lcd_Flush    (myGPIO_Lcd_t *lcd);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
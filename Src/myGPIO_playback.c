@@ -0,0 +1,202 @@
+/**
+ * @file myGPIO_playback.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_playback.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+#define MYGPIO_PLAYBACK_CALIBRATION_POLLS 64U    //!< letture del contatore per la stima del costo del polling
+#define MYGPIO_PLAYBACK_CALIBRATION_LOOPS 4096U  //!< iterazioni del ciclo di ritardo per la sua calibrazione
+
+/**
+ * @brief Inizializza il motore di playback e ne calibra la temporizzazione.
+ *
+ * @param[out] pb         motore da inizializzare;
+ * @param[in]  gpio       istanza myGPIO, già inizializzata con myGPIO_Init();
+ * @param[in]  timestamp  funzione che restituisce il valore corrente di un contatore libero a 32 bit;
+ * @param[in]  period     periodo di aggiornamento, in tick del contatore, minore di 2^31;
+ * @param[in]  mode       MYGPIO_PLAYBACK_ONESHOT, MYGPIO_PLAYBACK_LOOP oppure MYGPIO_PLAYBACK_DOUBLE;
+ */
+void myGPIO_Playback_Init(myGPIO_Playback_t *pb, myGPIO_t gpio, uint32_t (*timestamp)(void), uint32_t period, uint32_t mode) {
+	assert(pb != NULL);
+	assert(gpio != NULL);
+	assert(timestamp != NULL);
+	assert(period < 0x80000000U);
+	assert(mode <= MYGPIO_PLAYBACK_DOUBLE);
+	pb->gpio = gpio;
+	pb->timestamp = timestamp;
+	pb->period = period;
+	pb->mode = mode;
+	pb->deadline = 0;
+	pb->index = 0;
+	pb->submitted = 0;
+	pb->consumed = 0;
+	myGPIO_Playback_Calibrate(pb);
+	myGPIO_Playback_Start(pb);
+}
+
+/**
+ * @brief Misura il costo di una iterazione del polling sul contatore e la velocità del ciclo di ritardo.
+ *
+ * @details
+ * Viene chiamata da myGPIO_Playback_Init(); va ripetuta se cambia la frequenza del processore o del
+ * contatore. Il costo del polling viene raddoppiato, in modo da comprendere il resto dell'iterazione.
+ *
+ * @param[inout] pb  motore di playback;
+ */
+void myGPIO_Playback_Calibrate(myGPIO_Playback_t *pb) {
+	uint32_t i, start, elapsed;
+	assert(pb != NULL);
+	start = pb->timestamp();
+	for (i = 0; i < MYGPIO_PLAYBACK_CALIBRATION_POLLS; i++)
+		(void)pb->timestamp();
+	elapsed = pb->timestamp() - start;
+	pb->spin = 2 * ((elapsed + MYGPIO_PLAYBACK_CALIBRATION_POLLS) / (MYGPIO_PLAYBACK_CALIBRATION_POLLS + 1));
+
+	start = pb->timestamp();
+	myGPIO_Spin(MYGPIO_PLAYBACK_CALIBRATION_LOOPS);
+	elapsed = pb->timestamp() - start;
+	pb->loops_q8 = (MYGPIO_PLAYBACK_CALIBRATION_LOOPS << 8) / (elapsed != 0 ? elapsed : 1);
+}
+
+/**
+ * @brief Accoda un buffer per la riproduzione; va chiamata esclusivamente dal produttore.
+ *
+ * @details
+ * Il buffer non viene copiato e non deve essere modificato finché non è stato riprodotto per intero,
+ * ossia finché myGPIO_Playback_Step() non ha restituito MYGPIO_PLAYBACK_REFILL per esso. In modalità
+ * MYGPIO_PLAYBACK_LOOP il buffer resta in uso indefinitamente.
+ *
+ * @param[inout] pb      motore di playback;
+ * @param[in]    word    parole da scrivere sul registro WRITE;
+ * @param[in]    length  numero di parole, maggiore di zero;
+ *
+ * @retval 0 se il buffer è stato accodato
+ * @retval -1 se entrambi i buffer sono occupati
+ */
+int myGPIO_Playback_Submit(myGPIO_Playback_t *pb, const uint32_t *word, uint32_t length) {
+	uint32_t submitted;
+	assert(pb != NULL);
+	assert(word != NULL);
+	assert(length != 0);
+	submitted = pb->submitted;
+	if (submitted - myGPIO_LoadAcquire(&pb->consumed) == 2)
+		return -1;
+	pb->slot[submitted & 1].word = word;
+	pb->slot[submitted & 1].length = length;
+	myGPIO_StoreRelease(&pb->submitted, submitted + 1);
+	return 0;
+}
+
+/**
+ * @brief Avvia la riproduzione: il primo aggiornamento avviene un periodo dopo la chiamata.
+ *
+ * @details
+ * Le statistiche vengono azzerate.
+ *
+ * @param[inout] pb  motore di playback;
+ */
+void myGPIO_Playback_Start(myGPIO_Playback_t *pb) {
+	assert(pb != NULL);
+	pb->stats.ticks = 0;
+	pb->stats.underrun = 0;
+	pb->stats.late_min = 0x7FFFFFFF;
+	pb->stats.late_max = -0x7FFFFFFF - 1;
+	pb->stats.late_sum = 0;
+	pb->deadline = pb->timestamp() + pb->period;
+}
+
+/**
+ * @brief Effettua, se la scadenza è stata raggiunta, il prossimo aggiornamento.
+ *
+ * @details
+ * Non è bloccante se alla scadenza manca più di una iterazione del polling: in tal caso restituisce
+ * immediatamente MYGPIO_PLAYBACK_WAIT, così che il chiamante possa svolgere altre attività, ad esempio il
+ * riempimento del buffer libero. Una scadenza mancata non viene saltata: le parole in ritardo vengono
+ * scritte una dopo l'altra fino a recuperare, ed il ritardo viene registrato nelle statistiche.
+ *
+ * @param[inout] pb  motore di playback;
+ *
+ * @return MYGPIO_PLAYBACK_WAIT, MYGPIO_PLAYBACK_TICK, MYGPIO_PLAYBACK_REFILL, MYGPIO_PLAYBACK_UNDERRUN
+ * oppure MYGPIO_PLAYBACK_DONE
+ */
+int myGPIO_Playback_Step(myGPIO_Playback_t *pb) {
+	const myGPIO_PlaybackBuffer_t *slot;
+	uint32_t consumed = pb->consumed;
+	int32_t remaining, late;
+	int empty = (consumed == myGPIO_LoadAcquire(&pb->submitted));
+	if (empty && pb->mode != MYGPIO_PLAYBACK_DOUBLE)
+		return MYGPIO_PLAYBACK_DONE;
+
+	remaining = (int32_t)(pb->deadline - pb->timestamp());
+	if (remaining > (int32_t)pb->spin)
+		return MYGPIO_PLAYBACK_WAIT;
+	if (remaining > 0)
+		myGPIO_Spin(((uint32_t)remaining * pb->loops_q8) >> 8);
+
+	if (empty) {
+		pb->deadline += pb->period;
+		pb->stats.underrun++;
+		return MYGPIO_PLAYBACK_UNDERRUN;
+	}
+	slot = &pb->slot[consumed & 1];
+	myGPIO_RegWrite(pb->gpio, WRITE_REG, slot->word[pb->index]);
+	late = (int32_t)(pb->timestamp() - pb->deadline);
+	pb->deadline += pb->period;
+	pb->stats.ticks++;
+	pb->stats.late_sum += late;
+	if (late < pb->stats.late_min)
+		pb->stats.late_min = late;
+	if (late > pb->stats.late_max)
+		pb->stats.late_max = late;
+
+	if (++pb->index < slot->length)
+		return MYGPIO_PLAYBACK_TICK;
+	pb->index = 0;
+	if (pb->mode == MYGPIO_PLAYBACK_LOOP)
+		return MYGPIO_PLAYBACK_TICK;
+	myGPIO_StoreRelease(&pb->consumed, consumed + 1);
+	return MYGPIO_PLAYBACK_REFILL;
+}
+
+/**
+ * @brief Riproduce, in modo bloccante, il numero di aggiornamenti specificato.
+ *
+ * @details
+ * In modalità MYGPIO_PLAYBACK_DOUBLE il riempimento dei buffer deve avvenire in un altro contesto (ISR o
+ * altro core); le scadenze senza dati sono conteggiate tra gli aggiornamenti.
+ *
+ * @param[inout] pb     motore di playback;
+ * @param[in]    ticks  numero di scadenze da servire; se zero, la riproduzione prosegue fino a quando
+ *                      myGPIO_Playback_Step() non restituisce MYGPIO_PLAYBACK_DONE, il che non avviene
+ *                      mai nelle modalità MYGPIO_PLAYBACK_LOOP e MYGPIO_PLAYBACK_DOUBLE;
+ *
+ * @return stato restituito dall'ultima chiamata a myGPIO_Playback_Step()
+ */
+int myGPIO_Playback_Run(myGPIO_Playback_t *pb, uint32_t ticks) {
+	int status;
+	assert(pb != NULL);
+	do {
+		while ((status = myGPIO_Playback_Step(pb)) == MYGPIO_PLAYBACK_WAIT);
+	} while (status != MYGPIO_PLAYBACK_DONE && (ticks == 0 || --ticks != 0));
+	return status;
+}
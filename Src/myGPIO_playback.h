@@ -0,0 +1,130 @@
+/**
+ * @file myGPIO_playback.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_PLAYBACK_HEADER_H
+#define MYGPIO_PLAYBACK_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Riproduzione a frequenza fissa di una sequenza di valori sul registro WRITE.
+ *
+ * @details
+ * Il motore di playback riceve buffer di parole a 32 bit e le scrive, una per tick, sul registro WRITE di
+ * un device myGPIO, con una sola scrittura e nessuna lettura per aggiornamento, a differenza di una forma
+ * d'onda generata con chiamate a myGPIO_SetValue(), ciascuna delle quali effettua un read-modify-write.
+ *
+ * Il tempo è misurato attraverso una funzione che restituisce il valore di un contatore libero a 32 bit
+ * (ad esempio il global timer del processing-system); il periodo è espresso in tick di tale contatore.
+ * Le scadenze sono assolute, deadline(k) = start + k * period, per cui gli errori non si accumulano. La
+ * temporizzazione viene calibrata da myGPIO_Playback_Calibrate(), che misura il costo di una iterazione
+ * del polling sul contatore e la velocità di un ciclo di ritardo: l'attesa procede con il polling fino a
+ * quando alla scadenza manca meno di una iterazione, e si completa con il ciclo di ritardo, così che il
+ * jitter non dipenda dalla granularità del polling. Per ciascun aggiornamento viene misurato il ritardo
+ * rispetto alla scadenza; minimo, massimo e somma sono accumulati in myGPIO_Playback_t::stats.
+ *
+ * Sono previste tre modalità:
+ * - MYGPIO_PLAYBACK_ONESHOT: i buffer accodati vengono riprodotti una volta, nell'ordine, dopodiché la
+ *   riproduzione termina;
+ * - MYGPIO_PLAYBACK_LOOP: il buffer corrente viene riprodotto ciclicamente;
+ * - MYGPIO_PLAYBACK_DOUBLE: due buffer vengono riprodotti alternativamente; quando uno dei due è stato
+ *   riprodotto per intero, myGPIO_Playback_Step() restituisce MYGPIO_PLAYBACK_REFILL e il buffer può
+ *   essere riempito nuovamente ed accodato con myGPIO_Playback_Submit(). Se alla scadenza non vi sono dati
+ *   il valore in uscita resta invariato e il tick viene conteggiato come underrun.
+ *
+ * La coppia myGPIO_Playback_Submit() / myGPIO_Playback_Step() è single-producer/single-consumer, con lo
+ * stesso schema di pubblicazione degli indici di myGPIO_Queue_t: il riempimento può avvenire nello stesso
+ * main-loop che chiama myGPIO_Playback_Step(), in una ISR oppure sull'altro core.
+ *
+ * @code
+ * uint32_t pattern[4] = {0x1, 0x3, 0x2, 0x0};
+ * myGPIO_Playback_t pb;
+ * myGPIO_Playback_Init(&pb, led_gpio, read_global_timer, 1000, MYGPIO_PLAYBACK_LOOP);
+ * myGPIO_Playback_Submit(&pb, pattern, 4);
+ * myGPIO_Playback_Start(&pb);
+ * myGPIO_Playback_Run(&pb, 100000);
+ * @endcode
+ */
+
+#define MYGPIO_PLAYBACK_ONESHOT  0U  //!< riproduce i buffer accodati una sola volta
+#define MYGPIO_PLAYBACK_LOOP     1U  //!< riproduce ciclicamente il buffer corrente
+#define MYGPIO_PLAYBACK_DOUBLE   2U  //!< riproduce alternativamente due buffer, riempiti durante la riproduzione
+
+#define MYGPIO_PLAYBACK_WAIT     0   //!< la scadenza non è ancora stata raggiunta
+#define MYGPIO_PLAYBACK_TICK     1   //!< è stata scritta una parola
+#define MYGPIO_PLAYBACK_REFILL   2   //!< è stata scritta l'ultima parola di un buffer, che è di nuovo libero
+#define MYGPIO_PLAYBACK_UNDERRUN 3   //!< scadenza raggiunta senza dati da scrivere
+#define MYGPIO_PLAYBACK_DONE     4   //!< non vi sono altri dati da riprodurre
+
+/**
+ * @brief Buffer accodato per la riproduzione.
+ */
+typedef struct {
+	const uint32_t *word;    //!< parole da scrivere sul registro WRITE
+	uint32_t        length;  //!< numero di parole
+} myGPIO_PlaybackBuffer_t;
+
+/**
+ * @brief Statistiche di temporizzazione, in tick del contatore.
+ */
+typedef struct {
+	uint32_t ticks;     //!< numero di aggiornamenti effettuati
+	uint32_t underrun;  //!< numero di scadenze raggiunte senza dati
+	int32_t  late_min;  //!< ritardo minimo rispetto alla scadenza
+	int32_t  late_max;  //!< ritardo massimo rispetto alla scadenza
+	int64_t  late_sum;  //!< somma dei ritardi, per il calcolo del ritardo medio
+} myGPIO_PlaybackStats_t;
+
+typedef struct {
+	myGPIO_t  gpio;                 //!< device su cui avviene la riproduzione
+	uint32_t (*timestamp)(void);    //!< contatore libero a 32 bit
+	uint32_t  period;               //!< periodo di aggiornamento, in tick del contatore
+	uint32_t  mode;                 //!< modalità di riproduzione
+	uint32_t  deadline;             //!< scadenza del prossimo aggiornamento
+	uint32_t  index;                //!< indice della prossima parola del buffer corrente
+	uint32_t  spin;                 //!< costo di una iterazione del polling, in tick
+	uint32_t  loops_q8;             //!< iterazioni del ciclo di ritardo per tick, in virgola fissa Q24.8
+	volatile uint32_t submitted;    //!< numero di buffer accodati, scritto solo dal produttore
+	volatile uint32_t consumed;     //!< numero di buffer riprodotti, scritto solo dal consumatore
+	myGPIO_PlaybackBuffer_t slot[2];
+	myGPIO_PlaybackStats_t  stats;
+} myGPIO_Playback_t;
+
+void myGPIO_Playback_Init     (myGPIO_Playback_t *pb, myGPIO_t gpio, uint32_t (*timestamp)(void), uint32_t period, uint32_t mode);
+void myGPIO_Playback_Calibrate(myGPIO_Playback_t *pb);
+int  myGPIO_Playback_Submit   (myGPIO_Playback_t *pb, const uint32_t *word, uint32_t length);
+void myGPIO_Playback_Start    (myGPIO_Playback_t *pb);
+int  myGPIO_Playback_Step     (myGPIO_Playback_t *pb);
+int  myGPIO_Playback_Run      (myGPIO_Playback_t *pb, uint32_t ticks);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
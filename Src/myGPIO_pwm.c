@@ -0,0 +1,139 @@
+/**
+ * @file myGPIO_pwm.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_pwm.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/**
+ * @brief Costruisce la tabella di un periodo a partire dai duty-cycle correnti.
+ *
+ * @details
+ * In modalità PWM la parola dello slot t è la OR dei canali con duty > t: raggruppando i canali per
+ * duty-cycle, le parole si ottengono a ritroso, con un costo proporzionale a canali + slot invece che al
+ * loro prodotto. In modalità BAM la parola dello slot k raccoglie il bit k del duty-cycle di ciascun canale.
+ */
+static void myGPIO_Pwm_Build(const myGPIO_Pwm_t *pwm, uint32_t *table) {
+	uint32_t channel, t, word;
+	if (pwm->mode == MYGPIO_PWM_MODE_PWM) {
+		uint32_t bucket[MYGPIO_PWM_MAX_SLOTS + 1];
+		memset(bucket, 0, (pwm->slots + 1) * sizeof(uint32_t));
+		for (channel = 0; channel < 32; channel++)
+			bucket[pwm->duty[channel]] |= MYGPIO_PIN(channel) & pwm->mask;
+		word = 0;
+		for (t = pwm->slots; t > 0; t--) {
+			word |= bucket[t];
+			table[t - 1] = pwm->base | word;
+		}
+	}
+	else {
+		for (t = 0; t < pwm->slots; t++) {
+			word = 0;
+			for (channel = 0; channel < 32; channel++)
+				word |= (uint32_t)((pwm->duty[channel] >> t) & 1) << channel;
+			table[t] = pwm->base | (word & pwm->mask);
+		}
+	}
+}
+
+/**
+ * @brief Inizializza il generatore, con tutti i duty-cycle nulli, e configura come output i pin pilotati.
+ *
+ * @param[out] pwm   generatore da inizializzare;
+ * @param[in]  gpio  istanza myGPIO, già inizializzata con myGPIO_Init();
+ * @param[in]  mask  maschera dei pin pilotati; gli altri pin mantengono il valore che hanno nel registro
+ *                   WRITE al momento dell'inizializzazione;
+ * @param[in]  mode  MYGPIO_PWM_MODE_PWM oppure MYGPIO_PWM_MODE_BAM;
+ * @param[in]  bits  risoluzione, da 1 a MYGPIO_PWM_MAX_BITS;
+ */
+void myGPIO_Pwm_Init(myGPIO_Pwm_t *pwm, myGPIO_t gpio, uint32_t mask, uint32_t mode, uint32_t bits) {
+	assert(pwm != NULL);
+	assert(gpio != NULL);
+	assert(mode == MYGPIO_PWM_MODE_PWM || mode == MYGPIO_PWM_MODE_BAM);
+	assert(bits >= 1 && bits <= MYGPIO_PWM_MAX_BITS);
+	pwm->gpio = gpio;
+	pwm->mask = mask;
+	pwm->mode = mode;
+	pwm->bits = bits;
+	pwm->slots = (mode == MYGPIO_PWM_MODE_PWM ? (1U << bits) - 1 : bits);
+	pwm->slot = 0;
+	pwm->active = 0;
+	pwm->pending = 0;
+	memset(pwm->duty, 0, sizeof(pwm->duty));
+	pwm->base = myGPIO_RegRead(gpio, WRITE_REG) & ~mask;
+	myGPIO_Pwm_Build(pwm, pwm->table[0]);
+	myGPIO_RegWrite(gpio, WRITE_REG, pwm->base);
+	myGPIO_RegWrite(gpio, MODE_REG, myGPIO_RegRead(gpio, MODE_REG) | mask);
+}
+
+/**
+ * @brief Imposta il duty-cycle di un canale; il valore diventa effettivo con myGPIO_Pwm_Commit().
+ *
+ * @param[inout] pwm      generatore;
+ * @param[in]    channel  canale, ossia indice del pin;
+ * @param[in]    duty     duty-cycle, da 0 a 2^bits - 1;
+ */
+void myGPIO_Pwm_SetDuty(myGPIO_Pwm_t *pwm, uint32_t channel, uint32_t duty) {
+	assert(pwm != NULL);
+	assert(channel < 32);
+	assert(duty < (1U << pwm->bits));
+	pwm->duty[channel] = (uint8_t)duty;
+}
+
+/**
+ * @brief Ricostruisce la tabella non in uso con i duty-cycle correnti e la pubblica; lo scambio avviene
+ * all'inizio del periodo successivo.
+ *
+ * @param[inout] pwm  generatore;
+ *
+ * @retval 0 se la tabella è stata pubblicata
+ * @retval -1 se la tabella pubblicata in precedenza non è ancora stata presa in uso; la chiamata va
+ * ripetuta successivamente
+ */
+int myGPIO_Pwm_Commit(myGPIO_Pwm_t *pwm) {
+	assert(pwm != NULL);
+	if (myGPIO_LoadAcquire(&pwm->pending) != 0)
+		return -1;
+	myGPIO_Pwm_Build(pwm, pwm->table[pwm->active ^ 1]);
+	myGPIO_StoreRelease(&pwm->pending, 1);
+	return 0;
+}
+
+/**
+ * @brief Avvia lo slot successivo, con una sola scrittura sul registro WRITE.
+ *
+ * @param[inout] pwm  generatore;
+ *
+ * @return durata dello slot avviato, in unità di tempo: 1 in modalità PWM, 2^k per lo slot k in modalità
+ * BAM
+ */
+uint32_t myGPIO_Pwm_Tick(myGPIO_Pwm_t *pwm) {
+	uint32_t slot = pwm->slot;
+	if (slot == 0 && myGPIO_LoadAcquire(&pwm->pending) != 0) {
+		pwm->active ^= 1;
+		myGPIO_StoreRelease(&pwm->pending, 0);
+	}
+	myGPIO_RegWrite(pwm->gpio, WRITE_REG, pwm->table[pwm->active][slot]);
+	pwm->slot = (slot + 1 == pwm->slots ? 0 : slot + 1);
+	return (pwm->mode == MYGPIO_PWM_MODE_BAM ? 1U << slot : 1U);
+}
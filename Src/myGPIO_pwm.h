@@ -0,0 +1,98 @@
+/**
+ * @file myGPIO_pwm.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_PWM_HEADER_H
+#define MYGPIO_PWM_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief PWM software e bit-angle modulation su tutti i pin di un device myGPIO.
+ *
+ * @details
+ * Il periodo viene suddiviso in slot; per ciascuno slot viene precalcolata, a partire dai duty-cycle dei
+ * canali, la parola da scrivere nel registro WRITE, per cui myGPIO_Pwm_Tick() effettua esattamente una
+ * scrittura per slot, qualunque sia il numero di canali. Il canale i corrisponde al pin i; il duty-cycle è
+ * espresso in passi, da 0 (sempre spento) a 2^bits - 1 (sempre acceso). Sono previste due modalità:
+ * - MYGPIO_PWM_MODE_PWM: il periodo è costituito da 2^bits - 1 slot di eguale durata, ed il canale è
+ *   acceso negli slot t < duty;
+ * - MYGPIO_PWM_MODE_BAM (bit-angle modulation): il periodo è costituito da bits slot, lo slot k dura 2^k
+ *   unità di tempo, ed il canale è acceso se il bit k del duty-cycle è alto. A parità di risoluzione le
+ *   scritture, e le interruzioni del timer che scandisce gli slot, passano da 2^bits - 1 a bits per periodo.
+ *
+ * myGPIO_Pwm_Tick() va chiamata all'inizio di ciascuno slot, tipicamente dalla ISR di un timer, e
+ * restituisce la durata, in unità di tempo, dello slot appena iniziato, con cui riprogrammare il timer.
+ *
+ * Le tabelle sono due: i duty-cycle vengono modificati con myGPIO_Pwm_SetDuty(), che agisce solo su una
+ * copia, e resi effettivi con myGPIO_Pwm_Commit(), che ricostruisce la tabella non in uso e la pubblica;
+ * lo scambio avviene in myGPIO_Pwm_Tick(), all'inizio del periodo successivo, così che nessun periodo
+ * venga generato con una combinazione parziale dei duty-cycle. Commit e Tick costituiscono una coppia
+ * single-producer/single-consumer, e possono quindi essere chiamate dal main-loop e da una ISR.
+ *
+ * @code
+ * myGPIO_Pwm_t pwm;
+ * myGPIO_Pwm_Init(&pwm, led_gpio, 0xFF, MYGPIO_PWM_MODE_BAM, 8);
+ * myGPIO_Pwm_SetDuty(&pwm, 0, 16);
+ * myGPIO_Pwm_SetDuty(&pwm, 1, 200);
+ * myGPIO_Pwm_Commit(&pwm);
+ * // nella ISR del timer
+ * reload_timer(unit * myGPIO_Pwm_Tick(&pwm));
+ * @endcode
+ */
+
+#define MYGPIO_PWM_MODE_PWM  0U  //!< PWM: 2^bits - 1 slot di eguale durata
+#define MYGPIO_PWM_MODE_BAM  1U  //!< bit-angle modulation: bits slot di durata 2^k
+
+#define MYGPIO_PWM_MAX_BITS  8U                               //!< risoluzione massima, in bit
+#define MYGPIO_PWM_MAX_SLOTS ((1U << MYGPIO_PWM_MAX_BITS) - 1) //!< numero massimo di slot per periodo
+
+typedef struct {
+	myGPIO_t gpio;                              //!< device myGPIO
+	uint32_t mask;                              //!< maschera dei pin pilotati
+	uint32_t base;                              //!< valore degli altri pin del registro WRITE
+	uint32_t mode;                              //!< MYGPIO_PWM_MODE_PWM oppure MYGPIO_PWM_MODE_BAM
+	uint32_t bits;                              //!< risoluzione, in bit
+	uint32_t slots;                             //!< numero di slot per periodo
+	uint32_t slot;                              //!< prossimo slot
+	uint32_t active;                            //!< tabella in uso, accesso riservato a myGPIO_Pwm_Tick()
+	volatile uint32_t pending;                  //!< 1 se l'altra tabella è pronta per lo scambio
+	uint8_t  duty[32];                          //!< duty-cycle dei canali, non ancora resi effettivi
+	uint32_t table[2][MYGPIO_PWM_MAX_SLOTS];    //!< parole da scrivere nel registro WRITE, per slot
+} myGPIO_Pwm_t;
+
+void     myGPIO_Pwm_Init   (myGPIO_Pwm_t *pwm, myGPIO_t gpio, uint32_t mask, uint32_t mode, uint32_t bits);
+void     myGPIO_Pwm_SetDuty(myGPIO_Pwm_t *pwm, uint32_t channel, uint32_t duty);
+int      myGPIO_Pwm_Commit (myGPIO_Pwm_t *pwm);
+uint32_t myGPIO_Pwm_Tick   (myGPIO_Pwm_t *pwm);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
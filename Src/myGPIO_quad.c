@@ -0,0 +1,114 @@
+/**
+ * @file myGPIO_quad.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_quad.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/**
+ * @brief Somma 1 ai contatori verticali selezionati da x.
+ *
+ * @details
+ * Il riporto viene propagato su tutti i piani, senza uscire anticipatamente dal ciclo: con encoder in
+ * movimento l'uscita anticipata è difficilmente predicibile, e costa più delle operazioni che risparmia.
+ */
+static void myGPIO_Quad_Add(uint32_t *plane, uint32_t x) {
+	uint32_t k, carry;
+	for (k = 0; k < MYGPIO_QUAD_PLANES; k++) {
+		carry = plane[k] & x;
+		plane[k] ^= x;
+		x = carry;
+	}
+}
+
+/**
+ * @brief Inizializza il decoder, con posizioni e contatori di errore nulli.
+ *
+ * @param[out] quad    decoder;
+ * @param[in]  pairs   numero di coppie A/B, da 1 a MYGPIO_QUAD_MAX_PAIRS;
+ * @param[in]  sample  valore iniziale del registro READ;
+ */
+void myGPIO_Quad_Init(myGPIO_Quad_t *quad, uint32_t pairs, uint32_t sample) {
+	assert(quad != NULL);
+	assert(pairs >= 1 && pairs <= MYGPIO_QUAD_MAX_PAIRS);
+	memset(quad, 0, sizeof(myGPIO_Quad_t));
+	quad->mask = 0x55555555U & (uint32_t)((1ULL << (2 * pairs)) - 1);
+	quad->previous = sample;
+}
+
+/**
+ * @brief Decodifica un campione del registro READ.
+ *
+ * @param[inout] quad    decoder;
+ * @param[in]    sample  campione;
+ */
+void myGPIO_Quad_Update(myGPIO_Quad_t *quad, uint32_t sample) {
+	uint32_t a0, b0, a1, b1, step, error, forward;
+	assert(quad != NULL);
+	a0 = quad->previous;
+	b0 = quad->previous >> 1;
+	a1 = sample;
+	b1 = sample >> 1;
+	step  = ((a0 ^ a1) ^ (b0 ^ b1)) & quad->mask;
+	error = ((a0 ^ a1) & (b0 ^ b1)) & quad->mask;
+	forward = a1 ^ b0;
+	quad->previous = sample;
+	myGPIO_Quad_Add(quad->up, step & forward);
+	myGPIO_Quad_Add(quad->down, step & ~forward);
+	while (error != 0) {
+		quad->error[myGPIO_ctz(error) >> 1]++;
+		error &= error - 1;
+	}
+	if (++quad->pending == (1U << MYGPIO_QUAD_PLANES) - 1)
+		myGPIO_Quad_Flush(quad);
+}
+
+/**
+ * @brief Legge il registro READ e decodifica il campione.
+ *
+ * @param[inout] quad  decoder;
+ * @param[in]    gpio  istanza myGPIO, già inizializzata con myGPIO_Init();
+ */
+void myGPIO_Quad_Sample(myGPIO_Quad_t *quad, myGPIO_t gpio) {
+	assert(gpio != NULL);
+	myGPIO_Quad_Update(quad, myGPIO_RegRead(gpio, READ_REG));
+}
+
+/**
+ * @brief Riversa i contatori verticali nelle posizioni delle coppie, che diventano così aggiornate.
+ *
+ * @param[inout] quad  decoder;
+ */
+void myGPIO_Quad_Flush(myGPIO_Quad_t *quad) {
+	uint32_t k, pins;
+	assert(quad != NULL);
+	for (k = 0; k < MYGPIO_QUAD_PLANES; k++) {
+		for (pins = quad->up[k]; pins != 0; pins &= pins - 1)
+			quad->count[myGPIO_ctz(pins) >> 1] += (int32_t)(1U << k);
+		for (pins = quad->down[k]; pins != 0; pins &= pins - 1)
+			quad->count[myGPIO_ctz(pins) >> 1] -= (int32_t)(1U << k);
+		quad->up[k] = 0;
+		quad->down[k] = 0;
+	}
+	quad->pending = 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file myGPIO_quad.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_QUAD_HEADER_H
+#define MYGPIO_QUAD_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Decodifica in parallelo di fino a 16 encoder in quadratura.
+ *
+ * @details
+ * La coppia i occupa i pin 2i (fase A) e 2i+1 (fase B). Per ciascun campione del registro READ le
+ * transizioni di tutte le coppie vengono decodificate con poche operazioni sulla parola intera: detti
+ * a0, b0 e a1, b1 i valori delle fasi nel campione precedente ed in quello corrente, la coppia avanza se
+ * è cambiata una sola fase e a1 ^ b0 = 1, arretra se è cambiata una sola fase e a1 ^ b0 = 0, mentre il
+ * cambiamento di entrambe le fasi è una transizione illegale, che viene conteggiata come errore.
+ *
+ * Gli avanzamenti e gli arretramenti vengono accumulati in contatori verticali a 8 bit (un piano di bit per
+ * ciascuna cifra, come in myGPIO_Debounce_t), aggiornati senza salti condizionati; ogni 255 campioni, o
+ * quando viene chiamata myGPIO_Quad_Flush(), i contatori verticali vengono riversati nei contatori con
+ * segno a 32 bit delle coppie. Gli errori, che sono rari, vengono conteggiati direttamente, coppia per
+ * coppia.
+ *
+ * @code
+ * myGPIO_Quad_t quad;
+ * myGPIO_Quad_Init(&quad, 4, myGPIO_GetRead(encoders));
+ * for (;;) {
+ *   myGPIO_Quad_Sample(&quad, encoders);
+ *   ...
+ *   myGPIO_Quad_Flush(&quad);
+ *   position = quad.count[0];
+ * }
+ * @endcode
+ */
+
+#define MYGPIO_QUAD_MAX_PAIRS 16U  //!< numero massimo di coppie A/B
+#define MYGPIO_QUAD_PLANES    8U   //!< bit dei contatori verticali
+
+typedef struct {
+	uint32_t previous;                    //!< campione precedente
+	uint32_t mask;                        //!< maschera dei pin della fase A delle coppie decodificate
+	uint32_t pending;                     //!< campioni accumulati nei contatori verticali
+	uint32_t up[MYGPIO_QUAD_PLANES];      //!< contatori verticali degli avanzamenti, sui pin della fase A
+	uint32_t down[MYGPIO_QUAD_PLANES];    //!< contatori verticali degli arretramenti, sui pin della fase A
+	int32_t  count[MYGPIO_QUAD_MAX_PAIRS];  //!< posizione delle coppie, aggiornata da myGPIO_Quad_Flush()
+	uint32_t error[MYGPIO_QUAD_MAX_PAIRS];  //!< transizioni illegali rilevate per ciascuna coppia
+} myGPIO_Quad_t;
+
+void myGPIO_Quad_Init  (myGPIO_Quad_t *quad, uint32_t pairs, uint32_t sample);
+void myGPIO_Quad_Update(myGPIO_Quad_t *quad, uint32_t sample);
+void myGPIO_Quad_Sample(myGPIO_Quad_t *quad, myGPIO_t gpio);
+void myGPIO_Quad_Flush (myGPIO_Quad_t *quad);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file myGPIO_queue.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_queue.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Inizializza una coda vuota.
+ *
+ * @param[out] queue      coda da inizializzare;
+ * @param[in]  timestamp  funzione che restituisce il valore corrente di un contatore (ad esempio il
+ *                        global timer del processing-system), oppure NULL;
+ */
+void myGPIO_Queue_Init(myGPIO_Queue_t *queue, uint32_t (*timestamp)(void)) {
+	assert(queue != NULL);
+	queue->head = 0;
+	queue->tail = 0;
+	queue->overflow = 0;
+	queue->overflow_pins = 0;
+	queue->timestamp = timestamp;
+}
+
+/**
+ * @brief Accoda un evento; va chiamata esclusivamente dal produttore.
+ *
+ * @param[inout] queue  coda;
+ * @param[in]    event  evento da accodare;
+ *
+ * @retval 0 se l'evento è stato accodato
+ * @retval -1 se la coda è piena; l'evento viene conteggiato in overflow
+ */
+int myGPIO_Queue_Push(myGPIO_Queue_t *queue, const myGPIO_Event_t *event) {
+	uint32_t head = queue->head;
+	if (head - myGPIO_LoadAcquire(&queue->tail) == MYGPIO_QUEUE_SIZE) {
+		queue->overflow++;
+		queue->overflow_pins |= event->pending;
+		return -1;
+	}
+	queue->event[head & (MYGPIO_QUEUE_SIZE - 1)] = *event;
+	myGPIO_StoreRelease(&queue->head, head + 1);
+	return 0;
+}
+
+/**
+ * @brief Preleva dalla coda fino a max eventi; va chiamata esclusivamente dal consumatore.
+ *
+ * @param[inout] queue  coda;
+ * @param[out]   event  vettore in cui copiare gli eventi prelevati, in ordine di arrivo;
+ * @param[in]    max    dimensione del vettore;
+ *
+ * @return numero di eventi prelevati
+ */
+uint32_t myGPIO_Queue_Drain(myGPIO_Queue_t *queue, myGPIO_Event_t *event, uint32_t max) {
+	uint32_t i;
+	assert(queue != NULL);
+	assert(event != NULL);
+	uint32_t tail = queue->tail;
+	uint32_t available = myGPIO_LoadAcquire(&queue->head) - tail;
+	if (available > max)
+		available = max;
+	for (i = 0; i < available; i++)
+		event[i] = queue->event[(tail + i) & (MYGPIO_QUEUE_SIZE - 1)];
+	myGPIO_StoreRelease(&queue->tail, tail + available);
+	return available;
+}
+
+/**
+ * @brief ISR: accoda lo stato del device e notifica il servizio delle interruzioni pendenti.
+ *
+ * @param[in] source  puntatore ad un oggetto myGPIO_QueueSource_t, nella forma richiesta da
+ *                    XScuGic_Connect();
+ *
+ * @details
+ * Effettua due letture (IRQ e READ) e due scritture (IACK) sul device. L'ack riguarda solo i pin letti
+ * in IRQ: le interruzioni manifestatesi nel frattempo generano un nuovo evento. La seconda scrittura azzera
+ * IACK, che nel VHDL mantiene il valore scritto fino alla successiva scrittura sul device e, finché non è
+ * nullo, impedisce ad IRQ di registrare nuove interruzioni, anche dopo il ritorno della ISR.
+ */
+void myGPIO_Queue_Isr(void *source) {
+	myGPIO_QueueSource_t *src = (myGPIO_QueueSource_t*) source;
+	myGPIO_Event_t event;
+	event.gpio = src->gpio;
+	event.pending = myGPIO_RegRead(src->gpio, IRQ_REG);
+	event.read = myGPIO_RegRead(src->gpio, READ_REG);
+	event.timestamp = (src->queue->timestamp != NULL ? src->queue->timestamp() : 0);
+	myGPIO_Queue_Push(src->queue, &event);
+	myGPIO_RegWrite(src->gpio, IACK_REG, event.pending);
+	myGPIO_RegWrite(src->gpio, IACK_REG, 0);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file myGPIO_queue.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_QUEUE_HEADER_H
+#define MYGPIO_QUEUE_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Coda lock-free single-producer/single-consumer di eventi di interruzione.
+ *
+ * @details
+ * La ISR, myGPIO_Queue_Isr(), si limita a leggere i registri IRQ e READ del device, ad accodare un
+ * evento {device, maschera pendente, snapshot di READ, timestamp} ed a notificare l'interruzione al
+ * device, azzerando poi IACK; l'elaborazione avviene nel main-loop, che preleva gli eventi a blocchi con myGPIO_Queue_Drain().
+ * Il tempo trascorso in ISR si riduce così a poche decine di istruzioni.
+ *
+ * La coda è lock-free: l'indice head è scritto solo dal produttore (la ISR), l'indice tail solo dal
+ * consumatore (il main-loop); ciascuno pubblica il proprio indice con semantica release e legge quello
+ * altrui con semantica acquire. Più device possono condividere la stessa coda purché le rispettive ISR
+ * non possano interrompersi a vicenda (stessa priorità sul GIC), così che il produttore resti unico.
+ * Quando la coda è piena l'evento viene scartato: il numero di eventi persi e la OR delle maschere
+ * pendenti perse vengono accumulati in overflow ed overflow_pins.
+ *
+ * @code
+ * myGPIO_Queue_t queue;
+ * myGPIO_QueueSource_t btn_src = {btn_gpio, &queue};
+ * myGPIO_Queue_Init(&queue, read_global_timer);
+ * XScuGic_Connect(&gic, XPAR_FABRIC_MYGPIO_1_INTERRUPT_INTR, (Xil_InterruptHandler)myGPIO_Queue_Isr, &btn_src);
+ * for (;;) {
+ *   myGPIO_Event_t ev[8];
+ *   uint32_t i, n = myGPIO_Queue_Drain(&queue, ev, 8);
+ *   for (i = 0; i < n; i++)
+ *     handle(&ev[i]);
+ * }
+ * @endcode
+ */
+
+#ifndef MYGPIO_QUEUE_SIZE
+#define MYGPIO_QUEUE_SIZE 64U  //!< numero di eventi della coda, deve essere una potenza di due
+#endif
+
+#if (MYGPIO_QUEUE_SIZE & (MYGPIO_QUEUE_SIZE - 1)) != 0
+#error "MYGPIO_QUEUE_SIZE deve essere una potenza di due"
+#endif
+
+/**
+ * @brief Evento di interruzione.
+ */
+typedef struct {
+	myGPIO_t gpio;       //!< device che ha generato l'interruzione
+	uint32_t pending;    //!< contenuto del registro IRQ
+	uint32_t read;       //!< contenuto del registro READ
+	uint32_t timestamp;  //!< istante di servizio, in cicli della sorgente di timestamp
+} myGPIO_Event_t;
+
+typedef struct {
+	volatile uint32_t head;           //!< numero di eventi accodati, scritto solo dal produttore
+	volatile uint32_t tail;           //!< numero di eventi prelevati, scritto solo dal consumatore
+	volatile uint32_t overflow;       //!< numero di eventi scartati per coda piena
+	volatile uint32_t overflow_pins;  //!< OR delle maschere pendenti degli eventi scartati
+	uint32_t (*timestamp)(void);      //!< sorgente di timestamp, NULL se non usata
+	myGPIO_Event_t event[MYGPIO_QUEUE_SIZE];
+} myGPIO_Queue_t;
+
+/**
+ * @brief Argomento di myGPIO_Queue_Isr(): device servito e coda su cui accodare gli eventi.
+ */
+typedef struct {
+	myGPIO_t        gpio;   //!< device servito dalla ISR
+	myGPIO_Queue_t *queue;  //!< coda degli eventi
+} myGPIO_QueueSource_t;
+
+void     myGPIO_Queue_Init (myGPIO_Queue_t *queue, uint32_t (*timestamp)(void));
+int      myGPIO_Queue_Push (myGPIO_Queue_t *queue, const myGPIO_Event_t *event);
+uint32_t myGPIO_Queue_Drain(myGPIO_Queue_t *queue, myGPIO_Event_t *event, uint32_t max);
+void     myGPIO_Queue_Isr  (void *source);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,183 @@
+/**
+ * @file myGPIO_regs.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_REGS_HEADER_H
+#define MYGPIO_REGS_HEADER_H
+
+#include "myGPIO.h"
+#include <assert.h>
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Mappa dei registri del device myGPIO e primitive di accesso usate dai moduli del driver.
+ *
+ * @details
+ * Tutti gli accessi ai registri effettuati dai moduli del driver passano per le macro myGPIO_RegRead() e
+ * myGPIO_RegWrite(). Di default esse si traducono in un accesso volatile all'indirizzo del registro.
+ * Definendo il simbolo MYGPIO_COUNT_ACCESS in compilazione, ciascun accesso viene anche conteggiato nelle
+ * variabili myGPIO_BusReads e myGPIO_BusWrites, il che consente di misurare il numero di transazioni
+ * AXI4-Lite effettuate da una sequenza di chiamate.
+ * Definendo invece il simbolo MYGPIO_BACKEND, ciascun accesso viene inoltrato alle funzioni
+ * myGPIO_BackendRead() e myGPIO_BackendWrite(), che devono essere fornite dal programma: in questo modo
+ * i moduli del driver possono essere eseguiti sull'host, contro una simulazione del device e di ciò che è
+ * collegato ai suoi pin.
+ *
+ * Definendo il simbolo MYGPIO_TRACE, infine, ciascun accesso, comunque venga servito, viene anche registrato
+ * in un buffer circolare, come descritto in myGPIO_trace.h. In tal caso myGPIO_RegRead() e myGPIO_RegWrite()
+ * sono funzioni static inline, per cui gpio e reg vengono valutati una sola volta, come senza registrazione.
+ *
+ * Allo stesso modo, i ritardi brevi dei moduli del driver passano per myGPIO_Spin(), un ciclo di attesa
+ * attiva che, con MYGPIO_BACKEND definito, viene inoltrato a myGPIO_BackendSpin(): una simulazione in tempo
+ * virtuale può così far avanzare il tempo anziché consumarlo.
+ *
+ * Le verifiche sul puntatore al device, in myGPIO.c come nelle varianti inline, passano per myGPIO_Assert():
+ * definendo MYGPIO_NO_ASSERT vengono rimosse, indipendentemente da NDEBUG, che continua a governare le
+ * assert() del resto dell'applicazione.
+ *
+ * Questo header può essere incluso prima o dopo myGPIO.h: con MYGPIO_INLINE definito, myGPIO_inline.h viene
+ * incluso per ultimo, quando registri e primitive di accesso sono già definiti.
+ */
+
+#define  MODE_REG   0   /**< indice del registro "mode" */
+#define  WRITE_REG  1   /**< indice del registro "write" */
+#define  READ_REG   2   /**< indice del registro "read" */
+#define  GIES_REG   3   /**< indice del registro "gies" */
+#define  PIE_REG    4   /**< indice del registro "pie" */
+#define  IRQ_REG    5   /**< indice del registro "irq" */
+#define  IACK_REG   6   /**< indice del registro "iack" */
+
+#ifdef MYGPIO_NO_ASSERT
+#define myGPIO_Assert(expr) ((void)0)
+#else
+#define myGPIO_Assert(expr) assert(expr)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(MYGPIO_BACKEND)
+uint32_t myGPIO_BackendRead (myGPIO_t gpio, uint32_t reg);
+void     myGPIO_BackendWrite(myGPIO_t gpio, uint32_t reg, uint32_t value);
+void     myGPIO_BackendSpin (uint32_t loops);
+#elif defined(MYGPIO_COUNT_ACCESS)
+extern unsigned long myGPIO_BusReads;   //!< numero di letture dai registri effettuate
+extern unsigned long myGPIO_BusWrites;  //!< numero di scritture sui registri effettuate
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(MYGPIO_BACKEND)
+
+#define myGPIO_RawRead(gpio, reg)         myGPIO_BackendRead((gpio), (reg))
+#define myGPIO_RawWrite(gpio, reg, value) myGPIO_BackendWrite((gpio), (reg), (value))
+#define myGPIO_Spin(loops)                myGPIO_BackendSpin(loops)
+
+#elif defined(MYGPIO_COUNT_ACCESS)
+
+#define myGPIO_RawRead(gpio, reg)         (myGPIO_BusReads++, (gpio)[reg])
+#define myGPIO_RawWrite(gpio, reg, value) ((void)(myGPIO_BusWrites++, (gpio)[reg] = (value)))
+
+#else
+
+#define myGPIO_RawRead(gpio, reg)         ((gpio)[reg])
+#define myGPIO_RawWrite(gpio, reg, value) ((void)((gpio)[reg] = (value)))
+
+#endif
+
+#if defined(MYGPIO_TRACE)
+
+#include "myGPIO_trace.h"
+
+/**
+ * @brief Legge un registro e registra l'accesso.
+ */
+static inline uint32_t myGPIO_RegRead(myGPIO_t gpio, uint32_t reg) {
+	return myGPIO_Trace_Log(gpio, reg, myGPIO_RawRead(gpio, reg));
+}
+
+/**
+ * @brief Scrive un registro e registra l'accesso, dopo che la scrittura è stata effettuata.
+ */
+static inline void myGPIO_RegWrite(myGPIO_t gpio, uint32_t reg, uint32_t value) {
+	myGPIO_RawWrite(gpio, reg, value);
+	myGPIO_Trace_Log(gpio, reg | MYGPIO_TRACE_WRITE, value);
+}
+
+#else
+
+#define myGPIO_RegRead(gpio, reg)         myGPIO_RawRead((gpio), (reg))
+#define myGPIO_RegWrite(gpio, reg, value) myGPIO_RawWrite((gpio), (reg), (value))
+
+#endif
+
+#ifndef myGPIO_Spin
+/**
+ * @brief Ciclo di attesa attiva di loops iterazioni.
+ */
+static inline void myGPIO_Spin(uint32_t loops) {
+	volatile uint32_t n = loops;
+	while (n != 0)
+		n--;
+}
+#endif
+
+/**
+ * @brief Restituisce l'indice del bit meno significativo ad uno di x, che deve essere diverso da zero.
+ */
+static inline uint32_t myGPIO_ctz(uint32_t x) {
+#ifdef __GNUC__
+	return (uint32_t)__builtin_ctz(x);
+#else
+	uint32_t n = 0;
+	while ((x & 1) == 0) {
+		x >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+/**
+ * @brief Lettura con semantica acquire e scrittura con semantica release degli indici condivisi tra una
+ * ISR ed il main-loop, o tra due core.
+ */
+#define myGPIO_LoadAcquire(ptr)         __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define myGPIO_StoreRelease(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+
+/**
+ * @}
+ * @}
+ */
+
+#ifdef MYGPIO_INLINE
+#include "myGPIO_inline.h"
+#endif
+
+#endif
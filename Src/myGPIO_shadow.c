@@ -0,0 +1,119 @@
+/**
+ * @file myGPIO_shadow.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_shadow.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Inizializza un handle shadow per un device myGPIO.
+ *
+ * @param[out] shadow  handle shadow da inizializzare;
+ * @param[in]  gpio    istanza myGPIO, già inizializzata con myGPIO_Init();
+ *
+ * @details
+ * Le copie shadow vengono caricate dai registri del device, per cui l'inizializzazione costa tre letture.
+ */
+void myGPIO_Shadow_Init(myGPIO_Shadow_t *shadow, myGPIO_t gpio) {
+	assert(shadow != NULL);
+	assert(gpio != NULL);
+	shadow->gpio = gpio;
+	myGPIO_Shadow_Resync(shadow);
+}
+
+/**
+ * @brief Ricarica le copie shadow dai registri MODE, WRITE e PIE del device.
+ *
+ * @param[inout] shadow  handle shadow;
+ *
+ * @details
+ * Va chiamata ogni qual volta i registri del device possano essere stati modificati senza passare per
+ * l'handle shadow.
+ */
+void myGPIO_Shadow_Resync(myGPIO_Shadow_t *shadow) {
+	assert(shadow != NULL);
+	shadow->mode  = myGPIO_RegRead(shadow->gpio, MODE_REG);
+	shadow->write = myGPIO_RegRead(shadow->gpio, WRITE_REG);
+	shadow->pie   = myGPIO_RegRead(shadow->gpio, PIE_REG);
+}
+
+/**
+ * @brief Equivalente a myGPIO_SetMode(), ma effettua una sola scrittura sul registro MODE.
+ *
+ * @param[inout] shadow  handle shadow;
+ * @param[in]    mask    maschera dei pin su cui agire;
+ * @param[in]    mode    modalità di funzionamento dei pin;
+ */
+void myGPIO_Shadow_SetMode(myGPIO_Shadow_t *shadow, uint32_t mask, uint32_t mode) {
+	assert(shadow != NULL);
+	shadow->mode = (MYGPIO_MODE_WRITE == mode ? shadow->mode | mask : shadow->mode & (~mask));
+	myGPIO_RegWrite(shadow->gpio, MODE_REG, shadow->mode);
+}
+
+/**
+ * @brief Equivalente a myGPIO_SetValue(), ma effettua una sola scrittura sul registro WRITE.
+ *
+ * @param[inout] shadow  handle shadow;
+ * @param[in]    mask    maschera dei pin su cui agire;
+ * @param[in]    value   valore dei pin;
+ */
+void myGPIO_Shadow_SetValue(myGPIO_Shadow_t *shadow, uint32_t mask, uint32_t value) {
+	assert(shadow != NULL);
+	shadow->write = (MYGPIO_PIN_SET == value ? shadow->write | mask : shadow->write & (~mask));
+	myGPIO_RegWrite(shadow->gpio, WRITE_REG, shadow->write);
+}
+
+/**
+ * @brief Equivalente a myGPIO_Toggle(), ma effettua una sola scrittura sul registro WRITE.
+ *
+ * @param[inout] shadow  handle shadow;
+ * @param[in]    mask    maschera dei pin su cui agire;
+ */
+void myGPIO_Shadow_Toggle(myGPIO_Shadow_t *shadow, uint32_t mask) {
+	assert(shadow != NULL);
+	shadow->write ^= mask;
+	myGPIO_RegWrite(shadow->gpio, WRITE_REG, shadow->write);
+}
+
+/**
+ * @brief Equivalente a myGPIO_PinInterruptEnable(), ma effettua una sola scrittura sul registro PIE.
+ *
+ * @param[inout] shadow  handle shadow;
+ * @param[in]    mask    maschera di selezione degli interrupt da abilitare;
+ */
+void myGPIO_Shadow_PinInterruptEnable(myGPIO_Shadow_t *shadow, uint32_t mask) {
+	assert(shadow != NULL);
+	shadow->pie |= mask;
+	myGPIO_RegWrite(shadow->gpio, PIE_REG, shadow->pie);
+}
+
+/**
+ * @brief Equivalente a myGPIO_PinInterruptDisable(), ma effettua una sola scrittura sul registro PIE.
+ *
+ * @param[inout] shadow  handle shadow;
+ * @param[in]    mask    maschera di selezione degli interrupt da disabilitare;
+ */
+void myGPIO_Shadow_PinInterruptDisable(myGPIO_Shadow_t *shadow, uint32_t mask) {
+	assert(shadow != NULL);
+	shadow->pie &= ~mask;
+	myGPIO_RegWrite(shadow->gpio, PIE_REG, shadow->pie);
+}
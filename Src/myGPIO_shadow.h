@@ -0,0 +1,76 @@
+/**
+ * @file myGPIO_shadow.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_SHADOW_HEADER_H
+#define MYGPIO_SHADOW_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Handle myGPIO con copia shadow dei registri MODE, WRITE e PIE.
+ *
+ * @details
+ * Le funzioni myGPIO_SetMode(), myGPIO_SetValue(), myGPIO_Toggle(), myGPIO_PinInterruptEnable() e
+ * myGPIO_PinInterruptDisable() effettuano una sequenza read-modify-write sul registro coinvolto: ogni
+ * aggiornamento costa una lettura ed una scrittura sul bus AXI4-Lite, e la lettura, non essendo la memoria
+ * del device cacheable, è la più costosa delle due.
+ * Un oggetto myGPIO_Shadow_t mantiene una copia dei registri MODE, WRITE e PIE, per cui ogni aggiornamento
+ * si traduce in una sola scrittura. La copia è valida fin quando il device viene acceduto esclusivamente
+ * attraverso l'handle shadow; se i registri vengono modificati per altra via (un altro handle, un reset del
+ * device) è necessario chiamare myGPIO_Shadow_Resync() prima di proseguire.
+ *
+ * @code
+ * myGPIO_t gpio;
+ * myGPIO_Shadow_t leds;
+ * myGPIO_Init(&gpio, XPAR_MYGPIO_0_S00_AXI_BASEADDR);
+ * myGPIO_Shadow_Init(&leds, gpio);
+ * myGPIO_Shadow_SetMode(&leds, MYGPIO_PIN0 | MYGPIO_PIN1, MYGPIO_MODE_WRITE);
+ * myGPIO_Shadow_Toggle(&leds, MYGPIO_PIN0);
+ * @endcode
+ */
+typedef struct {
+	myGPIO_t gpio;   //!< device myGPIO cui l'handle si riferisce
+	uint32_t mode;   //!< copia shadow del registro MODE
+	uint32_t write;  //!< copia shadow del registro WRITE
+	uint32_t pie;    //!< copia shadow del registro PIE
+} myGPIO_Shadow_t;
+
+void     myGPIO_Shadow_Init               (myGPIO_Shadow_t *shadow, myGPIO_t gpio);
+void     myGPIO_Shadow_Resync             (myGPIO_Shadow_t *shadow);
+void     myGPIO_Shadow_SetMode            (myGPIO_Shadow_t *shadow, uint32_t mask, uint32_t mode);
+void     myGPIO_Shadow_SetValue           (myGPIO_Shadow_t *shadow, uint32_t mask, uint32_t value);
+void     myGPIO_Shadow_Toggle             (myGPIO_Shadow_t *shadow, uint32_t mask);
+void     myGPIO_Shadow_PinInterruptEnable (myGPIO_Shadow_t *shadow, uint32_t mask);
+void     myGPIO_Shadow_PinInterruptDisable(myGPIO_Shadow_t *shadow, uint32_t mask);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * @file myGPIO_spi.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_spi.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * @brief Traspone una matrice di 8x8 bit: il bit c del byte r diventa il bit r del byte c.
+ */
+static uint64_t myGPIO_Spi_Transpose8(uint64_t x) {
+	uint64_t t;
+	t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+	return x;
+}
+
+/**
+ * @brief Inizializza il master SPI e configura la direzione dei pin.
+ *
+ * @param[out] spi       master da inizializzare;
+ * @param[in]  gpio      istanza myGPIO, già inizializzata con myGPIO_Init();
+ * @param[in]  lanes     numero di lane, da 1 a MYGPIO_SPI_MAX_LANES;
+ * @param[in]  mosi_pin  pin della linea MOSI della lane 0;
+ * @param[in]  miso_pin  pin della linea MISO della lane 0, oppure MYGPIO_SPI_NO_MISO;
+ * @param[in]  sclk_pin  pin della linea SCLK;
+ * @param[in]  cs        maschera dei pin di chip-select, 0 se non usati;
+ *
+ * @details
+ * MOSI, SCLK e chip-select vengono configurati come output, MISO come input; il valore degli altri pin
+ * di output viene preservato. L'inizializzazione costa due letture e due scritture; nel corso dei
+ * trasferimenti il device non deve essere modificato per altra via.
+ */
+void myGPIO_Spi_Init(myGPIO_Spi_t *spi, myGPIO_t gpio, uint32_t lanes, uint32_t mosi_pin, uint32_t miso_pin, uint32_t sclk_pin, uint32_t cs) {
+	uint32_t lane_mask, mosi, miso, mode;
+	assert(spi != NULL);
+	assert(gpio != NULL);
+	assert(lanes >= 1 && lanes <= MYGPIO_SPI_MAX_LANES);
+	assert(mosi_pin + lanes <= 32 && sclk_pin < 32);
+	assert(miso_pin == MYGPIO_SPI_NO_MISO || miso_pin + lanes <= 32);
+	lane_mask = (uint32_t)((1ULL << lanes) - 1);
+	mosi = lane_mask << mosi_pin;
+	miso = (miso_pin != MYGPIO_SPI_NO_MISO ? lane_mask << miso_pin : 0);
+	assert(((mosi | MYGPIO_PIN(sclk_pin) | cs) & miso) == 0);
+	assert((mosi & (MYGPIO_PIN(sclk_pin) | cs)) == 0 && (cs & MYGPIO_PIN(sclk_pin)) == 0);
+	spi->gpio = gpio;
+	spi->lanes = lanes;
+	spi->mosi_pin = mosi_pin;
+	spi->miso_pin = miso_pin;
+	spi->sclk = MYGPIO_PIN(sclk_pin);
+	spi->cs = cs;
+	spi->idle = (myGPIO_RegRead(gpio, WRITE_REG) & ~(mosi | spi->sclk)) | cs;
+	myGPIO_RegWrite(gpio, WRITE_REG, spi->idle);
+	mode = myGPIO_RegRead(gpio, MODE_REG);
+	myGPIO_RegWrite(gpio, MODE_REG, (mode | mosi | spi->sclk | cs) & ~miso);
+}
+
+/**
+ * @brief Traspone i flussi di byte delle lane in slice, una per bit, MSB per primo.
+ *
+ * @param[in]  data    byte da trasporre, interallacciati: il byte k della lane i in data[k * lanes + i];
+ * @param[in]  lanes   numero di lane, da 1 a MYGPIO_SPI_MAX_LANES;
+ * @param[in]  length  numero di byte per lane;
+ * @param[out] slice   8 * length slice: il bit i di slice[8 * k + j] è il bit 7 - j del byte k della lane i;
+ */
+void myGPIO_Spi_Slice(const uint8_t *data, uint32_t lanes, uint32_t length, uint16_t *slice) {
+	uint32_t k, lane, group, c;
+	assert(data != NULL || length == 0);
+	assert(slice != NULL || length == 0);
+	assert(lanes >= 1 && lanes <= MYGPIO_SPI_MAX_LANES);
+	for (k = 0; k < length; k++, data += lanes, slice += 8) {
+		uint64_t x[2] = {0, 0};
+		for (lane = 0; lane < lanes; lane++)
+			x[lane >> 3] |= (uint64_t)data[lane] << (8 * (lane & 7));
+		for (group = 0; group < (lanes + 7) / 8; group++)
+			x[group] = myGPIO_Spi_Transpose8(x[group]);
+		for (c = 0; c < 8; c++)
+			slice[7 - c] = (uint16_t)(((x[0] >> (8 * c)) & 0xFF) | (((x[1] >> (8 * c)) & 0xFF) << 8));
+	}
+}
+
+/**
+ * @brief Operazione inversa di myGPIO_Spi_Slice().
+ *
+ * @param[in]  slice   8 * length slice;
+ * @param[in]  lanes   numero di lane, da 1 a MYGPIO_SPI_MAX_LANES;
+ * @param[in]  length  numero di byte per lane;
+ * @param[out] data    byte ricostruiti, interallacciati come per myGPIO_Spi_Slice();
+ */
+void myGPIO_Spi_Unslice(const uint16_t *slice, uint32_t lanes, uint32_t length, uint8_t *data) {
+	uint32_t k, lane, group, c;
+	assert(data != NULL || length == 0);
+	assert(slice != NULL || length == 0);
+	assert(lanes >= 1 && lanes <= MYGPIO_SPI_MAX_LANES);
+	for (k = 0; k < length; k++, data += lanes, slice += 8) {
+		uint64_t x[2] = {0, 0};
+		for (c = 0; c < 8; c++) {
+			x[0] |= (uint64_t)(slice[7 - c] & 0xFF) << (8 * c);
+			x[1] |= (uint64_t)(slice[7 - c] >> 8) << (8 * c);
+		}
+		for (group = 0; group < (lanes + 7) / 8; group++)
+			x[group] = myGPIO_Spi_Transpose8(x[group]);
+		for (lane = 0; lane < lanes; lane++)
+			data[lane] = (uint8_t)(x[lane >> 3] >> (8 * (lane & 7)));
+	}
+}
+
+/**
+ * @brief Trasmette e riceve, su tutte le lane, le slice specificate.
+ *
+ * @details
+ * Il chip-select non viene modificato: la funzione può essere usata per trasferimenti che non sono
+ * multipli di un byte, oppure, con il chip-select già asserito, per dati trasposti in anticipo. Per
+ * ciascun bit vengono effettuate due scritture (dato con SCLK basso, poi SCLK alto) ed una lettura; al
+ * termine SCLK viene riportato basso.
+ *
+ * @param[inout] spi       master SPI;
+ * @param[in]    tx_slice  slice da trasmettere;
+ * @param[out]   rx_slice  slice ricevute, NULL se non interessa o se le lane sono di sola trasmissione;
+ * @param[in]    bits      numero di slice;
+ */
+void myGPIO_Spi_TransferSlices(myGPIO_Spi_t *spi, const uint16_t *tx_slice, uint16_t *rx_slice, uint32_t bits) {
+	uint32_t i, base, lane_mask;
+	assert(spi != NULL);
+	assert(tx_slice != NULL || bits == 0);
+	assert(rx_slice == NULL || spi->miso_pin != MYGPIO_SPI_NO_MISO);
+	base = spi->idle & ~spi->cs;
+	lane_mask = (uint32_t)((1ULL << spi->lanes) - 1);
+	for (i = 0; i < bits; i++) {
+		uint32_t word = base | (((uint32_t)tx_slice[i] & lane_mask) << spi->mosi_pin);
+		myGPIO_RegWrite(spi->gpio, WRITE_REG, word);
+		myGPIO_RegWrite(spi->gpio, WRITE_REG, word | spi->sclk);
+		if (rx_slice != NULL)
+			rx_slice[i] = (uint16_t)((myGPIO_RegRead(spi->gpio, READ_REG) >> spi->miso_pin) & lane_mask);
+	}
+	myGPIO_RegWrite(spi->gpio, WRITE_REG, base);
+}
+
+/**
+ * @brief Effettua un trasferimento completo su tutte le lane, asserendo il chip-select.
+ *
+ * @details
+ * I dati vengono trasposti a blocchi di MYGPIO_SPI_CHUNK byte per lane, usando buffer sullo stack.
+ *
+ * @param[inout] spi     master SPI;
+ * @param[in]    tx      byte da trasmettere, interallacciati come per myGPIO_Spi_Slice();
+ * @param[out]   rx      byte ricevuti, interallacciati, NULL se non interessa o se le lane sono di sola
+ *                       trasmissione;
+ * @param[in]    length  numero di byte per lane;
+ */
+void myGPIO_Spi_Transfer(myGPIO_Spi_t *spi, const uint8_t *tx, uint8_t *rx, uint32_t length) {
+	uint16_t tx_slice[8 * MYGPIO_SPI_CHUNK], rx_slice[8 * MYGPIO_SPI_CHUNK];
+	uint32_t k, chunk;
+	assert(spi != NULL);
+	assert(tx != NULL || length == 0);
+	for (k = 0; k < length; k += chunk) {
+		chunk = (length - k < MYGPIO_SPI_CHUNK ? length - k : MYGPIO_SPI_CHUNK);
+		myGPIO_Spi_Slice(tx + k * spi->lanes, spi->lanes, chunk, tx_slice);
+		myGPIO_Spi_TransferSlices(spi, tx_slice, (rx != NULL ? rx_slice : NULL), 8 * chunk);
+		if (rx != NULL)
+			myGPIO_Spi_Unslice(rx_slice, spi->lanes, chunk, rx + k * spi->lanes);
+	}
+	myGPIO_RegWrite(spi->gpio, WRITE_REG, spi->idle);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file myGPIO_spi.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_SPI_HEADER_H
+#define MYGPIO_SPI_HEADER_H
+
+#include "myGPIO.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Master SPI bit-bang a più lane, con clock condiviso, su un singolo device myGPIO.
+ *
+ * @details
+ * Fino a MYGPIO_SPI_MAX_LANES slave identici condividono SCLK e, opzionalmente, il chip-select; ciascuno
+ * ha la propria linea MOSI e la propria linea MISO. Le linee MOSI occupano pin consecutivi, a partire da
+ * mosi_pin (la lane i sul pin mosi_pin + i), e così le linee MISO, a partire da miso_pin. Poiché un device
+ * ha 32 pin, in full-duplex, con SCLK e chip-select, si possono avere al più 15 lane; specificando
+ * MYGPIO_SPI_NO_MISO come miso_pin le lane sono di sola trasmissione, e se ne possono usare 16.
+ *
+ * Invece di servire gli slave uno alla volta, i flussi di byte delle lane vengono trasposti (bit-slicing):
+ * per ciascun fronte di clock si ottiene una parola, detta slice, il cui bit i è il bit da trasmettere
+ * sulla lane i, e che viene scritta sul registro WRITE, traslata in corrispondenza delle linee MOSI, con
+ * una sola scrittura. Dopo il fronte di salita di SCLK viene letto il registro READ, la cui porzione
+ * corrispondente alle linee MISO costituisce la slice ricevuta, che viene infine trasposta all'indietro.
+ * Ogni bit costa due scritture ed una lettura qualunque sia il numero di lane: il throughput complessivo
+ * cresce con il numero di lane, invece di dividersi tra esse.
+ *
+ * La trasposizione avviene a blocchi di 8x8 bit, con la trasposizione di matrice su parola a 64 bit
+ * descritta in "Hacker's Delight": myGPIO_Spi_Slice() e myGPIO_Spi_Unslice() sono esposte perché i dati
+ * possano essere trasposti in anticipo e trasferiti con myGPIO_Spi_TransferSlices().
+ * Il protocollo implementato è il modo 0 (CPOL = 0, CPHA = 0), MSB per primo; il chip-select è attivo basso.
+ *
+ * I byte delle lane sono interallacciati: il byte k della lane i si trova in posizione k * lanes + i.
+ *
+ * @code
+ * myGPIO_Spi_t spi;
+ * uint8_t tx[4 * 2] = {...}, rx[4 * 2];
+ * myGPIO_Spi_Init(&spi, gpio, 4, 0, 8, 16, MYGPIO_PIN(17));
+ * myGPIO_Spi_Transfer(&spi, tx, rx, 2);
+ * @endcode
+ */
+
+#define MYGPIO_SPI_MAX_LANES 16U  //!< numero massimo di lane
+#define MYGPIO_SPI_CHUNK     8U   //!< byte per lane trasposti per volta da myGPIO_Spi_Transfer()
+#define MYGPIO_SPI_NO_MISO   0xFFU  //!< valore di miso_pin per lane di sola trasmissione
+
+typedef struct {
+	myGPIO_t gpio;      //!< device myGPIO
+	uint32_t lanes;     //!< numero di lane
+	uint32_t mosi_pin;  //!< pin della linea MOSI della lane 0
+	uint32_t miso_pin;  //!< pin della linea MISO della lane 0, MYGPIO_SPI_NO_MISO se non usate
+	uint32_t sclk;      //!< maschera del pin SCLK
+	uint32_t cs;        //!< maschera dei pin di chip-select, attivi bassi, 0 se non usati
+	uint32_t idle;      //!< valore del registro WRITE a riposo: chip-select alti, SCLK e MOSI bassi
+} myGPIO_Spi_t;
+
+void myGPIO_Spi_Init           (myGPIO_Spi_t *spi, myGPIO_t gpio, uint32_t lanes, uint32_t mosi_pin, uint32_t miso_pin, uint32_t sclk_pin, uint32_t cs);
+void myGPIO_Spi_Slice          (const uint8_t *data, uint32_t lanes, uint32_t length, uint16_t *slice);
+void myGPIO_Spi_Unslice        (const uint16_t *slice, uint32_t lanes, uint32_t length, uint8_t *data);
+void myGPIO_Spi_TransferSlices (myGPIO_Spi_t *spi, const uint16_t *tx_slice, uint16_t *rx_slice, uint32_t bits);
+void myGPIO_Spi_Transfer       (myGPIO_Spi_t *spi, const uint8_t *tx, uint8_t *rx, uint32_t length);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
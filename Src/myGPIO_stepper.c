@@ -0,0 +1,226 @@
+/**
+ * @file myGPIO_stepper.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_stepper.h"
+#include "myGPIO_regs.h"
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+
+#define MYGPIO_STEPPER_BISECTIONS 48  //!< iterazioni della bisezione che inverte la rampa ad S
+
+/**
+ * @brief Istante in cui la rampa di accelerazione, di durata ta, raggiunge la posizione x.
+ *
+ * @details
+ * Nel profilo trapezoidale x(t) = v t^2 / (2 ta), ed è invertita in forma chiusa; nel profilo ad S
+ * x(t) = v / 2 (t - ta / pi sin(pi t / ta)), che è monotona e viene invertita per bisezione.
+ */
+static double myGPIO_Stepper_Ramp(double x, double v, double ta, uint32_t profile) {
+	double low = 0, high = ta, t;
+	int i;
+	if (x <= 0)
+		return 0;
+	if (profile == MYGPIO_STEPPER_TRAPEZOID)
+		return sqrt(2 * x * ta / v);
+	for (i = 0; i < MYGPIO_STEPPER_BISECTIONS; i++) {
+		t = (low + high) / 2;
+		if (v / 2 * (t - ta / M_PI * sin(M_PI * t / ta)) < x)
+			low = t;
+		else
+			high = t;
+	}
+	return (low + high) / 2;
+}
+
+/**
+ * @brief Restituisce l'istante ideale, in secondi, dell'impulso k-esimo di un movimento.
+ *
+ * @param[in] steps         lunghezza del movimento, in passi;
+ * @param[in] velocity      velocità massima, in passi al secondo;
+ * @param[in] acceleration  accelerazione media durante le rampe, in passi al secondo quadrato; nel profilo
+ *                          ad S l'accelerazione di picco è pi/2 volte maggiore;
+ * @param[in] profile       MYGPIO_STEPPER_TRAPEZOID oppure MYGPIO_STEPPER_SCURVE;
+ * @param[in] k             indice dell'impulso, da 1 a steps: l'impulso k porta l'asse in posizione k;
+ *
+ * @details
+ * È la funzione usata per il calcolo delle tabelle, esposta perché il movimento generato possa essere
+ * confrontato con il profilo ideale.
+ */
+double myGPIO_Stepper_Time(uint32_t steps, double velocity, double acceleration, uint32_t profile, uint32_t k) {
+	double v = velocity, ta = velocity / acceleration, xa = v * ta / 2, tc, x = k;
+	if (2 * xa > steps) {
+		v = sqrt(steps * acceleration);
+		ta = v / acceleration;
+		xa = (double)steps / 2;
+	}
+	tc = (steps - 2 * xa) / v;
+	if (x <= xa)
+		return myGPIO_Stepper_Ramp(x, v, ta, profile);
+	if (x <= steps - xa)
+		return ta + (x - xa) / v;
+	return 2 * ta + tc - myGPIO_Stepper_Ramp(steps - x, v, ta, profile);
+}
+
+/**
+ * @brief Inizializza il generatore, senza assi.
+ *
+ * @param[out] stepper  generatore da inizializzare;
+ * @param[in]  gpio     istanza myGPIO, già inizializzata con myGPIO_Init();
+ * @param[in]  rate     tick al secondo, ossia frequenza di aggiornamento del motore di playback;
+ *
+ * @details
+ * La parola di riposo viene ricavata dal contenuto del registro WRITE, letto una sola volta.
+ */
+void myGPIO_Stepper_Init(myGPIO_Stepper_t *stepper, myGPIO_t gpio, double rate) {
+	assert(stepper != NULL);
+	assert(gpio != NULL);
+	assert(rate > 0);
+	stepper->gpio = gpio;
+	stepper->rate = rate;
+	stepper->base = myGPIO_RegRead(gpio, WRITE_REG);
+	stepper->axes = 0;
+	stepper->tick = 0;
+	stepper->end = 0;
+}
+
+/**
+ * @brief Aggiunge un asse, configurandone i pin come output, e ne calcola la tabella degli impulsi.
+ *
+ * @param[inout] stepper       generatore;
+ * @param[in]    step_pin      pin della linea STEP;
+ * @param[in]    dir_pin       pin della linea DIR, alta per movimenti in verso positivo;
+ * @param[out]   table         tabella degli istanti degli impulsi, fornita dal chiamante;
+ * @param[in]    capacity      dimensione della tabella, almeno pari a |steps|;
+ * @param[in]    steps         lunghezza del movimento, in passi, con segno;
+ * @param[in]    velocity      velocità massima, in passi al secondo; non può superare rate / 2;
+ * @param[in]    acceleration  accelerazione media durante le rampe, in passi al secondo quadrato;
+ * @param[in]    profile       MYGPIO_STEPPER_TRAPEZOID oppure MYGPIO_STEPPER_SCURVE;
+ *
+ * @details
+ * Gli istanti ideali vengono arrotondati al tick più vicino; poiché ogni impulso dura un tick, due impulsi
+ * consecutivi sono distanziati da almeno due tick, ed il primo impulso non cade prima del tick 1, così che
+ * DIR sia stabile prima del primo fronte di STEP. Deve essere chiamata prima di myGPIO_Stepper_Fill().
+ *
+ * @retval 0 se l'asse è stato aggiunto
+ * @retval -1 se il numero di assi è già pari a MYGPIO_STEPPER_MAX_AXES o se la tabella è troppo piccola
+ */
+int myGPIO_Stepper_AddAxis(myGPIO_Stepper_t *stepper, uint32_t step_pin, uint32_t dir_pin, uint32_t *table, uint32_t capacity, int32_t steps, double velocity, double acceleration, uint32_t profile) {
+	myGPIO_StepperAxis_t *axis;
+	uint32_t k, length, tick, earliest = 1;
+	assert(stepper != NULL);
+	assert(table != NULL);
+	assert(step_pin < 32 && dir_pin < 32 && step_pin != dir_pin);
+	assert(velocity > 0 && velocity <= stepper->rate / 2 && acceleration > 0);
+	assert(profile == MYGPIO_STEPPER_TRAPEZOID || profile == MYGPIO_STEPPER_SCURVE);
+	length = (uint32_t)(steps < 0 ? -steps : steps);
+	if (stepper->axes == MYGPIO_STEPPER_MAX_AXES || capacity < length)
+		return -1;
+	axis = &stepper->axis[stepper->axes++];
+	axis->step = MYGPIO_PIN(step_pin);
+	axis->dir = MYGPIO_PIN(dir_pin);
+	axis->tick = table;
+	axis->steps = length;
+	axis->next = 0;
+	for (k = 0; k < length; k++) {
+		tick = (uint32_t)(myGPIO_Stepper_Time(length, velocity, acceleration, profile, k + 1) * stepper->rate + 0.5);
+		if (tick < earliest)
+			tick = earliest;
+		table[k] = tick;
+		earliest = tick + 2;
+	}
+	if (length != 0 && table[length - 1] + 2 > stepper->end)
+		stepper->end = table[length - 1] + 2;
+	stepper->base &= ~axis->step;
+	stepper->base = (steps >= 0 ? stepper->base | axis->dir : stepper->base & ~axis->dir);
+	myGPIO_RegWrite(stepper->gpio, MODE_REG, myGPIO_RegRead(stepper->gpio, MODE_REG) | axis->step | axis->dir);
+	return 0;
+}
+
+/**
+ * @brief Produce il blocco successivo della sequenza di parole da scrivere nel registro WRITE.
+ *
+ * @param[inout] stepper  generatore;
+ * @param[out]   word     parole prodotte, una per tick;
+ * @param[in]    length   dimensione del blocco;
+ *
+ * @return numero di parole prodotte, minore di length solo per l'ultimo blocco, zero a movimento concluso
+ */
+uint32_t myGPIO_Stepper_Fill(myGPIO_Stepper_t *stepper, uint32_t *word, uint32_t length) {
+	uint32_t i, a, n, first;
+	assert(stepper != NULL);
+	assert(word != NULL || length == 0);
+	if (stepper->tick >= stepper->end)
+		return 0;
+	first = stepper->tick;
+	n = (stepper->end - first < length ? stepper->end - first : length);
+	for (i = 0; i < n; i++)
+		word[i] = stepper->base;
+	for (a = 0; a < stepper->axes; a++) {
+		myGPIO_StepperAxis_t *axis = &stepper->axis[a];
+		for (; axis->next < axis->steps && axis->tick[axis->next] < first + n; axis->next++)
+			word[axis->tick[axis->next] - first] |= axis->step;
+	}
+	stepper->tick = first + n;
+	return n;
+}
+
+/**
+ * @brief Esegue il movimento, in modo bloccante, attraverso un motore di playback.
+ *
+ * @param[inout] stepper  generatore;
+ * @param[inout] pb       motore di playback, inizializzato in modalità MYGPIO_PLAYBACK_DOUBLE, sullo
+ *                        stesso device, con periodo pari ad un tick;
+ * @param[out]   buffer   buffer di 2 * length parole, riempiti alternativamente;
+ * @param[in]    length   dimensione di ciascuno dei due buffer;
+ *
+ * @details
+ * Vengono contati i soli underrun che si verificano prima che l'ultima parola del movimento sia stata
+ * accodata: quello successivo, che trova entrambi i buffer vuoti, segnala la fine del movimento.
+ *
+ * @retval 0 se il movimento è stato riprodotto senza underrun
+ * @retval -1 se il riempimento di un buffer non è stato completato in tempo
+ */
+int myGPIO_Stepper_Run(myGPIO_Stepper_t *stepper, myGPIO_Playback_t *pb, uint32_t *buffer, uint32_t length) {
+	uint32_t half, n, refill = 0, underruns = 0;
+	int status;
+	assert(stepper != NULL);
+	assert(pb != NULL && pb->mode == MYGPIO_PLAYBACK_DOUBLE);
+	assert(buffer != NULL && length != 0);
+	for (half = 0; half < 2; half++)
+		if ((n = myGPIO_Stepper_Fill(stepper, buffer + half * length, length)) != 0)
+			myGPIO_Playback_Submit(pb, buffer + half * length, n);
+	myGPIO_Playback_Start(pb);
+	for (;;) {
+		status = myGPIO_Playback_Step(pb);
+		if (status == MYGPIO_PLAYBACK_REFILL) {
+			uint32_t *free_buffer = buffer + (refill++ & 1) * length;
+			if ((n = myGPIO_Stepper_Fill(stepper, free_buffer, length)) != 0)
+				myGPIO_Playback_Submit(pb, free_buffer, n);
+		}
+		else if (status == MYGPIO_PLAYBACK_UNDERRUN) {
+			if (stepper->tick >= stepper->end)
+				break;
+			underruns++;
+		}
+	}
+	return (underruns != 0 ? -1 : 0);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file myGPIO_stepper.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+
+#ifndef MYGPIO_STEPPER_HEADER_H
+#define MYGPIO_STEPPER_HEADER_H
+
+#include "myGPIO.h"
+#include "myGPIO_playback.h"
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Generatore di impulsi STEP/DIR per più assi, con profili di accelerazione precalcolati.
+ *
+ * @details
+ * Per ciascun asse viene precalcolata, da myGPIO_Stepper_AddAxis(), la tabella degli istanti, in tick,
+ * in cui emettere gli impulsi, secondo un profilo di velocità trapezoidale (accelerazione costante) oppure
+ * ad S (accelerazione sinusoidale, quindi continua); i profili sono simmetrici, e se la distanza non
+ * consente di raggiungere la velocità massima diventano triangolari. Il tick ha durata costante, pari al
+ * periodo del motore di playback di myGPIO_playback.h che riproduce il movimento.
+ *
+ * myGPIO_Stepper_Fill() fonde le tabelle di tutti gli assi in un'unica sequenza ordinata di parole da
+ * scrivere nel registro WRITE, una per tick: gli impulsi di assi diversi che cadono nello stesso tick
+ * vengono emessi con la stessa scrittura, ed ogni impulso dura un tick. Le linee DIR vengono impostate dalla
+ * prima parola della sequenza, che precede sempre il primo impulso. La sequenza viene prodotta a blocchi,
+ * per cui può essere riprodotta in modalità MYGPIO_PLAYBACK_DOUBLE, riempiendo un buffer mentre l'altro
+ * viene riprodotto; myGPIO_Stepper_Run() fa esattamente questo.
+ *
+ * @code
+ * uint32_t x_ticks[4000], y_ticks[4000], buffer[2 * 256];
+ * myGPIO_Stepper_t st;
+ * myGPIO_Playback_t pb;
+ * myGPIO_Stepper_Init(&st, gpio, 100000);   // tick da 10 us
+ * myGPIO_Stepper_AddAxis(&st, 0, 1, x_ticks, 4000,  3200, 20000, 80000, MYGPIO_STEPPER_TRAPEZOID);
+ * myGPIO_Stepper_AddAxis(&st, 2, 3, y_ticks, 4000, -1600, 20000, 80000, MYGPIO_STEPPER_SCURVE);
+ * myGPIO_Playback_Init(&pb, gpio, read_global_timer, GLOBAL_TIMER_HZ / 100000, MYGPIO_PLAYBACK_DOUBLE);
+ * myGPIO_Stepper_Run(&st, &pb, buffer, 256);
+ * @endcode
+ */
+
+#define MYGPIO_STEPPER_MAX_AXES   8U  //!< numero massimo di assi
+#define MYGPIO_STEPPER_TRAPEZOID  0U  //!< profilo trapezoidale
+#define MYGPIO_STEPPER_SCURVE     1U  //!< profilo ad S, con accelerazione sinusoidale
+
+typedef struct {
+	uint32_t  step;   //!< maschera del pin STEP
+	uint32_t  dir;    //!< maschera del pin DIR
+	uint32_t *tick;   //!< istanti degli impulsi, in tick, strettamente crescenti
+	uint32_t  steps;  //!< numero di impulsi
+	uint32_t  next;   //!< indice del prossimo impulso da emettere
+} myGPIO_StepperAxis_t;
+
+typedef struct {
+	myGPIO_t gpio;                                   //!< device myGPIO
+	double   rate;                                   //!< tick al secondo
+	uint32_t base;                                   //!< parola di riposo: altri pin, DIR impostati, STEP bassi
+	uint32_t axes;                                   //!< numero di assi
+	uint32_t tick;                                   //!< prossimo tick da generare
+	uint32_t end;                                    //!< tick al quale termina il movimento
+	myGPIO_StepperAxis_t axis[MYGPIO_STEPPER_MAX_AXES];
+} myGPIO_Stepper_t;
+
+void     myGPIO_Stepper_Init    (myGPIO_Stepper_t *stepper, myGPIO_t gpio, double rate);
+int      myGPIO_Stepper_AddAxis (myGPIO_Stepper_t *stepper, uint32_t step_pin, uint32_t dir_pin, uint32_t *table, uint32_t capacity, int32_t steps, double velocity, double acceleration, uint32_t profile);
+double   myGPIO_Stepper_Time    (uint32_t steps, double velocity, double acceleration, uint32_t profile, uint32_t k);
+uint32_t myGPIO_Stepper_Fill    (myGPIO_Stepper_t *stepper, uint32_t *word, uint32_t length);
+int      myGPIO_Stepper_Run     (myGPIO_Stepper_t *stepper, myGPIO_Playback_t *pb, uint32_t *buffer, uint32_t length);
+
+/**
+ * @}
+ * @}
+ */
+
+#endif
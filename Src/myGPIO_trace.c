@@ -0,0 +1,106 @@
+/**
+ * @file myGPIO_trace.c
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ */
+#include "myGPIO_trace.h"
+#include <stdlib.h>
+#include <assert.h>
+
+myGPIO_Trace_t myGPIO_TraceLog = { NULL, 0, 0, 0, { NULL }, 0, NULL, 0 };
+
+/**
+ * @brief Inizializza la registrazione, che resta sospesa fino a myGPIO_Trace_Start().
+ *
+ * @param[in] ring      buffer in cui registrare gli accessi;
+ * @param[in] capacity  numero di elementi del buffer, potenza di due;
+ */
+void myGPIO_Trace_Init(myGPIO_TraceRecord_t *ring, uint32_t capacity) {
+	uint32_t i;
+	assert(ring != NULL);
+	assert(capacity != 0 && (capacity & (capacity - 1)) == 0);
+	myGPIO_TraceLog.enabled = 0;
+	myGPIO_TraceLog.ring = ring;
+	myGPIO_TraceLog.mask = capacity - 1;
+	myGPIO_TraceLog.head = 0;
+	for (i = 0; i < MYGPIO_TRACE_MAX_DEVICES; i++)
+		myGPIO_TraceLog.device[i] = NULL;
+	myGPIO_TraceLog.devices = 0;
+	myGPIO_TraceLog.last = NULL;
+	myGPIO_TraceLog.last_index = MYGPIO_TRACE_UNKNOWN;
+}
+
+/**
+ * @brief Avvia, o riprende, la registrazione degli accessi.
+ */
+void myGPIO_Trace_Start(void) {
+	assert(myGPIO_TraceLog.ring != NULL);
+	myGPIO_TraceLog.enabled = 1;
+}
+
+/**
+ * @brief Sospende la registrazione degli accessi.
+ */
+void myGPIO_Trace_Stop(void) {
+	myGPIO_TraceLog.enabled = 0;
+}
+
+/**
+ * @brief Restituisce il numero di accessi presenti nel buffer.
+ */
+uint32_t myGPIO_Trace_Count(void) {
+	uint64_t capacity = (uint64_t)myGPIO_TraceLog.mask + 1;
+	if (myGPIO_TraceLog.ring == NULL)
+		return 0;
+	return (uint32_t)(myGPIO_TraceLog.head < capacity ? myGPIO_TraceLog.head : capacity);
+}
+
+/**
+ * @brief Restituisce il numero di accessi sovrascritti perché il buffer era pieno.
+ */
+uint64_t myGPIO_Trace_Dropped(void) {
+	return myGPIO_TraceLog.head - myGPIO_Trace_Count();
+}
+
+/**
+ * @brief Restituisce un accesso presente nel buffer, in ordine cronologico.
+ *
+ * @param[in] index  indice dell'accesso, da 0 (il più vecchio) a myGPIO_Trace_Count() - 1;
+ */
+const myGPIO_TraceRecord_t* myGPIO_Trace_Get(uint32_t index) {
+	assert(index < myGPIO_Trace_Count());
+	return &myGPIO_TraceLog.ring[(myGPIO_Trace_Dropped() + index) & myGPIO_TraceLog.mask];
+}
+
+/**
+ * @brief Restituisce l'indice di un device nella tabella dei device incontrati, aggiungendovelo se
+ * necessario; i device oltre MYGPIO_TRACE_MAX_DEVICES vengono registrati come MYGPIO_TRACE_UNKNOWN.
+ */
+uint8_t myGPIO_Trace_Device(myGPIO_t gpio) {
+	uint32_t i;
+	for (i = 0; i < myGPIO_TraceLog.devices && myGPIO_TraceLog.device[i] != gpio; i++);
+	if (i == myGPIO_TraceLog.devices) {
+		if (i == MYGPIO_TRACE_MAX_DEVICES)
+			return MYGPIO_TRACE_UNKNOWN;
+		myGPIO_TraceLog.device[myGPIO_TraceLog.devices++] = gpio;
+	}
+	myGPIO_TraceLog.last = gpio;
+	myGPIO_TraceLog.last_index = i;
+	return i;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file myGPIO_trace.h
+ * @author Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * @copyright
+ * Copyright 2017 Salvatore Barone <salvator.barone@gmail.com>
+ *
+ * This file is part of Zynq7000DriverPack
+ *
+ * Zynq7000DriverPack is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU General Public License as published by the Free Software Foundation; either version 3 of
+ * the License, or any later version.
+ *
+ * Zynq7000DriverPack is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if not,
+ * write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+ * USA.
+ *
+ */
+#ifndef MYGPIO_TRACE_HEADER_H
+#define MYGPIO_TRACE_HEADER_H
+
+#include "myGPIO.h"
+#if !defined(MYGPIO_TRACE_CLOCK) && defined(__linux__)
+#include <time.h>
+#endif
+
+/**
+ * @addtogroup myGPIO
+ * @{
+ * @addtogroup bare-metal
+ * @{
+ *
+ * @brief Registrazione degli accessi ai registri dei device myGPIO.
+ *
+ * @details
+ * Definendo il simbolo MYGPIO_TRACE in compilazione, ogni accesso effettuato attraverso myGPIO_RegRead() e
+ * myGPIO_RegWrite() viene registrato, dopo essere stato effettuato come di consueto, in un buffer circolare
+ * fornito con myGPIO_Trace_Init(): una scrittura compare nel buffer solo quando è già stata inoltrata al
+ * device. Ciascun elemento, di 16 byte, riporta l'istante in cui l'accesso è stato completato, il device
+ * (come indice nella tabella dei device incontrati, myGPIO_Trace_Device()), il registro, il verso ed il
+ * valore letto o scritto. MYGPIO_TRACE può essere combinato con MYGPIO_BACKEND o con MYGPIO_COUNT_ACCESS: gli
+ * accessi vengono registrati qualunque sia la via con cui vengono serviti.
+ *
+ * Registrare un accesso costa una lettura del tempo, il confronto con l'ultimo device incontrato ed alcune
+ * scritture in memoria cacheable. Il tempo è dato da MYGPIO_TRACE_CLOCK(), che sotto Linux legge
+ * CLOCK_MONOTONIC, in ns, ed altrove vale zero: su bare-metal può essere ridefinito in compilazione, ad
+ * esempio con il valore del global timer. Se il buffer si riempie, gli accessi più vecchi vengono
+ * sovrascritti. La registrazione non è rientrante: se gli accessi avvengono sia nel programma che in una
+ * ISR, un elemento scritto mentre l'interruzione lo sovrascrive può risultare incoerente.
+ *
+ * Sotto Linux, Linux/myGPIO_tracefile.h salva il contenuto del buffer su file e Linux/myGPIO_replay.h lo
+ * riesegue sul modello del device.
+ *
+ * @code
+ * // gcc -DMYGPIO_TRACE ...
+ * static myGPIO_TraceRecord_t ring[4096];
+ * myGPIO_Trace_Init(ring, 4096);
+ * myGPIO_Trace_Start();
+ * myGPIO_Toggle(gpio, MYGPIO_PIN0);
+ * myGPIO_Trace_Stop();
+ * for (i = 0; i < myGPIO_Trace_Count(); i++)
+ * 	print(myGPIO_Trace_Get(i));  // lettura e scrittura di WRITE
+ * @endcode
+ */
+
+#define MYGPIO_TRACE_MAX_DEVICES  8      //!< numero massimo di device distinti registrati
+#define MYGPIO_TRACE_UNKNOWN      0xFFU  //!< indice dei device oltre MYGPIO_TRACE_MAX_DEVICES
+#define MYGPIO_TRACE_WRITE        0x80U  //!< flag, nel campo access, che contraddistingue una scrittura
+#define MYGPIO_TRACE_REG          0x07U  //!< maschera dell'indice del registro, nel campo access
+
+/**
+ * @brief Accesso ad un registro.
+ */
+typedef struct {
+	uint64_t time;     //!< istante di completamento dell'accesso, secondo MYGPIO_TRACE_CLOCK()
+	uint32_t value;    //!< valore letto o scritto
+	uint8_t  device;   //!< indice del device nella tabella dei device incontrati
+	uint8_t  access;   //!< indice del registro, in OR con MYGPIO_TRACE_WRITE se l'accesso è una scrittura
+	uint16_t reserved; //!< non usato, vale zero
+} myGPIO_TraceRecord_t;
+
+typedef struct {
+	myGPIO_TraceRecord_t *ring;                              //!< buffer circolare, fornito dal chiamante
+	uint32_t              mask;                              //!< dimensione del buffer meno uno
+	uint32_t              enabled;                           //!< vero se la registrazione è attiva
+	uint64_t              head;                              //!< numero di accessi registrati dall'inizializzazione
+	myGPIO_t              device[MYGPIO_TRACE_MAX_DEVICES];  //!< device incontrati, in ordine di comparsa
+	uint32_t              devices;                           //!< numero di device incontrati
+	myGPIO_t              last;                              //!< ultimo device incontrato
+	uint8_t               last_index;                        //!< indice dell'ultimo device incontrato
+} myGPIO_Trace_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern myGPIO_Trace_t myGPIO_TraceLog;  //!< stato della registrazione
+
+void                        myGPIO_Trace_Init   (myGPIO_TraceRecord_t *ring, uint32_t capacity);
+void                        myGPIO_Trace_Start  (void);
+void                        myGPIO_Trace_Stop   (void);
+uint32_t                    myGPIO_Trace_Count  (void);
+uint64_t                    myGPIO_Trace_Dropped(void);
+const myGPIO_TraceRecord_t* myGPIO_Trace_Get    (uint32_t index);
+uint8_t                     myGPIO_Trace_Device (myGPIO_t gpio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifndef MYGPIO_TRACE_CLOCK
+#if defined(__linux__)
+static inline uint64_t myGPIO_Trace_Clock(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#define MYGPIO_TRACE_CLOCK() myGPIO_Trace_Clock()
+#else
+#define MYGPIO_TRACE_CLOCK() 0ULL
+#endif
+#endif
+
+/**
+ * @brief Registra un accesso già effettuato, se la registrazione è attiva, e restituisce il valore letto o
+ * scritto.
+ */
+static inline uint32_t myGPIO_Trace_Log(myGPIO_t gpio, uint32_t access, uint32_t value) {
+	myGPIO_Trace_t *trace = &myGPIO_TraceLog;
+	myGPIO_TraceRecord_t *record;
+	if (trace->enabled) {
+		record = &trace->ring[trace->head++ & trace->mask];
+		record->time = MYGPIO_TRACE_CLOCK();
+		record->value = value;
+		record->device = (gpio == trace->last ? trace->last_index : myGPIO_Trace_Device(gpio));
+		record->access = access;
+		record->reserved = 0;
+	}
+	return value;
+}
+
+/**
+ * @}
+ * @}
+ */
+
+#endif